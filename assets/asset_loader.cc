@@ -0,0 +1,48 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_loader.h"
+
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+AssetLoader::AssetLoader(std::shared_ptr<AssetManager> asset_manager,
+                         fml::RefPtr<fml::TaskRunner> task_runner)
+    : asset_manager_(std::move(asset_manager)),
+      task_runner_(std::move(task_runner)) {
+  FML_DCHECK(asset_manager_);
+  FML_DCHECK(task_runner_);
+}
+
+AssetLoader::~AssetLoader() = default;
+
+void AssetLoader::GetAsMapping(std::string asset_name,
+                               MappingCallback callback) const {
+  task_runner_->PostTask([asset_manager = asset_manager_,
+                          asset_name = std::move(asset_name),
+                          callback = std::move(callback)]() {
+    TRACE_EVENT0("flutter", "AssetLoader::GetAsMapping");
+    callback(asset_manager->GetAsMapping(asset_name));
+  });
+}
+
+void AssetLoader::Prefetch(std::vector<std::string> asset_names) const {
+  task_runner_->PostTask([asset_manager = asset_manager_,
+                          asset_names = std::move(asset_names)]() {
+    asset_manager->Prefetch(asset_names);
+  });
+}
+
+void AssetLoader::PrefetchSubdir(std::string subdir) const {
+  task_runner_->PostTask(
+      [asset_manager = asset_manager_, subdir = std::move(subdir)]() {
+        asset_manager->PrefetchSubdir(subdir);
+      });
+}
+
+}  // namespace flutter
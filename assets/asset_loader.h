@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_LOADER_H_
+#define FLUTTER_ASSETS_ASSET_LOADER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Reads the assets of an asset manager on a task runner, usually
+///             the IO task runner, so that large assets do not block the
+///             thread that requested them.
+///
+///             Tasks keep the asset manager alive, so it may be replaced while
+///             reads are pending. Reads and prefetches run in the order they
+///             were requested, so a prefetch hint given before a read has been
+///             acted on by the time the read starts.
+///
+class AssetLoader {
+ public:
+  using MappingCallback = std::function<void(std::unique_ptr<fml::Mapping>)>;
+
+  AssetLoader(std::shared_ptr<AssetManager> asset_manager,
+              fml::RefPtr<fml::TaskRunner> task_runner);
+
+  ~AssetLoader();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads `asset_name` on the task runner.
+  ///
+  /// @param[in]  callback  Called on the task runner with the mapping of the
+  ///                       asset, or nullptr if no resolver has it.
+  ///
+  void GetAsMapping(std::string asset_name, MappingCallback callback) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gives the resolvers a hint on the task runner that the
+  ///             `asset_names` will be read soon.
+  ///
+  /// @see        AssetResolver::Prefetch
+  ///
+  void Prefetch(std::vector<std::string> asset_names) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gives the resolvers a hint on the task runner that the assets
+  ///             in `subdir` will be read soon.
+  ///
+  /// @see        AssetResolver::PrefetchSubdir
+  ///
+  void PrefetchSubdir(std::string subdir) const;
+
+ private:
+  const std::shared_ptr<AssetManager> asset_manager_;
+  const fml::RefPtr<fml::TaskRunner> task_runner_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AssetLoader);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_ASSET_LOADER_H_
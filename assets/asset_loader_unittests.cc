@@ -0,0 +1,209 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_loader.h"
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+static std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+static void WriteAsset(const fml::UniqueFD& directory,
+                       const char* name,
+                       const std::string& contents) {
+  ASSERT_TRUE(
+      fml::WriteAtomically(directory, name, fml::DataMapping(contents)));
+}
+
+static std::shared_ptr<AssetManager> MakeAssetManager(
+    const fml::UniqueFD& directory) {
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+      directory, PackedAssetBundle::kFileName, false));
+  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
+      fml::Duplicate(directory.get()), false));
+  return asset_manager;
+}
+
+namespace {
+
+// A resolver whose reads wait until they are allowed to finish.
+class BlockingAssetResolver : public AssetResolver {
+ public:
+  BlockingAssetResolver(fml::AutoResetWaitableEvent& reading,
+                        fml::AutoResetWaitableEvent& finish,
+                        bool& destroyed)
+      : reading_(reading), finish_(finish), destroyed_(destroyed) {}
+
+  ~BlockingAssetResolver() override { destroyed_ = true; }
+
+  // |AssetResolver|
+  bool IsValid() const override { return true; }
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override { return false; }
+
+  // |AssetResolver|
+  AssetResolverType GetType() const override {
+    return AssetResolverType::kDirectoryAssetBundle;
+  }
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override {
+    reading_.Signal();
+    finish_.Wait();
+    return std::make_unique<fml::DataMapping>(std::string("old"));
+  }
+
+ private:
+  fml::AutoResetWaitableEvent& reading_;
+  fml::AutoResetWaitableEvent& finish_;
+  bool& destroyed_;
+};
+
+}  // namespace
+
+TEST(AssetLoaderTest, ReadsAssetsOnTheTaskRunner) {
+  fml::ScopedTemporaryDirectory dir;
+  WriteAsset(dir.fd(), "data.json", "{}");
+
+  fml::Thread io("io");
+  auto task_runner = io.GetTaskRunner();
+  AssetLoader loader(MakeAssetManager(dir.fd()), task_runner);
+
+  fml::AutoResetWaitableEvent latch;
+  std::string contents;
+  loader.GetAsMapping("data.json", [&](std::unique_ptr<fml::Mapping> mapping) {
+    EXPECT_TRUE(task_runner->RunsTasksOnCurrentThread());
+    contents = mapping ? ToString(*mapping) : "<missing>";
+    latch.Signal();
+  });
+  latch.Wait();
+  EXPECT_EQ(contents, "{}");
+
+  bool found = true;
+  loader.GetAsMapping("missing.json",
+                      [&](std::unique_ptr<fml::Mapping> mapping) {
+                        found = mapping != nullptr;
+                        latch.Signal();
+                      });
+  latch.Wait();
+  EXPECT_FALSE(found);
+}
+
+TEST(AssetLoaderTest, ServesPrefetchedAssets) {
+  fml::ScopedTemporaryDirectory dir;
+  std::vector<std::pair<std::string, std::unique_ptr<fml::Mapping>>> packed;
+  packed.emplace_back("images/a.png",
+                      std::make_unique<fml::DataMapping>(std::string("a")));
+  packed.emplace_back("images/b.png",
+                      std::make_unique<fml::DataMapping>(std::string("bb")));
+  packed.emplace_back("empty",
+                      std::make_unique<fml::DataMapping>(std::string()));
+  ASSERT_TRUE(PackedAssetBundle::Write(dir.fd(), PackedAssetBundle::kFileName,
+                                       packed));
+  auto fonts = fml::CreateDirectory(dir.fd(), {"fonts"},
+                                    fml::FilePermission::kReadWrite);
+  WriteAsset(fonts, "Roboto.ttf", "roboto");
+
+  fml::Thread io("io");
+  AssetLoader loader(MakeAssetManager(dir.fd()), io.GetTaskRunner());
+  loader.PrefetchSubdir("images");
+  loader.PrefetchSubdir("fonts");
+  loader.PrefetchSubdir("missing");
+  loader.Prefetch({"images/b.png", "fonts/Roboto.ttf", "empty", "missing"});
+
+  fml::AutoResetWaitableEvent latch;
+  std::vector<std::string> contents;
+  for (const char* name : {"images/a.png", "images/b.png", "fonts/Roboto.ttf",
+                           "empty"}) {
+    loader.GetAsMapping(name, [&](std::unique_ptr<fml::Mapping> mapping) {
+      contents.push_back(mapping ? ToString(*mapping) : "<missing>");
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+  EXPECT_EQ(contents,
+            std::vector<std::string>({"a", "bb", "roboto", std::string()}));
+}
+
+TEST(AssetLoaderTest, KeepsTheAssetManagerAlive) {
+  fml::ScopedTemporaryDirectory dir;
+  WriteAsset(dir.fd(), "data.json", "{}");
+
+  fml::Thread io("io");
+  auto task_runner = io.GetTaskRunner();
+
+  // Hold the task runner so that the read is still pending when the asset
+  // manager and the loader go away.
+  fml::AutoResetWaitableEvent blocked;
+  fml::AutoResetWaitableEvent unblock;
+  task_runner->PostTask([&]() {
+    blocked.Signal();
+    unblock.Wait();
+  });
+  blocked.Wait();
+
+  fml::AutoResetWaitableEvent latch;
+  std::string contents;
+  {
+    auto asset_manager = MakeAssetManager(dir.fd());
+    AssetLoader loader(asset_manager, task_runner);
+    loader.GetAsMapping("data.json",
+                        [&](std::unique_ptr<fml::Mapping> mapping) {
+                          contents = mapping ? ToString(*mapping) : "";
+                          latch.Signal();
+                        });
+  }
+  unblock.Signal();
+  latch.Wait();
+  EXPECT_EQ(contents, "{}");
+}
+
+TEST(AssetLoaderTest, KeepsReplacedResolversAliveWhileReading) {
+  fml::ScopedTemporaryDirectory dir;
+  fml::Thread io("io");
+  fml::AutoResetWaitableEvent reading;
+  fml::AutoResetWaitableEvent finish;
+  bool destroyed = false;
+
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(
+      std::make_unique<BlockingAssetResolver>(reading, finish, destroyed));
+  AssetLoader loader(asset_manager, io.GetTaskRunner());
+
+  fml::AutoResetWaitableEvent latch;
+  std::string contents;
+  loader.GetAsMapping("data.json", [&](std::unique_ptr<fml::Mapping> mapping) {
+    contents = mapping ? ToString(*mapping) : "";
+    latch.Signal();
+  });
+  reading.Wait();
+
+  // The platform thread replaces the resolver in the middle of the read.
+  asset_manager->UpdateResolverByType(
+      std::make_unique<DirectoryAssetBundle>(fml::Duplicate(dir.fd().get()),
+                                             false),
+      AssetResolver::AssetResolverType::kDirectoryAssetBundle);
+  EXPECT_FALSE(destroyed);
+
+  finish.Signal();
+  latch.Wait();
+  EXPECT_EQ(contents, "old");
+  EXPECT_TRUE(destroyed);
+}
+
+}  // namespace testing
+}  // namespace flutter
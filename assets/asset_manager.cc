@@ -13,19 +13,21 @@ AssetManager::AssetManager() = default;
 
 AssetManager::~AssetManager() = default;
 
-void AssetManager::PushFront(std::unique_ptr<AssetResolver> resolver) {
+void AssetManager::PushFront(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return;
   }
 
+  std::scoped_lock lock(resolvers_mutex_);
   resolvers_.push_front(std::move(resolver));
 }
 
-void AssetManager::PushBack(std::unique_ptr<AssetResolver> resolver) {
+void AssetManager::PushBack(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return;
   }
 
+  std::scoped_lock lock(resolvers_mutex_);
   resolvers_.push_back(std::move(resolver));
 }
 
@@ -35,13 +37,24 @@ void AssetManager::UpdateResolverByType(
   if (updated_asset_resolver == nullptr) {
     return;
   }
+  // A packed bundle holds the assets of the directory it was packed from,
+  // and would keep serving their old contents ahead of the new directory.
+  const bool drop_packed_bundles =
+      type == AssetResolver::AssetResolverType::kDirectoryAssetBundle;
   bool updated = false;
-  std::deque<std::unique_ptr<AssetResolver>> new_resolvers;
+  // Declared before the lock, so that the replaced resolvers are released
+  // after it.
+  std::deque<std::shared_ptr<AssetResolver>> new_resolvers;
+  std::scoped_lock lock(resolvers_mutex_);
   for (auto& old_resolver : resolvers_) {
     if (!updated && old_resolver->GetType() == type) {
       // Push the replacement updated resolver in place of the old_resolver.
       new_resolvers.push_back(std::move(updated_asset_resolver));
       updated = true;
+    } else if (drop_packed_bundles &&
+               old_resolver->GetType() ==
+                   AssetResolver::AssetResolverType::kPackedAssetBundle) {
+      continue;
     } else {
       new_resolvers.push_back(std::move(old_resolver));
     }
@@ -53,10 +66,16 @@ void AssetManager::UpdateResolverByType(
   resolvers_.swap(new_resolvers);
 }
 
-std::deque<std::unique_ptr<AssetResolver>> AssetManager::TakeResolvers() {
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::TakeResolvers() {
+  std::scoped_lock lock(resolvers_mutex_);
   return std::move(resolvers_);
 }
 
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::GetResolvers() const {
+  std::scoped_lock lock(resolvers_mutex_);
+  return resolvers_;
+}
+
 // |AssetResolver|
 std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
     const std::string& asset_name) const {
@@ -65,7 +84,7 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   }
   TRACE_EVENT1("flutter", "AssetManager::GetAsMapping", "name",
                asset_name.c_str());
-  for (const auto& resolver : resolvers_) {
+  for (const auto& resolver : GetResolvers()) {
     auto mapping = resolver->GetAsMapping(asset_name);
     if (mapping != nullptr) {
       return mapping;
@@ -85,7 +104,7 @@ std::vector<std::unique_ptr<fml::Mapping>> AssetManager::GetAsMappings(
   }
   TRACE_EVENT1("flutter", "AssetManager::GetAsMappings", "pattern",
                asset_pattern.c_str());
-  for (const auto& resolver : resolvers_) {
+  for (const auto& resolver : GetResolvers()) {
     auto resolver_mappings = resolver->GetAsMappings(asset_pattern, subdir);
     mappings.insert(mappings.end(),
                     std::make_move_iterator(resolver_mappings.begin()),
@@ -94,8 +113,29 @@ std::vector<std::unique_ptr<fml::Mapping>> AssetManager::GetAsMappings(
   return mappings;
 }
 
+// |AssetResolver|
+void AssetManager::Prefetch(const std::vector<std::string>& asset_names) const {
+  if (asset_names.empty()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "AssetManager::Prefetch");
+  for (const auto& resolver : GetResolvers()) {
+    resolver->Prefetch(asset_names);
+  }
+}
+
+// |AssetResolver|
+void AssetManager::PrefetchSubdir(const std::string& subdir) const {
+  TRACE_EVENT1("flutter", "AssetManager::PrefetchSubdir", "subdir",
+               subdir.c_str());
+  for (const auto& resolver : GetResolvers()) {
+    resolver->PrefetchSubdir(subdir);
+  }
+}
+
 // |AssetResolver|
 bool AssetManager::IsValid() const {
+  std::scoped_lock lock(resolvers_mutex_);
   return resolvers_.size() > 0;
 }
 
@@ -7,6 +7,7 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <optional>
@@ -16,15 +17,21 @@
 
 namespace flutter {
 
+/// Resolves assets with a list of resolvers that are checked in order.
+///
+/// The list may be changed on one thread while assets are read on another, for
+/// instance on the platform thread while the IO thread reads assets for the
+/// framework. Reads use a snapshot of the list, and resolvers are shared, so a
+/// resolver that is removed stays alive until the reads using it are done.
 class AssetManager final : public AssetResolver {
  public:
   AssetManager();
 
   ~AssetManager() override;
 
-  void PushFront(std::unique_ptr<AssetResolver> resolver);
+  void PushFront(std::shared_ptr<AssetResolver> resolver);
 
-  void PushBack(std::unique_ptr<AssetResolver> resolver);
+  void PushBack(std::shared_ptr<AssetResolver> resolver);
 
   //--------------------------------------------------------------------------
   /// @brief      Replaces an asset resolver of the specified `type` with
@@ -43,6 +50,10 @@ class AssetManager final : public AssetResolver {
   ///             replacement only occurs with the first matching resolver.
   ///             Any additional matching resolvers are untouched.
   ///
+  ///             Replacing a directory asset bundle also removes any packed
+  ///             asset bundle, whose assets would otherwise shadow the
+  ///             updated ones.
+  ///
   /// @param[in]  updated_asset_resolver  The asset resolver to replace the
   ///             resolver of matching type with.
   ///
@@ -54,7 +65,7 @@ class AssetManager final : public AssetResolver {
       std::unique_ptr<AssetResolver> updated_asset_resolver,
       AssetResolver::AssetResolverType type);
 
-  std::deque<std::unique_ptr<AssetResolver>> TakeResolvers();
+  std::deque<std::shared_ptr<AssetResolver>> TakeResolvers();
 
   // |AssetResolver|
   bool IsValid() const override;
@@ -74,8 +85,17 @@ class AssetManager final : public AssetResolver {
       const std::string& asset_pattern,
       const std::optional<std::string>& subdir) const override;
 
+  // |AssetResolver|
+  void Prefetch(const std::vector<std::string>& asset_names) const override;
+
+  // |AssetResolver|
+  void PrefetchSubdir(const std::string& subdir) const override;
+
  private:
-  std::deque<std::unique_ptr<AssetResolver>> resolvers_;
+  mutable std::mutex resolvers_mutex_;
+  std::deque<std::shared_ptr<AssetResolver>> resolvers_;
+
+  std::deque<std::shared_ptr<AssetResolver>> GetResolvers() const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(AssetManager);
 };
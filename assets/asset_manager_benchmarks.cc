@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kAssetCount = 10000;
+
+// A bundle of 10k small assets spread over 100 directories, both as loose
+// files and packed, created once for all the benchmarks.
+class TestBundle {
+ public:
+  static const TestBundle& Get() {
+    static const TestBundle bundle;
+    return bundle;
+  }
+
+  const fml::ScopedTemporaryDirectory& directory() const { return dir_; }
+
+  const std::vector<std::string>& names() const { return names_; }
+
+ private:
+  fml::ScopedTemporaryDirectory dir_;
+  std::vector<std::string> names_;
+
+  TestBundle() {
+    std::vector<std::pair<std::string, std::unique_ptr<fml::Mapping>>> assets;
+    for (int i = 0; i < kAssetCount; i++) {
+      std::string subdir = "dir" + std::to_string(i % 100);
+      std::string file_name = "asset" + std::to_string(i) + ".json";
+      if (i < 100) {
+        fml::CreateDirectory(dir_.fd(), {subdir},
+                             fml::FilePermission::kReadWrite);
+      }
+      std::string name = subdir + "/" + file_name;
+      std::string contents(256 + i % 1024, 'a');
+      fml::DataMapping data(contents);
+      FML_CHECK(fml::WriteAtomically(dir_.fd(), name.c_str(), data));
+      assets.emplace_back(name, std::make_unique<fml::DataMapping>(contents));
+      names_.push_back(name);
+    }
+    FML_CHECK(PackedAssetBundle::Write(dir_.fd(), PackedAssetBundle::kFileName,
+                                       assets));
+  }
+};
+
+std::unique_ptr<AssetManager> CreateAssetManager(bool packed) {
+  const auto& dir = TestBundle::Get().directory();
+  auto asset_manager = std::make_unique<AssetManager>();
+  if (packed) {
+    asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+        dir.fd(), PackedAssetBundle::kFileName, false));
+  } else {
+    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(dir.path().c_str(), false,
+                           fml::FilePermission::kRead),
+        false));
+  }
+  return asset_manager;
+}
+
+}  // namespace
+
+static void BM_AssetManagerGetAsMapping(benchmark::State& state, bool packed) {
+  const auto& names = TestBundle::Get().names();
+  auto asset_manager = CreateAssetManager(packed);
+  size_t index = 0;
+  while (state.KeepRunning()) {
+    auto mapping = asset_manager->GetAsMapping(names[index]);
+    FML_CHECK(mapping);
+    benchmark::DoNotOptimize(mapping->GetMapping()[0]);
+    index = (index + 1) % names.size();
+  }
+}
+
+BENCHMARK_CAPTURE(BM_AssetManagerGetAsMapping, Directory, false);
+BENCHMARK_CAPTURE(BM_AssetManagerGetAsMapping, Packed, true);
+
+static void BM_AssetManagerGetAsMappings(benchmark::State& state,
+                                         bool packed) {
+  auto asset_manager = CreateAssetManager(packed);
+  while (state.KeepRunning()) {
+    auto mappings = asset_manager->GetAsMappings(".*\\.json$", "dir42");
+    FML_CHECK(mappings.size() == kAssetCount / 100);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_AssetManagerGetAsMappings, Directory, false)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AssetManagerGetAsMappings, Packed, true)
+    ->Unit(benchmark::kMicrosecond);
+
+// The cost of opening the packed bundle at startup, which loads its index.
+static void BM_PackedAssetBundleOpen(benchmark::State& state) {
+  const auto& dir = TestBundle::Get().directory();
+  while (state.KeepRunning()) {
+    PackedAssetBundle bundle(dir.fd(), PackedAssetBundle::kFileName, false);
+    FML_CHECK(bundle.GetAssetCount() == kAssetCount);
+  }
+}
+
+BENCHMARK(BM_PackedAssetBundleOpen)->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
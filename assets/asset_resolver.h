@@ -26,7 +26,8 @@ class AssetResolver {
   enum AssetResolverType {
     kAssetManager,
     kApkAssetProvider,
-    kDirectoryAssetBundle
+    kDirectoryAssetBundle,
+    kPackedAssetBundle,
   };
 
   virtual bool IsValid() const = 0;
@@ -81,6 +82,29 @@ class AssetResolver {
     return {};
   };
 
+  //----------------------------------------------------------------------------
+  /// @brief      Hints that the given assets will be requested soon. Resolvers
+  ///             that read assets from storage may start reading them into
+  ///             memory so that the later calls to GetAsMapping() do not block
+  ///             on it. Names of assets this resolver does not have are
+  ///             ignored.
+  ///
+  ///             Giving the hint may itself touch storage, so this should be
+  ///             called on the IO thread.
+  ///
+  /// @param[in]  asset_names  The names of the assets to prefetch.
+  ///
+  virtual void Prefetch(const std::vector<std::string>& asset_names) const {}
+
+  //----------------------------------------------------------------------------
+  /// @brief      Same as Prefetch() but for all the assets directly in
+  ///             `subdir`, for example the images of a screen that is about
+  ///             to be shown.
+  ///
+  /// @param[in]  subdir  The subdirectory of the assets to prefetch.
+  ///
+  virtual void PrefetchSubdir(const std::string& subdir) const {}
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(AssetResolver);
 };
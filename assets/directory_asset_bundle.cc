@@ -110,4 +110,40 @@ std::vector<std::unique_ptr<fml::Mapping>> DirectoryAssetBundle::GetAsMappings(
   return mappings;
 }
 
+// |AssetResolver|
+void DirectoryAssetBundle::Prefetch(
+    const std::vector<std::string>& asset_names) const {
+  if (!is_valid_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "DirectoryAssetBundle::Prefetch");
+  for (const auto& asset_name : asset_names) {
+    fml::AdviseWillRead(fml::OpenFile(descriptor_, asset_name.c_str(), false,
+                                      fml::FilePermission::kRead),
+                        0, 0);
+  }
+}
+
+// |AssetResolver|
+void DirectoryAssetBundle::PrefetchSubdir(const std::string& subdir) const {
+  if (!is_valid_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "DirectoryAssetBundle::PrefetchSubdir");
+  fml::UniqueFD subdir_fd =
+      fml::OpenDirectoryReadOnly(descriptor_, subdir.c_str());
+  if (!subdir_fd.is_valid()) {
+    return;
+  }
+  fml::VisitFiles(subdir_fd, [](const fml::UniqueFD& directory,
+                                const std::string& filename) {
+    fml::UniqueFD fd = fml::OpenFile(directory, filename.c_str(), false,
+                                     fml::FilePermission::kRead);
+    if (!fml::IsDirectory(fd)) {
+      fml::AdviseWillRead(fd, 0, 0);
+    }
+    return true;
+  });
+}
+
 }  // namespace flutter
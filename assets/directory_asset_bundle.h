@@ -43,6 +43,12 @@ class DirectoryAssetBundle : public AssetResolver {
       const std::string& asset_pattern,
       const std::optional<std::string>& subdir) const override;
 
+  // |AssetResolver|
+  void Prefetch(const std::vector<std::string>& asset_names) const override;
+
+  // |AssetResolver|
+  void PrefetchSubdir(const std::string& subdir) const override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(DirectoryAssetBundle);
 };
 
@@ -0,0 +1,293 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <regex>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+struct BundleHeader {
+  static const uint32_t kSignature = 0x50414C46;
+  static const uint32_t kVersion1 = 1;
+
+  uint32_t signature = kSignature;
+  uint32_t version = kVersion1;
+  uint32_t asset_count = 0;
+  uint32_t names_size = 0;
+};
+
+// The names follow the index entries, and the contents follow the names.
+// Offsets are from the start of the file.
+struct IndexEntry {
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint64_t data_offset;
+  uint64_t data_size;
+};
+
+static_assert(sizeof(BundleHeader) == 16, "Packed bundle header changed.");
+static_assert(sizeof(IndexEntry) == 24, "Packed bundle index changed.");
+
+// Assets are aligned for consumers that read them in place, such as fonts.
+constexpr size_t kAssetAlignment = 16;
+
+size_t AlignAssetOffset(size_t offset) {
+  return (offset + kAssetAlignment - 1) & ~(kAssetAlignment - 1);
+}
+
+// Prefetched assets closer than this are read ahead together, since reading
+// the gap between them costs less than another request to storage.
+constexpr size_t kPrefetchCoalescingGap = 64 * 1024;
+
+}  // namespace
+
+PackedAssetBundle::PackedAssetBundle(const fml::UniqueFD& directory,
+                                     const char* file_name,
+                                     bool is_valid_after_asset_manager_change) {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::PackedAssetBundle");
+  auto file = fml::OpenFileReadOnly(directory, file_name);
+  if (!file.is_valid()) {
+    return;
+  }
+  mapping_ = std::make_shared<fml::FileMapping>(file);
+  if (mapping_->GetMapping() == nullptr) {
+    return;
+  }
+  file_ = std::move(file);
+  if (!ReadIndex()) {
+    FML_LOG(ERROR) << "Packed asset bundle " << file_name << " is corrupt.";
+    assets_.clear();
+    return;
+  }
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::ReadIndex() {
+  const uint8_t* base = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  if (size < sizeof(BundleHeader)) {
+    return false;
+  }
+  BundleHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (header.signature != BundleHeader::kSignature ||
+      header.version != BundleHeader::kVersion1 ||
+      (size - sizeof(BundleHeader)) / sizeof(IndexEntry) <
+          header.asset_count) {
+    return false;
+  }
+
+  assets_.reserve(header.asset_count);
+  const uint8_t* index = base + sizeof(BundleHeader);
+  for (uint32_t i = 0; i < header.asset_count; i++) {
+    IndexEntry entry;
+    memcpy(&entry, index + i * sizeof(IndexEntry), sizeof(entry));
+    if (entry.name_offset > size ||
+        size - entry.name_offset < entry.name_size ||
+        entry.data_offset > size ||
+        size - entry.data_offset < entry.data_size) {
+      return false;
+    }
+    std::string_view name(reinterpret_cast<const char*>(base) +
+                              entry.name_offset,
+                          entry.name_size);
+    assets_[name] = {base + entry.data_offset,
+                     static_cast<size_t>(entry.data_size)};
+  }
+  return true;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::MakeSlice(
+    const Asset& asset) const {
+  // The slice keeps the file mapped for as long as it is alive.
+  return std::make_unique<fml::NonOwnedMapping>(
+      asset.data, asset.size,
+      [mapping = mapping_](const uint8_t* data, size_t size) {});
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+  auto found = assets_.find(asset_name);
+  if (found == assets_.end()) {
+    return nullptr;
+  }
+  return MakeSlice(found->second);
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  // Like |DirectoryAssetBundle|, match the pattern against file names, and
+  // only search the files directly in `subdir` if there is one.
+  std::regex asset_regex(asset_pattern);
+  for (const auto& [name, asset] : assets_) {
+    const size_t separator = name.rfind('/');
+    const std::string_view directory =
+        separator == std::string_view::npos ? std::string_view()
+                                            : name.substr(0, separator);
+    const std::string_view file_name =
+        separator == std::string_view::npos ? name : name.substr(separator + 1);
+    if (subdir && directory != subdir.value()) {
+      continue;
+    }
+    if (std::regex_match(file_name.begin(), file_name.end(), asset_regex)) {
+      mappings.push_back(MakeSlice(asset));
+    }
+  }
+  return mappings;
+}
+
+void PackedAssetBundle::PrefetchAssets(
+    std::vector<const Asset*> assets) const {
+  // The assets of a directory are usually next to each other in the file, so
+  // sorting them by offset turns most hints into a few large reads.
+  std::sort(assets.begin(), assets.end(),
+            [](const Asset* a, const Asset* b) { return a->data < b->data; });
+  const uint8_t* base = mapping_->GetMapping();
+  size_t range_start = 0;
+  size_t range_end = 0;
+  for (const Asset* asset : assets) {
+    const size_t start = asset->data - base;
+    const size_t end = start + asset->size;
+    if (range_end != 0 && start <= range_end + kPrefetchCoalescingGap) {
+      range_end = std::max(range_end, end);
+      continue;
+    }
+    if (range_end != 0) {
+      fml::AdviseWillRead(file_, range_start, range_end - range_start);
+    }
+    range_start = start;
+    range_end = end;
+  }
+  if (range_end != 0) {
+    fml::AdviseWillRead(file_, range_start, range_end - range_start);
+  }
+}
+
+// |AssetResolver|
+void PackedAssetBundle::Prefetch(
+    const std::vector<std::string>& asset_names) const {
+  if (!is_valid_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "PackedAssetBundle::Prefetch");
+  std::vector<const Asset*> assets;
+  for (const auto& asset_name : asset_names) {
+    auto found = assets_.find(asset_name);
+    if (found != assets_.end() && found->second.size > 0) {
+      assets.push_back(&found->second);
+    }
+  }
+  PrefetchAssets(std::move(assets));
+}
+
+// |AssetResolver|
+void PackedAssetBundle::PrefetchSubdir(const std::string& subdir) const {
+  if (!is_valid_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "PackedAssetBundle::PrefetchSubdir");
+  std::vector<const Asset*> assets;
+  for (const auto& [name, asset] : assets_) {
+    const size_t separator = name.rfind('/');
+    if (separator != std::string_view::npos &&
+        name.substr(0, separator) == subdir && asset.size > 0) {
+      assets.push_back(&asset);
+    }
+  }
+  PrefetchAssets(std::move(assets));
+}
+
+bool PackedAssetBundle::Write(
+    const fml::UniqueFD& directory,
+    const char* file_name,
+    const std::vector<std::pair<std::string, std::unique_ptr<fml::Mapping>>>&
+        assets) {
+  // The count and the name offsets are stored in 32 bits.
+  size_t names_size = 0;
+  for (const auto& asset : assets) {
+    names_size += asset.first.size();
+  }
+  const size_t names_offset =
+      sizeof(BundleHeader) + assets.size() * sizeof(IndexEntry);
+  if (assets.size() > std::numeric_limits<uint32_t>::max() ||
+      names_offset + names_size > std::numeric_limits<uint32_t>::max()) {
+    FML_LOG(ERROR) << "Too many assets to pack into " << file_name << ".";
+    return false;
+  }
+
+  BundleHeader header;
+  header.asset_count = static_cast<uint32_t>(assets.size());
+  header.names_size = static_cast<uint32_t>(names_size);
+  size_t size = names_offset + header.names_size;
+  for (const auto& asset : assets) {
+    size = AlignAssetOffset(size) + asset.second->GetSize();
+  }
+
+  std::vector<uint8_t> buffer(size);
+  memcpy(buffer.data(), &header, sizeof(header));
+  size_t name_offset = names_offset;
+  size_t data_offset = names_offset + header.names_size;
+  for (size_t i = 0; i < assets.size(); i++) {
+    const std::string& name = assets[i].first;
+    const fml::Mapping& data = *assets[i].second;
+    data_offset = AlignAssetOffset(data_offset);
+    IndexEntry entry = {static_cast<uint32_t>(name_offset),
+                        static_cast<uint32_t>(name.size()), data_offset,
+                        data.GetSize()};
+    memcpy(buffer.data() + sizeof(BundleHeader) + i * sizeof(IndexEntry),
+           &entry, sizeof(entry));
+    memcpy(buffer.data() + name_offset, name.data(), name.size());
+    if (data.GetSize() > 0) {
+      memcpy(buffer.data() + data_offset, data.GetMapping(), data.GetSize());
+    }
+    name_offset += name.size();
+    data_offset += data.GetSize();
+  }
+
+  return fml::WriteAtomically(directory, file_name,
+                              fml::DataMapping(std::move(buffer)));
+}
+
+}  // namespace flutter
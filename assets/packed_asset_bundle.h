@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver serving all the assets of a bundle from a
+///             single file.
+///
+///             The file starts with an index of the name, offset and size of
+///             every asset, followed by the names and then by the contents of
+///             the assets. It is mapped once when the bundle is created and
+///             the index is loaded into a hash table, so looking an asset up
+///             costs no system call, and the returned mappings are slices of
+///             the file mapping rather than copies.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  /// The name of the packed bundle in the assets directory.
+  static constexpr char kFileName[] = "flutter_assets.pack";
+
+  //----------------------------------------------------------------------------
+  /// @brief      Maps the packed bundle `file_name` in `directory`. The bundle
+  ///             is invalid if the file does not exist or is corrupt.
+  ///
+  PackedAssetBundle(const fml::UniqueFD& directory,
+                    const char* file_name,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the `assets` to a packed bundle `file_name` in
+  ///             `directory`, in the format read by this class.
+  ///
+  /// @param[in]  assets  The name and contents of each asset. Names are
+  ///                     paths relative to the root of the bundle.
+  ///
+  /// @return     Whether the bundle was written. It is not if the index
+  ///             does not fit the 32-bit counts and name offsets of the
+  ///             format.
+  ///
+  static bool Write(
+      const fml::UniqueFD& directory,
+      const char* file_name,
+      const std::vector<std::pair<std::string, std::unique_ptr<fml::Mapping>>>&
+          assets);
+
+  /// The number of assets in the bundle.
+  size_t GetAssetCount() const { return assets_.size(); }
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+  // |AssetResolver|
+  void Prefetch(const std::vector<std::string>& asset_names) const override;
+
+  // |AssetResolver|
+  void PrefetchSubdir(const std::string& subdir) const override;
+
+ private:
+  struct Asset {
+    const uint8_t* data;
+    size_t size;
+  };
+
+  // Kept open to give read-ahead hints for prefetched assets.
+  fml::UniqueFD file_;
+  // Shared with the mappings handed out, which may outlive the bundle.
+  std::shared_ptr<fml::FileMapping> mapping_;
+  // Keys point into |mapping_|.
+  std::unordered_map<std::string_view, Asset> assets_;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  bool ReadIndex();
+
+  std::unique_ptr<fml::Mapping> MakeSlice(const Asset& asset) const;
+
+  void PrefetchAssets(std::vector<const Asset*> assets) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
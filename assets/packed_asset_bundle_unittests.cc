@@ -0,0 +1,156 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+using Assets =
+    std::vector<std::pair<std::string, std::unique_ptr<fml::Mapping>>>;
+
+static std::unique_ptr<fml::Mapping> MakeData(const std::string& contents) {
+  return std::make_unique<fml::DataMapping>(contents);
+}
+
+static std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+static Assets MakeTestAssets() {
+  Assets assets;
+  assets.emplace_back("AssetManifest.json", MakeData("{}"));
+  assets.emplace_back("fonts/Roboto.ttf", MakeData("roboto"));
+  assets.emplace_back("shaders/a.skp", MakeData("a"));
+  assets.emplace_back("shaders/b.skp", MakeData("bb"));
+  assets.emplace_back("shaders/nested/c.skp", MakeData("ccc"));
+  assets.emplace_back("empty", MakeData(""));
+  return assets;
+}
+
+TEST(PackedAssetBundleTest, IsInvalidWithoutAPackedFile) {
+  fml::ScopedTemporaryDirectory dir;
+  PackedAssetBundle missing(dir.fd(), PackedAssetBundle::kFileName, true);
+  EXPECT_FALSE(missing.IsValid());
+
+  fml::DataMapping garbage(std::string("not a bundle"));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), PackedAssetBundle::kFileName,
+                                   garbage));
+  PackedAssetBundle corrupt(dir.fd(), PackedAssetBundle::kFileName, true);
+  EXPECT_FALSE(corrupt.IsValid());
+}
+
+TEST(PackedAssetBundleTest, ServesAssetsFromTheMapping) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(PackedAssetBundle::Write(dir.fd(), PackedAssetBundle::kFileName,
+                                       MakeTestAssets()));
+
+  auto bundle = std::make_unique<PackedAssetBundle>(
+      dir.fd(), PackedAssetBundle::kFileName, true);
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_TRUE(bundle->IsValidAfterAssetManagerChange());
+  EXPECT_EQ(bundle->GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+  EXPECT_EQ(bundle->GetAssetCount(), 6u);
+
+  auto font = bundle->GetAsMapping("fonts/Roboto.ttf");
+  ASSERT_NE(font, nullptr);
+  EXPECT_EQ(ToString(*font), "roboto");
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(font->GetMapping()) % 16, 0u);
+
+  auto empty = bundle->GetAsMapping("empty");
+  ASSERT_NE(empty, nullptr);
+  EXPECT_EQ(empty->GetSize(), 0u);
+
+  EXPECT_EQ(bundle->GetAsMapping("fonts/Missing.ttf"), nullptr);
+  EXPECT_EQ(bundle->GetAsMapping("Roboto.ttf"), nullptr);
+
+  // Mappings keep the file mapped after the bundle is gone.
+  bundle.reset();
+  EXPECT_EQ(ToString(*font), "roboto");
+}
+
+TEST(PackedAssetBundleTest, GetAsMappingsMatchesFileNames) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(PackedAssetBundle::Write(dir.fd(), PackedAssetBundle::kFileName,
+                                       MakeTestAssets()));
+  PackedAssetBundle bundle(dir.fd(), PackedAssetBundle::kFileName, true);
+  ASSERT_TRUE(bundle.IsValid());
+
+  auto contents = [](std::vector<std::unique_ptr<fml::Mapping>> mappings) {
+    std::vector<std::string> result;
+    for (const auto& mapping : mappings) {
+      result.push_back(ToString(*mapping));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+
+  // Without a subdirectory, the whole bundle is searched.
+  EXPECT_EQ(contents(bundle.GetAsMappings(".*\\.skp$", std::nullopt)),
+            (std::vector<std::string>{"a", "bb", "ccc"}));
+  // With one, only the files directly in it are.
+  EXPECT_EQ(contents(bundle.GetAsMappings(".*\\.skp$", "shaders")),
+            (std::vector<std::string>{"a", "bb"}));
+  EXPECT_TRUE(bundle.GetAsMappings(".*\\.ttf$", "shaders").empty());
+}
+
+TEST(PackedAssetBundleTest, DirectoryServesAssetsMissingFromTheBundle) {
+  fml::ScopedTemporaryDirectory dir;
+  Assets packed;
+  packed.emplace_back("packed.txt", MakeData("packed"));
+  ASSERT_TRUE(
+      PackedAssetBundle::Write(dir.fd(), PackedAssetBundle::kFileName, packed));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "loose.txt",
+                                   fml::DataMapping(std::string("loose"))));
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(std::make_unique<PackedAssetBundle>(
+      dir.fd(), PackedAssetBundle::kFileName, true));
+  asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+      fml::OpenDirectory(dir.path().c_str(), false, fml::FilePermission::kRead),
+      true));
+
+  EXPECT_EQ(ToString(*asset_manager.GetAsMapping("packed.txt")), "packed");
+  EXPECT_EQ(ToString(*asset_manager.GetAsMapping("loose.txt")), "loose");
+}
+
+TEST(PackedAssetBundleTest, IsDroppedWhenTheDirectoryIsReplaced) {
+  fml::ScopedTemporaryDirectory dir;
+  Assets packed;
+  packed.emplace_back("asset.txt", MakeData("packed"));
+  ASSERT_TRUE(
+      PackedAssetBundle::Write(dir.fd(), PackedAssetBundle::kFileName, packed));
+  fml::ScopedTemporaryDirectory updated_dir;
+  ASSERT_TRUE(fml::WriteAtomically(updated_dir.fd(), "asset.txt",
+                                   fml::DataMapping(std::string("updated"))));
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(std::make_unique<PackedAssetBundle>(
+      dir.fd(), PackedAssetBundle::kFileName, false));
+  asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+      fml::OpenDirectory(dir.path().c_str(), false, fml::FilePermission::kRead),
+      true));
+  EXPECT_EQ(ToString(*asset_manager.GetAsMapping("asset.txt")), "packed");
+
+  asset_manager.UpdateResolverByType(
+      std::make_unique<DirectoryAssetBundle>(
+          fml::OpenDirectory(updated_dir.path().c_str(), false,
+                             fml::FilePermission::kRead),
+          true),
+      AssetResolver::AssetResolverType::kDirectoryAssetBundle);
+  EXPECT_EQ(ToString(*asset_manager.GetAsMapping("asset.txt")), "updated");
+  EXPECT_EQ(asset_manager.TakeResolvers().size(), 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,414 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/packed_cache_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "openssl/sha.h"
+
+namespace flutter {
+
+namespace {
+
+struct FileHeader {
+  static const uint32_t kSignature = 0x4B504346;
+  static const uint32_t kVersion1 = 1;
+
+  uint32_t signature = kSignature;
+  uint32_t version = kVersion1;
+  uint32_t index_count = 0;
+  uint32_t reserved = 0;
+  // The offset of the first record that is not in the index.
+  uint64_t appended_offset = sizeof(FileHeader);
+};
+
+struct IndexEntry {
+  uint64_t key_hash;
+  uint64_t offset;
+};
+
+// Each record is this header followed by the key and the value, padded so
+// that the next record is 8 byte aligned.
+struct RecordHeader {
+  static const uint32_t kSignature = 0x52504346;
+
+  uint32_t signature = kSignature;
+  uint32_t key_size;
+  uint32_t value_size;
+  // A checksum of the key and value, to detect records that were only
+  // partially written when the process or the device went down.
+  uint32_t checksum;
+  uint64_t key_hash;
+};
+
+static_assert(sizeof(FileHeader) == 24, "Packed cache header layout changed.");
+static_assert(sizeof(RecordHeader) == 24, "Packed cache record changed.");
+
+constexpr size_t kRecordAlignment = 8;
+
+size_t AlignRecordOffset(size_t offset) {
+  return (offset + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+size_t GetRecordSize(size_t key_size, size_t value_size) {
+  return AlignRecordOffset(sizeof(RecordHeader) + key_size + value_size);
+}
+
+// The first 64 bits of the SHA-1 of the key, which also names the per-entry
+// files of older caches.
+uint64_t HashKey(const void* key, size_t size) {
+  uint8_t digest[SHA_DIGEST_LENGTH];
+  SHA1(static_cast<const uint8_t*>(key), size, digest);
+  uint64_t hash;
+  memcpy(&hash, digest, sizeof(hash));
+  return hash;
+}
+
+// FNV-1a, which is only used to detect torn writes.
+uint32_t Checksum(const uint8_t* key,
+                  size_t key_size,
+                  const uint8_t* value,
+                  size_t value_size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < key_size; i++) {
+    hash = (hash ^ key[i]) * 16777619u;
+  }
+  for (size_t i = 0; i < value_size; i++) {
+    hash = (hash ^ value[i]) * 16777619u;
+  }
+  return hash;
+}
+
+void WriteRecord(uint8_t* destination,
+                 uint64_t key_hash,
+                 const uint8_t* key,
+                 size_t key_size,
+                 const uint8_t* value,
+                 size_t value_size) {
+  RecordHeader header;
+  header.key_size = key_size;
+  header.value_size = value_size;
+  header.checksum = Checksum(key, key_size, value, value_size);
+  header.key_hash = key_hash;
+  memcpy(destination, &header, sizeof(header));
+  destination += sizeof(header);
+  memcpy(destination, key, key_size);
+  destination += key_size;
+  memcpy(destination, value, value_size);
+  destination += value_size;
+  memset(destination, 0,
+         GetRecordSize(key_size, value_size) - sizeof(header) - key_size -
+             value_size);
+}
+
+constexpr char kLockFileName[] = "io.flutter.packed_cache.lock";
+
+// Serializes appending to and compacting the packed file. The mutex orders the
+// threads of this process, whose engines may use different workers, and the
+// lock on a file next to the packed file orders the processes that share the
+// cache directory. The packed file itself is not locked, as compacting
+// replaces it.
+class PackedFileLock {
+ public:
+  explicit PackedFileLock(const fml::UniqueFD& directory)
+      : mutex_lock_(GetMutex()),
+        file_(fml::OpenFile(directory,
+                            kLockFileName,
+                            true,
+                            fml::FilePermission::kReadWrite)),
+        locked_(fml::AcquireFileLock(file_)) {}
+
+  ~PackedFileLock() {
+    if (locked_) {
+      fml::ReleaseFileLock(file_);
+    }
+  }
+
+  bool is_locked() const { return locked_; }
+
+ private:
+  static std::mutex& GetMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  std::scoped_lock<std::mutex> mutex_lock_;
+  fml::UniqueFD file_;
+  const bool locked_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedFileLock);
+};
+
+}  // namespace
+
+PackedCacheFile::PackedCacheFile(std::unique_ptr<fml::FileMapping> mapping)
+    : mapping_(std::move(mapping)) {}
+
+PackedCacheFile::~PackedCacheFile() = default;
+
+std::unique_ptr<PackedCacheFile> PackedCacheFile::Open(
+    const fml::UniqueFD& directory) {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Open");
+  auto file = fml::OpenFileReadOnly(directory, kFileName);
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  auto mapping = std::make_unique<fml::FileMapping>(file);
+  if (mapping->GetMapping() == nullptr) {
+    return nullptr;
+  }
+  std::unique_ptr<PackedCacheFile> packed_file(
+      new PackedCacheFile(std::move(mapping)));
+  if (!packed_file->ReadRecords()) {
+    FML_LOG(INFO) << "Packed persistent cache header is corrupt.";
+    return nullptr;
+  }
+  return packed_file;
+}
+
+bool PackedCacheFile::ReadRecords() {
+  const uint8_t* base = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  if (size < sizeof(FileHeader)) {
+    return false;
+  }
+  FileHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (header.signature != FileHeader::kSignature ||
+      header.version != FileHeader::kVersion1 ||
+      header.appended_offset > size ||
+      (size - sizeof(FileHeader)) / sizeof(IndexEntry) < header.index_count) {
+    return false;
+  }
+
+  // Returns the record at `offset`, or an empty record if it does not fit in
+  // the file.
+  auto read_record = [base, size](size_t offset, RecordHeader* record_header) {
+    Record record = {};
+    if (offset % kRecordAlignment != 0 || offset > size ||
+        size - offset < sizeof(RecordHeader)) {
+      return record;
+    }
+    memcpy(record_header, base + offset, sizeof(RecordHeader));
+    if (record_header->signature != RecordHeader::kSignature ||
+        size - offset - sizeof(RecordHeader) <
+            static_cast<uint64_t>(record_header->key_size) +
+                record_header->value_size) {
+      return record;
+    }
+    record.key = base + offset + sizeof(RecordHeader);
+    record.key_size = record_header->key_size;
+    record.value = record.key + record.key_size;
+    record.value_size = record_header->value_size;
+    return record;
+  };
+
+  // Records in the index were written atomically by |Compact|, so they are
+  // not checksummed again here. This keeps opening the file independent of
+  // the size of the values.
+  records_.reserve(header.index_count);
+  const uint8_t* index = base + sizeof(FileHeader);
+  for (uint32_t i = 0; i < header.index_count; i++) {
+    IndexEntry entry;
+    memcpy(&entry, index + i * sizeof(IndexEntry), sizeof(entry));
+    RecordHeader record_header;
+    Record record = read_record(entry.offset, &record_header);
+    if (record.key == nullptr || record_header.key_hash != entry.key_hash) {
+      return false;
+    }
+    // |Compact| writes the index in first use order.
+    record.sequence = i;
+    records_[entry.key_hash] = record;
+  }
+  indexed_count_ = records_.size();
+
+  size_t offset = header.appended_offset;
+  while (offset < size) {
+    RecordHeader record_header;
+    Record record = read_record(offset, &record_header);
+    if (record.key == nullptr ||
+        record_header.checksum != Checksum(record.key, record.key_size,
+                                           record.value, record.value_size)) {
+      // The append of this record was cut short, and later runs appended
+      // their records after it. Resynchronize on the next record header
+      // whose checksum matches.
+      has_torn_records_ = true;
+      offset += kRecordAlignment;
+      continue;
+    }
+    record.sequence = indexed_count_ + appended_count_;
+    auto inserted = records_.insert({record_header.key_hash, record});
+    if (!inserted.second) {
+      // The key keeps its place in the order in which keys were first used.
+      record.sequence = inserted.first->second.sequence;
+      inserted.first->second = record;
+      superseded_count_++;
+    }
+    appended_count_++;
+    offset += GetRecordSize(record.key_size, record.value_size);
+  }
+  return true;
+}
+
+const PackedCacheFile::Record* PackedCacheFile::FindRecord(
+    const SkData& key) const {
+  auto found = records_.find(HashKey(key.data(), key.size()));
+  if (found == records_.end()) {
+    return nullptr;
+  }
+  const Record& record = found->second;
+  if (record.key_size != key.size() ||
+      memcmp(record.key, key.data(), key.size()) != 0) {
+    return nullptr;
+  }
+  return &record;
+}
+
+sk_sp<SkData> PackedCacheFile::Find(const SkData& key) const {
+  const Record* record = FindRecord(key);
+  if (record == nullptr) {
+    return nullptr;
+  }
+  return SkData::MakeWithCopy(record->value, record->value_size);
+}
+
+bool PackedCacheFile::Contains(const SkData& key) const {
+  return FindRecord(key) != nullptr;
+}
+
+std::vector<std::pair<uint64_t, const PackedCacheFile::Record*>>
+PackedCacheFile::GetRecordsInFirstUseOrder() const {
+  std::vector<std::pair<uint64_t, const Record*>> records;
+  records.reserve(records_.size());
+  for (const auto& entry : records_) {
+    records.emplace_back(entry.first, &entry.second);
+  }
+  std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) {
+    return a.second->sequence < b.second->sequence;
+  });
+  return records;
+}
+
+void PackedCacheFile::ForEach(
+    const std::function<void(sk_sp<SkData> key, sk_sp<SkData> value)>& visitor)
+    const {
+  for (const auto& entry : GetRecordsInFirstUseOrder()) {
+    const Record& record = *entry.second;
+    visitor(SkData::MakeWithCopy(record.key, record.key_size),
+            SkData::MakeWithCopy(record.value, record.value_size));
+  }
+}
+
+bool PackedCacheFile::NeedsCompaction() const {
+  // Appended records are cheap to read until there are as many of them as
+  // there are indexed ones.
+  return has_torn_records_ || superseded_count_ > 0 ||
+         appended_count_ > std::max<size_t>(indexed_count_, 16);
+}
+
+bool PackedCacheFile::Append(const fml::UniqueFD& directory,
+                             const SkData& key,
+                             const SkData& value) {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Append");
+  PackedFileLock lock(directory);
+  if (!lock.is_locked()) {
+    return false;
+  }
+
+  auto file = fml::OpenFile(directory, kFileName, false,
+                            fml::FilePermission::kReadWrite);
+  size_t offset = 0;
+  if (file.is_valid()) {
+    fml::FileMapping existing(file);
+    if (existing.GetSize() >= sizeof(FileHeader)) {
+      FileHeader header;
+      memcpy(&header, existing.GetMapping(), sizeof(header));
+      if (header.signature == FileHeader::kSignature &&
+          header.version == FileHeader::kVersion1) {
+        offset = AlignRecordOffset(existing.GetSize());
+      }
+    }
+  }
+
+  const uint64_t key_hash = HashKey(key.data(), key.size());
+  const size_t record_size = GetRecordSize(key.size(), value.size());
+  if (offset == 0) {
+    // There is no file or it is not a packed cache. A new one replaces it
+    // rather than truncating it, as other processes may have it mapped.
+    std::vector<uint8_t> buffer(sizeof(FileHeader) + record_size);
+    FileHeader header;
+    memcpy(buffer.data(), &header, sizeof(header));
+    WriteRecord(buffer.data() + sizeof(FileHeader), key_hash, key.bytes(),
+                key.size(), value.bytes(), value.size());
+    return fml::WriteAtomically(directory, kFileName,
+                                fml::DataMapping(std::move(buffer)));
+  }
+
+  // The file only ever grows while it is in place, so the mappings of the
+  // readers stay valid.
+  if (!fml::TruncateFile(file, offset + record_size)) {
+    return false;
+  }
+  fml::FileMapping mapping(file, {fml::FileMapping::Protection::kRead,
+                                  fml::FileMapping::Protection::kWrite});
+  uint8_t* destination = mapping.GetMutableMapping();
+  if (destination == nullptr) {
+    return false;
+  }
+  WriteRecord(destination + offset, key_hash, key.bytes(), key.size(),
+              value.bytes(), value.size());
+  return true;
+}
+
+bool PackedCacheFile::Compact(const fml::UniqueFD& directory) {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Compact");
+  // Records appended while the file is rewritten would be lost when it is
+  // replaced.
+  PackedFileLock lock(directory);
+  if (!lock.is_locked()) {
+    return false;
+  }
+  auto packed_file = Open(directory);
+  if (!packed_file) {
+    return false;
+  }
+
+  const auto records = packed_file->GetRecordsInFirstUseOrder();
+  size_t records_size = 0;
+  for (const auto& entry : records) {
+    records_size +=
+        GetRecordSize(entry.second->key_size, entry.second->value_size);
+  }
+
+  FileHeader header;
+  header.index_count = records.size();
+  const size_t index_end = AlignRecordOffset(
+      sizeof(FileHeader) + records.size() * sizeof(IndexEntry));
+  header.appended_offset = index_end + records_size;
+
+  std::vector<uint8_t> buffer(header.appended_offset);
+  memcpy(buffer.data(), &header, sizeof(header));
+  size_t offset = index_end;
+  for (size_t i = 0; i < records.size(); i++) {
+    const Record& record = *records[i].second;
+    IndexEntry entry = {records[i].first, offset};
+    memcpy(buffer.data() + sizeof(FileHeader) + i * sizeof(IndexEntry), &entry,
+           sizeof(entry));
+    WriteRecord(buffer.data() + offset, records[i].first, record.key,
+                record.key_size, record.value, record.value_size);
+    offset += GetRecordSize(record.key_size, record.value_size);
+  }
+
+  return fml::WriteAtomically(directory, kFileName,
+                              fml::DataMapping(std::move(buffer)));
+}
+
+}  // namespace flutter
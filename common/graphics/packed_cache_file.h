@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_PACKED_CACHE_FILE_H_
+#define FLUTTER_COMMON_GRAPHICS_PACKED_CACHE_FILE_H_
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// A single file holding all the entries of a persistent cache directory.
+///
+/// The file starts with an index of the key hashes and offsets of the records
+/// that follow it. New records are appended after the last one without
+/// touching the index, and are found by scanning the tail of the file when it
+/// is opened. A record that was only partially written is skipped, and the
+/// scan resumes at the next valid record after it. Compacting the file folds
+/// the appended records into the index and drops the ones that were
+/// superseded by later records with the same key, or partially written.
+///
+/// Opening the file maps it once and builds a hash table from the index, so a
+/// lookup costs a hash of the key instead of opening and reading a file per
+/// entry. Instances are immutable and may be used from any thread. Appending
+/// and compacting may also be called from any thread: they take a lock that
+/// serializes them between the threads of the process, and between the
+/// processes that share the directory. The file is never shrunk in place, so
+/// the mappings of opened instances stay valid.
+class PackedCacheFile {
+ public:
+  static constexpr char kFileName[] = "io.flutter.packed_cache";
+
+  /// Maps the packed cache file in `directory` and indexes its records.
+  ///
+  /// @return     The opened file, or nullptr if there is no valid file.
+  static std::unique_ptr<PackedCacheFile> Open(const fml::UniqueFD& directory);
+
+  /// Appends a record for `key` to the packed cache file in `directory`,
+  /// creating the file if needed. A record with the same key that is already
+  /// in the file is superseded.
+  static bool Append(const fml::UniqueFD& directory,
+                     const SkData& key,
+                     const SkData& value);
+
+  /// Rewrites the packed cache file in `directory` with every live record in
+  /// its index, dropping superseded and partially written records. The file
+  /// is read back from its mapping rather than from any copy in memory.
+  static bool Compact(const fml::UniqueFD& directory);
+
+  ~PackedCacheFile();
+
+  /// @return     A copy of the value stored for `key`, or nullptr if there is
+  ///             none.
+  sk_sp<SkData> Find(const SkData& key) const;
+
+  /// @return     Whether a value is stored for `key`.
+  bool Contains(const SkData& key) const;
+
+  /// Calls `visitor` with a copy of the key and value of every live record,
+  /// in the order in which their keys were first written. Since entries are
+  /// appended as they are first needed, this is the order in which a run
+  /// used them.
+  void ForEach(
+      const std::function<void(sk_sp<SkData> key, sk_sp<SkData> value)>&
+          visitor) const;
+
+  /// The number of live records, one per key.
+  size_t GetEntryCount() const { return records_.size(); }
+
+  /// Whether appended, superseded or partially written records make it worth
+  /// rewriting the file with `Compact`.
+  bool NeedsCompaction() const;
+
+ private:
+  struct Record {
+    const uint8_t* key;
+    uint32_t key_size;
+    const uint8_t* value;
+    uint32_t value_size;
+    // The position of the first record written for the key among the records
+    // of the file. A record that supersedes another one keeps its sequence.
+    size_t sequence;
+  };
+
+  std::unique_ptr<fml::FileMapping> mapping_;
+  // Indexed by a 64 bit hash of the key. Keys are compared as well on lookup,
+  // so a collision is a cache miss rather than a wrong shader.
+  std::unordered_map<uint64_t, Record> records_;
+  size_t indexed_count_ = 0;
+  size_t appended_count_ = 0;
+  size_t superseded_count_ = 0;
+  bool has_torn_records_ = false;
+
+  explicit PackedCacheFile(std::unique_ptr<fml::FileMapping> mapping);
+
+  bool ReadRecords();
+
+  const Record* FindRecord(const SkData& key) const;
+
+  // Sorts the records by their sequence. Compaction writes the records in
+  // this order, so it is kept across compactions without being stored.
+  std::vector<std::pair<uint64_t, const Record*>> GetRecordsInFirstUseOrder()
+      const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedCacheFile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_PACKED_CACHE_FILE_H_
@@ -4,17 +4,24 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <future>
 #include <memory>
 #include <string>
 #include <string_view>
 
+#include "flutter/common/graphics/packed_cache_file.h"
+#include "flutter/common/startup_timeline.h"
 #include "flutter/fml/base32.h"
+#include "flutter/fml/closure.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/hex_codec.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/parallel_for.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/version/version.h"
@@ -25,6 +32,30 @@
 
 namespace flutter {
 
+namespace {
+
+// Entries stored one per file are named by |SkKeyToFilePath|.
+bool IsEntryFileName(const std::string& file_name) {
+  return file_name.size() == 2 * SHA_DIGEST_LENGTH &&
+         std::all_of(file_name.begin(), file_name.end(), [](char c) {
+           return std::isxdigit(static_cast<unsigned char>(c));
+         });
+}
+
+std::vector<std::string> GetEntryFileNames(const fml::UniqueFD& directory) {
+  std::vector<std::string> file_names;
+  fml::VisitFiles(directory, [&file_names](const fml::UniqueFD& directory,
+                                           const std::string& filename) {
+    if (IsEntryFileName(filename)) {
+      file_names.push_back(filename);
+    }
+    return true;
+  });
+  return file_names;
+}
+
+}  // namespace
+
 std::string PersistentCache::cache_base_path_;
 
 std::shared_ptr<AssetManager> PersistentCache::asset_manager_;
@@ -67,6 +98,37 @@ PersistentCache* PersistentCache::GetCacheForProcess() {
   return gPersistentCache.get();
 }
 
+void PersistentCache::PrewarmCacheForProcess() {
+  TRACE_EVENT0("flutter", "PersistentCache::PrewarmCacheForProcess");
+  std::shared_ptr<fml::UniqueFD> cache_directory;
+  {
+    std::scoped_lock lock(instance_mutex_);
+    if (gPersistentCache == nullptr) {
+      gPersistentCache.reset(new PersistentCache(gIsReadOnly));
+    }
+    if (!gPersistentCache->IsValid()) {
+      return;
+    }
+    cache_directory = gPersistentCache->cache_directory_;
+  }
+
+  // The files are read without holding a lock, so that neither
+  // |GetCacheForProcess| nor the first |load| waits for them.
+  auto packed_cache = PackedCacheFile::Open(*cache_directory);
+  const bool has_entry_files = !GetEntryFileNames(*cache_directory).empty();
+
+  std::scoped_lock lock(instance_mutex_);
+  // The cache may have been reset meanwhile, or opened by a |load|.
+  if (gPersistentCache == nullptr ||
+      gPersistentCache->cache_directory_ != cache_directory) {
+    return;
+  }
+  std::scoped_lock packed_cache_lock(gPersistentCache->packed_cache_mutex_);
+  if (!gPersistentCache->packed_cache_opened_) {
+    gPersistentCache->SetPackedCache(std::move(packed_cache), has_entry_files);
+  }
+}
+
 void PersistentCache::ResetCacheForProcess() {
   std::scoped_lock lock(instance_mutex_);
   gPersistentCache.reset(new PersistentCache(gIsReadOnly));
@@ -102,7 +164,14 @@ bool PersistentCache::Purge() {
       removed.set_value(false);
     }
   });
-  return removed.get_future().get();
+  bool result = removed.get_future().get();
+
+  std::scoped_lock lock(packed_cache_mutex_);
+  packed_cache_.reset();
+  packed_cache_opened_ = false;
+  stored_entries_.clear();
+  has_entry_files_ = false;
+  return result;
 }
 
 namespace {
@@ -191,42 +260,57 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
 }
 
 size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
+  StartupTimeline::ScopedPhase phase(StartupTimeline::kPersistentCacheLoad);
   auto known_sksls = LoadSkSLs();
   // A trace must be present even if no precompilations have been completed.
   FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs", "count",
                   known_sksls.size());
 
+  precompiled_sksl_count_ = 0;
+  succeeded_sksl_count_ = 0;
+  known_sksl_count_ = context == nullptr ? 0 : known_sksls.size();
   if (context == nullptr) {
     return 0;
   }
 
+  // Skia contexts are not thread safe and each one has its own program
+  // cache, so the shaders have to be compiled in the rendering context on
+  // this thread. What can be done elsewhere, reading and decoding them, was
+  // done by |LoadSkSLs| on the concurrent workers.
   size_t precompiled_count = 0;
-  for (const auto& sksl : known_sksls) {
+  for (size_t i = 0; i < known_sksls.size(); i++) {
     TRACE_EVENT0("flutter", "PrecompilingSkSL");
-    if (context->precompileShader(*sksl.key, *sksl.value)) {
+    if (context->precompileShader(*known_sksls[i].key,
+                                  *known_sksls[i].value)) {
       precompiled_count++;
+      succeeded_sksl_count_ = precompiled_count;
     }
+    precompiled_sksl_count_ = i + 1;
+    FML_TRACE_COUNTER("flutter", "PersistentCache::PrecompiledSkSLs",
+                      reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                      "Successful", precompiled_count,  //
+                      "Remaining", known_sksls.size() - i - 1);
   }
 
   FML_TRACE_COUNTER("flutter", "PersistentCache::PrecompiledSkSLs",
                     reinterpret_cast<int64_t>(this),  // Trace Counter ID
-                    "Successful", precompiled_count);
+                    "Successful", precompiled_count, "Remaining", 0);
   return precompiled_count;
 }
 
+PersistentCache::SkSLPrecompilationProgress
+PersistentCache::GetSkSLPrecompilationProgress() const {
+  SkSLPrecompilationProgress progress;
+  progress.compiled = precompiled_sksl_count_;
+  progress.succeeded = succeeded_sksl_count_;
+  progress.total = known_sksl_count_;
+  return progress;
+}
+
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
-  fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
-                                       const std::string& filename) {
-    SkSLCache cache = LoadFile(directory, filename, true);
-    if (cache.key != nullptr && cache.value != nullptr) {
-      result.push_back(cache);
-    } else {
-      FML_LOG(ERROR) << "Failed to load: " << filename;
-    }
-    return true;
-  };
+  auto worker = GetConcurrentTaskRunner();
 
   // Only visit sksl_cache_directory_ if this persistent cache is valid.
   // However, we'd like to continue visit the asset dir even if this persistent
@@ -237,7 +321,31 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
     fml::UniqueFD fresh_dir =
         fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
     if (fresh_dir.is_valid()) {
-      fml::VisitFiles(fresh_dir, visitor);
+      // The packed file holds everything stored by this engine version, in
+      // the order it was first used. Files with a single entry are still read
+      // for caches written by older versions or shipped pregenerated, until
+      // they are moved into the packed file.
+      auto packed_file = PackedCacheFile::Open(fresh_dir);
+      if (packed_file) {
+        packed_file->ForEach([&result](sk_sp<SkData> key, sk_sp<SkData> value) {
+          result.push_back({std::move(key), std::move(value)});
+        });
+      }
+
+      std::vector<std::string> file_names = GetEntryFileNames(fresh_dir);
+      std::vector<SkSLCache> files(file_names.size());
+      fml::ParallelFor(file_names.size(), worker, [&](size_t i) {
+        files[i] = LoadFile(fresh_dir, file_names[i], true);
+      });
+      for (size_t i = 0; i < files.size(); i++) {
+        if (files[i].key == nullptr || files[i].value == nullptr) {
+          FML_LOG(ERROR) << "Failed to load: " << file_names[i];
+        } else if (!packed_file || !packed_file->Contains(*files[i].key)) {
+          result.push_back(std::move(files[i]));
+        }
+      }
+      MaintainPackedCache(packed_file.get(), !file_names.empty(),
+                          sksl_cache_directory_);
     }
   }
 
@@ -256,13 +364,22 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
     if (parse_result.IsError()) {
       FML_LOG(ERROR) << "Failed to parse json file: " << kAssetFileName;
     } else {
+      // The asset is written from |LoadSkSLs| of a training run, so its
+      // members are in the order the shaders were first used as well.
+      std::vector<std::pair<const char*, const char*>> items;
       for (auto& item : json_doc["data"].GetObject()) {
-        sk_sp<SkData> key = ParseBase32(item.name.GetString());
-        sk_sp<SkData> sksl = ParseBase64(item.value.GetString());
-        if (key != nullptr && sksl != nullptr) {
-          result.push_back({key, sksl});
+        items.emplace_back(item.name.GetString(), item.value.GetString());
+      }
+      std::vector<SkSLCache> decoded(items.size());
+      fml::ParallelFor(items.size(), worker, [&](size_t i) {
+        decoded[i].key = ParseBase32(items[i].first);
+        decoded[i].value = ParseBase64(items[i].second);
+      });
+      for (size_t i = 0; i < decoded.size(); i++) {
+        if (decoded[i].key != nullptr && decoded[i].value != nullptr) {
+          result.push_back(std::move(decoded[i]));
         } else {
-          FML_LOG(ERROR) << "Failed to load: " << item.name.GetString();
+          FML_LOG(ERROR) << "Failed to load: " << items[i].first;
         }
       }
     }
@@ -325,21 +442,69 @@ PersistentCache::SkSLCache PersistentCache::LoadFile(
 // |GrContextOptions::PersistentCache|
 sk_sp<SkData> PersistentCache::load(const SkData& key) {
   TRACE_EVENT0("flutter", "PersistentCacheLoad");
-  if (!IsValid()) {
+  if (!IsValid() || key.data() == nullptr || key.size() == 0) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.size() == 0) {
-    return nullptr;
+  sk_sp<SkData> result;
+  bool has_entry_files = false;
+  {
+    std::scoped_lock lock(packed_cache_mutex_);
+    OpenPackedCache();
+    if (packed_cache_) {
+      result = packed_cache_->Find(key);
+    }
+    if (result == nullptr) {
+      auto stored = stored_entries_.find(
+          std::string(static_cast<const char*>(key.data()), key.size()));
+      if (stored != stored_entries_.end()) {
+        result = stored->second;
+      }
+    }
+    has_entry_files = has_entry_files_;
+  }
+  // The entries may still be stored one per file by an older engine or in a
+  // pregenerated read-only cache.
+  if (result == nullptr && has_entry_files) {
+    result = PersistentCache::LoadFile(*cache_directory_, SkKeyToFilePath(key),
+                                       false)
+                 .value;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
   return result;
 }
 
+void PersistentCache::OpenPackedCache() {
+  if (packed_cache_opened_) {
+    return;
+  }
+  SetPackedCache(PackedCacheFile::Open(*cache_directory_),
+                 !GetEntryFileNames(*cache_directory_).empty());
+}
+
+void PersistentCache::SetPackedCache(
+    std::unique_ptr<PackedCacheFile> packed_cache,
+    bool has_entry_files) {
+  packed_cache_opened_ = true;
+  packed_cache_ = std::move(packed_cache);
+  has_entry_files_ = has_entry_files;
+  MaintainPackedCache(packed_cache_.get(), has_entry_files_, cache_directory_);
+}
+
+static void PostPersistentCacheTask(fml::RefPtr<fml::TaskRunner> worker,
+                                    fml::closure task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(std::move(task));
+  }
+}
+
 static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
                                  std::shared_ptr<fml::UniqueFD> cache_directory,
                                  std::string key,
@@ -356,16 +521,58 @@ static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
       FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
     }
   });
+  PostPersistentCacheTask(std::move(worker), std::move(task));
+}
 
-  if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
+void PersistentCache::MaintainPackedCache(
+    const PackedCacheFile* packed_file,
+    bool has_entry_files,
+    std::shared_ptr<fml::UniqueFD> directory) const {
+  const bool needs_compaction =
+      packed_file != nullptr && packed_file->NeedsCompaction();
+  if (is_read_only_ || !(has_entry_files || needs_compaction)) {
+    return;
+  }
+  fml::closure task = [directory = std::move(directory), has_entry_files,
+                       needs_compaction]() {
+    TRACE_EVENT0("flutter", "PersistentCache::MaintainPackedCache");
+    bool appended = false;
+    if (has_entry_files) {
+      // The entries are appended to the packed file, but their files are only
+      // removed by the next run, which finds them in the packed file. This
+      // run may still read them, as its packed file was mapped before.
+      auto packed_file = PackedCacheFile::Open(*directory);
+      for (const auto& file_name : GetEntryFileNames(*directory)) {
+        SkSLCache entry = LoadFile(*directory, file_name, true);
+        if (entry.key == nullptr || entry.value == nullptr) {
+          continue;
+        }
+        if (packed_file && packed_file->Contains(*entry.key)) {
+          fml::UnlinkFile(*directory, file_name.c_str());
+        } else if (PackedCacheFile::Append(*directory, *entry.key,
+                                           *entry.value)) {
+          appended = true;
+        }
+      }
+    }
+    if ((needs_compaction || appended) &&
+        !PackedCacheFile::Compact(*directory)) {
+      FML_LOG(WARNING) << "Could not compact the packed persistent cache.";
+    }
+  };
+
+  fml::RefPtr<fml::TaskRunner> worker;
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    if (worker_task_runners_.empty()) {
+      // This is never urgent, so it waits for a worker rather than delaying a
+      // frame.
+      pending_maintenance_tasks_.push_back(std::move(task));
+      return;
+    }
+    worker = *worker_task_runners_.begin();
   }
+  worker->PostTask(std::move(task));
 }
 
 std::unique_ptr<fml::MallocMapping> PersistentCache::BuildCacheObject(
@@ -400,20 +607,30 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
-
-  if (file_name.size() == 0) {
-    return;
-  }
-
-  std::unique_ptr<fml::MallocMapping> mapping = BuildCacheObject(key, data);
-  if (!mapping) {
+  if (key.data() == nullptr || key.size() == 0) {
     return;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  auto key_copy = SkData::MakeWithCopy(key.data(), key.size());
+  auto data_copy = SkData::MakeWithCopy(data.data(), data.size());
+  if (!cache_sksl_) {
+    // The packed file may have been mapped before this entry is appended to
+    // it.
+    std::scoped_lock lock(packed_cache_mutex_);
+    stored_entries_[std::string(static_cast<const char*>(key.data()),
+                                key.size())] = data_copy;
+  }
+
+  auto directory = cache_sksl_ ? sksl_cache_directory_ : cache_directory_;
+  PostPersistentCacheTask(
+      GetWorkerTaskRunner(),
+      [directory, key = std::move(key_copy), data = std::move(data_copy)]() {
+        TRACE_EVENT0("flutter", "PersistentCacheStore");
+        if (!PackedCacheFile::Append(*directory, *key, *data)) {
+          FML_LOG(WARNING)
+              << "Could not write cache contents to persistent store.";
+        }
+      });
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -434,10 +651,42 @@ void PersistentCache::DumpSkp(const SkData& data) {
                        std::move(file_name), std::move(mapping));
 }
 
+std::unique_ptr<fml::Mapping> PersistentCache::LoadAuxiliaryFile(
+    const std::string& file_name) const {
+  if (!IsValid()) {
+    return nullptr;
+  }
+  auto file = fml::OpenFileReadOnly(*cache_directory_, file_name.c_str());
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  auto mapping = std::make_unique<fml::FileMapping>(file);
+  if (mapping->GetSize() == 0 || mapping->GetMapping() == nullptr) {
+    return nullptr;
+  }
+  return mapping;
+}
+
+void PersistentCache::StoreAuxiliaryFile(const std::string& file_name,
+                                         std::unique_ptr<fml::Mapping> data) {
+  if (is_read_only_ || !IsValid() || !data) {
+    return;
+  }
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_, file_name,
+                       std::move(data));
+}
+
 void PersistentCache::AddWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
-  std::scoped_lock lock(worker_task_runners_mutex_);
-  worker_task_runners_.insert(task_runner);
+  std::vector<fml::closure> pending_maintenance_tasks;
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    worker_task_runners_.insert(task_runner);
+    pending_maintenance_tasks.swap(pending_maintenance_tasks_);
+  }
+  for (auto& task : pending_maintenance_tasks) {
+    task_runner->PostTask(std::move(task));
+  }
 }
 
 void PersistentCache::RemoveWorkerTaskRunner(
@@ -449,6 +698,18 @@ void PersistentCache::RemoveWorkerTaskRunner(
   }
 }
 
+void PersistentCache::SetConcurrentTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  std::scoped_lock lock(worker_task_runners_mutex_);
+  concurrent_task_runner_ = std::move(task_runner);
+}
+
+std::shared_ptr<fml::ConcurrentTaskRunner>
+PersistentCache::GetConcurrentTaskRunner() const {
+  std::scoped_lock lock(worker_task_runners_mutex_);
+  return concurrent_task_runner_;
+}
+
 fml::RefPtr<fml::TaskRunner> PersistentCache::GetWorkerTaskRunner() const {
   fml::RefPtr<fml::TaskRunner> worker;
 
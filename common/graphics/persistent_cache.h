@@ -5,11 +5,16 @@
 #ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 #define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -17,6 +22,8 @@
 
 namespace flutter {
 
+class PackedCacheFile;
+
 namespace testing {
 class ShellTest;
 }
@@ -37,6 +44,12 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   static PersistentCache* GetCacheForProcess();
   static void ResetCacheForProcess();
 
+  // Opens the cache directory and the packed file in it, which the first
+  // |load| would otherwise do on the raster thread while drawing the first
+  // frame. Safe to call on any thread, concurrently with |GetCacheForProcess|
+  // and |ResetCacheForProcess|, which do not wait for the files to be read.
+  static void PrewarmCacheForProcess();
+
   // This must be called before |GetCacheForProcess|. Otherwise, it won't
   // affect the cache directory returned by |GetCacheForProcess|.
   static void SetCacheDirectoryPath(std::string path);
@@ -72,6 +85,12 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   void RemoveWorkerTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner);
 
+  /// Set the concurrent task runner on which |LoadSkSLs| reads and decodes
+  /// the SkSLs in parallel. Without one, they are loaded on the calling
+  /// thread.
+  void SetConcurrentTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
   // Whether Skia tries to store any shader into this persistent cache after
   // |ResetStoredNewShaders| is called. This flag is usually reset before each
   // frame so we can know if Skia tries to compile new shaders in that frame.
@@ -93,13 +112,34 @@ class PersistentCache : public GrContextOptions::PersistentCache {
     sk_sp<SkData> value;
   };
 
-  /// Load all the SkSL shader caches in the right directory.
+  /// Load all the SkSL shader caches in the right directory, followed by the
+  /// ones in the asset. The SkSLs stored by previous runs come first, in the
+  /// order in which they were first used.
   std::vector<SkSLCache> LoadSkSLs() const;
 
+  struct SkSLPrecompilationProgress {
+    /// The number of SkSLs that have been compiled, successfully or not.
+    size_t compiled = 0;
+    /// The number of SkSLs that compiled successfully.
+    size_t succeeded = 0;
+    /// The number of SkSLs to compile.
+    size_t total = 0;
+  };
+
+  /// The progress of the latest |PrecompileKnownSkSLs|, which may still be
+  /// running on another thread.
+  SkSLPrecompilationProgress GetSkSLPrecompilationProgress() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Precompile SkSLs packaged with the application and gathered
   ///             during previous runs in the given context.
   ///
+  ///             The SkSLs are compiled in the order returned by |LoadSkSLs|,
+  ///             so the shaders that the first frames of previous runs needed
+  ///             are ready first. Progress is reported through the
+  ///             "PersistentCache::PrecompiledSkSLs" trace counter and
+  ///             |GetSkSLPrecompilationProgress|.
+  ///
   /// @warning    The context must be the rendering context. This context may be
   ///             destroyed during application suspension and subsequently
   ///             recreated. The SkSLs must be precompiled again in the new
@@ -111,6 +151,15 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///
   size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
 
+  /// Map a file stored next to the cached Skia objects, such as the font
+  /// fallback index. Returns nullptr if the file does not exist.
+  std::unique_ptr<fml::Mapping> LoadAuxiliaryFile(
+      const std::string& file_name) const;
+
+  /// Write a file next to the cached Skia objects on a worker task runner.
+  void StoreAuxiliaryFile(const std::string& file_name,
+                          std::unique_ptr<fml::Mapping> data);
+
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
 
@@ -129,6 +178,7 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static constexpr char kSkSLSubdirName[] = "sksl";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kFontFallbackIndexFileName[] = "font_fallback_index";
 
  private:
   static std::string cache_base_path_;
@@ -153,6 +203,28 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  // Maintenance of the packed files that was needed before there was a
+  // worker, which the first worker added runs.
+  mutable std::vector<fml::closure> pending_maintenance_tasks_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+
+  mutable std::atomic<size_t> precompiled_sksl_count_ = 0;
+  mutable std::atomic<size_t> succeeded_sksl_count_ = 0;
+  mutable std::atomic<size_t> known_sksl_count_ = 0;
+
+  // The packed file of |cache_directory_|, which is opened by the first
+  // |load|.
+  mutable std::mutex packed_cache_mutex_;
+  bool packed_cache_opened_ = false;
+  std::unique_ptr<PackedCacheFile> packed_cache_;
+  // The entries stored into |cache_directory_| by this process, by key, which
+  // may have been appended to the packed file after it was mapped. They are
+  // kept until the packed file is opened again, so that loading them doesn't
+  // map the file again.
+  std::unordered_map<std::string, sk_sp<SkData>> stored_entries_;
+  // Whether |cache_directory_| has entries stored one per file, by older
+  // engines or in a pregenerated read-only cache.
+  bool has_entry_files_ = false;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -163,6 +235,20 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   bool IsValid() const;
 
+  // Must be called with |packed_cache_mutex_| held.
+  void OpenPackedCache();
+
+  // Must be called with |packed_cache_mutex_| held.
+  void SetPackedCache(std::unique_ptr<PackedCacheFile> packed_cache,
+                      bool has_entry_files);
+
+  // Moves the entries stored one per file in |directory| into its packed
+  // file, and compacts the packed file, on the worker. Without a worker, this
+  // waits for |AddWorkerTaskRunner|.
+  void MaintainPackedCache(const PackedCacheFile* packed_file,
+                           bool has_entry_files,
+                           std::shared_ptr<fml::UniqueFD> directory) const;
+
   explicit PersistentCache(bool read_only = false);
 
   // |GrContextOptions::PersistentCache|
@@ -170,6 +256,8 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   fml::RefPtr<fml::TaskRunner> GetWorkerTaskRunner() const;
 
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentTaskRunner() const;
+
   friend class testing::ShellTest;
 
   FML_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
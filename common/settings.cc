@@ -62,6 +62,12 @@ std::string Settings::ToString() const {
   stream << "frame_rasterized_callback set: " << !!frame_rasterized_callback
          << std::endl;
   stream << "old_gen_heap_size: " << old_gen_heap_size << std::endl;
+  stream << "decoded_image_cache_max_bytes: " << decoded_image_cache_max_bytes
+         << std::endl;
+  stream << "animated_image_lookahead_frames: "
+         << animated_image_lookahead_frames << std::endl;
+  stream << "animated_image_frame_cache_max_bytes: "
+         << animated_image_frame_cache_max_bytes << std::endl;
   return stream.str();
 }
 
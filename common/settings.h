@@ -134,6 +134,12 @@ struct Settings {
   std::optional<std::vector<std::string>> trace_skia_allowlist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // Record engine trace events into per-thread ring buffers, starting before
+  // the Dart VM is created. See |fml::tracing::TraceBufferEnable|.
+  bool trace_engine_buffer = false;
+  // Periodically sample the native stacks of the engine threads. See
+  // |StackSampler|.
+  bool enable_native_sampling_profiler = false;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
   bool purge_persistent_cache = false;
@@ -179,6 +185,20 @@ struct Settings {
   // after failing to bind to a specified port.
   bool enable_service_port_fallback = false;
 
+  // Batch the events sent from the platform thread to the UI thread, and
+  // deliver them at the start of the next frame or at the next vsync. See
+  // |InputBatcher|.
+  bool enable_input_batching = false;
+
+  // The types of events that are delivered right away even if input batching
+  // is enabled. See |InputBatcher::EventTypesFromNames|.
+  std::vector<std::string> input_batching_bypass;
+
+  // Lower the frame rate while the content changes less often than the
+  // display refreshes, and report the preferred rate to the vsync waiter. See
+  // |FrameRateController|.
+  bool enable_adaptive_frame_rate = false;
+
   // Font settings
   bool use_test_fonts = false;
 
@@ -283,6 +303,21 @@ struct Settings {
   /// https://github.com/dart-lang/sdk/blob/ca64509108b3e7219c50d6c52877c85ab6a35ff2/runtime/vm/flag_list.h#L150
   int64_t old_gen_heap_size = -1;
 
+  /// The maximum number of bytes of decoded images the IO manager keeps for
+  /// reuse by later decodes of the same data, or 0 to disable the cache. The
+  /// cache is purged on low memory warnings.
+  size_t decoded_image_cache_max_bytes = 32 * 1024 * 1024;
+
+  /// The number of frames of an animated image that are decoded on the worker
+  /// pool ahead of the frame being displayed, or 0 to only decode frames when
+  /// they are requested.
+  int animated_image_lookahead_frames = 2;
+
+  /// Animated images whose decoded frames all fit within this many bytes keep
+  /// every frame after it is first shown, so that later repetitions of the
+  /// animation are not decoded again.
+  size_t animated_image_frame_cache_max_bytes = 8 * 1024 * 1024;
+
   /// A timestamp representing when the engine started. The value is based
   /// on the clock used by the Dart timeline APIs. This timestamp is used
   /// to log a timeline event that tracks the latency of engine startup.
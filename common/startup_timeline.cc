@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/startup_timeline.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+static_assert(StartupTimeline::kCount <= 32,
+              "Recorded phases must fit in the bit mask.");
+
+StartupTimeline::ScopedPhase::ScopedPhase(Phase phase)
+    : phase_(phase), start_(fml::TimePoint::Now()) {}
+
+StartupTimeline::ScopedPhase::~ScopedPhase() {
+  StartupTimeline& timeline = GetForProcess();
+  if (!timeline.HasRecordedPhase(phase_)) {
+    timeline.RecordPhase(phase_, start_, fml::TimePoint::Now());
+  }
+}
+
+StartupTimeline::StartupTimeline() = default;
+
+StartupTimeline& StartupTimeline::GetForProcess() {
+  static StartupTimeline* timeline = new StartupTimeline();
+  return *timeline;
+}
+
+const char* StartupTimeline::GetPhaseName(Phase phase) {
+  switch (phase) {
+    case kDartSnapshotMapping:
+      return "DartSnapshotMapping";
+    case kDartVMCreation:
+      return "DartVMCreation";
+    case kAssetManagerSetup:
+      return "AssetManagerSetup";
+    case kFontCollectionSetup:
+      return "FontCollectionSetup";
+    case kIsolateCreation:
+      return "IsolateCreation";
+    case kPersistentCacheLoad:
+      return "PersistentCacheLoad";
+    case kFirstBeginFrame:
+      return "FirstBeginFrame";
+    case kFirstRasterizedFrame:
+      return "FirstRasterizedFrame";
+    case kCount:
+      break;
+  }
+  FML_UNREACHABLE();
+}
+
+void StartupTimeline::RecordPhase(Phase phase,
+                                  fml::TimePoint start,
+                                  fml::TimePoint end) {
+  FML_DCHECK(phase < kCount);
+  FML_DCHECK(start <= end);
+  std::scoped_lock lock(mutex_);
+  const uint32_t bit = 1u << phase;
+  if (recorded_phases_.load(std::memory_order_relaxed) & bit) {
+    return;
+  }
+  phases_[phase] = {phase, start, end};
+  recorded_phases_.fetch_or(bit, std::memory_order_release);
+  TRACE_EVENT_INSTANT1("flutter", "StartupTimeline::RecordPhase", "phase",
+                       GetPhaseName(phase));
+}
+
+bool StartupTimeline::HasRecordedPhase(Phase phase) const {
+  return recorded_phases_.load(std::memory_order_acquire) & (1u << phase);
+}
+
+std::vector<StartupTimeline::PhaseTiming> StartupTimeline::GetPhases() const {
+  std::vector<PhaseTiming> phases;
+  {
+    std::scoped_lock lock(mutex_);
+    const uint32_t recorded = recorded_phases_.load(std::memory_order_relaxed);
+    for (size_t phase = 0; phase < kCount; phase++) {
+      if (recorded & (1u << phase)) {
+        phases.push_back(phases_[phase]);
+      }
+    }
+  }
+  std::stable_sort(phases.begin(), phases.end(),
+                   [](const PhaseTiming& a, const PhaseTiming& b) {
+                     return a.start < b.start;
+                   });
+  return phases;
+}
+
+void StartupTimeline::Reset() {
+  std::scoped_lock lock(mutex_);
+  recorded_phases_.store(0, std::memory_order_release);
+}
+
+}  // namespace flutter
@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_STARTUP_TIMELINE_H_
+#define FLUTTER_COMMON_STARTUP_TIMELINE_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Records when each phase of starting Flutter in this process
+///             happened.
+///
+///             Startup is a property of the process rather than of a shell:
+///             the Dart VM and the persistent cache are shared by all shells,
+///             and the first shell is the one that the user waits for. So
+///             only the first time a phase happens is recorded, and later
+///             occurrences of the same phase, for example the isolate creation
+///             of a second shell, are ignored until the timeline is reset.
+///
+///             Recording is thread safe. Checking whether a phase was already
+///             recorded is lock free, so phases that repeat on every frame
+///             can be recorded unconditionally.
+///
+class StartupTimeline {
+ public:
+  enum Phase {
+    // Mapping the VM and isolate snapshots from the settings.
+    kDartSnapshotMapping,
+    // Launching the Dart VM.
+    kDartVMCreation,
+    // Giving the engine its asset manager, which also registers the fonts
+    // of the application.
+    kAssetManagerSetup,
+    // Setting up the default font manager of the font collection.
+    kFontCollectionSetup,
+    // Creating and launching the root isolate.
+    kIsolateCreation,
+    // Loading and precompiling the shaders of the persistent cache.
+    kPersistentCacheLoad,
+    // The first Animator::BeginFrame, which builds the first frame.
+    kFirstBeginFrame,
+    // Rasterizing the first frame.
+    kFirstRasterizedFrame,
+    kCount
+  };
+
+  struct PhaseTiming {
+    Phase phase;
+    fml::TimePoint start;
+    fml::TimePoint end;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the phase from its construction to its destruction,
+  ///             unless it was already recorded.
+  ///
+  class ScopedPhase {
+   public:
+    explicit ScopedPhase(Phase phase);
+
+    ~ScopedPhase();
+
+   private:
+    const Phase phase_;
+    const fml::TimePoint start_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPhase);
+  };
+
+  static StartupTimeline& GetForProcess();
+
+  static const char* GetPhaseName(Phase phase);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records that `phase` happened from `start` to `end`, unless
+  ///             it was already recorded.
+  ///
+  void RecordPhase(Phase phase, fml::TimePoint start, fml::TimePoint end);
+
+  bool HasRecordedPhase(Phase phase) const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The recorded phases, sorted by their start time.
+  ///
+  std::vector<PhaseTiming> GetPhases() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forgets all the recorded phases, so that the next startup in
+  ///             this process is recorded. Used by benchmarks that start
+  ///             Flutter repeatedly.
+  ///
+  void Reset();
+
+ private:
+  mutable std::mutex mutex_;
+  std::array<PhaseTiming, kCount> phases_;
+  std::atomic<uint32_t> recorded_phases_ = 0;
+
+  StartupTimeline();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_STARTUP_TIMELINE_H_
@@ -72,6 +72,24 @@ bool IsFile(const std::string& path);
 
 bool TruncateFile(const fml::UniqueFD& file, size_t size);
 
+/// Hints to the operating system that `length` bytes of `file` starting at
+/// `offset` will be read soon, so that it can start reading them into the page
+/// cache. A `length` of zero extends the range to the end of the file.
+///
+/// Return false if the hint could not be given, which includes platforms that
+/// do not support it.
+bool AdviseWillRead(const fml::UniqueFD& file, size_t offset, size_t length);
+
+/// Takes an exclusive advisory lock on `file`, waiting until other open
+/// descriptions of the file, in this or another process, release theirs. The
+/// lock is released by `ReleaseFileLock` or when the file is closed.
+///
+/// Return false if the lock could not be taken.
+bool AcquireFileLock(const fml::UniqueFD& file);
+
+/// Releases a lock taken with `AcquireFileLock`.
+bool ReleaseFileLock(const fml::UniqueFD& file);
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path);
 
 bool UnlinkDirectory(const char* path);
@@ -2,8 +2,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "flutter/fml/build_config.h"
@@ -104,6 +107,60 @@ TEST(FileTest, CanTruncateAndWrite) {
   fml::UnlinkFile(dir.fd(), "some.txt");
 }
 
+TEST(FileTest, AdviseWillReadKeepsContents) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(dir.fd().is_valid());
+
+  std::string contents = "some contents here";
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "some.txt",
+                                   fml::DataMapping(contents)));
+
+  auto fd =
+      fml::OpenFile(dir.fd(), "some.txt", false, fml::FilePermission::kRead);
+  ASSERT_TRUE(fd.is_valid());
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  ASSERT_TRUE(fml::AdviseWillRead(fd, 0, 0));
+  ASSERT_TRUE(fml::AdviseWillRead(fd, 5, 4));
+#else
+  fml::AdviseWillRead(fd, 0, 0);
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
+  fml::FileMapping mapping(fd);
+  ASSERT_EQ(mapping.GetSize(), contents.size());
+  ASSERT_EQ(0,
+            ::memcmp(mapping.GetMapping(), contents.data(), contents.size()));
+
+  ASSERT_FALSE(fml::AdviseWillRead(fml::UniqueFD(), 0, 0));
+}
+
+TEST(FileTest, CanLockFileAcrossDescriptions) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(dir.fd().is_valid());
+
+  auto first = fml::OpenFile(dir.fd(), "some.lock", true,
+                             fml::FilePermission::kReadWrite);
+  auto second = fml::OpenFile(dir.fd(), "some.lock", true,
+                              fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(first.is_valid());
+  ASSERT_TRUE(second.is_valid());
+
+  ASSERT_TRUE(fml::AcquireFileLock(first));
+  std::atomic_bool second_locked = false;
+  std::thread thread([&]() {
+    ASSERT_TRUE(fml::AcquireFileLock(second));
+    second_locked = true;
+    ASSERT_TRUE(fml::ReleaseFileLock(second));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(second_locked);
+  ASSERT_TRUE(fml::ReleaseFileLock(first));
+  thread.join();
+  ASSERT_TRUE(second_locked);
+
+  ASSERT_FALSE(fml::AcquireFileLock(fml::UniqueFD()));
+  fml::UnlinkFile(dir.fd(), "some.lock");
+}
+
 TEST(FileTest, CreateDirectoryStructure) {
   fml::ScopedTemporaryDirectory dir;
 
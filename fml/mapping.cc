@@ -9,6 +9,10 @@
 
 namespace fml {
 
+uint8_t* Mapping::GetMutableMapping() {
+  return nullptr;
+}
+
 // FileMapping
 
 uint8_t* FileMapping::GetMutableMapping() {
@@ -85,6 +89,10 @@ bool DataMapping::IsDontNeedSafe() const {
   return false;
 }
 
+uint8_t* DataMapping::GetMutableMapping() {
+  return data_.data();
+}
+
 // NonOwnedMapping
 NonOwnedMapping::NonOwnedMapping(const uint8_t* data,
                                  size_t size,
@@ -150,6 +158,10 @@ bool MallocMapping::IsDontNeedSafe() const {
   return false;
 }
 
+uint8_t* MallocMapping::GetMutableMapping() {
+  return data_;
+}
+
 uint8_t* MallocMapping::Release() {
   uint8_t* result = data_;
   data_ = nullptr;
@@ -32,10 +32,22 @@ class Mapping {
   // Generally true for file-mapped memory and false for anonymous memory.
   virtual bool IsDontNeedSafe() const = 0;
 
+  // The contents of the mapping if the owner of the mapping may write to
+  // them, or nullptr. Consumers that own the mapping can take the memory over
+  // through this instead of copying it.
+  virtual uint8_t* GetMutableMapping();
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
 
+/// Hints to the operating system that the pages of `mapping` will be read
+/// soon, so that it can start reading them in before they fault.
+///
+/// Return false if the hint could not be given, which includes mappings of
+/// anonymous memory on some platforms and platforms that do not support it.
+bool AdviseWillNeed(const Mapping& mapping);
+
 class FileMapping final : public Mapping {
  public:
   enum class Protection {
@@ -72,7 +84,8 @@ class FileMapping final : public Mapping {
   // |Mapping|
   bool IsDontNeedSafe() const override;
 
-  uint8_t* GetMutableMapping();
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
 
   bool IsValid() const;
 
@@ -106,6 +119,9 @@ class DataMapping final : public Mapping {
   // |Mapping|
   bool IsDontNeedSafe() const override;
 
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
+
  private:
   std::vector<uint8_t> data_;
 
@@ -180,6 +196,9 @@ class MallocMapping final : public Mapping {
   // |Mapping|
   bool IsDontNeedSafe() const override;
 
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
+
   /// Removes ownership of the data buffer.
   /// After this is called; the mapping will point to nullptr.
   [[nodiscard]] uint8_t* Release();
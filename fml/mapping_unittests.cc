@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "flutter/fml/mapping.h"
+
+#include <cstring>
+
 #include "flutter/testing/testing.h"
 
 namespace fml {
@@ -60,4 +63,44 @@ TEST(MallocMapping, IsDontNeedSafe) {
   ASSERT_FALSE(mapping.IsDontNeedSafe());
 }
 
+TEST(MallocMapping, GetMutableMapping) {
+  MallocMapping mapping = MallocMapping::Copy("abc", 3);
+  Mapping& base = mapping;
+  ASSERT_EQ(base.GetMutableMapping(), mapping.GetMapping());
+}
+
+TEST(DataMapping, GetMutableMapping) {
+  DataMapping mapping(std::string("abc"));
+  Mapping& base = mapping;
+  ASSERT_EQ(base.GetMutableMapping(), mapping.GetMapping());
+}
+
+TEST(NonOwnedMapping, IsNotMutable) {
+  const uint8_t data[] = {1, 2, 3};
+  NonOwnedMapping mapping(data, sizeof(data));
+  ASSERT_EQ(mapping.GetMutableMapping(), nullptr);
+}
+
+TEST(MallocMapping, AdviseWillNeedIgnoresEmptyMappings) {
+  MallocMapping mapping;
+  ASSERT_FALSE(AdviseWillNeed(mapping));
+}
+
+TEST(FileMapping, AdviseWillNeedKeepsContents) {
+  ScopedTemporaryDirectory dir;
+  std::string contents = "some contents here";
+  ASSERT_TRUE(WriteAtomically(dir.fd(), "some.txt", DataMapping(contents)));
+
+  auto mapping = FileMapping::CreateReadOnly(dir.fd(), "some.txt");
+  ASSERT_NE(mapping, nullptr);
+#if defined(OS_LINUX) || defined(OS_ANDROID) || defined(OS_MACOSX)
+  ASSERT_TRUE(AdviseWillNeed(*mapping));
+#else
+  AdviseWillNeed(*mapping);
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID) || defined(OS_MACOSX)
+  ASSERT_EQ(mapping->GetSize(), contents.size());
+  ASSERT_EQ(0,
+            ::memcmp(mapping->GetMapping(), contents.data(), contents.size()));
+}
+
 }  // namespace fml
@@ -0,0 +1,63 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+
+namespace {
+
+// The calls of a |ParallelFor|, shared by the threads running them.
+struct ParallelForJob {
+  ParallelForJob(size_t count, std::function<void(size_t)> task)
+      : count(count), task(std::move(task)), remaining(count) {}
+
+  const size_t count;
+  const std::function<void(size_t)> task;
+  std::atomic_size_t next = 0;
+  CountDownLatch remaining;
+
+  // Runs calls until there are none left to start.
+  void Run() {
+    while (true) {
+      const size_t index = next.fetch_add(1);
+      if (index >= count) {
+        return;
+      }
+      task(index);
+      remaining.CountDown();
+    }
+  }
+};
+
+}  // namespace
+
+void ParallelFor(size_t count,
+                 const std::shared_ptr<ConcurrentTaskRunner>& worker,
+                 std::function<void(size_t)> task) {
+  if (count == 0) {
+    return;
+  }
+  auto job = std::make_shared<ParallelForJob>(count, std::move(task));
+  if (worker) {
+    const size_t helpers =
+        std::min<size_t>(count - 1,
+                         std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    for (size_t i = 0; i < helpers; i++) {
+      worker->PostTask([job]() { job->Run(); });
+    }
+  }
+  // Helpers that start after every call has been taken return immediately,
+  // so waiting below only ever waits for calls that are running.
+  job->Run();
+  job->remaining.Wait();
+}
+
+}  // namespace fml
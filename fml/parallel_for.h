@@ -0,0 +1,28 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_PARALLEL_FOR_H_
+#define FLUTTER_FML_PARALLEL_FOR_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+namespace fml {
+
+// Calls |task| with every index below |count|, on the calling thread and on
+// |worker| if there is one, and returns once all the calls are done.
+//
+// The calling thread runs calls itself rather than waiting for the worker to
+// start them, so this makes progress even if the worker is busy, and needs no
+// worker at all.
+void ParallelFor(size_t count,
+                 const std::shared_ptr<ConcurrentTaskRunner>& worker,
+                 std::function<void(size_t)> task);
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_PARALLEL_FOR_H_
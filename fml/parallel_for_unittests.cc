@@ -0,0 +1,50 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/parallel_for.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(ParallelForTest, CallsTaskWithEveryIndexOnce) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  std::vector<std::atomic_int> calls(1000);
+  ParallelFor(calls.size(), loop->GetTaskRunner(),
+              [&calls](size_t i) { calls[i]++; });
+  for (const auto& call_count : calls) {
+    ASSERT_EQ(call_count.load(), 1);
+  }
+}
+
+TEST(ParallelForTest, RunsOnTheCallingThreadWithoutAWorker) {
+  const std::thread::id caller = std::this_thread::get_id();
+  size_t call_count = 0;
+  ParallelFor(10, nullptr, [&](size_t i) {
+    ASSERT_EQ(std::this_thread::get_id(), caller);
+    call_count++;
+  });
+  ASSERT_EQ(call_count, 10u);
+}
+
+TEST(ParallelForTest, DoesNotWaitForABusyWorker) {
+  auto loop = ConcurrentMessageLoop::Create(1);
+  auto worker = loop->GetTaskRunner();
+  AutoResetWaitableEvent worker_blocked;
+  worker->PostTask([&worker_blocked]() { worker_blocked.Wait(); });
+
+  std::atomic_size_t call_count = 0;
+  ParallelFor(10, worker, [&call_count](size_t i) { call_count++; });
+  EXPECT_EQ(call_count.load(), 10u);
+  worker_blocked.Signal();
+}
+
+}  // namespace testing
+}  // namespace fml
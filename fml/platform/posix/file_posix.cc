@@ -6,13 +6,17 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <sstream>
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/eintr_wrapper.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/mapping.h"
@@ -159,6 +163,48 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return ::ftruncate(file.get(), size) == 0;
 }
 
+bool AdviseWillRead(const fml::UniqueFD& file, size_t offset, size_t length) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  return ::posix_fadvise(file.get(), offset, length, POSIX_FADV_WILLNEED) == 0;
+#elif defined(OS_MACOSX)
+  if (length == 0) {
+    struct stat info = {};
+    if (::fstat(file.get(), &info) != 0 ||
+        static_cast<size_t>(info.st_size) <= offset) {
+      return false;
+    }
+    length = info.st_size - offset;
+  }
+  struct radvisory advisory = {};
+  advisory.ra_offset = offset;
+  advisory.ra_count = static_cast<int>(
+      std::min<size_t>(length, std::numeric_limits<int>::max()));
+  return ::fcntl(file.get(), F_RDADVISE, &advisory) != -1;
+#else
+  return false;
+#endif
+}
+
+bool AcquireFileLock(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  return FML_HANDLE_EINTR(::flock(file.get(), LOCK_EX)) == 0;
+}
+
+bool ReleaseFileLock(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  return ::flock(file.get(), LOCK_UN) == 0;
+}
+
 bool UnlinkDirectory(const char* path) {
   return UnlinkDirectory(fml::UniqueFD{AT_FDCWD}, path);
 }
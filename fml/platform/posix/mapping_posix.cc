@@ -108,4 +108,18 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+bool AdviseWillNeed(const Mapping& mapping) {
+  const uint8_t* data = mapping.GetMapping();
+  if (data == nullptr || mapping.GetSize() == 0) {
+    return false;
+  }
+  // The advice applies to whole pages, and the mapping may start anywhere in
+  // its first page, for instance when it is a symbol in a shared library.
+  const uintptr_t page_size = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(page_size - 1);
+  const uintptr_t end = reinterpret_cast<uintptr_t>(data) + mapping.GetSize();
+  return ::madvise(reinterpret_cast<void*>(start), end - start,
+                   MADV_WILLNEED) == 0;
+}
+
 }  // namespace fml
@@ -313,6 +313,30 @@ bool IsFile(const std::string& path) {
            (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_REPARSE_POINT));
 }
 
+bool AdviseWillRead(const fml::UniqueFD& file, size_t offset, size_t length) {
+  // Windows only offers prefetching for mapped memory.
+  return false;
+}
+
+bool AcquireFileLock(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  if (!::LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD,
+                    &overlapped)) {
+    FML_DLOG(ERROR) << "Could not lock the file. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
+bool ReleaseFileLock(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  if (!::UnlockFileEx(file.get(), 0, MAXDWORD, MAXDWORD, &overlapped)) {
+    FML_DLOG(ERROR) << "Could not unlock the file. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
 bool UnlinkDirectory(const char* path) {
   if (!::RemoveDirectory(StringToWideString(path).c_str())) {
     FML_DLOG(ERROR) << "Could not remove directory: '" << path << "'. "
@@ -123,4 +123,10 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+bool AdviseWillNeed(const Mapping& mapping) {
+  // PrefetchVirtualMemory is not available on every supported version of
+  // Windows.
+  return false;
+}
+
 }  // namespace fml
@@ -0,0 +1,622 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/thread_local.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#elif defined(OS_FUCHSIA)
+#include <lib/zx/thread.h>
+#include <zircon/process.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/object.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+#if defined(OS_FUCHSIA)
+int64_t GetKoid(zx_handle_t handle) {
+  zx_info_handle_basic_t info;
+  zx_status_t status = zx_object_get_info(handle, ZX_INFO_HANDLE_BASIC, &info,
+                                          sizeof(info), nullptr, nullptr);
+  return status == ZX_OK ? info.koid : 0;
+}
+#endif
+
+// The ids the OS knows the process and the calling thread by, which are the
+// ids other traces of the process, such as systrace, use.
+int64_t GetCurrentProcessID() {
+#if defined(OS_WIN)
+  return ::GetCurrentProcessId();
+#elif defined(OS_FUCHSIA)
+  return GetKoid(zx_process_self());
+#else
+  return getpid();
+#endif
+}
+
+int64_t GetCurrentThreadID() {
+#if defined(OS_WIN)
+  return ::GetCurrentThreadId();
+#elif defined(OS_FUCHSIA)
+  return GetKoid(zx_thread_self());
+#elif defined(OS_MACOSX)
+  uint64_t thread_id = 0;
+  pthread_threadid_np(nullptr, &thread_id);
+  return thread_id;
+#elif defined(OS_LINUX) || defined(OS_ANDROID)
+  return syscall(SYS_gettid);
+#else
+  return 0;
+#endif
+}
+
+// Returns the length of the longest prefix of the first |length| bytes of
+// |string| that does not end in the middle of a UTF-8 sequence.
+size_t GetUTF8PrefixLength(const char* string, size_t length) {
+  if (length == 0) {
+    return 0;
+  }
+  // Find the first byte of the last sequence, which is followed by at most
+  // three continuation bytes.
+  size_t lead = length;
+  while (lead > 0 && length - lead < 4) {
+    lead--;
+    if ((static_cast<unsigned char>(string[lead]) & 0xC0) != 0x80) {
+      break;
+    }
+  }
+  const unsigned char lead_byte = static_cast<unsigned char>(string[lead]);
+  size_t sequence_length = 1;
+  if (lead_byte >= 0xF0) {
+    sequence_length = 4;
+  } else if (lead_byte >= 0xE0) {
+    sequence_length = 3;
+  } else if (lead_byte >= 0xC0) {
+    sequence_length = 2;
+  }
+  return length - lead < sequence_length ? lead : length;
+}
+
+// Returns the name of the calling thread, or an empty string if the platform
+// can't tell.
+std::string GetCurrentThreadName() {
+  char name[64] = {};
+#if defined(OS_FUCHSIA)
+  zx::thread::self()->get_property(ZX_PROP_NAME, name, sizeof(name) - 1);
+#elif defined(OS_MACOSX)
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+#elif defined(OS_LINUX) || defined(OS_ANDROID)
+  prctl(PR_GET_NAME, name);
+#endif
+  // The platforms may cut long names in the middle of a character.
+  return std::string(name, GetUTF8PrefixLength(name, strlen(name)));
+}
+
+enum class SlotKind : uint8_t {
+  kEvent,
+  kInt,
+  kUint,
+  kDouble,
+  kString,
+};
+
+// The contents of a buffer slot: an event, or one of the arguments of the
+// event in the slots before it.
+struct SlotData {
+  SlotKind kind;
+  uint8_t argument_count;
+  int32_t event_type;
+  const char* name;
+  union {
+    struct {
+      const char* category_group;
+      int64_t timestamp_micros;
+      int64_t id;
+      int64_t thread_id;
+    } event;
+    int64_t int_value;
+    uint64_t uint_value;
+    double double_value;
+    char string_value[kTraceBufferMaxStringLength + 1];
+  };
+};
+
+struct Slot {
+  // One more than the position the slot was last written at, or zero while
+  // it is being written. Readers compare it before and after copying the data
+  // to detect slots that were overwritten under them.
+  std::atomic<uint64_t> sequence;
+  SlotData data;
+};
+
+// The events recorded by one thread. Only the thread that leases the buffer
+// writes to it, so recording needs no locks. Any thread can read it.
+class ThreadBuffer {
+ public:
+  explicit ThreadBuffer(size_t capacity)
+      : slots_(new Slot[capacity]()), capacity_(capacity) {}
+
+  size_t capacity() const { return capacity_; }
+
+  // The thread that leased the buffer last. Only set and read with the
+  // registry locked, or by that thread.
+  int64_t thread_id() const { return thread_id_; }
+
+  void set_thread_id(int64_t thread_id) { thread_id_ = thread_id; }
+
+  // Records an event with |argument_count| arguments, where
+  // |argument_at(i)| returns the i-th argument.
+  template <typename ArgumentAt>
+  void Add(const char* category_group,
+           const char* name,
+           int64_t timestamp_micros,
+           int64_t id,
+           Dart_Timeline_Event_Type type,
+           size_t argument_count,
+           ArgumentAt argument_at) {
+    argument_count = std::min<size_t>({argument_count, capacity_ - 1, 255});
+    uint64_t position = next_position_.load(std::memory_order_relaxed);
+
+    SlotData& event = BeginWrite(position);
+    event.kind = SlotKind::kEvent;
+    event.argument_count = argument_count;
+    event.event_type = type;
+    event.name = name;
+    event.event.category_group = category_group;
+    event.event.timestamp_micros = timestamp_micros;
+    event.event.id = id;
+    event.event.thread_id = thread_id_;
+    EndWrite(position);
+
+    for (size_t i = 0; i < argument_count; i++) {
+      const TraceArgument trace_argument = argument_at(i);
+      const TraceValue& value = trace_argument.value;
+      SlotData& argument = BeginWrite(position + 1 + i);
+      argument.name = trace_argument.name;
+      switch (value.type()) {
+        case TraceValue::Type::kInt:
+          argument.kind = SlotKind::kInt;
+          argument.int_value = value.int_value();
+          break;
+        case TraceValue::Type::kUint:
+          argument.kind = SlotKind::kUint;
+          argument.uint_value = value.uint_value();
+          break;
+        case TraceValue::Type::kDouble:
+          argument.kind = SlotKind::kDouble;
+          argument.double_value = value.double_value();
+          break;
+        case TraceValue::Type::kString:
+          argument.kind = SlotKind::kString;
+          CopyString(value.string_value(), argument.string_value);
+          break;
+      }
+      EndWrite(position + 1 + i);
+    }
+
+    next_position_.store(position + 1 + argument_count,
+                         std::memory_order_release);
+  }
+
+  void Clear() {
+    start_position_.store(next_position_.load(std::memory_order_acquire),
+                          std::memory_order_relaxed);
+  }
+
+  // Calls |visitor| with each complete event still in the buffer, and its
+  // arguments.
+  template <typename Visitor>
+  void ForEachEvent(Visitor visitor) const {
+    uint64_t end = next_position_.load(std::memory_order_acquire);
+    uint64_t start = std::max<uint64_t>(
+        start_position_.load(std::memory_order_relaxed),
+        end > capacity_ ? end - capacity_ : 0);
+    std::vector<SlotData> arguments;
+    uint64_t position = start;
+    while (position < end) {
+      SlotData event;
+      if (!Read(position++, &event) || event.kind != SlotKind::kEvent) {
+        continue;
+      }
+      arguments.resize(event.argument_count);
+      bool complete = true;
+      for (size_t i = 0; i < event.argument_count && complete; i++) {
+        complete = position < end && Read(position++, &arguments[i]) &&
+                   arguments[i].kind != SlotKind::kEvent;
+      }
+      if (complete) {
+        visitor(event, arguments);
+      }
+    }
+  }
+
+  // Whether a thread is recording into this buffer.
+  std::atomic<bool> leased{false};
+
+ private:
+  std::unique_ptr<Slot[]> slots_;
+  const size_t capacity_;
+  int64_t thread_id_ = 0;
+  std::atomic<uint64_t> next_position_{0};
+  std::atomic<uint64_t> start_position_{0};
+
+  // Copies |string| to |destination|, truncated to the last whole character
+  // that fits.
+  static void CopyString(const char* string,
+                         char (&destination)[kTraceBufferMaxStringLength + 1]) {
+    const size_t length = GetUTF8PrefixLength(
+        string, strnlen(string, kTraceBufferMaxStringLength));
+    memcpy(destination, string, length);
+    destination[length] = '\0';
+  }
+
+  SlotData& BeginWrite(uint64_t position) {
+    Slot& slot = slots_[position % capacity_];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot.data;
+  }
+
+  void EndWrite(uint64_t position) {
+    slots_[position % capacity_].sequence.store(position + 1,
+                                                std::memory_order_release);
+  }
+
+  bool Read(uint64_t position, SlotData* data) const {
+    const Slot& slot = slots_[position % capacity_];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      return false;
+    }
+    memcpy(data, &slot.data, sizeof(SlotData));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == position + 1;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+// The buffers of all threads that have recorded events. Buffers outlive their
+// threads, so that their events can still be exported, and are handed to new
+// threads once the old ones have exited.
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  // The names of the threads that leased the buffers, by thread id.
+  std::map<int64_t, std::string> thread_names;
+};
+
+// Leaked so that threads can still return their buffers while the process
+// exits.
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+std::atomic<bool> gEnabled;
+std::atomic<size_t> gCapacity{kTraceBufferDefaultCapacity};
+
+// Returns a thread's buffer to the registry when the thread exits.
+class ThreadBufferLease {
+ public:
+  explicit ThreadBufferLease(ThreadBuffer* buffer) : buffer_(buffer) {}
+
+  ~ThreadBufferLease() {
+    buffer_->leased.store(false, std::memory_order_release);
+  }
+
+  ThreadBuffer* buffer() const { return buffer_; }
+
+ private:
+  ThreadBuffer* buffer_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadBufferLease);
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadBufferLease> tls_buffer_lease;
+
+ThreadBuffer* GetThreadBuffer() {
+  if (ThreadBufferLease* lease = tls_buffer_lease.get()) {
+    return lease->buffer();
+  }
+  size_t capacity = gCapacity.load(std::memory_order_relaxed);
+  Registry& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  ThreadBuffer* buffer = nullptr;
+  for (const auto& candidate : registry.buffers) {
+    if (candidate->capacity() == capacity &&
+        !candidate->leased.load(std::memory_order_acquire)) {
+      buffer = candidate.get();
+      break;
+    }
+  }
+  if (buffer == nullptr) {
+    registry.buffers.push_back(std::make_unique<ThreadBuffer>(capacity));
+    buffer = registry.buffers.back().get();
+  }
+  buffer->leased.store(true, std::memory_order_relaxed);
+  buffer->set_thread_id(GetCurrentThreadID());
+  registry.thread_names[buffer->thread_id()] = GetCurrentThreadName();
+  tls_buffer_lease.reset(new ThreadBufferLease(buffer));
+  return buffer;
+}
+
+// Returns the Chrome trace event phase of an event type.
+const char* GetPhase(int32_t type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+  }
+  return "i";
+}
+
+void WriteJSONString(std::ostream& stream, const char* string) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  stream << '"';
+  for (const char* c = string ? string : ""; *c != '\0'; c++) {
+    switch (*c) {
+      case '"':
+        stream << "\\\"";
+        break;
+      case '\\':
+        stream << "\\\\";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          stream << "\\u00" << kHexDigits[*c >> 4] << kHexDigits[*c & 0xf];
+        } else {
+          stream << *c;
+        }
+    }
+  }
+  stream << '"';
+}
+
+void WriteJSONValue(std::ostream& stream, const SlotData& argument) {
+  switch (argument.kind) {
+    case SlotKind::kInt:
+      stream << argument.int_value;
+      break;
+    case SlotKind::kUint:
+      stream << argument.uint_value;
+      break;
+    case SlotKind::kDouble:
+      if (std::isfinite(argument.double_value)) {
+        stream << TraceValue(argument.double_value).ToString();
+      } else {
+        WriteJSONString(
+            stream, TraceValue(argument.double_value).ToString().c_str());
+      }
+      break;
+    case SlotKind::kString:
+      WriteJSONString(stream, argument.string_value);
+      break;
+    case SlotKind::kEvent:
+      FML_DCHECK(false);
+      break;
+  }
+}
+
+void WriteJSONEvent(std::ostream& stream,
+                    int64_t process_id,
+                    const SlotData& event,
+                    const std::vector<SlotData>& arguments) {
+  stream << "{\"name\":";
+  WriteJSONString(stream, event.name);
+  stream << ",\"cat\":";
+  WriteJSONString(stream, event.event.category_group);
+  stream << ",\"ph\":\"" << GetPhase(event.event_type) << '"';
+  stream << ",\"ts\":" << event.event.timestamp_micros;
+  stream << ",\"pid\":" << process_id
+         << ",\"tid\":" << event.event.thread_id;
+  switch (event.event_type) {
+    case Dart_Timeline_Event_Instant:
+      stream << ",\"s\":\"t\"";
+      break;
+    case Dart_Timeline_Event_Duration:
+      stream << ",\"dur\":"
+             << event.event.id - event.event.timestamp_micros;
+      break;
+    case Dart_Timeline_Event_Flow_End:
+      stream << ",\"bp\":\"e\"";
+      [[fallthrough]];
+    case Dart_Timeline_Event_Async_Begin:
+    case Dart_Timeline_Event_Async_End:
+    case Dart_Timeline_Event_Async_Instant:
+    case Dart_Timeline_Event_Counter:
+    case Dart_Timeline_Event_Flow_Begin:
+    case Dart_Timeline_Event_Flow_Step:
+      stream << ",\"id\":\"0x" << std::hex << event.event.id << std::dec
+             << '"';
+      break;
+  }
+  if (!arguments.empty()) {
+    stream << ",\"args\":{";
+    for (size_t i = 0; i < arguments.size(); i++) {
+      if (i > 0) {
+        stream << ',';
+      }
+      WriteJSONString(stream, arguments[i].name);
+      stream << ':';
+      WriteJSONValue(stream, arguments[i]);
+    }
+    stream << '}';
+  }
+  stream << '}';
+}
+
+// Writes the metadata event that names a thread in trace viewers.
+void WriteJSONThreadName(std::ostream& stream,
+                         int64_t process_id,
+                         int64_t thread_id,
+                         const std::string& name) {
+  stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << process_id
+         << ",\"tid\":" << thread_id << ",\"args\":{\"name\":";
+  WriteJSONString(stream, name.c_str());
+  stream << "}}";
+}
+
+}  // namespace
+
+std::string TraceValue::ToString() const {
+  switch (type_) {
+    case Type::kInt:
+      return std::to_string(int_);
+    case Type::kUint:
+      return std::to_string(uint_);
+    case Type::kDouble:
+      return std::to_string(double_);
+    case Type::kString:
+      return string_;
+  }
+  return std::string();
+}
+
+void TraceBufferEnable(size_t capacity) {
+  FML_DCHECK(capacity > 1);
+  gCapacity.store(capacity, std::memory_order_relaxed);
+  gEnabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceBufferDisable() {
+  gEnabled.store(false, std::memory_order_relaxed);
+}
+
+bool TraceBufferIsEnabled() {
+  return gEnabled.load(std::memory_order_relaxed);
+}
+
+void TraceBufferAddEvent(const char* category_group,
+                         const char* name,
+                         int64_t timestamp_micros,
+                         int64_t id,
+                         Dart_Timeline_Event_Type type,
+                         const TraceArgument* arguments,
+                         size_t argument_count) {
+  if (!TraceBufferIsEnabled()) {
+    return;
+  }
+  GetThreadBuffer()->Add(category_group, name, timestamp_micros, id, type,
+                         argument_count,
+                         [arguments](size_t i) { return arguments[i]; });
+}
+
+void TraceBufferAddEvent(const char* category_group,
+                         const char* name,
+                         int64_t timestamp_micros,
+                         int64_t id,
+                         Dart_Timeline_Event_Type type,
+                         size_t argument_count,
+                         const char** argument_names,
+                         const char** argument_values) {
+  if (!TraceBufferIsEnabled()) {
+    return;
+  }
+  GetThreadBuffer()->Add(
+      category_group, name, timestamp_micros, id, type, argument_count,
+      [argument_names, argument_values](size_t i) {
+        return TraceArgument{argument_names[i], argument_values[i]};
+      });
+}
+
+void TraceBufferClear() {
+  Registry& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  // Only the threads still recording can add events with their names.
+  std::map<int64_t, std::string> thread_names;
+  for (const auto& buffer : registry.buffers) {
+    buffer->Clear();
+    if (buffer->leased.load(std::memory_order_acquire)) {
+      auto found = registry.thread_names.find(buffer->thread_id());
+      if (found != registry.thread_names.end()) {
+        thread_names.insert(*found);
+      }
+    }
+  }
+  registry.thread_names = std::move(thread_names);
+}
+
+std::string TraceBufferExportJSON() {
+  std::ostringstream stream;
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  const int64_t process_id = GetCurrentProcessID();
+  std::set<int64_t> thread_ids;
+  Registry& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  for (const auto& buffer : registry.buffers) {
+    buffer->ForEachEvent([&stream, &first, &thread_ids, process_id](
+                             const SlotData& event,
+                             const std::vector<SlotData>& arguments) {
+      if (!first) {
+        stream << ',';
+      }
+      first = false;
+      WriteJSONEvent(stream, process_id, event, arguments);
+      thread_ids.insert(event.event.thread_id);
+    });
+  }
+  for (int64_t thread_id : thread_ids) {
+    auto found = registry.thread_names.find(thread_id);
+    if (found == registry.thread_names.end() || found->second.empty()) {
+      continue;
+    }
+    stream << ',';
+    WriteJSONThreadName(stream, process_id, thread_id, found->second);
+  }
+  stream << "]}";
+  return stream.str();
+}
+
+}  // namespace tracing
+}  // namespace fml
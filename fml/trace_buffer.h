@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_BUFFER_H_
+#define FLUTTER_FML_TRACE_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "flutter/fml/time/time_point.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+// An engine owned trace recorder that does not depend on the Dart VM.
+//
+// Once enabled, every trace event is appended to a ring buffer owned by the
+// thread that emits it. Appending never takes a lock or allocates, and the
+// oldest events of a thread are overwritten once its buffer is full. The
+// buffers can be exported at any time in the Chrome JSON trace format, which
+// Perfetto and chrome://tracing can load.
+//
+// Categories, event names and argument names are recorded by pointer and
+// only read when the buffers are exported, so they must be string literals
+// or otherwise outlive the process, as they already are for the TRACE_EVENT
+// macros. Numeric argument values are recorded as numbers and only formatted
+// on export. String argument values are copied, and truncated to at most
+// |kTraceBufferMaxStringLength| bytes without splitting UTF-8 characters.
+//
+// Events are recorded with the ids the OS knows the process and its threads
+// by, so that they line up with other traces of the process, and the export
+// names the threads that recorded them.
+
+namespace fml {
+namespace tracing {
+
+// The number of events (and arguments) each thread can hold by default.
+constexpr size_t kTraceBufferDefaultCapacity = 4096;
+
+// The longest string argument value, in bytes, that is recorded in full.
+constexpr size_t kTraceBufferMaxStringLength = 39;
+
+// The value of a trace event argument.
+class TraceValue {
+ public:
+  enum class Type : uint8_t { kInt, kUint, kDouble, kString };
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  TraceValue(T value) {  // NOLINT(google-explicit-constructor)
+    if constexpr (std::is_floating_point<T>::value) {
+      type_ = Type::kDouble;
+      double_ = value;
+    } else if constexpr (std::is_signed<T>::value) {
+      type_ = Type::kInt;
+      int_ = value;
+    } else {
+      type_ = Type::kUint;
+      uint_ = value;
+    }
+  }
+
+  TraceValue(const char* value)  // NOLINT(google-explicit-constructor)
+      : type_(Type::kString), string_(value ? value : "") {}
+
+  TraceValue(const std::string& value)  // NOLINT(google-explicit-constructor)
+      : type_(Type::kString), string_(value.c_str()) {}
+
+  // Time points are recorded as nanoseconds since the epoch.
+  TraceValue(TimePoint value)  // NOLINT(google-explicit-constructor)
+      : type_(Type::kInt), int_(value.ToEpochDelta().ToNanoseconds()) {}
+
+  TraceValue() : type_(Type::kInt), int_(0) {}
+
+  Type type() const { return type_; }
+
+  int64_t int_value() const { return int_; }
+
+  uint64_t uint_value() const { return uint_; }
+
+  double double_value() const { return double_; }
+
+  // Only valid while the value this was created from is.
+  const char* string_value() const { return string_; }
+
+  std::string ToString() const;
+
+ private:
+  Type type_;
+  union {
+    int64_t int_;
+    uint64_t uint_;
+    double double_;
+    const char* string_;
+  };
+};
+
+struct TraceArgument {
+  const char* name;
+  TraceValue value;
+};
+
+// Starts recording trace events into the per-thread buffers. Threads that
+// have not recorded events yet get buffers holding |capacity| entries. An
+// event takes one entry, plus one for each of its arguments.
+void TraceBufferEnable(size_t capacity = kTraceBufferDefaultCapacity);
+
+// Stops recording trace events. The events recorded so far are kept.
+void TraceBufferDisable();
+
+bool TraceBufferIsEnabled();
+
+// Records an event in the buffer of the calling thread, if enabled.
+void TraceBufferAddEvent(const char* category_group,
+                         const char* name,
+                         int64_t timestamp_micros,
+                         int64_t id,
+                         Dart_Timeline_Event_Type type,
+                         const TraceArgument* arguments,
+                         size_t argument_count);
+
+// Records an event whose argument values are all strings.
+void TraceBufferAddEvent(const char* category_group,
+                         const char* name,
+                         int64_t timestamp_micros,
+                         int64_t id,
+                         Dart_Timeline_Event_Type type,
+                         size_t argument_count,
+                         const char** argument_names,
+                         const char** argument_values);
+
+// Discards the events recorded so far.
+void TraceBufferClear();
+
+// Returns the recorded events of all threads in the Chrome JSON trace format.
+std::string TraceBufferExportJSON();
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_BUFFER_H_
@@ -0,0 +1,210 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_buffer.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+namespace {
+
+class TraceBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override { TraceBufferClear(); }
+
+  void TearDown() override {
+    TraceBufferDisable();
+    TraceBufferClear();
+  }
+};
+
+size_t CountOccurrences(const std::string& string, const std::string& part) {
+  size_t count = 0;
+  for (size_t position = string.find(part); position != std::string::npos;
+       position = string.find(part, position + part.size())) {
+    count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_F(TraceBufferTest, RecordsNothingWhenDisabled) {
+  TraceBufferAddEvent("flutter", "Disabled", 1, 0, Dart_Timeline_Event_Instant,
+                      nullptr, 0);
+  ASSERT_EQ(TraceBufferExportJSON(), "{\"traceEvents\":[]}");
+}
+
+TEST_F(TraceBufferTest, ExportsEventsInChromeJSONFormat) {
+  TraceBufferEnable();
+  const TraceArgument arguments[] = {
+      {"count", 42},
+      {"ratio", 0.5},
+      {"label", "a \"quoted\" label"},
+  };
+  TraceBufferAddEvent("flutter", "Work", 100, 0, Dart_Timeline_Event_Begin,
+                      arguments, 3);
+  TraceBufferAddEvent("", "Work", 250, 0, Dart_Timeline_Event_End, nullptr, 0);
+  TraceBufferAddEvent("flutter", "Frame", 300, 0x2a,
+                      Dart_Timeline_Event_Async_Begin, nullptr, 0);
+
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_NE(json.find("{\"name\":\"Work\",\"cat\":\"flutter\",\"ph\":\"B\","
+                      "\"ts\":100,\"pid\":"),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"args\":{\"count\":42,\"ratio\":0.500000,"
+                      "\"label\":\"a \\\"quoted\\\" label\"}}"),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"ph\":\"E\",\"ts\":250"), std::string::npos) << json;
+  ASSERT_NE(json.find("\"ph\":\"b\",\"ts\":300,\"pid\":"),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"id\":\"0x2a\""), std::string::npos) << json;
+}
+
+TEST_F(TraceBufferTest, TruncatesLongStrings) {
+  TraceBufferEnable();
+  const std::string value(100, 'x');
+  const TraceArgument arguments[] = {{"value", value}};
+  TraceBufferAddEvent("flutter", "LongString", 1, 0,
+                      Dart_Timeline_Event_Instant, arguments, 1);
+
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_NE(json.find("\"value\":\"" +
+                      std::string(kTraceBufferMaxStringLength, 'x') + "\""),
+            std::string::npos)
+      << json;
+}
+
+TEST_F(TraceBufferTest, TruncatesLongStringsBetweenCharacters) {
+  TraceBufferEnable();
+  // The two bytes of the last character straddle the limit.
+  const std::string prefix(kTraceBufferMaxStringLength - 1, 'x');
+  const std::string value = prefix + "\xc3\xa9";
+  const TraceArgument arguments[] = {{"value", value}};
+  TraceBufferAddEvent("flutter", "LongString", 1, 0,
+                      Dart_Timeline_Event_Instant, arguments, 1);
+
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_NE(json.find("\"value\":\"" + prefix + "\""), std::string::npos)
+      << json;
+}
+
+TEST_F(TraceBufferTest, KeepsNewestEventsWhenFull) {
+  TraceBufferEnable(8);
+  std::thread thread([] {
+    for (int i = 0; i < 10; i++) {
+      const TraceArgument arguments[] = {{"index", i}};
+      TraceBufferAddEvent("flutter", "Overwritten", i, 0,
+                          Dart_Timeline_Event_Instant, arguments, 1);
+    }
+  });
+  thread.join();
+
+  // Each event takes two entries, so only the last four fit. Their
+  // timestamps are their indices.
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_EQ(CountOccurrences(json, "\"name\":\"Overwritten\""), 4u) << json;
+  for (int i = 6; i < 10; i++) {
+    ASSERT_NE(json.find("\"index\":" + std::to_string(i)), std::string::npos)
+        << json;
+  }
+}
+
+TEST_F(TraceBufferTest, ExportsEventsOfExitedThreads) {
+  TraceBufferEnable();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([] {
+      TraceBufferAddEvent("flutter", "Exited", 1, 0,
+                          Dart_Timeline_Event_Instant, nullptr, 0);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(CountOccurrences(TraceBufferExportJSON(), "\"name\":\"Exited\""),
+            4u);
+}
+
+// Windows doesn't let threads read their names back.
+#if !defined(OS_WIN)
+TEST_F(TraceBufferTest, NamesThreadsThatRecordedEvents) {
+  TraceBufferEnable();
+  std::thread thread([] {
+    Thread::SetCurrentThreadName("trace.test");
+    TraceBufferAddEvent("flutter", "Named", 1, 0, Dart_Timeline_Event_Instant,
+                        nullptr, 0);
+  });
+  thread.join();
+
+  const std::string json = TraceBufferExportJSON();
+  const std::string tid_key = "\"tid\":";
+  size_t event = json.find("\"name\":\"Named\"");
+  ASSERT_NE(event, std::string::npos) << json;
+  size_t tid = json.find(tid_key, event) + tid_key.size();
+  const std::string thread_id = json.substr(tid, json.find(',', tid) - tid);
+  ASSERT_NE(json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"tid\":" + thread_id +
+                      ",\"args\":{\"name\":\"trace.test\"}}"),
+            std::string::npos)
+      << json;
+}
+#endif  // !defined(OS_WIN)
+
+TEST_F(TraceBufferTest, ClearDiscardsRecordedEvents) {
+  TraceBufferEnable();
+  TraceBufferAddEvent("flutter", "Cleared", 1, 0, Dart_Timeline_Event_Instant,
+                      nullptr, 0);
+  TraceBufferClear();
+  TraceBufferAddEvent("flutter", "Kept", 2, 0, Dart_Timeline_Event_Instant,
+                      nullptr, 0);
+
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_EQ(json.find("\"name\":\"Cleared\""), std::string::npos) << json;
+  ASSERT_NE(json.find("\"name\":\"Kept\""), std::string::npos) << json;
+}
+
+#if FLUTTER_TIMELINE_ENABLED
+TEST_F(TraceBufferTest, RecordsTraceEventMacros) {
+  TraceBufferEnable();
+  {
+    TRACE_EVENT1("flutter", "Macro", "key", "value");
+    FML_TRACE_COUNTER("flutter", "Counter", 7, "bytes", 1024, "ratio", 0.25);
+  }
+
+  const std::string json = TraceBufferExportJSON();
+  ASSERT_NE(json.find("\"name\":\"Macro\",\"cat\":\"flutter\",\"ph\":\"B\""),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"args\":{\"key\":\"value\"}"), std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"name\":\"Macro\",\"cat\":\"\",\"ph\":\"E\""),
+            std::string::npos)
+      << json;
+  // Counter values stay numbers.
+  ASSERT_NE(json.find("\"args\":{\"bytes\":1024,\"ratio\":0.250000}"),
+            std::string::npos)
+      << json;
+}
+#endif  // FLUTTER_TIMELINE_ENABLED
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
@@ -11,6 +11,7 @@
 #include "flutter/fml/ascii_trie.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_buffer.h"
 
 namespace fml {
 namespace tracing {
@@ -21,18 +22,56 @@ namespace {
 AsciiTrie gAllowlist;
 TimelineEventHandler gTimelineEventHandler;
 
-inline void FlutterTimelineEvent(const char* label,
+// Whether events named |label| are recorded anywhere.
+inline bool ShouldTrace(const char* label) {
+  return (gTimelineEventHandler || TraceBufferIsEnabled()) &&
+         gAllowlist.Query(label);
+}
+
+inline void FlutterTimelineEvent(const char* category_group,
+                                 const char* label,
                                  int64_t timestamp0,
                                  int64_t timestamp1_or_async_id,
                                  Dart_Timeline_Event_Type type,
                                  intptr_t argument_count,
                                  const char** argument_names,
                                  const char** argument_values) {
-  if (gTimelineEventHandler && gAllowlist.Query(label)) {
+  if (!ShouldTrace(label)) {
+    return;
+  }
+  TraceBufferAddEvent(category_group, label, timestamp0,
+                      timestamp1_or_async_id, type, argument_count,
+                      argument_names, argument_values);
+  if (gTimelineEventHandler) {
     gTimelineEventHandler(label, timestamp0, timestamp1_or_async_id, type,
                           argument_count, argument_names, argument_values);
   }
 }
+
+// Records an event whose argument values have not been formatted yet.
+void FlutterTimelineEvent(const char* category_group,
+                          const char* label,
+                          int64_t timestamp_micros,
+                          int64_t identifier,
+                          Dart_Timeline_Event_Type type,
+                          const TraceArgument* arguments,
+                          size_t argument_count) {
+  TraceBufferAddEvent(category_group, label, timestamp_micros, identifier,
+                      type, arguments, argument_count);
+  if (gTimelineEventHandler) {
+    // The timeline event handler takes the argument values as strings.
+    std::vector<const char*> c_names(argument_count);
+    std::vector<std::string> values(argument_count);
+    std::vector<const char*> c_values(argument_count);
+    for (size_t i = 0; i < argument_count; i++) {
+      c_names[i] = arguments[i].name;
+      values[i] = arguments[i].value.ToString();
+      c_values[i] = values[i].c_str();
+    }
+    gTimelineEventHandler(label, timestamp_micros, identifier, type,
+                          argument_count, c_names.data(), c_values.data());
+  }
+}
 }  // namespace
 
 void TraceSetAllowlist(const std::vector<std::string>& allowlist) {
@@ -65,6 +104,7 @@ void TraceTimelineEvent(TraceArg category_group,
   }
 
   FlutterTimelineEvent(
+      category_group,                            // category_group
       name,                                      // label
       timestamp_micros,                          // timestamp0
       identifier,                                // timestamp1_or_async_id
@@ -91,8 +131,35 @@ void TraceTimelineEvent(TraceArg category_group,
   );
 }
 
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        int64_t timestamp_micros,
+                        TraceIDArg identifier,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count) {
+  if (ShouldTrace(name)) {
+    FlutterTimelineEvent(category_group, name, timestamp_micros, identifier,
+                         type, arguments, argument_count);
+  }
+}
+
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        TraceIDArg identifier,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count) {
+  // Only read the clock for events that are recorded.
+  if (ShouldTrace(name)) {
+    FlutterTimelineEvent(category_group, name, Dart_TimelineGetMicros(),
+                         identifier, type, arguments, argument_count);
+  }
+}
+
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category_group
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -108,7 +175,8 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category_group
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -126,7 +194,8 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category_group
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -137,7 +206,8 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent("",                        // category_group
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        0,                         // timestamp1_or_async_id
                        Dart_Timeline_Event_End,   // event type
@@ -150,7 +220,8 @@ void TraceEventEnd(TraceArg name) {
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category_group
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -163,7 +234,8 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category_group
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -180,7 +252,8 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category_group
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -197,7 +270,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category_group
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -208,7 +282,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category_group
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -224,7 +299,8 @@ void TraceEventInstant1(TraceArg category_group,
                         TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category_group
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -242,7 +318,8 @@ void TraceEventInstant2(TraceArg category_group,
                         TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category_group
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -255,7 +332,8 @@ void TraceEventInstant2(TraceArg category_group,
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category_group
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Begin,  // event type
@@ -268,7 +346,8 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category_group
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Step,  // event type
@@ -279,7 +358,8 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-  FlutterTimelineEvent(name,                          // label
+  FlutterTimelineEvent(category_group,                // category_group
+                       name,                          // label
                        Dart_TimelineGetMicros(),      // timestamp0
                        id,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_End,  // event type
@@ -314,6 +394,21 @@ void TraceTimelineEvent(TraceArg category_group,
                         const std::vector<const char*>& c_names,
                         const std::vector<std::string>& values) {}
 
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        int64_t timestamp_micros,
+                        TraceIDArg identifier,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count) {}
+
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        TraceIDArg identifier,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count) {}
+
 void TraceEvent0(TraceArg category_group, TraceArg name) {}
 
 void TraceEvent1(TraceArg category_group,
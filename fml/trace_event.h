@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_TRACE_EVENT_H_
 #define FLUTTER_FML_TRACE_EVENT_H_
 
+#include <array>
 #include <functional>
 
 #include "flutter/fml/build_config.h"
@@ -45,6 +46,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_buffer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 #if (FLUTTER_RELEASE && !defined(OS_FUCHSIA) && !defined(OS_ANDROID))
@@ -172,49 +174,44 @@ void TraceTimelineEvent(TraceArg category_group,
                         const std::vector<const char*>& names,
                         const std::vector<std::string>& values);
 
-inline std::string TraceToString(const char* string) {
-  return std::string{string};
-}
-
-inline std::string TraceToString(std::string string) {
-  return string;
-}
-
-inline std::string TraceToString(TimePoint point) {
-  return std::to_string(point.ToEpochDelta().ToNanoseconds());
-}
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        int64_t timestamp_micros,
+                        TraceIDArg id,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count);
 
-template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
-std::string TraceToString(T string) {
-  return std::to_string(string);
-}
+void TraceTimelineEvent(TraceArg category_group,
+                        TraceArg name,
+                        TraceIDArg id,
+                        Dart_Timeline_Event_Type type,
+                        const TraceArgument* arguments,
+                        size_t argument_count);
 
-inline void SplitArgumentsCollect(std::vector<const char*>& keys,
-                                  std::vector<std::string>& values) {}
+inline void CollectArgumentsInto(TraceArgument* arguments) {}
 
 template <typename Key, typename Value, typename... Args>
-void SplitArgumentsCollect(std::vector<const char*>& keys,
-                           std::vector<std::string>& values,
-                           Key key,
-                           Value value,
-                           Args... args) {
-  keys.emplace_back(key);
-  values.emplace_back(TraceToString(value));
-  SplitArgumentsCollect(keys, values, args...);
+void CollectArgumentsInto(TraceArgument* arguments,
+                          Key key,
+                          const Value& value,
+                          const Args&... args) {
+  *arguments = {key, TraceValue(value)};
+  CollectArgumentsInto(arguments + 1, args...);
 }
 
-inline std::pair<std::vector<const char*>, std::vector<std::string>>
-SplitArguments() {
-  return {};
-}
-
-template <typename Key, typename Value, typename... Args>
-std::pair<std::vector<const char*>, std::vector<std::string>>
-SplitArguments(Key key, Value value, Args... args) {
-  std::vector<const char*> keys;
-  std::vector<std::string> values;
-  SplitArgumentsCollect(keys, values, key, value, args...);
-  return std::make_pair(std::move(keys), std::move(values));
+// Pairs up the alternating argument names and values of a trace event. The
+// values are kept as they are, and only formatted if the event is sent to a
+// recorder that needs them as strings. String values refer to |args|, so the
+// result must not outlive them.
+template <typename... Args>
+std::array<TraceArgument, sizeof...(Args) / 2> CollectArguments(
+    const Args&... args) {
+  static_assert(sizeof...(Args) % 2 == 0,
+                "Trace event arguments must be name/value pairs.");
+  std::array<TraceArgument, sizeof...(Args) / 2> arguments;
+  CollectArgumentsInto(arguments.data(), args...);
+  return arguments;
 }
 
 size_t TraceNonce();
@@ -225,9 +222,9 @@ void TraceCounter(TraceArg category,
                   TraceIDArg identifier,
                   Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
+  const auto arguments = CollectArguments(args...);
   TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
-                     split.first, split.second);
+                     arguments.data(), arguments.size());
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -242,9 +239,9 @@ void TraceCounterNopHACK(TraceArg category,
 template <typename... Args>
 void TraceEvent(TraceArg category, TraceArg name, Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
-  TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin, split.first,
-                     split.second);
+  const auto arguments = CollectArguments(args...);
+  TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin,
+                     arguments.data(), arguments.size());
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -272,7 +269,7 @@ void TraceEventAsyncComplete(TraceArg category_group,
                              Args... args) {
 #if FLUTTER_TIMELINE_ENABLED
   auto identifier = TraceNonce();
-  const auto split = SplitArguments(args...);
+  const auto arguments = CollectArguments(args...);
 
   if (begin > end) {
     std::swap(begin, end);
@@ -286,8 +283,8 @@ void TraceEventAsyncComplete(TraceArg category_group,
                      begin_micros,                     // timestamp_micros
                      identifier,                       // identifier
                      Dart_Timeline_Event_Async_Begin,  // type
-                     split.first,                      // names
-                     split.second                      // values
+                     arguments.data(),                 // arguments
+                     arguments.size()                  // argument_count
   );
 
   TraceTimelineEvent(category_group,                 // group
@@ -295,8 +292,8 @@ void TraceEventAsyncComplete(TraceArg category_group,
                      end_micros,                     // timestamp_micros
                      identifier,                     // identifier
                      Dart_Timeline_Event_Async_End,  // type
-                     split.first,                    // names
-                     split.second                    // values
+                     arguments.data(),               // arguments
+                     arguments.size()                // argument_count
   );
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
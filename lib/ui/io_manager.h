@@ -8,6 +8,7 @@
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/sync_switch.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
@@ -26,6 +27,10 @@ class IOManager {
 
   virtual std::shared_ptr<const fml::SyncSwitch>
   GetIsGpuDisabledSyncSwitch() = 0;
+
+  // The cache of decoded images shared by the engines using this IO manager,
+  // or nullptr if decoded images are not cached.
+  virtual DecodedImageCache* GetDecodedImageCache() = 0;
 };
 
 }  // namespace flutter
@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <cstring>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+#include "openssl/sha.h"
+
+namespace flutter {
+
+// An estimate of the memory used by an image, including its mipmaps.
+static size_t EstimateImageBytes(const SkImage& image) {
+  const size_t bytes = image.imageInfo().computeMinByteSize();
+  return image.hasMipmaps() ? bytes + bytes / 3 : bytes;
+}
+
+size_t DecodedImageCache::KeyHash::operator()(const Key& key) const {
+  uint64_t digest_prefix;
+  memcpy(&digest_prefix, key.digest.data(), sizeof(digest_prefix));
+  return fml::HashCombine(digest_prefix, key.target_width, key.target_height);
+}
+
+DecodedImageCache::DecodedImageCache(fml::RefPtr<SkiaUnrefQueue> unref_queue,
+                                     size_t max_bytes)
+    : unref_queue_(std::move(unref_queue)), max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(const SkData& encoded,
+                                                  uint32_t target_width,
+                                                  uint32_t target_height) {
+  TRACE_EVENT0("flutter", "DecodedImageCache::MakeKey");
+  static_assert(sizeof(Key::digest) == SHA256_DIGEST_LENGTH,
+                "The key holds a SHA-256 digest.");
+  Key key;
+  SHA256(encoded.bytes(), encoded.size(), key.digest.data());
+  key.target_width = target_width;
+  key.target_height = target_height;
+  return key;
+}
+
+sk_sp<SkImage> DecodedImageCache::Get(const Key& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->image.skia_object();
+}
+
+void DecodedImageCache::Put(const Key& key, sk_sp<SkImage> image) {
+  if (!image) {
+    return;
+  }
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    current_bytes_ -= found->second->bytes;
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+
+  const size_t bytes = EstimateImageBytes(*image);
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  EvictToFit(max_bytes_ - bytes);
+  entries_.push_front({key, {std::move(image), unref_queue_}, bytes});
+  index_[key] = entries_.begin();
+  current_bytes_ += bytes;
+}
+
+void DecodedImageCache::Purge() {
+  TRACE_EVENT0("flutter", "DecodedImageCache::Purge");
+  EvictToFit(0);
+}
+
+void DecodedImageCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictToFit(max_bytes_);
+}
+
+void DecodedImageCache::EvictToFit(size_t max_bytes) {
+  while (current_bytes_ > max_bytes && !entries_.empty()) {
+    const Entry& entry = entries_.back();
+    current_bytes_ -= entry.bytes;
+    index_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+/// @brief  A least recently used cache of decoded images, keyed by the
+///         contents of the encoded data and the size the image was decoded
+///         to.
+///
+///         The cache is owned by the IO manager and only used on the IO task
+///         runner. The cached images are usually textures in the resource
+///         context, and so evicted images are released through the unref
+///         queue. Since engines spawned from the same shell share its IO
+///         manager, they share decoded images too.
+class DecodedImageCache {
+ public:
+  struct Key {
+    // The SHA-256 of the encoded bytes. Images may come from untrusted
+    // sources, so finding two images with the same digest must not be
+    // feasible, or one of them could be shown in place of the other.
+    std::array<uint8_t, 32> digest = {};
+    // The requested size of the decoded image, or zero for its intrinsic size.
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+
+    bool operator==(const Key& other) const {
+      return digest == other.digest && target_width == other.target_width &&
+             target_height == other.target_height;
+    }
+  };
+
+  /// @brief      Creates a cache holding at most `max_bytes` of images,
+  ///             usually `Settings::decoded_image_cache_max_bytes`.
+  DecodedImageCache(fml::RefPtr<SkiaUnrefQueue> unref_queue, size_t max_bytes);
+
+  ~DecodedImageCache();
+
+  /// @brief      Computes the key of an image decoded from `encoded`. This
+  ///             reads all of the encoded data and so can be called from any
+  ///             thread, preferably not the IO thread.
+  static Key MakeKey(const SkData& encoded,
+                     uint32_t target_width,
+                     uint32_t target_height);
+
+  /// @brief      Returns the image cached for `key` and marks it as the most
+  ///             recently used, or nullptr on a cache miss.
+  sk_sp<SkImage> Get(const Key& key);
+
+  /// @brief      Caches `image` for `key`, evicting the least recently used
+  ///             images to stay within the byte budget. Images larger than
+  ///             the budget are not cached.
+  void Put(const Key& key, sk_sp<SkImage> image);
+
+  /// @brief      Releases all cached images, for example in response to a low
+  ///             memory warning.
+  void Purge();
+
+  /// @brief      Sets the byte budget, evicting images as necessary. A budget
+  ///             of zero disables the cache.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  /// @brief      The estimated size of the cached images.
+  size_t GetCurrentBytes() const { return current_bytes_; }
+
+  size_t GetCount() const { return entries_.size(); }
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    SkiaGPUObject<SkImage> image;
+    size_t bytes;
+  };
+
+  const fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  size_t max_bytes_;
+  size_t current_bytes_ = 0;
+  // Ordered from the most to the least recently used.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+  void EvictToFit(size_t max_bytes);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
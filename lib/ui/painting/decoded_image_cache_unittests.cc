@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+class DecodedImageCacheTest : public ::testing::Test {
+ public:
+  DecodedImageCacheTest() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    unref_queue_ = fml::MakeRefCounted<SkiaUnrefQueue>(
+        fml::MessageLoop::GetCurrent().GetTaskRunner(),
+        fml::TimeDelta::FromNanoseconds(0));
+  }
+
+  ~DecodedImageCacheTest() override { unref_queue_->Drain(); }
+
+  fml::RefPtr<SkiaUnrefQueue> unref_queue() const { return unref_queue_; }
+
+ private:
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+};
+
+static constexpr size_t kMaxBytes = 1024;
+
+// An image of `width` x 1 pixels, which uses `width` * 4 bytes.
+static sk_sp<SkImage> CreateImage(int width) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, 1);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+static DecodedImageCache::Key MakeKey(const char* contents,
+                                      uint32_t target_width = 0,
+                                      uint32_t target_height = 0) {
+  auto data = SkData::MakeWithCString(contents);
+  return DecodedImageCache::MakeKey(*data, target_width, target_height);
+}
+
+TEST_F(DecodedImageCacheTest, KeysDependOnContentsAndTargetSize) {
+  EXPECT_EQ(MakeKey("image"), MakeKey("image"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("other"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("image", 10, 0));
+  EXPECT_FALSE(MakeKey("image", 10, 0) == MakeKey("image", 0, 10));
+}
+
+TEST_F(DecodedImageCacheTest, ReturnsCachedImages) {
+  DecodedImageCache cache(unref_queue(), kMaxBytes);
+  auto image = CreateImage(10);
+  cache.Put(MakeKey("a"), image);
+  EXPECT_EQ(cache.Get(MakeKey("a")).get(), image.get());
+  EXPECT_EQ(cache.Get(MakeKey("b")), nullptr);
+  EXPECT_EQ(cache.GetCount(), 1u);
+  EXPECT_EQ(cache.GetCurrentBytes(), 40u);
+}
+
+TEST_F(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  DecodedImageCache cache(unref_queue(), 100);
+  cache.Put(MakeKey("a"), CreateImage(10));
+  cache.Put(MakeKey("b"), CreateImage(10));
+  // Using "a" makes "b" the least recently used image.
+  ASSERT_TRUE(cache.Get(MakeKey("a")));
+  cache.Put(MakeKey("c"), CreateImage(10));
+
+  EXPECT_TRUE(cache.Get(MakeKey("a")));
+  EXPECT_FALSE(cache.Get(MakeKey("b")));
+  EXPECT_TRUE(cache.Get(MakeKey("c")));
+  EXPECT_EQ(cache.GetCount(), 2u);
+  EXPECT_EQ(cache.GetCurrentBytes(), 80u);
+}
+
+TEST_F(DecodedImageCacheTest, DoesNotCacheImagesLargerThanTheBudget) {
+  DecodedImageCache cache(unref_queue(), 100);
+  cache.Put(MakeKey("a"), CreateImage(10));
+  cache.Put(MakeKey("b"), CreateImage(30));
+  EXPECT_TRUE(cache.Get(MakeKey("a")));
+  EXPECT_FALSE(cache.Get(MakeKey("b")));
+  EXPECT_EQ(cache.GetCurrentBytes(), 40u);
+}
+
+TEST_F(DecodedImageCacheTest, ReplacesImagesWithTheSameKey) {
+  DecodedImageCache cache(unref_queue(), kMaxBytes);
+  auto replacement = CreateImage(20);
+  cache.Put(MakeKey("a"), CreateImage(10));
+  cache.Put(MakeKey("a"), replacement);
+  EXPECT_EQ(cache.Get(MakeKey("a")).get(), replacement.get());
+  EXPECT_EQ(cache.GetCount(), 1u);
+  EXPECT_EQ(cache.GetCurrentBytes(), 80u);
+}
+
+TEST_F(DecodedImageCacheTest, PurgeAndSetMaxBytesEvictImages) {
+  DecodedImageCache cache(unref_queue(), kMaxBytes);
+  cache.Put(MakeKey("a"), CreateImage(10));
+  cache.Put(MakeKey("b"), CreateImage(10));
+
+  cache.SetMaxBytes(40);
+  EXPECT_FALSE(cache.Get(MakeKey("a")));
+  EXPECT_TRUE(cache.Get(MakeKey("b")));
+
+  cache.Purge();
+  EXPECT_EQ(cache.GetCount(), 0u);
+  EXPECT_EQ(cache.GetCurrentBytes(), 0u);
+
+  // A budget of zero disables the cache.
+  cache.SetMaxBytes(0);
+  cache.Put(MakeKey("a"), CreateImage(1));
+  EXPECT_EQ(cache.GetCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
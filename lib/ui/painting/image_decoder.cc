@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/lib/ui/painting/scanline_resampler.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 
 namespace flutter {
@@ -14,10 +15,12 @@ namespace flutter {
 ImageDecoder::ImageDecoder(
     TaskRunners runners,
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-    fml::WeakPtr<IOManager> io_manager)
+    fml::WeakPtr<IOManager> io_manager,
+    bool cache_decoded_images)
     : runners_(std::move(runners)),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      cache_decoded_images_(cache_decoded_images),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -98,6 +101,44 @@ static sk_sp<SkImage> ImageFromDecompressedData(
                            SkISize::Make(target_width, target_height), flow);
 }
 
+// Decodes the image a row at a time at `decode_dimensions`, downscaling each
+// row into the target bitmap as it arrives. Unlike decoding and then calling
+// `ResizeRasterImage`, this never allocates a bitmap for the decoded image.
+static sk_sp<SkImage> DecodeAndResampleImage(
+    ImageDescriptor* descriptor,
+    const SkISize& decode_dimensions,
+    const SkISize& resized_dimensions,
+    const fml::tracing::TraceFlow& flow) {
+  const SkImageInfo resized_info =
+      descriptor->image_info().makeDimensions(resized_dimensions);
+  if (!ScanlineResampler::CanResample(decode_dimensions, resized_info)) {
+    return nullptr;
+  }
+
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  SkBitmap resized_bitmap;
+  if (!resized_bitmap.tryAllocPixels(resized_info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                   << resized_info.computeMinByteSize() << "B";
+    return nullptr;
+  }
+
+  ScanlineResampler resampler(decode_dimensions, resized_bitmap.pixmap());
+  if (!descriptor->get_scanlines(
+          descriptor->image_info().makeDimensions(decode_dimensions),
+          [&resampler](const void* row) { resampler.AddRow(row); })) {
+    return nullptr;
+  }
+  FML_DCHECK(resampler.IsComplete());
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  resized_bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(resized_bitmap);
+}
+
 sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                                        uint32_t target_width,
                                        uint32_t target_height,
@@ -121,6 +162,20 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                static_cast<double>(resized_dimensions.height()) /
                    source_dimensions.height()));
 
+  // Prefer resampling while decoding, at a resolution close to the target
+  // resolution if the codec supports efficient sub-pixel decoding and
+  // otherwise at full resolution.
+  if (auto image = DecodeAndResampleImage(descriptor, decode_dimensions,
+                                          resized_dimensions, flow)) {
+    return image;
+  }
+  if (decode_dimensions != source_dimensions) {
+    if (auto image = DecodeAndResampleImage(descriptor, source_dimensions,
+                                            resized_dimensions, flow)) {
+      return image;
+    }
+  }
+
   // If the codec supports efficient sub-pixel decoding, decoded at a resolution
   // close to the target resolution before resizing.
   if (decode_dimensions != source_dimensions) {
@@ -216,6 +271,84 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
+using DecodeResult =
+    std::function<void(SkiaGPUObject<SkImage>, fml::tracing::TraceFlow)>;
+
+// Decodes the image on a worker, then uploads it to the GPU on the IO thread.
+// If a `cache_key` is given, the result is cached under it.
+static void DecodeAndUpload(
+    ImageDescriptor* raw_descriptor,
+    fml::WeakPtr<IOManager> io_manager,
+    fml::RefPtr<fml::TaskRunner> io_runner,
+    const DecodeResult& result,
+    uint32_t target_width,
+    uint32_t target_height,
+    std::optional<DecodedImageCache::Key> cache_key,
+    fml::tracing::TraceFlow flow) {
+  // Step 1: Decompress the image.
+  // On Worker.
+
+  auto decompressed = raw_descriptor->is_compressed()
+                          ? ImageFromCompressedData(raw_descriptor,  //
+                                                    target_width,    //
+                                                    target_height,   //
+                                                    flow)
+                          : ImageFromDecompressedData(raw_descriptor,  //
+                                                      target_width,    //
+                                                      target_height,   //
+                                                      flow);
+
+  if (!decompressed) {
+    FML_DLOG(ERROR) << "Could not decompress image.";
+    result({}, std::move(flow));
+    return;
+  }
+
+  // Step 2: Update the image to the GPU.
+  // On IO Thread.
+
+  io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
+                                         cache_key,
+                                         flow = std::move(flow)]() mutable {
+    if (!io_manager) {
+      FML_DLOG(ERROR) << "Could not acquire IO manager.";
+      result({}, std::move(flow));
+      return;
+    }
+
+    auto cache = cache_key.has_value() ? io_manager->GetDecodedImageCache()
+                                       : nullptr;
+
+    // If the IO manager does not have a resource context, the caller
+    // might not have set one or a software backend could be in use.
+    // Either way, just return the image as-is.
+    if (!io_manager->GetResourceContext()) {
+      if (cache) {
+        cache->Put(cache_key.value(), decompressed);
+      }
+      result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
+             std::move(flow));
+      return;
+    }
+
+    auto uploaded =
+        UploadRasterImage(std::move(decompressed), io_manager, flow);
+
+    if (!uploaded.skia_object()) {
+      FML_DLOG(ERROR) << "Could not upload image to the GPU.";
+      result({}, std::move(flow));
+      return;
+    }
+
+    if (cache) {
+      cache->Put(cache_key.value(), uploaded.skia_object());
+    }
+
+    // Finally, all done.
+    result(std::move(uploaded), std::move(flow));
+  }));
+}
+
 void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                           uint32_t target_width,
                           uint32_t target_height,
@@ -243,7 +376,7 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
   // Always service the callback (and cleanup the descriptor) on the UI thread.
-  auto result =
+  DecodeResult result =
       [callback, raw_descriptor, ui_runner = runners_.GetUITaskRunner()](
           SkiaGPUObject<SkImage> image, fml::tracing::TraceFlow flow) {
         ui_runner->PostTask(fml::MakeCopyable(
@@ -263,67 +396,64 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
     return;
   }
 
-  concurrent_task_runner_->PostTask(
-      fml::MakeCopyable([raw_descriptor,                          //
-                         io_manager = io_manager_,                //
-                         io_runner = runners_.GetIOTaskRunner(),  //
-                         result,                                  //
-                         target_width = target_width,             //
-                         target_height = target_height,           //
-                         flow = std::move(flow)                   //
-  ]() mutable {
-        // Step 1: Decompress the image.
-        // On Worker.
-
-        auto decompressed = raw_descriptor->is_compressed()
-                                ? ImageFromCompressedData(raw_descriptor,  //
-                                                          target_width,    //
-                                                          target_height,   //
-                                                          flow)
-                                : ImageFromDecompressedData(raw_descriptor,  //
-                                                            target_width,    //
-                                                            target_height,   //
-                                                            flow);
-
-        if (!decompressed) {
-          FML_DLOG(ERROR) << "Could not decompress image.";
-          result({}, std::move(flow));
-          return;
-        }
-
-        // Step 2: Update the image to the GPU.
-        // On IO Thread.
-
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_DLOG(ERROR) << "Could not acquire IO manager.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.skia_object()) {
-            FML_DLOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
+  if (!raw_descriptor->is_compressed() || !cache_decoded_images_) {
+    concurrent_task_runner_->PostTask(
+        fml::MakeCopyable([raw_descriptor,                          //
+                           io_manager = io_manager_,                //
+                           io_runner = runners_.GetIOTaskRunner(),  //
+                           result,                                  //
+                           target_width = target_width,             //
+                           target_height = target_height,           //
+                           flow = std::move(flow)                   //
+    ]() mutable {
+          DecodeAndUpload(raw_descriptor, std::move(io_manager),
+                          std::move(io_runner), result, target_width,
+                          target_height, std::nullopt, std::move(flow));
         }));
+    return;
+  }
+
+  concurrent_task_runner_->PostTask(fml::MakeCopyable(
+      [raw_descriptor,                                    //
+       io_manager = io_manager_,                          //
+       io_runner = runners_.GetIOTaskRunner(),            //
+       concurrent_task_runner = concurrent_task_runner_,  //
+       result,                                            //
+       target_width = target_width,                       //
+       target_height = target_height,                     //
+       flow = std::move(flow)                             //
+  ]() mutable {
+        // Step 0: Look for an image decoded from the same data. Hash on a
+        // worker, and look up the cache on the IO thread that owns it.
+        auto key = DecodedImageCache::MakeKey(*raw_descriptor->data(),
+                                              target_width, target_height);
+        io_runner->PostTask(fml::MakeCopyable(
+            [raw_descriptor, io_manager, io_runner, concurrent_task_runner,
+             result, target_width, target_height, key,
+             flow = std::move(flow)]() mutable {
+              if (!io_manager) {
+                FML_DLOG(ERROR) << "Could not acquire IO manager.";
+                result({}, std::move(flow));
+                return;
+              }
+
+              auto cache = io_manager->GetDecodedImageCache();
+              if (sk_sp<SkImage> image = cache ? cache->Get(key) : nullptr) {
+                TRACE_EVENT0("flutter", "DecodedImageCacheHit");
+                flow.Step("DecodedImageCacheHit");
+                result({std::move(image), io_manager->GetSkiaUnrefQueue()},
+                       std::move(flow));
+                return;
+              }
+
+              concurrent_task_runner->PostTask(fml::MakeCopyable(
+                  [raw_descriptor, io_manager, io_runner, result, target_width,
+                   target_height, key, flow = std::move(flow)]() mutable {
+                    DecodeAndUpload(raw_descriptor, std::move(io_manager),
+                                    std::move(io_runner), result, target_width,
+                                    target_height, key, std::move(flow));
+                  }));
+            }));
       }));
 }
 
@@ -31,10 +31,14 @@ namespace flutter {
 // occur in a frame pipeline.
 class ImageDecoder {
  public:
+  // If `cache_decoded_images` is false, decodes neither look up nor populate
+  // the decoded image cache of the IO manager, and so skip hashing the
+  // encoded data and the lookup on the IO thread.
   ImageDecoder(
       TaskRunners runners,
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-      fml::WeakPtr<IOManager> io_manager);
+      fml::WeakPtr<IOManager> io_manager,
+      bool cache_decoded_images = false);
 
   ~ImageDecoder();
 
@@ -52,10 +56,18 @@ class ImageDecoder {
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The worker pool used for decompression, which other decoders (such as
+  // animated image codecs) may share.
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& GetConcurrentTaskRunner()
+      const {
+    return concurrent_task_runner_;
+  }
+
  private:
   TaskRunners runners_;
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   fml::WeakPtr<IOManager> io_manager_;
+  const bool cache_decoded_images_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
 };
@@ -46,11 +46,11 @@ class TestIOManager final : public IOManager {
 
   ~TestIOManager() override {
     fml::AutoResetWaitableEvent latch;
-    fml::TaskRunner::RunNowOrPostTask(runner_,
-                                      [&latch, queue = unref_queue_]() {
-                                        queue->Drain();
-                                        latch.Signal();
-                                      });
+    fml::TaskRunner::RunNowOrPostTask(runner_, [&latch, this]() {
+      decoded_image_cache_.reset();
+      unref_queue_->Drain();
+      latch.Signal();
+    });
     latch.Wait();
   }
 
@@ -76,6 +76,16 @@ class TestIOManager final : public IOManager {
     return is_gpu_disabled_sync_switch_;
   }
 
+  // |IOManager|
+  DecodedImageCache* GetDecodedImageCache() override {
+    return decoded_image_cache_.get();
+  }
+
+  void EnableDecodedImageCache() {
+    decoded_image_cache_ =
+        std::make_unique<DecodedImageCache>(unref_queue_, 32 * 1024 * 1024);
+  }
+
   bool did_access_is_gpu_disabled_sync_switch_ = false;
 
  private:
@@ -87,6 +97,7 @@ class TestIOManager final : public IOManager {
   fml::WeakPtr<TestIOManager> weak_prototype_;
   fml::RefPtr<fml::TaskRunner> runner_;
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
+  std::unique_ptr<DecodedImageCache> decoded_image_cache_;
   fml::WeakPtrFactory<TestIOManager> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TestIOManager);
@@ -377,6 +388,146 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithoutAGPUContext) {
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest, DecodedImagesAreCachedByContent) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager =
+        std::make_unique<TestIOManager>(runners.GetIOTaskRunner(), false);
+    io_manager->EnableDecodedImageCache();
+  });
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager(),
+        /*cache_decoded_images=*/true);
+  });
+
+  auto decode = [&](uint32_t target_width, uint32_t target_height) {
+    sk_sp<SkImage> result;
+    // Each decode uses its own copy of the data, as separate calls to
+    // instantiateImageCodec with the same bytes would.
+    auto fixture = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    auto data = SkData::MakeWithCopy(fixture->data(), fixture->size());
+    runners.GetUITaskRunner()->PostTask([&]() {
+      ImageGeneratorRegistry registry;
+      std::shared_ptr<ImageGenerator> generator =
+          registry.CreateCompatibleGenerator(data);
+      ASSERT_TRUE(generator);
+
+      auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+          std::move(data), std::move(generator));
+      image_decoder->Decode(descriptor, target_width, target_height,
+                            [&](SkiaGPUObject<SkImage> image) {
+                              result = image.skia_object();
+                              latch.Signal();
+                            });
+    });
+    latch.Wait();
+    return result;
+  };
+
+  sk_sp<SkImage> first = decode(100, 100);
+  ASSERT_TRUE(first);
+  sk_sp<SkImage> second = decode(100, 100);
+  ASSERT_TRUE(second);
+  EXPECT_EQ(first.get(), second.get());
+
+  // Decoding to another size is a separate cache entry.
+  sk_sp<SkImage> resized = decode(50, 50);
+  ASSERT_TRUE(resized);
+  EXPECT_NE(first.get(), resized.get());
+  EXPECT_EQ(resized->width(), 50);
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    EXPECT_EQ(io_manager->GetDecodedImageCache()->GetCount(), 2u);
+    io_manager->GetDecodedImageCache()->Purge();
+    EXPECT_EQ(io_manager->GetDecodedImageCache()->GetCount(), 0u);
+  });
+
+  first.reset();
+  second.reset();
+  resized.reset();
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+TEST_F(ImageDecoderFixtureTest, DecodedImagesAreNotCachedWhenDisabled) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager =
+        std::make_unique<TestIOManager>(runners.GetIOTaskRunner(), false);
+    io_manager->EnableDecodedImageCache();
+  });
+
+  // The decoder is not told to cache images, for example because the shell
+  // was configured with a budget of zero.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+  });
+
+  auto decode = [&]() {
+    sk_sp<SkImage> result;
+    auto fixture = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    auto data = SkData::MakeWithCopy(fixture->data(), fixture->size());
+    runners.GetUITaskRunner()->PostTask([&]() {
+      ImageGeneratorRegistry registry;
+      std::shared_ptr<ImageGenerator> generator =
+          registry.CreateCompatibleGenerator(data);
+      ASSERT_TRUE(generator);
+
+      auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+          std::move(data), std::move(generator));
+      image_decoder->Decode(descriptor, 100, 100,
+                            [&](SkiaGPUObject<SkImage> image) {
+                              result = image.skia_object();
+                              latch.Signal();
+                            });
+    });
+    latch.Wait();
+    return result;
+  };
+
+  sk_sp<SkImage> first = decode();
+  ASSERT_TRUE(first);
+  sk_sp<SkImage> second = decode();
+  ASSERT_TRUE(second);
+  EXPECT_NE(first.get(), second.get());
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    EXPECT_EQ(io_manager->GetDecodedImageCache()->GetCount(), 0u);
+  });
+
+  first.reset();
+  second.reset();
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
 TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   const auto image_dimensions =
       SkImage::MakeFromEncoded(OpenFixtureAsSkData("DashInNooglerHat.jpg"))
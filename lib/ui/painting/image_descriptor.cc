@@ -134,7 +134,10 @@ void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
         target_height);
   } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
+    auto* dart_state = UIDartState::Current();
+    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(
+        generator_, dart_state->animated_image_lookahead_frames(),
+        dart_state->animated_image_frame_cache_max_bytes());
   }
   ui_codec->AssociateWithDartWrapper(codec_handle);
 }
@@ -149,4 +152,11 @@ bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
                                pixmap.rowBytes());
 }
 
+bool ImageDescriptor::get_scanlines(
+    const SkImageInfo& info,
+    const ImageGenerator::ScanlineCallback& row_callback) const {
+  FML_DCHECK(generator_);
+  return generator_->DecodeScanlines(info, row_callback);
+}
+
 }  // namespace flutter
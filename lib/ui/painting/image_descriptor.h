@@ -106,6 +106,12 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         orientation tag, if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// @brief  Decodes this image a row at a time, if supported by the
+  ///         `ImageGenerator`.
+  /// @see    `ImageGenerator::DecodeScanlines`
+  bool get_scanlines(const SkImageInfo& info,
+                     const ImageGenerator::ScanlineCallback& row_callback) const;
+
   void dispose() {
     buffer_.reset();
     generator_.reset();
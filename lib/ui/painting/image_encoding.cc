@@ -13,6 +13,8 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/png_encoder.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
@@ -31,6 +33,7 @@ enum ImageByteFormat {
   kRawStraightRGBA,
   kRawUnmodified,
   kPNG,
+  kPNGFast,
 };
 
 void FinalizeSkData(void* isolate_callback_data, void* peer) {
@@ -158,7 +161,32 @@ sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
   return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
 }
 
-sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
+// Smaller images are encoded by Skia, which is as fast for a single stripe of
+// rows and keeps their encoding unchanged.
+constexpr size_t kMinParallelPngBytes = 512 * 1024;
+
+sk_sp<SkData> EncodePng(
+    sk_sp<SkImage> raster_image,
+    ImageByteFormat format,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  SkPixmap pixmap;
+  if (raster_image->peekPixels(&pixmap) && CanEncodePngInParallel(pixmap) &&
+      (format == kPNGFast ||
+       pixmap.computeByteSize() >= kMinParallelPngBytes)) {
+    PngEncodingOptions options;
+    if (format == kPNGFast) {
+      options.compression_level = 1;
+      options.adaptive_filtering = false;
+    }
+    return EncodePngInParallel(pixmap, options, worker_task_runner);
+  }
+  return raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
+}
+
+sk_sp<SkData> EncodeImage(
+    sk_sp<SkImage> raster_image,
+    ImageByteFormat format,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
   TRACE_EVENT0("flutter", __FUNCTION__);
 
   if (!raster_image) {
@@ -166,9 +194,10 @@ sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
   }
 
   switch (format) {
-    case kPNG: {
+    case kPNG:
+    case kPNGFast: {
       auto png_image =
-          raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
+          EncodePng(std::move(raster_image), format, worker_task_runner);
 
       if (png_image == nullptr) {
         FML_LOG(ERROR) << "Could not convert raster image to PNG.";
@@ -201,6 +230,7 @@ void EncodeImageAndInvokeDataCallback(
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
     fml::RefPtr<fml::TaskRunner> raster_task_runner,
     fml::RefPtr<fml::TaskRunner> io_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
     fml::WeakPtr<GrDirectContext> resource_context,
     fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
     const std::shared_ptr<const fml::SyncSwitch>& is_gpu_disabled_sync_switch) {
@@ -210,12 +240,24 @@ void EncodeImageAndInvokeDataCallback(
       });
 
   auto encode_task = [callback_task = std::move(callback_task), format,
-                      ui_task_runner](sk_sp<SkImage> raster_image) {
-    sk_sp<SkData> encoded = EncodeImage(std::move(raster_image), format);
-    ui_task_runner->PostTask([callback_task = std::move(callback_task),
-                              encoded = std::move(encoded)]() mutable {
-      callback_task(std::move(encoded));
-    });
+                      ui_task_runner, worker_task_runner](
+                         sk_sp<SkImage> raster_image) {
+    auto encode = [callback_task, format, ui_task_runner, worker_task_runner,
+                   raster_image = std::move(raster_image)]() mutable {
+      sk_sp<SkData> encoded =
+          EncodeImage(std::move(raster_image), format, worker_task_runner);
+      ui_task_runner->PostTask([callback_task = std::move(callback_task),
+                                encoded = std::move(encoded)]() mutable {
+        callback_task(std::move(encoded));
+      });
+    };
+    // Raster images can be read from any thread, so encoding does not need to
+    // hold up the IO thread.
+    if (worker_task_runner) {
+      worker_task_runner->PostTask(std::move(encode));
+    } else {
+      encode();
+    }
   };
 
   ConvertImageToRaster(std::move(image), encode_task, raster_task_runner,
@@ -243,18 +285,25 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
 
   const auto& task_runners = UIDartState::Current()->GetTaskRunners();
 
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner;
+  if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+    worker_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
+
   task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
       [callback = std::move(callback), image = canvas_image->image(),
        image_format, ui_task_runner = task_runners.GetUITaskRunner(),
        raster_task_runner = task_runners.GetRasterTaskRunner(),
        io_task_runner = task_runners.GetIOTaskRunner(),
+       worker_task_runner = std::move(worker_task_runner),
        io_manager = UIDartState::Current()->GetIOManager(),
        snapshot_delegate =
            UIDartState::Current()->GetSnapshotDelegate()]() mutable {
         EncodeImageAndInvokeDataCallback(
             std::move(image), std::move(callback), image_format,
             std::move(ui_task_runner), std::move(raster_task_runner),
-            std::move(io_task_runner), io_manager->GetResourceContext(),
+            std::move(io_task_runner), std::move(worker_task_runner),
+            io_manager->GetResourceContext(),
             std::move(snapshot_delegate),
             io_manager->GetIsGpuDisabledSyncSwitch());
       }));
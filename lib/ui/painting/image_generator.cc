@@ -4,12 +4,19 @@
 
 #include "flutter/lib/ui/painting/image_generator.h"
 
+#include <vector>
+
 #include "flutter/fml/logging.h"
 
 namespace flutter {
 
 ImageGenerator::~ImageGenerator() = default;
 
+bool ImageGenerator::DecodeScanlines(const SkImageInfo& info,
+                                     const ScanlineCallback& row_callback) {
+  return false;
+}
+
 sk_sp<SkImage> ImageGenerator::GetImage() {
   SkImageInfo info = GetInfo();
 
@@ -85,7 +92,8 @@ BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
 BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
     sk_sp<SkData> buffer)
     : codec_generator_(static_cast<SkCodecImageGenerator*>(
-          SkCodecImageGenerator::MakeFromEncodedCodec(buffer).release())) {}
+          SkCodecImageGenerator::MakeFromEncodedCodec(buffer).release())),
+      data_(std::move(buffer)) {}
 
 const SkImageInfo& BuiltinSkiaCodecImageGenerator::GetInfo() {
   return codec_generator_->getInfo();
@@ -131,13 +139,44 @@ bool BuiltinSkiaCodecImageGenerator::GetPixels(
   return codec_generator_->getPixels(info, pixels, row_bytes, &options);
 }
 
+bool BuiltinSkiaCodecImageGenerator::DecodeScanlines(
+    const SkImageInfo& info,
+    const ScanlineCallback& row_callback) {
+  // The codec generator does not expose its codec, so decode with a new one.
+  // Creating it only parses the header.
+  std::unique_ptr<SkCodec> codec =
+      data_ ? SkCodec::MakeFromData(data_) : nullptr;
+  if (!codec || codec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return false;
+  }
+
+  if (codec->startScanlineDecode(info) != SkCodec::kSuccess ||
+      codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder) {
+    // Either the size is not supported, or the format cannot be decoded a row
+    // at a time in order, as is the case for interlaced PNG images.
+    return false;
+  }
+
+  std::vector<uint8_t> row(info.minRowBytes());
+  for (int y = 0; y < info.height(); y++) {
+    // If the data is truncated, the codec fills the missing rows, so that
+    // the result is the same as `GetPixels`.
+    codec->getScanlines(row.data(), 1, row.size());
+    row_callback(row.data());
+  }
+  return true;
+}
+
 std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
     sk_sp<SkData> data) {
   auto codec = SkCodec::MakeFromData(data);
   if (!codec) {
     return nullptr;
   }
-  return std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec));
+  auto generator =
+      std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec));
+  generator->data_ = std::move(data);
+  return generator;
 }
 
 }  // namespace flutter
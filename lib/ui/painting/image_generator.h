@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_GENERATOR_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_GENERATOR_H_
 
+#include <functional>
 #include <optional>
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -123,6 +124,32 @@ class ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) = 0;
 
+  /// @brief      Receives a single decoded row of pixels.
+  using ScanlineCallback = std::function<void(const void* row)>;
+
+  /// @brief      Decode the first frame of the image one row at a time, from
+  ///             top to bottom, handing each row to `row_callback` as soon as
+  ///             it has been decoded. This allows the decoded image to be
+  ///             consumed, for example by resampling it, without ever holding
+  ///             all of it in memory. Decoders are not required to support
+  ///             this, and the default implementation always fails.
+  /// @param[in]  info          The desired size and color info of the decoded
+  ///                           rows. As with `GetPixels`, the implementation
+  ///                           of `GetScaledDimensions` determines which sizes
+  ///                           may be supported.
+  /// @param[in]  row_callback  Called with each of the `info.height()` rows,
+  ///                           in order. The row is only valid for the
+  ///                           duration of the call.
+  /// @return     True if every row was handed to `row_callback`. False if the
+  ///             decoder cannot decode this image a row at a time into `info`,
+  ///             in which case `row_callback` is never called.
+  /// @note       Rows are produced in the encoded orientation of the image.
+  ///             Decoders must fail for images with an EXIF orientation other
+  ///             than the default.
+  /// @see        `GetPixels`
+  virtual bool DecodeScanlines(const SkImageInfo& info,
+                               const ScanlineCallback& row_callback);
+
   /// @brief   Creates an `SkImage` based on the current `ImageInfo` of this
   ///          `ImageGenerator`.
   /// @return  A new `SkImage` containing the decoded image data.
@@ -200,11 +227,17 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) override;
 
+  // |ImageGenerator|
+  bool DecodeScanlines(const SkImageInfo& info,
+                       const ScanlineCallback& row_callback) override;
+
   static std::unique_ptr<ImageGenerator> MakeFromData(sk_sp<SkData> data);
 
  private:
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(BuiltinSkiaCodecImageGenerator);
   std::unique_ptr<SkCodecImageGenerator> codec_generator_;
+  // The encoded image, if known, for decoding scanlines.
+  sk_sp<SkData> data_;
 };
 
 }  // namespace flutter
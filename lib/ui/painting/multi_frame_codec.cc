@@ -4,27 +4,55 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
+
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
 namespace flutter {
 
-MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
-    : state_(new State(std::move(generator))) {}
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 int lookahead_frames,
+                                 size_t frame_cache_max_bytes)
+    : state_(new State(std::move(generator),
+                       lookahead_frames,
+                       frame_cache_max_bytes)) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
-MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
+static SkImageInfo GetDecodeInfo(const ImageGenerator& generator) {
+  SkImageInfo info = generator.GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator,
+                              int lookAheadFrames,
+                              size_t frameCacheMaxBytes)
     : generator_(std::move(generator)),
       frameCount_(generator_->GetFrameCount()),
       repetitionCount_(generator_->GetPlayCount() ==
                                ImageGenerator::kInfinitePlayCount
                            ? -1
                            : generator_->GetPlayCount() - 1),
-      nextFrameIndex_(0) {}
+      info_(GetDecodeInfo(*generator_)),
+      lookAheadFrames_(std::max(lookAheadFrames, 0)),
+      cacheAllFrames_(frameCount_ > 1 &&
+                      info_.computeMinByteSize() <=
+                          frameCacheMaxBytes / frameCount_),
+      nextFrameIndex_(0),
+      frameDurations_(frameCount_) {
+  if (cacheAllFrames_) {
+    cachedFrames_.resize(frameCount_);
+  }
+}
 
 static void InvokeNextFrameCallback(
     fml::RefPtr<CanvasImage> image,
@@ -75,19 +103,12 @@ static bool CopyToBitmap(SkBitmap* dst,
   return true;
 }
 
-sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
-    fml::WeakPtr<GrDirectContext> resourceContext,
-    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch) {
-  SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
-    info = updated;
-  }
-  bitmap.allocPixels(info);
+bool MultiFrameCodec::State::DecodeNextFrame(SkBitmap* bitmap,
+                                             int* duration) {
+  const int frameIndex = decodeFrameIndex_;
+  bitmap->allocPixels(info_);
 
-  ImageGenerator::FrameInfo frameInfo =
-      generator_->GetFrameInfo(nextFrameIndex_);
+  ImageGenerator::FrameInfo frameInfo = generator_->GetFrameInfo(frameIndex);
 
   const int requiredFrameIndex =
       frameInfo.required_frame.value_or(SkCodec::kNoFrame);
@@ -95,10 +116,10 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
 
   if (requiredFrameIndex != SkCodec::kNoFrame) {
     if (lastRequiredFrame_ == nullptr) {
-      FML_LOG(ERROR) << "Frame " << nextFrameIndex_ << " depends on frame "
+      FML_LOG(ERROR) << "Frame " << frameIndex << " depends on frame "
                      << requiredFrameIndex
                      << " and no required frames are cached.";
-      return nullptr;
+      return false;
     } else if (lastRequiredFrameIndex_ != requiredFrameIndex) {
       FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
                      << " is not cached. Using " << lastRequiredFrameIndex_
@@ -106,23 +127,75 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
     }
 
     if (lastRequiredFrame_->getPixels() &&
-        CopyToBitmap(&bitmap, lastRequiredFrame_->colorType(),
+        CopyToBitmap(bitmap, lastRequiredFrame_->colorType(),
                      *lastRequiredFrame_)) {
       prior_frame_index = requiredFrameIndex;
     }
   }
 
-  if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
-                             nextFrameIndex_, requiredFrameIndex)) {
-    FML_LOG(ERROR) << "Could not getPixels for frame " << nextFrameIndex_;
-    return nullptr;
+  if (!generator_->GetPixels(info_, bitmap->getPixels(), bitmap->rowBytes(),
+                             frameIndex, requiredFrameIndex)) {
+    FML_LOG(ERROR) << "Could not getPixels for frame " << frameIndex;
+    return false;
   }
 
   // Hold onto this if we need it to decode future frames.
   if (frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep) {
-    lastRequiredFrame_ = std::make_unique<SkBitmap>(bitmap);
-    lastRequiredFrameIndex_ = nextFrameIndex_;
+    lastRequiredFrame_ = std::make_unique<SkBitmap>(*bitmap);
+    lastRequiredFrameIndex_ = frameIndex;
+  }
+
+  *duration = frameInfo.duration;
+  decodeFrameIndex_ = (frameIndex + 1) % frameCount_;
+  decodedFrameCount_++;
+  return true;
+}
+
+sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+    int* duration) {
+  SkBitmap bitmap;
+  bool ready = false;
+  {
+    std::scoped_lock lock(readyMutex_);
+    if (!readyFrames_.empty() &&
+        readyFrames_.front().index == nextFrameIndex_) {
+      bitmap = std::move(readyFrames_.front().bitmap);
+      *duration = readyFrames_.front().duration;
+      readyFrames_.pop_front();
+      ready = true;
+    }
+  }
+
+  if (!ready) {
+    // The frame has not been decoded ahead of time. Wait for any decode in
+    // progress on the worker pool, which may be this frame, and otherwise
+    // decode it here.
+    TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeFrameOnIOThread");
+    foregroundDecodePending_ = true;
+    std::scoped_lock decode_lock(decodeMutex_);
+    foregroundDecodePending_ = false;
+    {
+      std::scoped_lock lock(readyMutex_);
+      if (!readyFrames_.empty() &&
+          readyFrames_.front().index == nextFrameIndex_) {
+        bitmap = std::move(readyFrames_.front().bitmap);
+        *duration = readyFrames_.front().duration;
+        readyFrames_.pop_front();
+        ready = true;
+      } else {
+        readyFrames_.clear();
+      }
+    }
+    if (!ready) {
+      decodeFrameIndex_ = nextFrameIndex_;
+      if (!DecodeNextFrame(&bitmap, duration)) {
+        return nullptr;
+      }
+    }
   }
+
   sk_sp<SkImage> result;
 
   gpu_disable_sync_switch->Execute(
@@ -158,14 +231,21 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     size_t trace_id) {
   fml::RefPtr<CanvasImage> image = nullptr;
   int duration = 0;
-  sk_sp<SkImage> skImage =
-      GetNextFrameImage(resourceContext, gpu_disable_sync_switch);
+  sk_sp<SkImage> skImage;
+  if (cacheAllFrames_) {
+    skImage = cachedFrames_[nextFrameIndex_].skia_object();
+  }
+  if (!skImage) {
+    skImage = GetNextFrameImage(resourceContext, gpu_disable_sync_switch,
+                                &frameDurations_[nextFrameIndex_]);
+    if (skImage && cacheAllFrames_) {
+      cachedFrames_[nextFrameIndex_] = {skImage, unref_queue};
+    }
+  }
   if (skImage) {
     image = CanvasImage::Create();
     image->set_image({skImage, std::move(unref_queue)});
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
+    duration = frameDurations_[nextFrameIndex_];
   }
   nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
@@ -177,6 +257,64 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
   }));
 }
 
+bool MultiFrameCodec::State::IsPrefetchComplete() const {
+  return static_cast<int>(readyFrames_.size()) >= lookAheadFrames_ ||
+         (cacheAllFrames_ && decodedFrameCount_ >= frameCount_);
+}
+
+void MultiFrameCodec::State::SchedulePrefetch(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  if (!worker_task_runner || lookAheadFrames_ == 0) {
+    return;
+  }
+
+  {
+    std::scoped_lock lock(readyMutex_);
+    if (prefetchPending_ ||
+        static_cast<int>(readyFrames_.size()) >= lookAheadFrames_) {
+      return;
+    }
+    prefetchPending_ = true;
+  }
+
+  worker_task_runner->PostTask(
+      [weak_state = std::weak_ptr<State>(shared_from_this())]() {
+        if (auto state = weak_state.lock()) {
+          state->PrefetchFrames();
+        }
+      });
+}
+
+void MultiFrameCodec::State::PrefetchFrames() {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::PrefetchFrames");
+  while (true) {
+    // The decoder is taken for one frame at a time, so that the IO thread
+    // waits for at most one prefetched frame. Once it is waiting, the
+    // prefetch stops, and it is scheduled again after the frame is returned.
+    std::scoped_lock decode_lock(decodeMutex_);
+    {
+      std::scoped_lock lock(readyMutex_);
+      if (foregroundDecodePending_ || IsPrefetchComplete()) {
+        prefetchPending_ = false;
+        return;
+      }
+    }
+
+    const int frameIndex = decodeFrameIndex_;
+    SkBitmap bitmap;
+    int duration = 0;
+    const bool decoded = DecodeNextFrame(&bitmap, &duration);
+
+    std::scoped_lock lock(readyMutex_);
+    if (!decoded) {
+      // Leave the frame to the IO thread, which reports the error.
+      prefetchPending_ = false;
+      return;
+    }
+    readyFrames_.push_back({frameIndex, std::move(bitmap), duration});
+  }
+}
+
 Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   static size_t trace_counter = 1;
   const size_t trace_id = trace_counter++;
@@ -200,12 +338,18 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
     return Dart_Null();
   }
 
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner;
+  if (auto image_decoder = dart_state->GetImageDecoder()) {
+    worker_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
+
   task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
       [callback = std::make_unique<DartPersistentValue>(
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
-       io_manager = dart_state->GetIOManager()]() mutable {
+       io_manager = dart_state->GetIOManager(),
+       worker_task_runner = std::move(worker_task_runner)]() mutable {
         auto state = weak_state.lock();
         if (!state) {
           ui_task_runner->PostTask(fml::MakeCopyable(
@@ -216,6 +360,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
             std::move(callback), std::move(ui_task_runner),
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
             io_manager->GetIsGpuDisabledSyncSwitch(), trace_id);
+        state->SchedulePrefetch(worker_task_runner);
       }));
 
   return Dart_Null();
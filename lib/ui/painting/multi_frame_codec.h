@@ -5,15 +5,39 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
 #include "flutter/fml/macros.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
 namespace flutter {
 
+namespace testing {
+class MultiFrameCodecTest;
+}  // namespace testing
+
+// Decodes the frames of an animated image on demand.
+//
+// Frames are decoded ahead of the one being displayed on the concurrent
+// worker pool, into a bounded queue of up to `lookahead_frames` frames, and
+// only uploaded on the IO task runner when they are requested. If every frame
+// of the animation fits within `frame_cache_max_bytes`, the uploaded frames
+// are also kept so that later repetitions of the loop are never decoded
+// again.
 class MultiFrameCodec : public Codec {
  public:
-  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
+  static constexpr int kDefaultLookAheadFrames = 2;
+  static constexpr size_t kDefaultFrameCacheMaxBytes = 8 * 1024 * 1024;
+
+  explicit MultiFrameCodec(
+      std::shared_ptr<ImageGenerator> generator,
+      int lookahead_frames = kDefaultLookAheadFrames,
+      size_t frame_cache_max_bytes = kDefaultFrameCacheMaxBytes);
 
   ~MultiFrameCodec() override;
 
@@ -36,26 +60,69 @@ class MultiFrameCodec : public Codec {
   // Instead, the MultiFrameCodec creates this object when it is constructed,
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
-  struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+  struct State : public std::enable_shared_from_this<State> {
+    State(std::shared_ptr<ImageGenerator> generator,
+          int lookAheadFrames,
+          size_t frameCacheMaxBytes);
 
     const std::shared_ptr<ImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
+    // The format frames are decoded to.
+    const SkImageInfo info_;
+    const int lookAheadFrames_;
+    // Whether every frame fits within the frame cache budget, in which case
+    // frames are only decoded and uploaded once.
+    const bool cacheAllFrames_;
 
     // The non-const members and functions below here are only read or written
     // to on the IO thread. They are not safe to access or write on the UI
     // thread.
     int nextFrameIndex_;
+    // The uploaded frames, by index, if `cacheAllFrames_` is set.
+    std::vector<SkiaGPUObject<SkImage>> cachedFrames_;
+    // The durations of the frames returned so far, by index, as recorded when
+    // they were decoded.
+    std::vector<int> frameDurations_;
+
+    // The decoder, which is used by both the worker pool and the IO thread.
+    // `decodeMutex_` is held for the duration of each decode since image
+    // generators are not thread safe.
+    std::mutex decodeMutex_;
+    // Whether the IO thread is waiting for `decodeMutex_` to decode the frame
+    // it needs, in which case the worker pool stops prefetching.
+    std::atomic<bool> foregroundDecodePending_ = false;
+    // The index of the frame the decoder will decode next.
+    int decodeFrameIndex_ = 0;
+    // The number of frames decoded so far.
+    int decodedFrameCount_ = 0;
     // The last decoded frame that's required to decode any subsequent frames.
     std::unique_ptr<SkBitmap> lastRequiredFrame_;
-
     // The index of the last decoded required frame.
     int lastRequiredFrameIndex_ = -1;
 
+    struct DecodedFrame {
+      int index;
+      SkBitmap bitmap;
+      int duration;
+    };
+
+    // Frames decoded ahead of `nextFrameIndex_`, in order, guarded by
+    // `readyMutex_`.
+    std::mutex readyMutex_;
+    std::deque<DecodedFrame> readyFrames_;
+    // Whether a prefetch task has been posted to the worker pool.
+    bool prefetchPending_ = false;
+
+    // Decodes the frame at `decodeFrameIndex_` and advances to the next one.
+    // The duration of the frame is read from the decoder at the same time,
+    // as it may still be parsing the image. `decodeMutex_` must be held.
+    bool DecodeNextFrame(SkBitmap* bitmap, int* duration);
+
     sk_sp<SkImage> GetNextFrameImage(
         fml::WeakPtr<GrDirectContext> resourceContext,
-        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch);
+        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+        int* duration);
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<DartPersistentValue> callback,
@@ -64,11 +131,26 @@ class MultiFrameCodec : public Codec {
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         size_t trace_id);
+
+    // Posts a task to decode frames ahead of `nextFrameIndex_`, unless one is
+    // already pending or enough frames are ready.
+    void SchedulePrefetch(
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner);
+
+    // Decodes frames into `readyFrames_` until the look-ahead is full, or
+    // until the IO thread needs the decoder. `decodeMutex_` is only held for
+    // one frame at a time. Runs on the worker pool.
+    void PrefetchFrames();
+
+    // Whether the decoder has nothing left to prefetch. `decodeMutex_` and
+    // `readyMutex_` must be held.
+    bool IsPrefetchComplete() const;
   };
 
   // Shared across the UI and IO task runners.
   std::shared_ptr<State> state_;
 
+  friend class testing::MultiFrameCodecTest;
   FML_FRIEND_MAKE_REF_COUNTED(MultiFrameCodec);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MultiFrameCodec);
 };
@@ -0,0 +1,199 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/multi_frame_codec.h"
+
+#include <atomic>
+#include <functional>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/sync_switch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Each frame is filled with a color that encodes its index.
+SkColor FrameColor(unsigned int frame_index) {
+  return SkColorSetARGB(0xFF, frame_index * 16, 0, 0);
+}
+
+int FrameDuration(unsigned int frame_index) {
+  return 10 + static_cast<int>(frame_index);
+}
+
+int FrameIndexOf(const sk_sp<SkImage>& image) {
+  SkPixmap pixmap;
+  if (!image || !image->peekPixels(&pixmap)) {
+    return -1;
+  }
+  return SkColorGetR(pixmap.getColor(0, 0)) / 16;
+}
+
+// An animation of independent frames, which counts how many frames were
+// decoded.
+class TestAnimatedImageGenerator : public ImageGenerator {
+ public:
+  explicit TestAnimatedImageGenerator(unsigned int frame_count)
+      : info_(SkImageInfo::MakeN32Premul(4, 4)), frame_count_(frame_count) {}
+
+  ~TestAnimatedImageGenerator() override = default;
+
+  // |ImageGenerator|
+  const SkImageInfo& GetInfo() override { return info_; }
+
+  // |ImageGenerator|
+  unsigned int GetFrameCount() const override { return frame_count_; }
+
+  // |ImageGenerator|
+  unsigned int GetPlayCount() const override { return kInfinitePlayCount; }
+
+  // |ImageGenerator|
+  const ImageGenerator::FrameInfo GetFrameInfo(
+      unsigned int frame_index) const override {
+    return {std::nullopt, FrameDuration(frame_index),
+            SkCodecAnimation::DisposalMethod::kRestorePrevious};
+  }
+
+  // |ImageGenerator|
+  SkISize GetScaledDimensions(float scale) override {
+    return info_.dimensions();
+  }
+
+  // |ImageGenerator|
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) override {
+    if (on_decode) {
+      on_decode(frame_index);
+    }
+    SkPixmap(info, pixels, row_bytes).erase(FrameColor(frame_index));
+    decode_count++;
+    return true;
+  }
+
+  // Called before each frame is decoded, on the decoding thread.
+  std::function<void(unsigned int frame_index)> on_decode;
+  std::atomic<int> decode_count = 0;
+
+ private:
+  const SkImageInfo info_;
+  const unsigned int frame_count_;
+};
+
+}  // namespace
+
+class MultiFrameCodecTest : public ::testing::Test {
+ protected:
+  using State = MultiFrameCodec::State;
+
+  static std::shared_ptr<State> GetState(MultiFrameCodec& codec) {
+    return codec.state_;
+  }
+
+  // Returns the next frame as the IO thread does, without uploading it, and
+  // moves on to the frame after it. The frame's duration must be the one the
+  // decoder reported for it.
+  static sk_sp<SkImage> GetNextFrame(State& state) {
+    auto gpu_disabled_switch = std::make_shared<fml::SyncSwitch>(true);
+    int duration = -1;
+    sk_sp<SkImage> image =
+        state.GetNextFrameImage({}, gpu_disabled_switch, &duration);
+    EXPECT_EQ(duration, FrameDuration(state.nextFrameIndex_));
+    state.nextFrameIndex_ = (state.nextFrameIndex_ + 1) % state.frameCount_;
+    return image;
+  }
+
+  static bool IsForegroundDecodePending(State& state) {
+    return state.foregroundDecodePending_;
+  }
+
+  static void SetForegroundDecodePending(State& state, bool pending) {
+    state.foregroundDecodePending_ = pending;
+  }
+};
+
+TEST_F(MultiFrameCodecTest, ReturnsFramesInOrderWhilePrefetching) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto generator = std::make_shared<TestAnimatedImageGenerator>(5);
+  auto codec = fml::MakeRefCounted<MultiFrameCodec>(
+      generator, /*lookahead_frames=*/2, /*frame_cache_max_bytes=*/0);
+  auto state = GetState(*codec);
+
+  for (int i = 0; i < 12; i++) {
+    EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), i % 5);
+    state->SchedulePrefetch(loop->GetTaskRunner());
+  }
+
+  loop.reset();
+  EXPECT_FALSE(IsForegroundDecodePending(*state));
+}
+
+TEST_F(MultiFrameCodecTest, UsesPrefetchedFrames) {
+  auto generator = std::make_shared<TestAnimatedImageGenerator>(5);
+  auto codec = fml::MakeRefCounted<MultiFrameCodec>(
+      generator, /*lookahead_frames=*/2, /*frame_cache_max_bytes=*/0);
+  auto state = GetState(*codec);
+
+  // Nothing is prefetched while the IO thread waits for the decoder.
+  SetForegroundDecodePending(*state, true);
+  state->PrefetchFrames();
+  EXPECT_EQ(generator->decode_count, 0);
+  SetForegroundDecodePending(*state, false);
+
+  state->PrefetchFrames();
+  EXPECT_EQ(generator->decode_count, 2);
+
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 0);
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 1);
+  EXPECT_EQ(generator->decode_count, 2);
+
+  // The look-ahead is used up, so the next frame is decoded on demand.
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 2);
+  EXPECT_EQ(generator->decode_count, 3);
+
+  state->PrefetchFrames();
+  EXPECT_EQ(generator->decode_count, 5);
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 3);
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 4);
+  EXPECT_EQ(FrameIndexOf(GetNextFrame(*state)), 0);
+  EXPECT_EQ(generator->decode_count, 6);
+}
+
+TEST_F(MultiFrameCodecTest, CanBeCollectedWhilePrefetching) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto generator = std::make_shared<TestAnimatedImageGenerator>(5);
+  fml::AutoResetWaitableEvent decode_started;
+  fml::ManualResetWaitableEvent finish_decode;
+  generator->on_decode = [&](unsigned int frame_index) {
+    decode_started.Signal();
+    finish_decode.Wait();
+  };
+
+  std::weak_ptr<MultiFrameCodecTest::State> weak_state;
+  {
+    auto codec = fml::MakeRefCounted<MultiFrameCodec>(
+        generator, /*lookahead_frames=*/2, /*frame_cache_max_bytes=*/0);
+    auto state = GetState(*codec);
+    weak_state = state;
+    state->SchedulePrefetch(loop->GetTaskRunner());
+    decode_started.Wait();
+  }
+
+  // The prefetch keeps the state alive until it is done.
+  EXPECT_FALSE(weak_state.expired());
+  finish_decode.Signal();
+  loop.reset();
+  EXPECT_TRUE(weak_state.expired());
+  EXPECT_EQ(generator->decode_count, 2);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,407 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/png_encoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/parallel_for.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/zlib/zlib.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint8_t kPngSignature[] = {0x89, 'P',  'N',  'G',
+                                     '\r', '\n', 0x1A, '\n'};
+
+// A zlib header for a deflate stream with a 32 KiB window.
+constexpr uint8_t kZlibHeader[] = {0x78, 0x9C};
+
+// The amount of image data in each stripe. Smaller stripes spread the work
+// more evenly, but each one restarts the deflate window, which costs a little
+// compression.
+constexpr size_t kStripeBytes = 256 * 1024;
+
+// Keeps each stripe within the 32 bit sizes zlib takes.
+constexpr size_t kMaxRowBytes = 16 * 1024 * 1024;
+
+enum PngFilter : uint8_t {
+  kNone = 0,
+  kSub = 1,
+  kUp = 2,
+  kAverage = 3,
+  kPaeth = 4,
+};
+
+constexpr PngFilter kFilters[] = {kNone, kSub, kUp, kAverage, kPaeth};
+
+struct Stripe {
+  int first_row = 0;
+  int row_count = 0;
+  // The filtered rows, deflated without a zlib header or trailer.
+  std::vector<uint8_t> deflated;
+  // The size and Adler-32 checksum of the filtered rows.
+  size_t filtered_size = 0;
+  uint32_t adler = 0;
+  // The CRC-32 of `deflated`.
+  uint32_t crc = 0;
+  bool succeeded = false;
+};
+
+uint8_t* WriteUint32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+  return out + 4;
+}
+
+uint8_t PaethPredictor(int a, int b, int c) {
+  const int pa = std::abs(b - c);
+  const int pb = std::abs(a - c);
+  const int pc = std::abs(a + b - 2 * c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+// Filters `size` bytes of `row` against the row `above` it. The loops have no
+// dependencies between iterations, other than through the unfiltered input,
+// so the compiler can vectorize them.
+void ApplyFilter(PngFilter filter,
+                 const uint8_t* row,
+                 const uint8_t* above,
+                 size_t size,
+                 size_t bpp,
+                 uint8_t* out) {
+  switch (filter) {
+    case kNone:
+      memcpy(out, row, size);
+      break;
+    case kSub:
+      memcpy(out, row, bpp);
+      for (size_t i = bpp; i < size; i++) {
+        out[i] = row[i] - row[i - bpp];
+      }
+      break;
+    case kUp:
+      for (size_t i = 0; i < size; i++) {
+        out[i] = row[i] - above[i];
+      }
+      break;
+    case kAverage:
+      for (size_t i = 0; i < bpp; i++) {
+        out[i] = row[i] - (above[i] >> 1);
+      }
+      for (size_t i = bpp; i < size; i++) {
+        out[i] = row[i] - ((row[i - bpp] + above[i]) >> 1);
+      }
+      break;
+    case kPaeth:
+      for (size_t i = 0; i < bpp; i++) {
+        out[i] = row[i] - above[i];
+      }
+      for (size_t i = bpp; i < size; i++) {
+        out[i] =
+            row[i] - PaethPredictor(row[i - bpp], above[i], above[i - bpp]);
+      }
+      break;
+  }
+}
+
+// The heuristic libpng uses to choose a filter: the sum of the filtered bytes
+// as signed values.
+size_t FilterCost(const uint8_t* filtered, size_t size) {
+  size_t cost = 0;
+  for (size_t i = 0; i < size; i++) {
+    cost += std::abs(static_cast<int8_t>(filtered[i]));
+  }
+  return cost;
+}
+
+// Writes the filter type byte and the filtered row to `out`.
+void FilterRow(bool adaptive,
+               const uint8_t* row,
+               const uint8_t* above,
+               size_t size,
+               size_t bpp,
+               uint8_t* out,
+               uint8_t* scratch) {
+  if (!adaptive) {
+    out[0] = kUp;
+    ApplyFilter(kUp, row, above, size, bpp, out + 1);
+    return;
+  }
+
+  size_t best_cost = SIZE_MAX;
+  for (PngFilter filter : kFilters) {
+    ApplyFilter(filter, row, above, size, bpp, scratch);
+    const size_t cost = FilterCost(scratch, size);
+    if (cost < best_cost) {
+      best_cost = cost;
+      out[0] = filter;
+      memcpy(out + 1, scratch, size);
+    }
+  }
+}
+
+// Reads `row_count` rows of `pixmap` starting at `first_row` as 8 bit RGBA
+// with straight alpha, or RGB if `opaque`.
+bool ReadRows(const SkPixmap& pixmap,
+              int first_row,
+              int row_count,
+              bool opaque,
+              std::vector<uint8_t>* rows) {
+  SkPixmap subset;
+  if (!pixmap.extractSubset(&subset, SkIRect::MakeXYWH(0, first_row,
+                                                       pixmap.width(),
+                                                       row_count))) {
+    return false;
+  }
+
+  const size_t width = pixmap.width();
+  rows->resize(width * 4 * row_count);
+  SkPixmap rgba(SkImageInfo::Make(pixmap.width(), row_count,
+                                  kRGBA_8888_SkColorType,
+                                  opaque ? kOpaque_SkAlphaType
+                                         : kUnpremul_SkAlphaType,
+                                  pixmap.refColorSpace()),
+                rows->data(), width * 4);
+  if (!subset.readPixels(rgba)) {
+    return false;
+  }
+
+  if (opaque) {
+    uint8_t* rgb = rows->data();
+    const size_t pixels = width * row_count;
+    for (size_t i = 0; i < pixels; i++) {
+      rgb[i * 3 + 0] = rgb[i * 4 + 0];
+      rgb[i * 3 + 1] = rgb[i * 4 + 1];
+      rgb[i * 3 + 2] = rgb[i * 4 + 2];
+    }
+    rows->resize(pixels * 3);
+  }
+  return true;
+}
+
+bool Deflate(const std::vector<uint8_t>& input,
+             int level,
+             bool last,
+             std::vector<uint8_t>* output) {
+  z_stream stream = {};
+  // Negative window bits produce a raw deflate stream, without the zlib
+  // header and trailer, so that stripes can be concatenated.
+  if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    return false;
+  }
+
+  // Leave room for the empty block a sync flush ends with.
+  output->resize(deflateBound(&stream, input.size()) + 16);
+  stream.next_in = const_cast<uint8_t*>(input.data());
+  stream.avail_in = input.size();
+  stream.next_out = output->data();
+  stream.avail_out = output->size();
+
+  // All but the last stripe end with a sync flush, which leaves the stream
+  // byte aligned and open, so that the next stripe can follow it.
+  const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+  bool succeeded = false;
+  while (true) {
+    const int result = deflate(&stream, flush);
+    if (result == Z_STREAM_ERROR) {
+      break;
+    }
+    if (last ? result == Z_STREAM_END
+             : stream.avail_in == 0 && stream.avail_out != 0) {
+      succeeded = true;
+      break;
+    }
+    const size_t written = stream.total_out;
+    output->resize(output->size() * 2);
+    stream.next_out = output->data() + written;
+    stream.avail_out = output->size() - written;
+  }
+
+  output->resize(stream.total_out);
+  deflateEnd(&stream);
+  return succeeded;
+}
+
+bool EncodeStripe(const SkPixmap& pixmap,
+                  const PngEncodingOptions& options,
+                  bool opaque,
+                  bool last,
+                  Stripe* stripe) {
+  const size_t bpp = opaque ? 3 : 4;
+  const size_t row_size = pixmap.width() * bpp;
+
+  // Filters refer to the row above the stripe too.
+  const int read_first_row = std::max(stripe->first_row - 1, 0);
+  std::vector<uint8_t> rows;
+  if (!ReadRows(pixmap, read_first_row,
+                stripe->first_row + stripe->row_count - read_first_row, opaque,
+                &rows)) {
+    return false;
+  }
+
+  std::vector<uint8_t> zero_row;
+  const uint8_t* above;
+  const uint8_t* row;
+  if (stripe->first_row == 0) {
+    zero_row.resize(row_size, 0);
+    above = zero_row.data();
+    row = rows.data();
+  } else {
+    above = rows.data();
+    row = rows.data() + row_size;
+  }
+
+  std::vector<uint8_t> filtered((row_size + 1) * stripe->row_count);
+  std::vector<uint8_t> scratch(options.adaptive_filtering ? row_size : 0);
+  for (int i = 0; i < stripe->row_count; i++) {
+    FilterRow(options.adaptive_filtering, row, above, row_size, bpp,
+              filtered.data() + i * (row_size + 1), scratch.data());
+    above = row;
+    row += row_size;
+  }
+
+  stripe->filtered_size = filtered.size();
+  stripe->adler =
+      adler32(adler32(0, Z_NULL, 0), filtered.data(), filtered.size());
+  if (!Deflate(filtered, options.compression_level, last,
+               &stripe->deflated)) {
+    return false;
+  }
+  stripe->crc = crc32(crc32(0, Z_NULL, 0), stripe->deflated.data(),
+                      stripe->deflated.size());
+  return true;
+}
+
+void WriteChunk(uint8_t** out,
+                const char type[4],
+                const uint8_t* data,
+                size_t size) {
+  *out = WriteUint32(*out, size);
+  uint8_t* type_and_data = *out;
+  memcpy(*out, type, 4);
+  if (size > 0) {
+    memcpy(*out + 4, data, size);
+  }
+  *out += 4 + size;
+  *out =
+      WriteUint32(*out, crc32(crc32(0, Z_NULL, 0), type_and_data, 4 + size));
+}
+
+}  // namespace
+
+bool CanEncodePngInParallel(const SkPixmap& pixmap) {
+  if (pixmap.width() <= 0 || pixmap.height() <= 0 || !pixmap.addr()) {
+    return false;
+  }
+  if (pixmap.colorType() != kRGBA_8888_SkColorType &&
+      pixmap.colorType() != kBGRA_8888_SkColorType) {
+    return false;
+  }
+  // Other color spaces need an ICC profile, which Skia's encoder writes.
+  if (pixmap.colorSpace() && !pixmap.colorSpace()->isSRGB()) {
+    return false;
+  }
+  return static_cast<size_t>(pixmap.width()) * 4 <= kMaxRowBytes;
+}
+
+sk_sp<SkData> EncodePngInParallel(
+    const SkPixmap& pixmap,
+    const PngEncodingOptions& options,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  TRACE_EVENT0("flutter", "EncodePngInParallel");
+  if (!CanEncodePngInParallel(pixmap)) {
+    return nullptr;
+  }
+
+  const bool opaque = pixmap.info().isOpaque();
+  const size_t row_size = pixmap.width() * (opaque ? 3 : 4);
+  const int rows_per_stripe =
+      static_cast<int>(std::max<size_t>(kStripeBytes / row_size, 1));
+
+  std::vector<Stripe> stripes;
+  for (int row = 0; row < pixmap.height(); row += rows_per_stripe) {
+    Stripe stripe;
+    stripe.first_row = row;
+    stripe.row_count = std::min(rows_per_stripe, pixmap.height() - row);
+    stripes.push_back(std::move(stripe));
+  }
+
+  fml::ParallelFor(stripes.size(), worker_task_runner, [&](size_t index) {
+    Stripe& stripe = stripes[index];
+    stripe.succeeded = EncodeStripe(pixmap, options, opaque,
+                                    index + 1 == stripes.size(), &stripe);
+  });
+
+  size_t idat_size = sizeof(kZlibHeader) + 4;
+  uLong adler = adler32(0, Z_NULL, 0);
+  for (const Stripe& stripe : stripes) {
+    if (!stripe.succeeded) {
+      FML_LOG(ERROR) << "Could not encode rows " << stripe.first_row << " to "
+                     << stripe.first_row + stripe.row_count << " as PNG.";
+      return nullptr;
+    }
+    idat_size += stripe.deflated.size();
+    adler = adler32_combine(adler, stripe.adler, stripe.filtered_size);
+  }
+
+  constexpr size_t kChunkOverhead = 12;
+  constexpr size_t kHeaderSize = 13;
+  const size_t total_size = sizeof(kPngSignature) + kChunkOverhead +
+                            kHeaderSize + kChunkOverhead + idat_size +
+                            kChunkOverhead;
+  sk_sp<SkData> data = SkData::MakeUninitialized(total_size);
+  uint8_t* out = static_cast<uint8_t*>(data->writable_data());
+
+  memcpy(out, kPngSignature, sizeof(kPngSignature));
+  out += sizeof(kPngSignature);
+
+  uint8_t header[kHeaderSize];
+  uint8_t* header_out = WriteUint32(header, pixmap.width());
+  header_out = WriteUint32(header_out, pixmap.height());
+  header_out[0] = 8;               // Bit depth.
+  header_out[1] = opaque ? 2 : 6;  // Color type: RGB or RGBA.
+  header_out[2] = 0;               // Compression method: deflate.
+  header_out[3] = 0;               // Filter method: adaptive.
+  header_out[4] = 0;               // Interlace method: none.
+  WriteChunk(&out, "IHDR", header, sizeof(header));
+
+  // The image data is written directly, since its CRC is combined from those
+  // of the stripes.
+  out = WriteUint32(out, idat_size);
+  uint8_t* idat = out;
+  memcpy(out, "IDAT", 4);
+  memcpy(out + 4, kZlibHeader, sizeof(kZlibHeader));
+  out += 4 + sizeof(kZlibHeader);
+  uLong crc = crc32(crc32(0, Z_NULL, 0), idat, 4 + sizeof(kZlibHeader));
+  for (const Stripe& stripe : stripes) {
+    memcpy(out, stripe.deflated.data(), stripe.deflated.size());
+    out += stripe.deflated.size();
+    crc = crc32_combine(crc, stripe.crc, stripe.deflated.size());
+  }
+  uint8_t* trailer = out;
+  out = WriteUint32(out, adler);
+  crc = crc32(crc, trailer, 4);
+  out = WriteUint32(out, crc);
+
+  WriteChunk(&out, "IEND", nullptr, 0);
+
+  FML_DCHECK(out == static_cast<uint8_t*>(data->writable_data()) + total_size);
+  return data;
+}
+
+}  // namespace flutter
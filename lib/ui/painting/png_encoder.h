@@ -0,0 +1,49 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
+#define FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
+
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+struct PngEncodingOptions {
+  /// The zlib compression level, from 0 (store) to 9 (smallest output).
+  int compression_level = 6;
+  /// Whether the filter of each row is chosen by trying all of them, as
+  /// libpng does by default. Otherwise every row uses the "up" filter, which
+  /// is the cheapest one that still helps compression.
+  bool adaptive_filtering = true;
+};
+
+/// @brief      Whether `pixmap` can be encoded by `EncodePngInParallel`. Only
+///             8 bit RGBA and BGRA pixmaps in sRGB (or no color space) are
+///             supported.
+bool CanEncodePngInParallel(const SkPixmap& pixmap);
+
+/// @brief      Encodes `pixmap` as an 8 bit RGB or RGBA PNG.
+///
+///             The image is split into horizontal stripes that are converted,
+///             filtered and deflated independently, and then concatenated
+///             into a single zlib stream, as pigz does. Stripes are encoded
+///             on `worker_task_runner` as well as on the calling thread, which
+///             also encodes any stripes the workers have not picked up, so
+///             this may be called from a worker itself. If
+///             `worker_task_runner` is null, the stripes are encoded
+///             serially.
+///
+/// @return     The encoded image, or nullptr if encoding failed.
+sk_sp<SkData> EncodePngInParallel(
+    const SkPixmap& pixmap,
+    const PngEncodingOptions& options,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PNG_ENCODER_H_
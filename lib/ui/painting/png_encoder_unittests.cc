@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/png_encoder.h"
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+namespace testing {
+
+static SkBitmap CreateGradientBitmap(int width, int height, bool opaque) {
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeN32(
+      width, height, opaque ? kOpaque_SkAlphaType : kPremul_SkAlphaType));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const U8CPU alpha = opaque ? 0xFF : (x + y) & 0xFF;
+      const U8CPU checker = ((x / 8 + y / 8) & 1) * 0xFF;
+      *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(alpha, x * 255 / width,
+                                                  y * 255 / height, checker);
+    }
+  }
+  return bitmap;
+}
+
+// Decodes `encoded` and checks that it holds the same pixels as `bitmap`, up
+// to the rounding of unpremultiplying and premultiplying them again.
+static void ExpectSamePixels(const SkBitmap& bitmap, sk_sp<SkData> encoded) {
+  ASSERT_TRUE(encoded);
+  sk_sp<SkImage> decoded = SkImage::MakeFromEncoded(encoded);
+  ASSERT_TRUE(decoded);
+  ASSERT_EQ(decoded->dimensions(), bitmap.dimensions());
+
+  SkBitmap actual;
+  actual.allocPixels(bitmap.info());
+  ASSERT_TRUE(decoded->readPixels(actual.pixmap(), 0, 0));
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      const uint32_t actual_pixel = *actual.getAddr32(x, y);
+      const uint32_t expected_pixel = *bitmap.getAddr32(x, y);
+      for (int shift = 0; shift < 32; shift += 8) {
+        ASSERT_NEAR((actual_pixel >> shift) & 0xFF,
+                    (expected_pixel >> shift) & 0xFF, 1)
+            << "at " << x << "," << y;
+      }
+    }
+  }
+}
+
+TEST(PngEncoderTest, CanEncodeOnly8BitSRGBPixmaps) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(4, 4);
+  EXPECT_TRUE(CanEncodePngInParallel(bitmap.pixmap()));
+
+  SkBitmap f16;
+  f16.allocPixels(SkImageInfo::Make(4, 4, kRGBA_F16_SkColorType,
+                                    kPremul_SkAlphaType));
+  EXPECT_FALSE(CanEncodePngInParallel(f16.pixmap()));
+
+  SkBitmap display_p3;
+  display_p3.allocPixels(SkImageInfo::MakeN32(
+      4, 4, kPremul_SkAlphaType,
+      SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                            SkNamedGamut::kDisplayP3)));
+  EXPECT_FALSE(CanEncodePngInParallel(display_p3.pixmap()));
+}
+
+TEST(PngEncoderTest, EncodesTranslucentImages) {
+  SkBitmap bitmap = CreateGradientBitmap(67, 45, false);
+  ExpectSamePixels(bitmap, EncodePngInParallel(bitmap.pixmap(), {}, nullptr));
+}
+
+TEST(PngEncoderTest, EncodesOpaqueImages) {
+  SkBitmap bitmap = CreateGradientBitmap(67, 45, true);
+  ExpectSamePixels(bitmap, EncodePngInParallel(bitmap.pixmap(), {}, nullptr));
+}
+
+TEST(PngEncoderTest, EncodesStripesInParallel) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  // Large enough to be split into several stripes.
+  SkBitmap bitmap = CreateGradientBitmap(1000, 700, false);
+
+  ExpectSamePixels(bitmap, EncodePngInParallel(bitmap.pixmap(), {},
+                                               loop->GetTaskRunner()));
+
+  PngEncodingOptions fast;
+  fast.compression_level = 1;
+  fast.adaptive_filtering = false;
+  ExpectSamePixels(bitmap, EncodePngInParallel(bitmap.pixmap(), fast,
+                                               loop->GetTaskRunner()));
+
+  PngEncodingOptions store;
+  store.compression_level = 0;
+  ExpectSamePixels(bitmap, EncodePngInParallel(bitmap.pixmap(), store,
+                                               loop->GetTaskRunner()));
+}
+
+}  // namespace testing
+}  // namespace flutter
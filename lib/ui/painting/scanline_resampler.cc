@@ -0,0 +1,148 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/scanline_resampler.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kChannels = 4;
+
+// The fixed point representation of a whole source pixel when filtering
+// horizontally.
+constexpr uint32_t kColumnWeightOne = 256;
+
+// Keeps the horizontal sums of a destination pixel within 32 bits.
+constexpr int kMaxSourceWidth = 1 << 16;
+
+// Splits the `source` pixels along an axis between the one or two
+// `destination` pixels each of them overlaps. The overlaps are computed
+// exactly, in units of 1/`destination` of a source pixel, and `to_weight`
+// converts them to the weight of the first pixel.
+template <typename Contribution, typename WeightConverter>
+std::vector<Contribution> ComputeContributions(int source,
+                                               int destination,
+                                               WeightConverter to_weight) {
+  std::vector<Contribution> contributions(source);
+  for (int i = 0; i < source; i++) {
+    const int64_t index = static_cast<int64_t>(i) * destination / source;
+    const int64_t overlap = std::min<int64_t>(
+        (index + 1) * source - static_cast<int64_t>(i) * destination,
+        destination);
+    contributions[i].index = static_cast<int>(index);
+    contributions[i].weight =
+        to_weight(static_cast<double>(overlap) / destination);
+  }
+  return contributions;
+}
+
+}  // namespace
+
+bool ScanlineResampler::CanResample(const SkISize& source_dimensions,
+                                    const SkImageInfo& destination) {
+  return !source_dimensions.isEmpty() && !destination.isEmpty() &&
+         destination.bytesPerPixel() == kChannels &&
+         source_dimensions.width() <= kMaxSourceWidth &&
+         destination.width() <= source_dimensions.width() &&
+         destination.height() <= source_dimensions.height();
+}
+
+ScanlineResampler::ScanlineResampler(const SkISize& source_dimensions,
+                                     const SkPixmap& destination)
+    : source_dimensions_(source_dimensions),
+      destination_(destination),
+      normalization_(static_cast<float>(destination.width()) *
+                     destination.height() / source_dimensions.width() /
+                     source_dimensions.height() / kColumnWeightOne),
+      columns_(ComputeContributions<ColumnContribution>(
+          source_dimensions.width(),
+          destination.width(),
+          [](double weight) {
+            return static_cast<uint32_t>(weight * kColumnWeightOne + 0.5);
+          })),
+      rows_(ComputeContributions<RowContribution>(
+          source_dimensions.height(),
+          destination.height(),
+          [](double weight) { return static_cast<float>(weight); })),
+      // One extra pixel absorbs the zero weighted spill over from the last
+      // column so that the horizontal filter does not need to branch.
+      filtered_row_((destination.width() + 1) * kChannels),
+      current_row_(destination.width() * kChannels),
+      next_row_(destination.width() * kChannels) {
+  FML_DCHECK(CanResample(source_dimensions, destination.info()));
+}
+
+ScanlineResampler::~ScanlineResampler() = default;
+
+bool ScanlineResampler::IsComplete() const {
+  return source_row_ == source_dimensions_.height();
+}
+
+void ScanlineResampler::FilterRow(const uint8_t* row) {
+  std::fill(filtered_row_.begin(), filtered_row_.end(), 0);
+  uint32_t* filtered = filtered_row_.data();
+  const int width = source_dimensions_.width();
+  for (int x = 0; x < width; x++) {
+    const ColumnContribution& column = columns_[x];
+    const uint8_t* pixel = row + x * kChannels;
+    uint32_t* first = filtered + column.index * kChannels;
+    uint32_t* second = first + kChannels;
+    const uint32_t weight = column.weight;
+    const uint32_t remainder = kColumnWeightOne - weight;
+    for (int c = 0; c < kChannels; c++) {
+      first[c] += pixel[c] * weight;
+      second[c] += pixel[c] * remainder;
+    }
+  }
+}
+
+void ScanlineResampler::AddRow(const void* row) {
+  FML_DCHECK(!IsComplete());
+  const RowContribution& contribution = rows_[source_row_++];
+  if (contribution.index != destination_row_) {
+    // Source rows are added in order and the destination is no taller than
+    // the source, so rows only ever advance one destination row at a time.
+    FML_DCHECK(contribution.index == destination_row_ + 1);
+    WriteDestinationRow();
+    std::swap(current_row_, next_row_);
+    std::fill(next_row_.begin(), next_row_.end(), 0.0f);
+    destination_row_++;
+  }
+
+  FilterRow(static_cast<const uint8_t*>(row));
+
+  const float weight = contribution.weight;
+  const float remainder = 1.0f - weight;
+  const uint32_t* filtered = filtered_row_.data();
+  float* current = current_row_.data();
+  float* next = next_row_.data();
+  const size_t count = current_row_.size();
+  for (size_t i = 0; i < count; i++) {
+    current[i] += filtered[i] * weight;
+    next[i] += filtered[i] * remainder;
+  }
+
+  if (IsComplete()) {
+    WriteDestinationRow();
+  }
+}
+
+void ScanlineResampler::WriteDestinationRow() {
+  uint8_t* destination =
+      static_cast<uint8_t*>(destination_.writable_addr(0, destination_row_));
+  const float* current = current_row_.data();
+  const size_t count = current_row_.size();
+  for (size_t i = 0; i < count; i++) {
+    const float value = current[i] * normalization_ + 0.5f;
+    destination[i] =
+        static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f));
+  }
+}
+
+}  // namespace flutter
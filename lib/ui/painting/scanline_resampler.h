@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_SCANLINE_RESAMPLER_H_
+#define FLUTTER_LIB_UI_PAINTING_SCANLINE_RESAMPLER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+/// @brief  Downscales an image while it is being decoded, one source row at a
+///         time, into a destination pixmap. Each destination pixel is the
+///         average of the source pixels it covers (a box filter), so that no
+///         full sized copy of the decoded image is ever needed.
+///
+///         Rows are filtered horizontally in fixed point as they arrive and
+///         accumulated into the destination row they contribute to, so only
+///         two destination rows are held at a time. The inner loops are
+///         branch free over the channels of a row so that the compiler can
+///         vectorize them.
+class ScanlineResampler {
+ public:
+  /// @brief      Whether rows of the given size can be resampled into
+  ///             `destination`. The destination must be 32 bits per pixel and
+  ///             must not be larger than the source in either dimension.
+  static bool CanResample(const SkISize& source_dimensions,
+                          const SkImageInfo& destination);
+
+  /// @param[in]  source_dimensions  The size of the decoded image.
+  /// @param[in]  destination        Where the resampled image is written. It
+  ///                                must satisfy `CanResample`.
+  ScanlineResampler(const SkISize& source_dimensions,
+                    const SkPixmap& destination);
+
+  ~ScanlineResampler();
+
+  /// @brief      Adds the next source row, top to bottom. The row holds
+  ///             `source_dimensions.width()` pixels in the color type and
+  ///             alpha type of the destination.
+  void AddRow(const void* row);
+
+  /// @brief      Whether every source row has been added, and so every row of
+  ///             the destination has been written.
+  bool IsComplete() const;
+
+ private:
+  // Where a source pixel lands along one axis. The source pixel contributes
+  // `weight` of itself to destination pixel `index`, and the rest to
+  // `index + 1`.
+  struct RowContribution {
+    int index;
+    float weight;
+  };
+
+  // As above, with the weight in fixed point so that rows can be filtered
+  // horizontally with integer arithmetic.
+  struct ColumnContribution {
+    int index;
+    uint32_t weight;
+  };
+
+  const SkISize source_dimensions_;
+  const SkPixmap destination_;
+  const float normalization_;
+  std::vector<ColumnContribution> columns_;
+  std::vector<RowContribution> rows_;
+  // The source row being added, filtered horizontally.
+  std::vector<uint32_t> filtered_row_;
+  // Accumulated channels of the destination row being produced and the one
+  // below it.
+  std::vector<float> current_row_;
+  std::vector<float> next_row_;
+  int source_row_ = 0;
+  int destination_row_ = 0;
+
+  void FilterRow(const uint8_t* row);
+
+  void WriteDestinationRow();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ScanlineResampler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_SCANLINE_RESAMPLER_H_
@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/scanline_resampler.h"
+
+#include <algorithm>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+static SkBitmap CreateNoiseBitmap(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height, true);
+  uint32_t seed = 42;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      seed = seed * 1103515245 + 12345;
+      *bitmap.getAddr32(x, y) = 0xFF000000 | (seed >> 8);
+    }
+  }
+  return bitmap;
+}
+
+static SkBitmap Resample(const SkBitmap& source, int width, int height) {
+  SkBitmap destination;
+  destination.allocPixels(source.info().makeWH(width, height));
+  ScanlineResampler resampler(source.dimensions(), destination.pixmap());
+  for (int y = 0; y < source.height(); y++) {
+    EXPECT_FALSE(resampler.IsComplete());
+    resampler.AddRow(source.getAddr32(0, y));
+  }
+  EXPECT_TRUE(resampler.IsComplete());
+  return destination;
+}
+
+// The exact average of the source pixels covered by a destination pixel.
+static double AreaAverage(const SkBitmap& source,
+                          int width,
+                          int height,
+                          int x,
+                          int y,
+                          int channel) {
+  const double scale_x = static_cast<double>(source.width()) / width;
+  const double scale_y = static_cast<double>(source.height()) / height;
+  const double left = x * scale_x, right = (x + 1) * scale_x;
+  const double top = y * scale_y, bottom = (y + 1) * scale_y;
+  double sum = 0;
+  for (int source_y = static_cast<int>(top); source_y < bottom; source_y++) {
+    for (int source_x = static_cast<int>(left); source_x < right; source_x++) {
+      const double coverage =
+          (std::min<double>(source_x + 1, right) -
+           std::max<double>(source_x, left)) *
+          (std::min<double>(source_y + 1, bottom) -
+           std::max<double>(source_y, top));
+      const uint32_t pixel = *source.getAddr32(source_x, source_y);
+      sum += coverage * ((pixel >> (channel * 8)) & 0xFF);
+    }
+  }
+  return sum / (scale_x * scale_y);
+}
+
+TEST(ScanlineResamplerTest, CanResampleOnlyDownscales) {
+  const SkISize source = SkISize::Make(100, 50);
+  EXPECT_TRUE(ScanlineResampler::CanResample(
+      source, SkImageInfo::MakeN32Premul(100, 50)));
+  EXPECT_TRUE(ScanlineResampler::CanResample(
+      source, SkImageInfo::MakeN32Premul(1, 1)));
+  EXPECT_FALSE(ScanlineResampler::CanResample(
+      source, SkImageInfo::MakeN32Premul(101, 50)));
+  EXPECT_FALSE(ScanlineResampler::CanResample(
+      source, SkImageInfo::MakeN32Premul(100, 51)));
+  EXPECT_FALSE(ScanlineResampler::CanResample(
+      source, SkImageInfo::MakeA8(50, 25)));
+}
+
+TEST(ScanlineResamplerTest, PreservesImageOfSameSize) {
+  SkBitmap source = CreateNoiseBitmap(37, 23);
+  SkBitmap destination = Resample(source, 37, 23);
+  for (int y = 0; y < source.height(); y++) {
+    for (int x = 0; x < source.width(); x++) {
+      ASSERT_EQ(*destination.getAddr32(x, y), *source.getAddr32(x, y));
+    }
+  }
+}
+
+TEST(ScanlineResamplerTest, AveragesCoveredSourcePixels) {
+  SkBitmap source = CreateNoiseBitmap(97, 61);
+  for (SkISize size : {SkISize::Make(48, 30), SkISize::Make(13, 61),
+                       SkISize::Make(97, 7), SkISize::Make(1, 1)}) {
+    SkBitmap destination = Resample(source, size.width(), size.height());
+    for (int y = 0; y < size.height(); y++) {
+      for (int x = 0; x < size.width(); x++) {
+        const uint32_t pixel = *destination.getAddr32(x, y);
+        for (int channel = 0; channel < 4; channel++) {
+          const double expected = AreaAverage(source, size.width(),
+                                              size.height(), x, y, channel);
+          ASSERT_NEAR((pixel >> (channel * 8)) & 0xFF, expected, 1.0)
+              << size.width() << "x" << size.height() << " at " << x << ","
+              << y;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,509 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/streaming_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/immutable_buffer.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+
+namespace flutter {
+
+namespace {
+
+// Enough bytes to hold the signature and header of every format Skia
+// decodes. Creating a codec is not attempted with fewer bytes unless the
+// stream is closed.
+constexpr size_t kMinimumHeaderBytes = 64;
+
+}  // namespace
+
+// The encoded bytes received so far. Chunks that the codec has consumed can be
+// discarded, in which case |base_offset_| records how many bytes were dropped
+// from the front.
+class StreamingImageDecoder::Buffer {
+ public:
+  void Append(sk_sp<SkData> data) {
+    std::scoped_lock lock(mutex_);
+    size_ += data->size();
+    chunks_.push_back(std::move(data));
+  }
+
+  void Close() {
+    std::scoped_lock lock(mutex_);
+    closed_ = true;
+  }
+
+  bool closed() const {
+    std::scoped_lock lock(mutex_);
+    return closed_;
+  }
+
+  // The total number of bytes appended, including discarded ones.
+  size_t size() const {
+    std::scoped_lock lock(mutex_);
+    return size_;
+  }
+
+  size_t base_offset() const {
+    std::scoped_lock lock(mutex_);
+    return base_offset_;
+  }
+
+  size_t held_bytes() const {
+    std::scoped_lock lock(mutex_);
+    return size_ - base_offset_;
+  }
+
+  // Copies up to |length| bytes starting at the absolute |offset| into |dst|,
+  // or skips them if |dst| is null. Returns the number of bytes available.
+  size_t Read(size_t offset, void* dst, size_t length) const {
+    std::scoped_lock lock(mutex_);
+    if (offset < base_offset_ || offset >= size_) {
+      return 0;
+    }
+    length = std::min(length, size_ - offset);
+    size_t chunk_start = base_offset_;
+    size_t copied = 0;
+    for (const sk_sp<SkData>& chunk : chunks_) {
+      const size_t chunk_end = chunk_start + chunk->size();
+      if (offset + copied < chunk_end) {
+        const size_t from = offset + copied - chunk_start;
+        const size_t count = std::min(length - copied, chunk->size() - from);
+        if (dst) {
+          memcpy(static_cast<uint8_t*>(dst) + copied, chunk->bytes() + from,
+                 count);
+        }
+        copied += count;
+        if (copied == length) {
+          break;
+        }
+      }
+      chunk_start = chunk_end;
+    }
+    return copied;
+  }
+
+  // Releases the chunks that end at or before the absolute |offset|.
+  void DiscardBefore(size_t offset) {
+    std::scoped_lock lock(mutex_);
+    while (!chunks_.empty() &&
+           base_offset_ + chunks_.front()->size() <= offset) {
+      base_offset_ += chunks_.front()->size();
+      chunks_.pop_front();
+    }
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<sk_sp<SkData>> chunks_;
+  size_t base_offset_ = 0;
+  size_t size_ = 0;
+  bool closed_ = false;
+};
+
+// An |SkStream| over the bytes received so far. Like the segment streams used
+// for incremental decoding elsewhere, it reports the end of the stream when it
+// has caught up with the data that has arrived; codecs that support
+// incremental decoding pick up from there once more data is appended.
+class StreamingImageDecoder::BufferStream final : public SkStream {
+ public:
+  explicit BufferStream(std::shared_ptr<Buffer> buffer)
+      : buffer_(std::move(buffer)) {}
+
+  size_t position() const { return position_; }
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    const size_t count = buffer_->Read(position_, buffer, size);
+    position_ += count;
+    return count;
+  }
+
+  // |SkStream|
+  size_t peek(void* buffer, size_t size) const override {
+    return buffer_->Read(position_, buffer, size);
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override { return position_ >= buffer_->size(); }
+
+  // |SkStream|
+  bool rewind() override {
+    if (buffer_->base_offset() != 0) {
+      return false;
+    }
+    position_ = 0;
+    return true;
+  }
+
+ private:
+  const std::shared_ptr<Buffer> buffer_;
+  size_t position_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BufferStream);
+};
+
+StreamingImageDecoder::StreamingImageDecoder()
+    : buffer_(std::make_shared<Buffer>()) {}
+
+StreamingImageDecoder::~StreamingImageDecoder() = default;
+
+void StreamingImageDecoder::AddData(sk_sp<SkData> data) {
+  if (data && data->size() > 0) {
+    buffer_->Append(std::move(data));
+  }
+}
+
+void StreamingImageDecoder::Close() {
+  buffer_->Close();
+}
+
+size_t StreamingImageDecoder::GetBufferedBytes() const {
+  return buffer_->held_bytes();
+}
+
+bool StreamingImageDecoder::CreateCodec(bool closed) {
+  if (!closed && buffer_->size() < kMinimumHeaderBytes) {
+    return false;
+  }
+
+  auto stream = std::make_unique<BufferStream>(buffer_);
+  BufferStream* stream_pointer = stream.get();
+  SkCodec::Result result;
+  std::unique_ptr<SkCodec> codec =
+      SkCodec::MakeFromStream(std::move(stream), &result);
+  if (!codec) {
+    // The header may not have arrived yet. Try again with more data.
+    if (result != SkCodec::kIncompleteInput || closed) {
+      status_ = Status::kFailed;
+    }
+    return false;
+  }
+
+  // Decode into a premultiplied bitmap even for opaque images so that the
+  // rows that have not been decoded yet are transparent.
+  const SkImageInfo info = codec->getInfo()
+                               .makeColorType(kN32_SkColorType)
+                               .makeAlphaType(kPremul_SkAlphaType);
+  if (!bitmap_.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for a streamed image of "
+                   << info.computeMinByteSize() << "B";
+    status_ = Status::kFailed;
+    return false;
+  }
+  bitmap_.eraseColor(SK_ColorTRANSPARENT);
+
+  // The PNG decoder reads its input strictly sequentially, so bytes it has
+  // consumed will never be read again.
+  discard_consumed_data_ =
+      codec->getEncodedFormat() == SkEncodedImageFormat::kPNG;
+  codec_ = std::move(codec);
+  stream_ = stream_pointer;
+  return true;
+}
+
+StreamingImageDecoder::Status StreamingImageDecoder::DecodeIncrementally(
+    bool closed) {
+  int rows_decoded = 0;
+  const SkCodec::Result result = codec_->incrementalDecode(&rows_decoded);
+  if (discard_consumed_data_) {
+    buffer_->DiscardBefore(stream_->position());
+  }
+
+  switch (result) {
+    case SkCodec::kSuccess:
+      decoded_rows_ = bitmap_.height();
+      return Status::kComplete;
+    case SkCodec::kIncompleteInput:
+    case SkCodec::kErrorInInput: {
+      const bool progressed = rows_decoded > decoded_rows_;
+      decoded_rows_ = std::max(decoded_rows_, rows_decoded);
+      // Like the non-streaming decoders, a truncated image is still shown
+      // with whatever rows could be decoded.
+      if (closed || result == SkCodec::kErrorInInput) {
+        return Status::kComplete;
+      }
+      return progressed ? Status::kProgress : Status::kNeedMoreData;
+    }
+    default:
+      return Status::kFailed;
+  }
+}
+
+StreamingImageDecoder::Status StreamingImageDecoder::Decode() {
+  if (status_ == Status::kComplete || status_ == Status::kFailed) {
+    return status_;
+  }
+
+  // Sample the closed state first so that no data appended before the buffer
+  // was closed can be missed below.
+  const bool closed = buffer_->closed();
+
+  if (!codec_ && !CreateCodec(closed)) {
+    if (status_ != Status::kFailed && closed) {
+      status_ = Status::kFailed;
+    }
+    return status_;
+  }
+
+  if (!started_) {
+    const SkCodec::Result result = codec_->startIncrementalDecode(
+        bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+    switch (result) {
+      case SkCodec::kSuccess:
+        started_ = true;
+        incremental_ = true;
+        break;
+      case SkCodec::kIncompleteInput:
+        // The first frame has not been located in the data yet.
+        if (!closed) {
+          return Status::kNeedMoreData;
+        }
+        status_ = Status::kFailed;
+        return status_;
+      default:
+        // This codec cannot decode incrementally. Decode once all the data
+        // has arrived.
+        started_ = true;
+        incremental_ = false;
+        break;
+    }
+  }
+
+  if (incremental_) {
+    status_ = DecodeIncrementally(closed);
+    return status_;
+  }
+
+  if (!closed) {
+    return Status::kNeedMoreData;
+  }
+  const SkCodec::Result result = codec_->getPixels(
+      bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+  if (result == SkCodec::kSuccess || result == SkCodec::kIncompleteInput ||
+      result == SkCodec::kErrorInInput) {
+    decoded_rows_ = bitmap_.height();
+    status_ = Status::kComplete;
+  } else {
+    status_ = Status::kFailed;
+  }
+  return status_;
+}
+
+static void StreamingCodec_constructor(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  DartCallConstructor(&StreamingCodec::Create, args);
+}
+
+#define FOR_EACH_BINDING(V)    \
+  V(StreamingCodec, addChunk) \
+  V(StreamingCodec, close)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void StreamingCodec::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register(
+      {{"StreamingCodec_constructor", StreamingCodec_constructor, 1, true},
+       FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<StreamingCodec> StreamingCodec::Create() {
+  return fml::MakeRefCounted<StreamingCodec>();
+}
+
+StreamingCodec::StreamingCodec() {
+  auto* dart_state = UIDartState::Current();
+  const auto& task_runners = dart_state->GetTaskRunners();
+  io_task_runner_ = task_runners.GetIOTaskRunner();
+  state_ = std::make_shared<State>(task_runners.GetUITaskRunner(),
+                                   dart_state->GetIOManager());
+}
+
+StreamingCodec::~StreamingCodec() = default;
+
+int StreamingCodec::frameCount() const {
+  return 1;
+}
+
+int StreamingCodec::repetitionCount() const {
+  return 0;
+}
+
+void StreamingCodec::addChunk(tonic::Uint8List& chunk) {  // NOLINT
+  state_->decoder_.AddData(
+      ImmutableBuffer::MakeSkDataWithCopy(chunk.data(), chunk.num_elements()));
+  chunk.Release();
+  PumpOnIOTaskRunner();
+}
+
+void StreamingCodec::close() {
+  state_->decoder_.Close();
+  PumpOnIOTaskRunner();
+}
+
+void StreamingCodec::PumpOnIOTaskRunner() {
+  io_task_runner_->PostTask(
+      [weak_state = std::weak_ptr<State>(state_)]() {
+        if (auto state = weak_state.lock()) {
+          state->Pump();
+        }
+      });
+}
+
+Dart_Handle StreamingCodec::getNextFrame(Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+
+  io_task_runner_->PostTask(fml::MakeCopyable(
+      [callback = std::make_unique<DartPersistentValue>(
+           tonic::DartState::Current(), callback_handle),
+       weak_state = std::weak_ptr<State>(state_),
+       ui_task_runner = state_->ui_task_runner_]() mutable {
+        auto state = weak_state.lock();
+        if (!state) {
+          ui_task_runner->PostTask(fml::MakeCopyable(
+              [callback = std::move(callback)]() { callback->Clear(); }));
+          return;
+        }
+        state->RequestFrame(std::move(callback));
+      }));
+
+  return Dart_Null();
+}
+
+StreamingCodec::State::State(fml::RefPtr<fml::TaskRunner> ui_task_runner,
+                             fml::WeakPtr<IOManager> io_manager)
+    : ui_task_runner_(std::move(ui_task_runner)),
+      io_manager_(std::move(io_manager)) {}
+
+StreamingCodec::State::~State() {
+  // Persistent handles must be released on the UI task runner.
+  if (!pending_callbacks_.empty()) {
+    ui_task_runner_->PostTask(
+        fml::MakeCopyable([callbacks = std::move(pending_callbacks_)]() {
+          for (const auto& callback : callbacks) {
+            callback->Clear();
+          }
+        }));
+  }
+}
+
+void StreamingCodec::State::Pump() {
+  TRACE_EVENT0("flutter", "StreamingCodec::Pump");
+  decoder_.Decode();
+  DeliverFrameIfReady();
+}
+
+void StreamingCodec::State::RequestFrame(
+    std::unique_ptr<DartPersistentValue> callback) {
+  pending_callbacks_.push_back(std::move(callback));
+  DeliverFrameIfReady();
+}
+
+static sk_sp<SkImage> UploadFrame(
+    const SkBitmap& bitmap,
+    bool is_final,
+    fml::WeakPtr<GrDirectContext> resource_context,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch) {
+  sk_sp<SkImage> result;
+  // The decoder keeps writing into the bitmap until the image is complete, so
+  // intermediate frames take a snapshot of its pixels.
+  auto make_raster_image = [&bitmap, is_final]() {
+    return is_final ? SkImage::MakeFromBitmap(bitmap)
+                    : SkImage::MakeRasterCopy(bitmap.pixmap());
+  };
+  gpu_disable_sync_switch->Execute(
+      fml::SyncSwitch::Handlers()
+          .SetIfTrue([&result, &make_raster_image] {
+            // Defer the upload until the image is drawn on the raster
+            // thread, as GL operations are currently forbidden.
+            result = make_raster_image();
+          })
+          .SetIfFalse([&result, &resource_context, &bitmap,
+                       &make_raster_image] {
+            if (resource_context) {
+              result = SkImage::MakeCrossContextFromPixmap(
+                  resource_context.get(), bitmap.pixmap(), true);
+            } else {
+              result = make_raster_image();
+            }
+          }));
+  return result;
+}
+
+void StreamingCodec::State::DeliverFrameIfReady() {
+  if (pending_callbacks_.empty() || !io_manager_) {
+    return;
+  }
+
+  sk_sp<SkImage> image;
+  switch (decoder_.Decode()) {
+    case StreamingImageDecoder::Status::kFailed:
+      break;
+    case StreamingImageDecoder::Status::kComplete:
+      if (!final_image_) {
+        TRACE_EVENT0("flutter", "StreamingCodec::UploadFinalFrame");
+        final_image_ = UploadFrame(decoder_.bitmap(), true,
+                                   io_manager_->GetResourceContext(),
+                                   io_manager_->GetIsGpuDisabledSyncSwitch());
+      }
+      image = final_image_;
+      break;
+    case StreamingImageDecoder::Status::kProgress:
+    case StreamingImageDecoder::Status::kNeedMoreData:
+      if (decoder_.decoded_rows() <= delivered_rows_) {
+        // Wait until more of the image has been decoded.
+        return;
+      }
+      TRACE_EVENT0("flutter", "StreamingCodec::UploadPartialFrame");
+      image = UploadFrame(decoder_.bitmap(), false,
+                          io_manager_->GetResourceContext(),
+                          io_manager_->GetIsGpuDisabledSyncSwitch());
+      break;
+  }
+  delivered_rows_ = decoder_.decoded_rows();
+
+  fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue =
+      io_manager_->GetSkiaUnrefQueue();
+  std::vector<std::unique_ptr<DartPersistentValue>> callbacks;
+  callbacks.swap(pending_callbacks_);
+  ui_task_runner_->PostTask(fml::MakeCopyable(
+      [callbacks = std::move(callbacks), image = std::move(image),
+       unref_queue = std::move(unref_queue)]() mutable {
+        for (auto& callback : callbacks) {
+          std::shared_ptr<tonic::DartState> dart_state =
+              callback->dart_state().lock();
+          if (!dart_state) {
+            FML_DLOG(ERROR) << "Could not acquire Dart state while attempting "
+                               "to fire next frame callback.";
+            return;
+          }
+          tonic::DartState::Scope scope(dart_state);
+          fml::RefPtr<CanvasImage> canvas_image;
+          if (image) {
+            canvas_image = CanvasImage::Create();
+            canvas_image->set_image({image, unref_queue});
+          }
+          tonic::DartInvoke(callback->value(),
+                            {tonic::ToDart(canvas_image), tonic::ToDart(0)});
+        }
+      }));
+}
+
+}  // namespace flutter
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_STREAMING_CODEC_H_
+#define FLUTTER_LIB_UI_PAINTING_STREAMING_CODEC_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/codec.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/tonic/typed_data/typed_list.h"
+
+namespace flutter {
+
+/// @brief  Decodes an encoded image while its bytes are still arriving.
+///
+///         Encoded data is appended with `AddData` from any thread and
+///         decoded with `Decode`, which must always be called from the same
+///         thread. Codecs that support incremental decoding (PNG, including
+///         interlaced passes, and the first frame of GIF) make the decoded
+///         rows available as data arrives. For PNG the encoded bytes are
+///         released as soon as the codec has consumed them, so peak memory
+///         is bounded by the size of the decoded image. Other formats are
+///         buffered and decoded once `Close` has been called.
+class StreamingImageDecoder {
+ public:
+  enum class Status {
+    // Nothing new was decoded. Waiting for more data.
+    kNeedMoreData,
+    // More rows of the image were decoded.
+    kProgress,
+    // The image is fully decoded, or the data ended early and the rows that
+    // could be decoded are final.
+    kComplete,
+    // The data could not be decoded.
+    kFailed,
+  };
+
+  StreamingImageDecoder();
+
+  ~StreamingImageDecoder();
+
+  /// Appends encoded bytes. Thread safe.
+  void AddData(sk_sp<SkData> data);
+
+  /// Signals that no more data will be added. Thread safe.
+  void Close();
+
+  /// Decodes as much of the data that has arrived so far as possible.
+  Status Decode();
+
+  /// The number of rows, from the top, that hold decoded pixels. Rows below
+  /// are transparent.
+  int decoded_rows() const { return decoded_rows_; }
+
+  /// The bitmap the image is decoded into. Empty until the image header has
+  /// arrived.
+  const SkBitmap& bitmap() const { return bitmap_; }
+
+  /// The number of encoded bytes that have arrived and are still held.
+  size_t GetBufferedBytes() const;
+
+ private:
+  class Buffer;
+  class BufferStream;
+
+  std::shared_ptr<Buffer> buffer_;
+  std::unique_ptr<SkCodec> codec_;
+  // Owned by codec_.
+  BufferStream* stream_ = nullptr;
+  SkBitmap bitmap_;
+  bool started_ = false;
+  bool incremental_ = false;
+  bool discard_consumed_data_ = false;
+  int decoded_rows_ = 0;
+  Status status_ = Status::kNeedMoreData;
+
+  bool CreateCodec(bool closed);
+
+  Status DecodeIncrementally(bool closed);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StreamingImageDecoder);
+};
+
+/// @brief  A `Codec` fed with encoded data from Dart as it arrives. Each call
+///         to `getNextFrame` completes with the image decoded so far, once
+///         more of it has been decoded than was returned by the previous call.
+class StreamingCodec : public Codec {
+ public:
+  ~StreamingCodec() override;
+
+  static fml::RefPtr<StreamingCodec> Create();
+
+  // |Codec|
+  int frameCount() const override;
+
+  // |Codec|
+  int repetitionCount() const override;
+
+  // |Codec|
+  Dart_Handle getNextFrame(Dart_Handle callback_handle) override;
+
+  void addChunk(tonic::Uint8List& chunk);  // NOLINT
+
+  void close();
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  // Shared between the UI and IO task runners. See `MultiFrameCodec::State`.
+  struct State {
+    State(fml::RefPtr<fml::TaskRunner> ui_task_runner,
+          fml::WeakPtr<IOManager> io_manager);
+
+    ~State();
+
+    const fml::RefPtr<fml::TaskRunner> ui_task_runner_;
+    const fml::WeakPtr<IOManager> io_manager_;
+    StreamingImageDecoder decoder_;
+
+    // The members and functions below here are only accessed on the IO task
+    // runner.
+    int delivered_rows_ = 0;
+    sk_sp<SkImage> final_image_;
+    std::vector<std::unique_ptr<DartPersistentValue>> pending_callbacks_;
+
+    void Pump();
+
+    void RequestFrame(std::unique_ptr<DartPersistentValue> callback);
+
+    void DeliverFrameIfReady();
+  };
+
+  StreamingCodec();
+
+  // Posts a task that decodes the data that arrived so far.
+  void PumpOnIOTaskRunner();
+
+  std::shared_ptr<State> state_;
+  fml::RefPtr<fml::TaskRunner> io_task_runner_;
+
+  FML_FRIEND_MAKE_REF_COUNTED(StreamingCodec);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(StreamingCodec);
+  FML_DISALLOW_COPY_AND_ASSIGN(StreamingCodec);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_STREAMING_CODEC_H_
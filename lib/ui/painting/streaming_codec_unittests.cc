@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/streaming_codec.h"
+
+#include <algorithm>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<SkData> OpenFixtureAsCopiedSkData(const char* name) {
+  auto mapping = OpenFixtureAsMapping(name);
+  if (!mapping) {
+    return nullptr;
+  }
+  return SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+}
+
+static SkBitmap DecodeAtOnce(const sk_sp<SkData>& data) {
+  std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+  SkBitmap bitmap;
+  if (!codec) {
+    return bitmap;
+  }
+  const SkImageInfo info = codec->getInfo()
+                               .makeColorType(kN32_SkColorType)
+                               .makeAlphaType(kPremul_SkAlphaType);
+  bitmap.allocPixels(info);
+  codec->getPixels(info, bitmap.getPixels(), bitmap.rowBytes());
+  return bitmap;
+}
+
+static bool PixelsMatch(const SkBitmap& a, const SkBitmap& b) {
+  if (a.width() != b.width() || a.height() != b.height()) {
+    return false;
+  }
+  for (int y = 0; y < a.height(); y++) {
+    for (int x = 0; x < a.width(); x++) {
+      if (a.getColor(x, y) != b.getColor(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(StreamingImageDecoderTest, DecodesPNGProgressively) {
+  sk_sp<SkData> data = OpenFixtureAsCopiedSkData("Horizontal.png");
+  ASSERT_TRUE(data);
+
+  StreamingImageDecoder decoder;
+  const size_t chunk_size = 512;
+  int progress_count = 0;
+  int previous_rows = 0;
+  size_t max_buffered_bytes = 0;
+  StreamingImageDecoder::Status status =
+      StreamingImageDecoder::Status::kNeedMoreData;
+  for (size_t offset = 0; offset < data->size(); offset += chunk_size) {
+    const size_t size = std::min(chunk_size, data->size() - offset);
+    decoder.AddData(SkData::MakeWithCopy(data->bytes() + offset, size));
+    status = decoder.Decode();
+    ASSERT_NE(status, StreamingImageDecoder::Status::kFailed);
+    ASSERT_GE(decoder.decoded_rows(), previous_rows);
+    if (status == StreamingImageDecoder::Status::kProgress) {
+      progress_count++;
+    }
+    previous_rows = decoder.decoded_rows();
+    max_buffered_bytes =
+        std::max(max_buffered_bytes, decoder.GetBufferedBytes());
+  }
+  decoder.Close();
+  status = decoder.Decode();
+
+  EXPECT_EQ(status, StreamingImageDecoder::Status::kComplete);
+  EXPECT_GT(progress_count, 1);
+  EXPECT_EQ(decoder.decoded_rows(), decoder.bitmap().height());
+  // Consumed chunks are released while decoding.
+  EXPECT_LT(max_buffered_bytes, data->size());
+  EXPECT_TRUE(PixelsMatch(decoder.bitmap(), DecodeAtOnce(data)));
+}
+
+TEST(StreamingImageDecoderTest, DecodesNonIncrementalFormatOnClose) {
+  sk_sp<SkData> data = OpenFixtureAsCopiedSkData("Horizontal.jpg");
+  ASSERT_TRUE(data);
+
+  StreamingImageDecoder decoder;
+  const size_t half = data->size() / 2;
+  decoder.AddData(SkData::MakeWithCopy(data->bytes(), half));
+  EXPECT_EQ(decoder.Decode(), StreamingImageDecoder::Status::kNeedMoreData);
+  decoder.AddData(
+      SkData::MakeWithCopy(data->bytes() + half, data->size() - half));
+  EXPECT_EQ(decoder.Decode(), StreamingImageDecoder::Status::kNeedMoreData);
+  EXPECT_EQ(decoder.decoded_rows(), 0);
+
+  decoder.Close();
+  EXPECT_EQ(decoder.Decode(), StreamingImageDecoder::Status::kComplete);
+  EXPECT_EQ(decoder.decoded_rows(), decoder.bitmap().height());
+  EXPECT_TRUE(PixelsMatch(decoder.bitmap(), DecodeAtOnce(data)));
+}
+
+TEST(StreamingImageDecoderTest, FailsOnInvalidData) {
+  StreamingImageDecoder decoder;
+  const char garbage[] = "This is not an image, just some text to decode.";
+  decoder.AddData(SkData::MakeWithCopy(garbage, sizeof(garbage)));
+  EXPECT_EQ(decoder.Decode(), StreamingImageDecoder::Status::kNeedMoreData);
+  decoder.Close();
+  EXPECT_EQ(decoder.Decode(), StreamingImageDecoder::Status::kFailed);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,9 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/image_descriptor.h"
+#include "flutter/lib/ui/painting/png_encoder.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -19,7 +22,10 @@ class Fixture : public testing::FixtureTest {
   void TestBody() override{};
 };
 
-static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
+// Completes responses of 3 MB with data that Dart has to copy, or with data
+// that it takes over.
+static void BM_PlatformMessageResponseDartComplete(benchmark::State& state,
+                                                   bool handed_over) {
   ThreadHost thread_host("test",
                          ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
                              ThreadHost::Type::IO | ThreadHost::Type::UI);
@@ -34,13 +40,20 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
       testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
                                     testing::GetDefaultKernelFilePath(), {});
 
+  // Read-only data, which outlives the responses that refer to it.
+  const std::vector<uint8_t> shared_data(3 << 20, 0);
+
   while (state.KeepRunning()) {
     state.PauseTiming();
     bool successful = isolate->RunInIsolateScope([&]() -> bool {
-      // Simulate a message of 3 MB
-      std::vector<uint8_t> data(3 << 20, 0);
-      std::unique_ptr<fml::Mapping> mapping =
-          std::make_unique<fml::DataMapping>(data);
+      std::unique_ptr<fml::Mapping> mapping;
+      if (handed_over) {
+        mapping = std::make_unique<fml::DataMapping>(
+            std::vector<uint8_t>(3 << 20, 0));
+      } else {
+        mapping = std::make_unique<fml::NonOwnedMapping>(shared_data.data(),
+                                                         shared_data.size());
+      }
 
       Dart_Handle library = Dart_RootLibrary();
       Dart_Handle closure =
@@ -57,9 +70,9 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
     FML_CHECK(successful);
     state.ResumeTiming();
 
-    // We skip timing everything above because the copy triggered by
-    // message->Complete is a task posted on the UI thread. The following wait
-    // for a UI task would let us know when that copy is done.
+    // We skip timing everything above because the copy or handover triggered
+    // by message->Complete is a task posted on the UI thread. The following
+    // wait for a UI task would let us know when that task is done.
     std::promise<bool> completed;
     task_runners.GetUITaskRunner()->PostTask(
         [&completed] { completed.set_value(true); });
@@ -112,7 +125,124 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_PlatformMessageResponseDartComplete)
+// A 4000x3000 camera sized photo, encoded in the given format.
+static sk_sp<SkData> CreateLargeEncodedImage(SkEncodedImageFormat format) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(4000, 3000, true);
+  uint32_t seed = 1;
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      // Smooth gradients with some noise, so that the encoded size is closer
+      // to that of a photo than of a flat color.
+      seed = seed * 1103515245 + 12345;
+      const int noise = (seed >> 16) & 0xF;
+      *bitmap.getAddr32(x, y) =
+          SkPreMultiplyARGB(0xFF, (x * 255 / bitmap.width()) ^ noise,
+                            (y * 255 / bitmap.height()) ^ noise, noise * 8);
+    }
+  }
+  return SkImage::MakeFromBitmap(bitmap)->encodeToData(format, 90);
+}
+
+static void BM_ImageFromCompressedDataThumbnail(benchmark::State& state,
+                                                SkEncodedImageFormat format) {
+  sk_sp<SkData> data = CreateLargeEncodedImage(format);
+  ImageGeneratorRegistry registry;
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+      data, registry.CreateCompatibleGenerator(data));
+
+  while (state.KeepRunning()) {
+    sk_sp<SkImage> image = ImageFromCompressedData(
+        descriptor.get(), 320, 240, fml::tracing::TraceFlow(""));
+    FML_CHECK(image && image->width() == 320);
+  }
+}
+
+// The previous pipeline, for comparison: a full resolution decode followed
+// by a separate resize.
+static void BM_DecodeThenScalePixelsThumbnail(benchmark::State& state,
+                                              SkEncodedImageFormat format) {
+  sk_sp<SkData> data = CreateLargeEncodedImage(format);
+  ImageGeneratorRegistry registry;
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+      data, registry.CreateCompatibleGenerator(data));
+
+  while (state.KeepRunning()) {
+    sk_sp<SkImage> image = descriptor->image();
+    SkBitmap scaled;
+    scaled.allocPixels(image->imageInfo().makeWH(320, 240));
+    FML_CHECK(image->scalePixels(
+        scaled.pixmap(),
+        SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone),
+        SkImage::kDisallow_CachingHint));
+  }
+}
+
+// A 1080x1920 screenshot: flat colors with some sharp edges.
+static SkBitmap CreateScreenshotBitmap() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1080, 1920, true);
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      const bool text = (y / 24) % 3 == 1 && ((x * 7 + y * 3) % 11) < 4;
+      *bitmap.getAddr32(x, y) =
+          text ? SkPreMultiplyARGB(0xFF, 0x20, 0x20, 0x20)
+               : SkPreMultiplyARGB(0xFF, 0xF0, 0xF0 - y / 16, 0xFF);
+    }
+  }
+  return bitmap;
+}
+
+static void BM_EncodePngWithSkia(benchmark::State& state) {
+  sk_sp<SkImage> image = SkImage::MakeFromBitmap(CreateScreenshotBitmap());
+  while (state.KeepRunning()) {
+    FML_CHECK(image->encodeToData(SkEncodedImageFormat::kPNG, 0));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          image->imageInfo().computeMinByteSize());
+}
+
+static void BM_EncodePngInParallel(benchmark::State& state, bool fast) {
+  SkBitmap bitmap = CreateScreenshotBitmap();
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  PngEncodingOptions options;
+  if (fast) {
+    options.compression_level = 1;
+    options.adaptive_filtering = false;
+  }
+  while (state.KeepRunning()) {
+    FML_CHECK(EncodePngInParallel(bitmap.pixmap(), options,
+                                  loop->GetTaskRunner()));
+  }
+  state.SetBytesProcessed(state.iterations() * bitmap.computeByteSize());
+}
+
+BENCHMARK_CAPTURE(BM_ImageFromCompressedDataThumbnail,
+                  jpeg,
+                  SkEncodedImageFormat::kJPEG)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ImageFromCompressedDataThumbnail,
+                  png,
+                  SkEncodedImageFormat::kPNG)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeThenScalePixelsThumbnail,
+                  jpeg,
+                  SkEncodedImageFormat::kJPEG)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeThenScalePixelsThumbnail,
+                  png,
+                  SkEncodedImageFormat::kPNG)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_EncodePngWithSkia)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodePngInParallel, adaptive, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodePngInParallel, fast, true)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_PlatformMessageResponseDartComplete, copied, false)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PlatformMessageResponseDartComplete, handed_over, true)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
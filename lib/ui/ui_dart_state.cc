@@ -57,6 +57,8 @@ UIDartState::UIDartState(
     bool is_root_isolate,
     bool enable_skparagraph,
     bool enable_display_list,
+    int animated_image_lookahead_frames,
+    size_t animated_image_frame_cache_max_bytes,
     const UIDartState::Context& context)
     : add_callback_(std::move(add_callback)),
       remove_callback_(std::move(remove_callback)),
@@ -67,6 +69,9 @@ UIDartState::UIDartState(
       isolate_name_server_(std::move(isolate_name_server)),
       enable_skparagraph_(enable_skparagraph),
       enable_display_list_(enable_display_list),
+      animated_image_lookahead_frames_(animated_image_lookahead_frames),
+      animated_image_frame_cache_max_bytes_(
+          animated_image_frame_cache_max_bytes),
       context_(std::move(context)) {
   AddOrRemoveTaskObserver(true /* add */);
 }
@@ -244,4 +249,12 @@ bool UIDartState::enable_display_list() const {
   return enable_display_list_;
 }
 
+int UIDartState::animated_image_lookahead_frames() const {
+  return animated_image_lookahead_frames_;
+}
+
+size_t UIDartState::animated_image_frame_cache_max_bytes() const {
+  return animated_image_frame_cache_max_bytes_;
+}
+
 }  // namespace flutter
@@ -145,6 +145,10 @@ class UIDartState : public tonic::DartState {
 
   bool enable_display_list() const;
 
+  int animated_image_lookahead_frames() const;
+
+  size_t animated_image_frame_cache_max_bytes() const;
+
   template <class T>
   static flutter::SkiaGPUObject<T> CreateGPUObject(sk_sp<T> object) {
     if (!object) {
@@ -166,6 +170,8 @@ class UIDartState : public tonic::DartState {
               bool is_root_isolate_,
               bool enable_skparagraph,
               bool enable_display_list,
+              int animated_image_lookahead_frames,
+              size_t animated_image_frame_cache_max_bytes,
               const UIDartState::Context& context);
 
   ~UIDartState() override;
@@ -193,6 +199,8 @@ class UIDartState : public tonic::DartState {
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
   const bool enable_skparagraph_;
   const bool enable_display_list_;
+  const int animated_image_lookahead_frames_;
+  const size_t animated_image_frame_cache_max_bytes_;
   UIDartState::Context context_;
 
   void AddOrRemoveTaskObserver(bool add);
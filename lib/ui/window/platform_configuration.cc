@@ -181,10 +181,6 @@ void GetPersistentIsolateData(Dart_NativeArguments args) {
                                         persistent_isolate_data->GetSize()));
 }
 
-Dart_Handle ToByteData(const fml::Mapping& buffer) {
-  return tonic::DartByteData::Create(buffer.GetMapping(), buffer.GetSize());
-}
-
 }  // namespace
 
 PlatformConfigurationClient::~PlatformConfigurationClient() {}
@@ -307,8 +303,12 @@ void PlatformConfiguration::DispatchPlatformMessage(
     return;
   }
   tonic::DartState::Scope scope(dart_state);
+  // The message is not used after this, so Dart can take over its data.
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      (message->hasData())
+          ? WrapByteData(
+                std::make_unique<fml::MallocMapping>(message->releaseData()))
+          : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -339,7 +339,9 @@ void PlatformConfiguration::DispatchSemanticsAction(int32_t id,
   tonic::DartState::Scope scope(dart_state);
 
   Dart_Handle args_handle =
-      (args.GetSize() <= 0) ? Dart_Null() : ToByteData(args);
+      (args.GetSize() <= 0)
+          ? Dart_Null()
+          : WrapByteData(std::make_unique<fml::MallocMapping>(std::move(args)));
 
   if (Dart_IsError(args_handle)) {
     return;
@@ -14,6 +14,33 @@
 
 namespace flutter {
 
+namespace {
+
+// Like |tonic::DartByteData|, which copies smaller data into the Dart heap.
+constexpr size_t kExternalSizeThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data, void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+}  // namespace
+
+Dart_Handle WrapByteData(std::unique_ptr<fml::Mapping> data) {
+  uint8_t* bytes = data->GetMutableMapping();
+  const size_t length = data->GetSize();
+  if (bytes == nullptr || length < kExternalSizeThreshold) {
+    return tonic::DartByteData::Create(data->GetMapping(), length);
+  }
+  void* peer = reinterpret_cast<void*>(data.release());
+  Dart_Handle handle = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, length, peer, length, FinalizeMapping);
+  if (Dart_IsError(handle)) {
+    // The finalizer is only attached to the typed data once it exists.
+    FinalizeMapping(nullptr, peer);
+  }
+  return handle;
+}
+
 PlatformMessageResponseDart::PlatformMessageResponseDart(
     tonic::DartPersistentValue callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner)
@@ -42,8 +69,7 @@ void PlatformMessageResponseDart::Complete(std::unique_ptr<fml::Mapping> data) {
         }
         tonic::DartState::Scope scope(dart_state);
 
-        Dart_Handle byte_buffer =
-            tonic::DartByteData::Create(data->GetMapping(), data->GetSize());
+        Dart_Handle byte_buffer = WrapByteData(std::move(data));
         tonic::DartInvoke(callback.Release(), {byte_buffer});
       }));
 }
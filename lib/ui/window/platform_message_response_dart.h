@@ -11,6 +11,17 @@
 
 namespace flutter {
 
+//------------------------------------------------------------------------------
+/// @brief      Creates a ByteData with the contents of `data` for the current
+///             isolate.
+///
+///             If the owner of `data` may write to it and it is large enough
+///             to be kept outside the Dart heap, Dart takes the memory over
+///             and the mapping is destroyed when the ByteData is collected.
+///             Otherwise the contents are copied.
+///
+Dart_Handle WrapByteData(std::unique_ptr<fml::Mapping> data);
+
 class PlatformMessageResponseDart : public PlatformMessageResponse {
   FML_FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDart);
 
@@ -428,6 +428,7 @@ enum ImageByteFormat {
   rawStraightRgba,
   rawUnmodified,
   png,
+  pngFast,
 }
 
 enum PixelFormat {
@@ -470,6 +471,22 @@ Future<Codec> instantiateImageCodec(
   }
 }
 
+Future<Codec> instantiateStreamingImageCodec(Stream<Uint8List> chunks) async {
+  final List<Uint8List> received = <Uint8List>[];
+  int length = 0;
+  await for (final Uint8List chunk in chunks) {
+    received.add(chunk);
+    length += chunk.length;
+  }
+  final Uint8List bytes = Uint8List(length);
+  int offset = 0;
+  for (final Uint8List chunk in received) {
+    bytes.setRange(offset, offset + chunk.length, chunk);
+    offset += chunk.length;
+  }
+  return instantiateImageCodec(bytes);
+}
+
 Future<Codec> webOnlyInstantiateImageCodecFromUrl(Uri uri,
   {engine.WebOnlyImageCodecChunkCallback? chunkCallback}) {
   if (engine.useCanvasKit) {
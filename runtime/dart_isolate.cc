@@ -325,6 +325,8 @@ DartIsolate::DartIsolate(const Settings& settings,
                   is_root_isolate,
                   settings.enable_skparagraph,
                   settings.enable_display_list,
+                  settings.animated_image_lookahead_frames,
+                  settings.animated_image_frame_cache_max_bytes,
                   std::move(context)),
       may_insecurely_connect_to_all_domains_(
           settings.may_insecurely_connect_to_all_domains),
@@ -259,6 +259,16 @@ bool DartSnapshot::IsDontNeedSafe() const {
   return true;
 }
 
+void DartSnapshot::PrefetchMappings() const {
+  TRACE_EVENT0("flutter", "DartSnapshot::PrefetchMappings");
+  if (data_) {
+    fml::AdviseWillNeed(*data_);
+  }
+  if (instructions_) {
+    fml::AdviseWillNeed(*instructions_);
+  }
+}
+
 bool DartSnapshot::IsNullSafetyEnabled(const fml::Mapping* kernel) const {
   return ::Dart_DetectNullSafety(
       nullptr,           // script_uri (unsupported by Flutter)
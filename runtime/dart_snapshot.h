@@ -165,6 +165,14 @@ class DartSnapshot : public fml::RefCountedThreadSafe<DartSnapshot> {
   ///             safe to use with madvise(DONTNEED).
   bool IsDontNeedSafe() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Hints to the operating system that the data and instructions
+  ///             mappings will be read soon, so that their pages are read in
+  ///             before the isolate launched from this snapshot faults on
+  ///             them.
+  ///
+  void PrefetchMappings() const;
+
   bool IsNullSafetyEnabled(
       const fml::Mapping* application_kernel_mapping) const;
 
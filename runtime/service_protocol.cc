@@ -37,6 +37,13 @@ const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
 const std::string_view
     ServiceProtocol::kEstimateRasterCacheMemoryExtensionName =
         "_flutter.estimateRasterCacheMemory";
+const std::string_view
+    ServiceProtocol::kGetSkSLPrecompilationProgressExtensionName =
+        "_flutter.getSkSLPrecompilationProgress";
+const std::string_view ServiceProtocol::kGetEngineTraceExtensionName =
+    "_flutter.getEngineTrace";
+const std::string_view ServiceProtocol::kGetNativeProfileExtensionName =
+    "_flutter.getNativeProfile";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -56,6 +63,9 @@ ServiceProtocol::ServiceProtocol()
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
+          kGetSkSLPrecompilationProgressExtensionName,
+          kGetEngineTraceExtensionName,
+          kGetNativeProfileExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
@@ -29,6 +29,9 @@ class ServiceProtocol {
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
+  static const std::string_view kGetSkSLPrecompilationProgressExtensionName;
+  static const std::string_view kGetEngineTraceExtensionName;
+  static const std::string_view kGetNativeProfileExtensionName;
 
   class Handler {
    public:
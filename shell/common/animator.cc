@@ -4,6 +4,7 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include "flutter/common/startup_timeline.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
@@ -76,6 +77,11 @@ void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
       });
 }
 
+void Animator::SetFrameRateController(
+    std::shared_ptr<FrameRateController> controller) {
+  frame_rate_controller_ = std::move(controller);
+}
+
 // This Parity is used by the timeline component to correctly align
 // GPU Workloads events with their respective Framework Workload.
 const char* Animator::FrameParity() {
@@ -100,6 +106,7 @@ void Animator::BeginFrame(
 
   frame_timings_recorder_ = std::move(frame_timings_recorder);
   frame_timings_recorder_->RecordBuildStart(fml::TimePoint::Now());
+  StartupTimeline::ScopedPhase startup_phase(StartupTimeline::kFirstBeginFrame);
 
   TRACE_EVENT_WITH_FRAME_NUMBER(frame_timings_recorder_, "flutter",
                                 "Animator::BeginFrame");
@@ -140,6 +147,12 @@ void Animator::BeginFrame(
   const fml::TimePoint frame_target_time =
       frame_timings_recorder_->GetVsyncTargetTime();
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
+  if (frame_rate_controller_ && !rendered_since_begin_frame_) {
+    // The content of the previous frame did not change, as it was not
+    // rendered.
+    frame_rate_controller_->RecordFrame(false);
+  }
+  rendered_since_begin_frame_ = false;
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
                  FrameParity());
@@ -178,6 +191,7 @@ void Animator::BeginFrame(
 
 void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
   has_rendered_ = true;
+  rendered_since_begin_frame_ = true;
   if (dimension_change_pending_ &&
       layer_tree->frame_size() != last_layer_tree_size_) {
     dimension_change_pending_ = false;
@@ -258,13 +272,19 @@ void Animator::RequestFrame(bool regenerate_layer_tree) {
 void Animator::AwaitVSync() {
   TRACE_EVENT_ASYNC_BEGIN0("flutter", "Frame Request Pending",
                            frame_request_number_);
+  WaitForVSync();
+}
 
+void Animator::WaitForVSync() {
   waiter_->AsyncWaitForVsync(
       [self = weak_factory_.GetWeakPtr()](
           std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
         if (self) {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree(std::move(frame_timings_recorder));
+          } else if (self->ShouldSkipVSync(*frame_timings_recorder)) {
+            // The frame request stays pending until the next vsync.
+            self->WaitForVSync();
           } else {
             self->BeginFrame(std::move(frame_timings_recorder));
           }
@@ -272,6 +292,30 @@ void Animator::AwaitVSync() {
       });
 }
 
+bool Animator::ShouldSkipVSync(
+    const FrameTimingsRecorder& frame_timings_recorder) {
+  // Frames that resize the content are never delayed.
+  if (!frame_rate_controller_ || dimension_change_pending_) {
+    return false;
+  }
+
+  if (!frame_rate_controller_->ShouldBeginFrame(
+          frame_timings_recorder.GetVsyncStartTime(),
+          frame_timings_recorder.GetVsyncTargetTime())) {
+    TRACE_EVENT0("flutter", "Animator::SkipVSync");
+    return true;
+  }
+
+  const double preferred_frame_rate =
+      frame_rate_controller_->GetPreferredFrameRate();
+  if (preferred_frame_rate > 0 &&
+      preferred_frame_rate != preferred_frame_rate_) {
+    preferred_frame_rate_ = preferred_frame_rate;
+    waiter_->SetPreferredFrameRate(preferred_frame_rate);
+  }
+  return false;
+}
+
 void Animator::NotifyIdle() {
   if (has_rendered_) {
     delegate_.OnAnimatorNotifyIdle(
@@ -13,6 +13,7 @@
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_rate_controller.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -83,6 +84,11 @@ class Animator final {
   // active rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  // Adapts the frame rate to how often the content changes, by skipping the
+  // vsyncs at which |controller| does not begin a frame. The preferred frame
+  // rate is reported to the vsync waiter.
+  void SetFrameRateController(std::shared_ptr<FrameRateController> controller);
+
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
 
@@ -95,6 +101,13 @@ class Animator final {
 
   void AwaitVSync();
 
+  // Arms the vsync waiter for the frame request that |AwaitVSync| started.
+  void WaitForVSync();
+
+  // Returns whether the frame that would begin at the vsync recorded in
+  // |frame_timings_recorder| is skipped by the frame rate controller.
+  bool ShouldSkipVSync(const FrameTimingsRecorder& frame_timings_recorder);
+
   void NotifyIdle();
 
   const char* FrameParity();
@@ -120,6 +133,10 @@ class Animator final {
   SkISize last_layer_tree_size_ = {0, 0};
   std::deque<uint64_t> trace_flow_ids_;
   bool has_rendered_ = false;
+  std::shared_ptr<FrameRateController> frame_rate_controller_;
+  double preferred_frame_rate_ = 0;
+  // Whether |Render| was called since the last |BeginFrame|.
+  bool rendered_since_begin_frame_ = true;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
@@ -223,5 +223,111 @@ TEST_F(ShellTest, AnimatorDoesNotNotifyIdleBeforeRender) {
   latch.Wait();
 }
 
+// Renders a frame at every begin frame and requests the next one, as running
+// animations do, and records whether the content of the frames changes.
+class AnimatingAnimatorDelegate : public Animator::Delegate {
+ public:
+  void OnAnimatorBeginFrame(fml::TimePoint frame_target_time,
+                            uint64_t frame_number) override {
+    begin_frame_count_++;
+    animator_->RequestFrame();
+    animator_->Render(
+        std::make_unique<LayerTree>(SkISize::Make(600, 800), 1.0));
+  }
+
+  void OnAnimatorNotifyIdle(int64_t deadline) override {}
+
+  void OnAnimatorDraw(
+      std::shared_ptr<Pipeline<flutter::LayerTree>> pipeline,
+      std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) override {
+    // Stands in for the rasterizer, which reports the damage of the frame.
+    auto result = pipeline->Consume([](std::unique_ptr<LayerTree>) {});
+    ASSERT_NE(result, PipelineConsumeResult::NoneAvailable);
+    frame_rate_controller_->RecordFrame(content_changes_);
+  }
+
+  void OnAnimatorDrawLastLayerTree(
+      std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) override {}
+
+  Animator* animator_ = nullptr;
+  std::shared_ptr<FrameRateController> frame_rate_controller_;
+  bool content_changes_ = false;
+  size_t begin_frame_count_ = 0;
+};
+
+TEST_F(ShellTest, AnimatorAdaptsFrameRateToContentChanges) {
+  AnimatingAnimatorDelegate delegate;
+  delegate.frame_rate_controller_ = std::make_shared<FrameRateController>();
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+
+  // A 100Hz display.
+  const auto period = fml::TimeDelta::FromMilliseconds(10);
+  SimulatedVsyncWaiter* vsync_waiter = nullptr;
+  std::unique_ptr<Animator> animator;
+  fml::AutoResetWaitableEvent latch;
+
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    auto waiter =
+        std::make_unique<SimulatedVsyncWaiter>(task_runners, period);
+    vsync_waiter = waiter.get();
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(waiter));
+    animator->SetFrameRateController(delegate.frame_rate_controller_);
+    delegate.animator_ = animator.get();
+    animator->Start();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Simulates |count| vsyncs and returns the number of frames that began.
+  auto simulate_vsyncs = [&](size_t count) {
+    size_t begin_frame_count = delegate.begin_frame_count_;
+    for (size_t i = 0; i < count; i++) {
+      task_runners.GetUITaskRunner()->PostTask([&] {
+        vsync_waiter->SimulateVSync();
+        // Runs after the vsync callback posted by the simulated vsync.
+        task_runners.GetUITaskRunner()->PostTask([&] { latch.Signal(); });
+      });
+      latch.Wait();
+    }
+    return delegate.begin_frame_count_ - begin_frame_count;
+  };
+
+  // Frames that do not change the content lower the frame rate in steps, to
+  // a frame every 4 vsyncs.
+  ASSERT_EQ(simulate_vsyncs(FrameRateController::kWindowSize), 16u);
+  ASSERT_EQ(delegate.frame_rate_controller_->GetVsyncInterval(), 2u);
+  ASSERT_EQ(simulate_vsyncs(2 * FrameRateController::kWindowSize), 16u);
+  ASSERT_EQ(delegate.frame_rate_controller_->GetVsyncInterval(), 4u);
+  ASSERT_EQ(simulate_vsyncs(40), 10u);
+  ASSERT_DOUBLE_EQ(vsync_waiter->GetPreferredFrameRate(), 25);
+
+  // User input restores the full frame rate right away.
+  delegate.frame_rate_controller_->Reset();
+  ASSERT_EQ(simulate_vsyncs(FrameRateController::kWindowSize), 16u);
+  ASSERT_DOUBLE_EQ(vsync_waiter->GetPreferredFrameRate(), 100);
+  ASSERT_EQ(delegate.frame_rate_controller_->GetVsyncInterval(), 2u);
+
+  // So does content that changes at every frame, after a few frames.
+  delegate.content_changes_ = true;
+  ASSERT_EQ(simulate_vsyncs(2 * FrameRateController::kRampUpFrames),
+            FrameRateController::kRampUpFrames);
+  ASSERT_EQ(delegate.frame_rate_controller_->GetVsyncInterval(), 1u);
+  ASSERT_EQ(simulate_vsyncs(FrameRateController::kWindowSize), 16u);
+  ASSERT_DOUBLE_EQ(vsync_waiter->GetPreferredFrameRate(), 100);
+
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    animator.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -10,7 +10,9 @@
 #include <utility>
 #include <vector>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/settings.h"
+#include "flutter/common/startup_timeline.h"
 #include "flutter/fml/eintr_wrapper.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/make_copyable.h"
@@ -30,6 +32,7 @@
 namespace flutter {
 
 static constexpr char kAssetChannel[] = "flutter/assets";
+static constexpr char kAssetPrefetchChannel[] = "flutter/assetprefetch";
 static constexpr char kLifecycleChannel[] = "flutter/lifecycle";
 static constexpr char kNavigationChannel[] = "flutter/navigation";
 static constexpr char kLocalizationChannel[] = "flutter/localization";
@@ -40,6 +43,11 @@ namespace {
 fml::MallocMapping MakeMapping(const std::string& str) {
   return fml::MallocMapping::Copy(str.c_str(), str.length());
 }
+
+// How long updates to the font fallback index are collected before it is
+// stored.
+constexpr fml::TimeDelta kFontFallbackIndexStoreDelay =
+    fml::TimeDelta::FromSeconds(1);
 }  // namespace
 
 Engine::Engine(
@@ -59,7 +67,10 @@ Engine::Engine(
       activity_running_(true),
       have_surface_(false),
       font_collection_(font_collection),
-      image_decoder_(task_runners, image_decoder_task_runner, io_manager),
+      image_decoder_(task_runners,
+                     image_decoder_task_runner,
+                     io_manager,
+                     settings_.decoded_image_cache_max_bytes > 0),
       task_runners_(std::move(task_runners)),
       weak_factory_(this) {
   pointer_data_dispatcher_ = dispatcher_maker(*this);
@@ -144,9 +155,70 @@ fml::WeakPtr<Engine> Engine::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
-void Engine::SetupDefaultFontManager() {
+void Engine::SetupDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   TRACE_EVENT0("flutter", "Engine::SetupDefaultFontManager");
-  font_collection_->SetupDefaultFontManager(settings_.font_initialization_data);
+  if (font_manager) {
+    font_collection_->GetFontCollection()->SetDefaultFontManager(
+        std::move(font_manager));
+  } else {
+    StartupTimeline::ScopedPhase phase(StartupTimeline::kFontCollectionSetup);
+    font_collection_->SetupDefaultFontManager(
+        settings_.font_initialization_data);
+  }
+  SetupFontFallbackIndex();
+}
+
+void Engine::SetupFontFallbackIndex() {
+  std::shared_ptr<txt::FontCollection> collection =
+      font_collection_->GetFontCollection();
+  if (collection->GetFallbackIndex() != nullptr) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "Engine::SetupFontFallbackIndex");
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  std::unique_ptr<txt::FontFallbackIndex> index;
+  std::unique_ptr<fml::Mapping> mapping = persistent_cache->LoadAuxiliaryFile(
+      PersistentCache::kFontFallbackIndexFileName);
+  if (mapping) {
+    index = txt::FontFallbackIndex::Deserialize(mapping->GetMapping(),
+                                                mapping->GetSize());
+  }
+  if (!index) {
+    index = std::make_unique<txt::FontFallbackIndex>();
+  }
+
+  // Font manager queries come in bursts, when text in a new script is first
+  // laid out. Store the index once after a burst rather than after every
+  // query. The collection is shared with the engines spawned from this one,
+  // so the store must not depend on this engine.
+  auto store_scheduled = std::make_shared<bool>(false);
+  std::weak_ptr<txt::FontCollection> weak_collection = collection;
+  fml::RefPtr<fml::TaskRunner> ui_task_runner = task_runners_.GetUITaskRunner();
+  collection->SetFallbackIndex(
+      std::move(index),
+      [store_scheduled, weak_collection, ui_task_runner]() {
+        if (*store_scheduled) {
+          return;
+        }
+        *store_scheduled = true;
+        ui_task_runner->PostDelayedTask(
+            [store_scheduled, weak_collection]() {
+              *store_scheduled = false;
+              std::shared_ptr<txt::FontCollection> collection =
+                  weak_collection.lock();
+              if (!collection || !collection->GetFallbackIndex()) {
+                return;
+              }
+              TRACE_EVENT0("flutter", "Engine::StoreFontFallbackIndex");
+              // The file is written by a persistent cache worker.
+              PersistentCache::GetCacheForProcess()->StoreAuxiliaryFile(
+                  PersistentCache::kFontFallbackIndexFileName,
+                  std::make_unique<fml::DataMapping>(
+                      collection->GetFallbackIndex()->Serialize()));
+            },
+            kFontFallbackIndexStoreDelay);
+      });
 }
 
 std::shared_ptr<AssetManager> Engine::GetAssetManager() {
@@ -163,12 +235,17 @@ bool Engine::UpdateAssetManager(
     return false;
   }
 
+  StartupTimeline::ScopedPhase phase(StartupTimeline::kAssetManagerSetup);
   asset_manager_ = new_asset_manager;
 
   if (!asset_manager_) {
+    asset_loader_.reset();
     return false;
   }
 
+  asset_loader_ = std::make_unique<AssetLoader>(
+      asset_manager_, task_runners_.GetIOTaskRunner());
+
   // Using libTXT as the text engine.
   font_collection_->RegisterFonts(asset_manager_);
 
@@ -219,6 +296,7 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
     }
   };
 
+  const fml::TimePoint isolate_creation_start = fml::TimePoint::Now();
   if (!runtime_controller_->LaunchRootIsolate(
           settings_,                                 //
           root_isolate_create_callback,              //
@@ -229,6 +307,9 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
   ) {
     return RunStatus::Failure;
   }
+  StartupTimeline::GetForProcess().RecordPhase(
+      StartupTimeline::kIsolateCreation, isolate_creation_start,
+      fml::TimePoint::Now());
 
   auto service_id = runtime_controller_->GetRootIsolateServiceID();
   if (service_id.has_value()) {
@@ -497,6 +578,8 @@ void Engine::UpdateSemantics(SemanticsNodeUpdates update,
 void Engine::HandlePlatformMessage(std::unique_ptr<PlatformMessage> message) {
   if (message->channel() == kAssetChannel) {
     HandleAssetPlatformMessage(std::move(message));
+  } else if (message->channel() == kAssetPrefetchChannel) {
+    HandleAssetPrefetchPlatformMessage(std::move(message));
   } else {
     delegate_.OnEngineHandlePlatformMessage(std::move(message));
   }
@@ -547,18 +630,60 @@ void Engine::HandleAssetPlatformMessage(
   std::string asset_name(reinterpret_cast<const char*>(data.GetMapping()),
                          data.GetSize());
 
-  if (asset_manager_) {
-    std::unique_ptr<fml::Mapping> asset_mapping =
-        asset_manager_->GetAsMapping(asset_name);
-    if (asset_mapping) {
-      response->Complete(std::move(asset_mapping));
-      return;
-    }
+  if (asset_loader_) {
+    // Large assets such as fonts and images would delay frames if they were
+    // read on the UI thread. The response is posted back to the UI thread.
+    asset_loader_->GetAsMapping(
+        std::move(asset_name),
+        [response](std::unique_ptr<fml::Mapping> asset_mapping) {
+          if (asset_mapping) {
+            response->Complete(std::move(asset_mapping));
+          } else {
+            response->CompleteEmpty();
+          }
+        });
+    return;
   }
 
   response->CompleteEmpty();
 }
 
+void Engine::HandleAssetPrefetchPlatformMessage(
+    std::unique_ptr<PlatformMessage> message) {
+  if (auto response = message->response()) {
+    response->CompleteEmpty();
+  }
+  if (!asset_loader_) {
+    return;
+  }
+
+  const auto& data = message->data();
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
+  if (document.HasParseError() || !document.IsObject()) {
+    return;
+  }
+  auto root = document.GetObject();
+  auto method = root.FindMember("method");
+  auto args = root.FindMember("args");
+  if (method == root.MemberEnd() || args == root.MemberEnd()) {
+    return;
+  }
+  if (method->value == "AssetBundle.prefetch" && args->value.IsArray()) {
+    std::vector<std::string> asset_names;
+    for (const auto& asset_name : args->value.GetArray()) {
+      if (asset_name.IsString()) {
+        asset_names.push_back(asset_name.GetString());
+      }
+    }
+    asset_loader_->Prefetch(std::move(asset_names));
+  } else if (method->value == "AssetBundle.prefetchSubdir" &&
+             args->value.IsString()) {
+    asset_loader_->PrefetchSubdir(args->value.GetString());
+  }
+}
+
 const std::string& Engine::GetLastEntrypoint() const {
   return last_entry_point_;
 }
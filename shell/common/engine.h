@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 
+#include "flutter/assets/asset_loader.h"
 #include "flutter/assets/asset_manager.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/macros.h"
@@ -437,7 +438,13 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   //----------------------------------------------------------------------------
   /// @brief      Setup default font manager according to specific platform.
   ///
-  void SetupDefaultFontManager();
+  /// @param[in]  font_manager  The default font manager for this platform,
+  ///                           as returned by `txt::GetDefaultFontManager`,
+  ///                           if it was created ahead of time, usually on a
+  ///                           background thread while the shell was being
+  ///                           created. If null, it is created here.
+  ///
+  void SetupDefaultFontManager(sk_sp<SkFontMgr> font_manager = nullptr);
 
   //----------------------------------------------------------------------------
   /// @brief      Updates the asset manager referenced by the root isolate of a
@@ -832,6 +839,14 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   const std::string& InitialRoute() const { return initial_route_; }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the initial route of an engine that was created before
+  ///             the route was known. Must be called before |Run|.
+  ///
+  void SetInitialRoute(std::string initial_route) {
+    initial_route_ = std::move(initial_route);
+  }
+
   //--------------------------------------------------------------------------
   /// @brief      Loads the Dart shared library into the Dart VM. When the
   ///             Dart library is loaded successfully, the Dart future
@@ -935,6 +950,10 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
 
   void StartAnimatorIfPossible();
 
+  // Restores the font fallback coverage index from the persistent cache
+  // directory and keeps it up to date on disk.
+  void SetupFontFallbackIndex();
+
   bool HandleLifecyclePlatformMessage(PlatformMessage* message);
 
   bool HandleNavigationPlatformMessage(
@@ -946,6 +965,9 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
 
   void HandleAssetPlatformMessage(std::unique_ptr<PlatformMessage> message);
 
+  void HandleAssetPrefetchPlatformMessage(
+      std::unique_ptr<PlatformMessage> message);
+
   bool GetAssetAsBuffer(const std::string& name, std::vector<uint8_t>* data);
 
   friend class testing::ShellTest;
@@ -966,6 +988,8 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   std::string initial_route_;
   ViewportMetrics viewport_metrics_;
   std::shared_ptr<AssetManager> asset_manager_;
+  // Reads the assets of |asset_manager_| on the IO thread.
+  std::unique_ptr<AssetLoader> asset_loader_;
   bool activity_running_;
   bool have_surface_;
   std::shared_ptr<FontCollection> font_collection_;
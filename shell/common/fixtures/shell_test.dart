@@ -36,6 +36,25 @@ void drawFrames() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void drawFirstFrame() {
+  PlatformDispatcher.instance.onBeginFrame = (Duration beginTime) {
+    final SceneBuilder builder = SceneBuilder();
+    final PictureRecorder recorder = PictureRecorder();
+    final Canvas canvas = Canvas(recorder);
+    canvas.drawPaint(Paint()..color = const Color(0xFFABCDEF));
+    final Picture picture = recorder.endRecording();
+    builder.addPicture(Offset.zero, picture);
+
+    final Scene scene = builder.build();
+    window.render(scene);
+
+    scene.dispose();
+    picture.dispose();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void reportTimingsMain() {
   PlatformDispatcher.instance.onReportTimings = (List<FrameTiming> timings) {
@@ -248,6 +267,25 @@ void canAccessResourceFromAssetDir() async {
   );
 }
 
+@pragma('vm:entry-point')
+void canPrefetchResourcesFromAssetDir() async {
+  window.sendPlatformMessage(
+    'flutter/assetprefetch',
+    Uint8List.fromList(utf8.encode(json.encode(<String, Object>{
+      'method': 'AssetBundle.prefetch',
+      'args': <String>['kernel_blob.bin', 'missing.bin'],
+    }))).buffer.asByteData(),
+    null,
+  );
+  window.sendPlatformMessage(
+    'flutter/assets',
+    Uint8List.fromList(utf8.encode('kernel_blob.bin')).buffer.asByteData(),
+    (ByteData? byteData) {
+      notifyCanAccessResource(byteData != null && byteData.lengthInBytes > 0);
+    },
+  );
+}
+
 void notifyNativeWhenEngineRun(bool success) native 'NotifyNativeWhenEngineRun';
 
 void notifyNativeWhenEngineSpawn(bool success) native 'NotifyNativeWhenEngineSpawn';
@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_rate_controller.h"
+
+#include <algorithm>
+#include <string>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+FrameRateController::FrameRateController() = default;
+
+FrameRateController::~FrameRateController() = default;
+
+void FrameRateController::RecordFrame(bool content_changed) {
+  std::scoped_lock lock(mutex_);
+  content_changes_.push_back(content_changed);
+  if (content_changes_.size() > kWindowSize) {
+    content_changes_.pop_front();
+  }
+
+  if (vsync_interval_ > 1 && content_changes_.size() >= kRampUpFrames &&
+      std::all_of(content_changes_.end() - kRampUpFrames,
+                  content_changes_.end(), [](bool changed) { return changed; })) {
+    SetVsyncInterval(vsync_interval_ / 2);
+    return;
+  }
+
+  if (vsync_interval_ < kMaxVsyncInterval &&
+      content_changes_.size() == kWindowSize) {
+    size_t changed = std::count(content_changes_.begin(),
+                                content_changes_.end(), true);
+    if (changed * 4 <= kWindowSize) {
+      SetVsyncInterval(vsync_interval_ * 2);
+    }
+  }
+}
+
+void FrameRateController::Reset() {
+  std::scoped_lock lock(mutex_);
+  if (vsync_interval_ != 1) {
+    SetVsyncInterval(1);
+  }
+}
+
+bool FrameRateController::ShouldBeginFrame(fml::TimePoint vsync_start_time,
+                                           fml::TimePoint vsync_target_time) {
+  std::scoped_lock lock(mutex_);
+  const fml::TimeDelta period = vsync_target_time - vsync_start_time;
+  if (period > fml::TimeDelta::Zero() &&
+      (!display_period_ || period < *display_period_)) {
+    display_period_ = period;
+  }
+
+  // Vsyncs are allowed to arrive up to half a period early, as their times
+  // jitter.
+  if (vsync_interval_ > 1 && display_period_ && last_frame_start_time_ &&
+      vsync_start_time - *last_frame_start_time_ <
+          *display_period_ * vsync_interval_ - *display_period_ / 2) {
+    return false;
+  }
+
+  last_frame_start_time_ = vsync_start_time;
+  return true;
+}
+
+size_t FrameRateController::GetVsyncInterval() const {
+  std::scoped_lock lock(mutex_);
+  return vsync_interval_;
+}
+
+double FrameRateController::GetPreferredFrameRate() const {
+  std::scoped_lock lock(mutex_);
+  if (!display_period_) {
+    return 0;
+  }
+  return 1.0 / (*display_period_ * vsync_interval_).ToSecondsF();
+}
+
+void FrameRateController::SetVsyncInterval(size_t vsync_interval) {
+  TRACE_EVENT_INSTANT1("flutter", "FrameRateController::SetVsyncInterval",
+                       "interval", std::to_string(vsync_interval).c_str());
+  vsync_interval_ = vsync_interval;
+  content_changes_.clear();
+}
+
+}  // namespace flutter
@@ -0,0 +1,88 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_RATE_CONTROLLER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_RATE_CONTROLLER_H_
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// Chooses how often the |Animator| begins frames while it is animating,
+/// from how often the content of the frames actually changes.
+///
+/// Frames begin every `GetVsyncInterval()` vsyncs. The interval is doubled,
+/// up to `kMaxVsyncInterval`, while at most a quarter of the last
+/// `kWindowSize` frames changed the content, and halved as soon as the last
+/// `kRampUpFrames` frames all changed it. User input restores an interval of
+/// one vsync right away, as the content is about to respond to it.
+///
+/// Whether the content of a frame changed is recorded on the raster thread,
+/// from the damage of the frame against the previous one. The other methods
+/// are used on the UI thread.
+class FrameRateController {
+ public:
+  /// The number of frames whose content changes are considered to lower the
+  /// frame rate.
+  static constexpr size_t kWindowSize = 16;
+
+  /// The number of consecutive frames that must change the content to raise
+  /// the frame rate.
+  static constexpr size_t kRampUpFrames = 4;
+
+  /// The largest number of vsyncs between two frames.
+  static constexpr size_t kMaxVsyncInterval = 4;
+
+  FrameRateController();
+
+  ~FrameRateController();
+
+  /// Records whether the content of a frame that was displayed changed from
+  /// the frame displayed before it.
+  void RecordFrame(bool content_changed);
+
+  /// Restores the full frame rate, for instance because of user input.
+  void Reset();
+
+  /// Returns whether a frame should begin at the vsync with the given start
+  /// and target times. A vsync at which no frame begins is skipped, and the
+  /// animator waits for the next one.
+  ///
+  /// The display refresh period is measured from the vsyncs as the shortest
+  /// time between a start and target time, so that vsyncs are still skipped
+  /// correctly after the display lowers its refresh rate to the preferred
+  /// one.
+  bool ShouldBeginFrame(fml::TimePoint vsync_start_time,
+                        fml::TimePoint vsync_target_time);
+
+  /// The number of vsyncs between two frames.
+  size_t GetVsyncInterval() const;
+
+  /// The frame rate in frames per second at which frames currently begin, or
+  /// 0 if it is not known yet because no vsync was seen.
+  double GetPreferredFrameRate() const;
+
+ private:
+  mutable std::mutex mutex_;
+  // Whether the content changed, for the frames since the interval changed.
+  std::deque<bool> content_changes_;
+  size_t vsync_interval_ = 1;
+  std::optional<fml::TimeDelta> display_period_;
+  std::optional<fml::TimePoint> last_frame_start_time_;
+
+  void SetVsyncInterval(size_t vsync_interval);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameRateController);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_RATE_CONTROLLER_H_
@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_rate_controller.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+void RecordFrames(FrameRateController& controller,
+                  size_t count,
+                  bool content_changed) {
+  for (size_t i = 0; i < count; i++) {
+    controller.RecordFrame(content_changed);
+  }
+}
+
+fml::TimePoint VsyncTime(int64_t vsync, int64_t period_ms) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(vsync * period_ms));
+}
+
+}  // namespace
+
+TEST(FrameRateControllerTest, LowersFrameRateWhileContentIsStatic) {
+  FrameRateController controller;
+  ASSERT_EQ(controller.GetVsyncInterval(), 1u);
+
+  RecordFrames(controller, FrameRateController::kWindowSize - 1, false);
+  ASSERT_EQ(controller.GetVsyncInterval(), 1u);
+  controller.RecordFrame(false);
+  ASSERT_EQ(controller.GetVsyncInterval(), 2u);
+
+  RecordFrames(controller, FrameRateController::kWindowSize, false);
+  ASSERT_EQ(controller.GetVsyncInterval(), 4u);
+  RecordFrames(controller, FrameRateController::kWindowSize, false);
+  ASSERT_EQ(controller.GetVsyncInterval(),
+            FrameRateController::kMaxVsyncInterval);
+
+  controller.Reset();
+  ASSERT_EQ(controller.GetVsyncInterval(), 1u);
+}
+
+TEST(FrameRateControllerTest, KeepsFrameRateWhileContentChangesOften) {
+  FrameRateController controller;
+
+  // Half of the frames change the content.
+  for (size_t i = 0; i < 2 * FrameRateController::kWindowSize; i++) {
+    controller.RecordFrame(i % 2 == 0);
+  }
+  ASSERT_EQ(controller.GetVsyncInterval(), 1u);
+
+  // A quarter of them do.
+  for (size_t i = 0; i < FrameRateController::kWindowSize; i++) {
+    controller.RecordFrame(i % 4 == 0);
+  }
+  ASSERT_EQ(controller.GetVsyncInterval(), 2u);
+
+  // The frame rate is raised again once consecutive frames change the
+  // content.
+  RecordFrames(controller, FrameRateController::kRampUpFrames - 1, true);
+  ASSERT_EQ(controller.GetVsyncInterval(), 2u);
+  controller.RecordFrame(true);
+  ASSERT_EQ(controller.GetVsyncInterval(), 1u);
+}
+
+TEST(FrameRateControllerTest, SkipsVsyncsBetweenFrames) {
+  FrameRateController controller;
+  ASSERT_EQ(controller.GetPreferredFrameRate(), 0);
+
+  // A 100Hz display.
+  ASSERT_TRUE(controller.ShouldBeginFrame(VsyncTime(0, 10), VsyncTime(1, 10)));
+  ASSERT_TRUE(controller.ShouldBeginFrame(VsyncTime(1, 10), VsyncTime(2, 10)));
+  ASSERT_DOUBLE_EQ(controller.GetPreferredFrameRate(), 100);
+
+  RecordFrames(controller, 2 * FrameRateController::kWindowSize, false);
+  ASSERT_EQ(controller.GetVsyncInterval(), 4u);
+  ASSERT_DOUBLE_EQ(controller.GetPreferredFrameRate(), 25);
+  for (int64_t vsync = 2; vsync < 5; vsync++) {
+    ASSERT_FALSE(controller.ShouldBeginFrame(VsyncTime(vsync, 10),
+                                             VsyncTime(vsync + 1, 10)));
+  }
+  ASSERT_TRUE(controller.ShouldBeginFrame(VsyncTime(5, 10), VsyncTime(6, 10)));
+
+  // After the display lowers its refresh rate to the preferred one, no vsync
+  // is skipped, and the preferred rate stays the same.
+  ASSERT_TRUE(controller.ShouldBeginFrame(VsyncTime(9, 10), VsyncTime(13, 10)));
+  ASSERT_TRUE(
+      controller.ShouldBeginFrame(VsyncTime(13, 10), VsyncTime(17, 10)));
+  ASSERT_DOUBLE_EQ(controller.GetPreferredFrameRate(), 25);
+}
+
+}  // namespace testing
+}  // namespace flutter
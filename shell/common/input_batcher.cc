@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/input_batcher.h"
+
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+uint32_t InputBatcher::EventTypesFromNames(
+    const std::vector<std::string>& names) {
+  uint32_t event_types = 0;
+  for (const auto& name : names) {
+    if (name == "viewport-metrics") {
+      event_types |= static_cast<uint32_t>(EventType::kViewportMetrics);
+    } else if (name == "pointer") {
+      event_types |= static_cast<uint32_t>(EventType::kPointerDataPacket);
+    } else if (name == "platform-message") {
+      event_types |= static_cast<uint32_t>(EventType::kPlatformMessage);
+    } else if (name == "semantics-action") {
+      event_types |= static_cast<uint32_t>(EventType::kSemanticsAction);
+    } else {
+      FML_LOG(WARNING) << "Unknown input batching event type: " << name;
+    }
+  }
+  return event_types;
+}
+
+InputBatcher::InputBatcher(uint32_t bypass_event_types)
+    : bypass_event_types_(bypass_event_types) {}
+
+InputBatcher::~InputBatcher() = default;
+
+InputBatcher::Delivery InputBatcher::AddViewportMetrics(
+    const ViewportMetrics& metrics) {
+  return Add(EventType::kViewportMetrics, ViewportMetricsEvent{metrics});
+}
+
+InputBatcher::Delivery InputBatcher::AddPointerDataPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  return Add(EventType::kPointerDataPacket,
+             PointerDataPacketEvent{std::move(packet), trace_flow_id});
+}
+
+InputBatcher::Delivery InputBatcher::AddPlatformMessage(
+    std::unique_ptr<PlatformMessage> message) {
+  return Add(EventType::kPlatformMessage,
+             PlatformMessageEvent{std::move(message)});
+}
+
+InputBatcher::Delivery InputBatcher::AddSemanticsAction(
+    int32_t node_id,
+    SemanticsAction action,
+    fml::MallocMapping args) {
+  return Add(EventType::kSemanticsAction,
+             SemanticsActionEvent{node_id, action, std::move(args)});
+}
+
+InputBatcher::Delivery InputBatcher::Add(EventType type, Event event) {
+  std::scoped_lock lock(mutex_);
+  const bool starts_batch = events_.empty();
+  events_.push_back(std::move(event));
+  if (!oldest_event_time_) {
+    oldest_event_time_ = fml::TimePoint::Now();
+  }
+
+  if (bypass_event_types_ & static_cast<uint32_t>(type)) {
+    if (immediate_delivery_scheduled_) {
+      return Delivery::kScheduled;
+    }
+    immediate_delivery_scheduled_ = true;
+    return Delivery::kNow;
+  }
+
+  // The event that started the batch arranged for its delivery. A delivery
+  // arranged for an earlier batch cannot be relied on, as that batch may have
+  // been delivered at the start of a frame without waiting for it.
+  return starts_batch ? Delivery::kAtNextVsync : Delivery::kScheduled;
+}
+
+size_t InputBatcher::Deliver(Delegate& delegate) {
+  std::deque<Event> events;
+  {
+    std::scoped_lock lock(mutex_);
+    events.swap(events_);
+    oldest_event_time_.reset();
+    immediate_delivery_scheduled_ = false;
+  }
+
+  if (events.empty()) {
+    return 0;
+  }
+
+  auto trace_event = std::to_string(events.size());
+  TRACE_EVENT1("flutter", "InputBatcher::Deliver", "events",
+               trace_event.c_str());
+
+  // Dispatching may add events on this thread, so the lock is not held.
+  size_t dispatches = 0;
+  for (auto it = events.begin(); it != events.end(); ++it) {
+    auto next = std::next(it);
+
+    if (auto* metrics_event = std::get_if<ViewportMetricsEvent>(&*it)) {
+      // Only the last of adjacent viewport metrics matters.
+      if (next != events.end() &&
+          std::holds_alternative<ViewportMetricsEvent>(*next)) {
+        continue;
+      }
+      delegate.OnInputBatcherSetViewportMetrics(metrics_event->metrics);
+    } else if (auto* pointer_event =
+                   std::get_if<PointerDataPacketEvent>(&*it)) {
+      // Merge adjacent pointer data packets into the first one. The trace
+      // flows of the merged packets end here.
+      if (next != events.end() &&
+          std::holds_alternative<PointerDataPacketEvent>(*next)) {
+        std::vector<uint8_t> data = pointer_event->packet->data();
+        for (; next != events.end() &&
+               std::holds_alternative<PointerDataPacketEvent>(*next);
+             ++next) {
+          auto& merged = std::get<PointerDataPacketEvent>(*next);
+          const auto& merged_data = merged.packet->data();
+          data.insert(data.end(), merged_data.begin(), merged_data.end());
+          TRACE_FLOW_END("flutter", "PointerEvent", merged.trace_flow_id);
+        }
+        pointer_event->packet =
+            std::make_unique<PointerDataPacket>(data.data(), data.size());
+      }
+      delegate.OnInputBatcherDispatchPointerDataPacket(
+          std::move(pointer_event->packet), pointer_event->trace_flow_id);
+      it = std::prev(next);
+    } else if (auto* message_event = std::get_if<PlatformMessageEvent>(&*it)) {
+      delegate.OnInputBatcherDispatchPlatformMessage(
+          std::move(message_event->message));
+    } else if (auto* semantics_event =
+                   std::get_if<SemanticsActionEvent>(&*it)) {
+      delegate.OnInputBatcherDispatchSemanticsAction(
+          semantics_event->node_id, semantics_event->action,
+          std::move(semantics_event->args));
+    }
+    dispatches++;
+  }
+  return dispatches;
+}
+
+std::optional<fml::TimePoint> InputBatcher::GetOldestEventTime() const {
+  std::scoped_lock lock(mutex_);
+  return oldest_event_time_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_INPUT_BATCHER_H_
+#define FLUTTER_SHELL_COMMON_INPUT_BATCHER_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/lib/ui/semantics/semantics_node.h"
+#include "flutter/lib/ui/window/platform_message.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+#include "flutter/lib/ui/window/viewport_metrics.h"
+
+namespace flutter {
+
+/// Accumulates the events that the platform thread sends to the UI thread
+/// between two vsyncs, so that they can be delivered in order in a single UI
+/// task instead of one task per event.
+///
+/// Events may be added on any thread. The batch is delivered on the UI thread,
+/// either at the start of the next frame or, if no frame is scheduled, at the
+/// next vsync. Adjacent viewport metrics are coalesced into the last one, and
+/// adjacent pointer data packets into a single packet, so they also enter Dart
+/// once per batch.
+///
+/// Event types that are latency critical may bypass batching. A bypassing
+/// event is delivered right away, together with the events queued before it so
+/// that the order of events is kept.
+class InputBatcher {
+ public:
+  /// The types of events that can be batched. Used as bit flags for the
+  /// event types that bypass batching.
+  enum class EventType : uint32_t {
+    kViewportMetrics = 1 << 0,
+    kPointerDataPacket = 1 << 1,
+    kPlatformMessage = 1 << 2,
+    kSemanticsAction = 1 << 3,
+  };
+
+  /// How the caller of one of the `Add` methods must arrange for the batch to
+  /// be delivered.
+  enum class Delivery {
+    /// A delivery that includes the event is already scheduled.
+    kScheduled,
+    /// The event started a new batch, which should be delivered at the next
+    /// vsync, or after a timeout if vsync does not fire. This is arranged for
+    /// every batch, even if an earlier batch was delivered by another
+    /// `Deliver` before its vsync.
+    kAtNextVsync,
+    /// The event bypasses batching, so the batch should be delivered now.
+    kNow,
+  };
+
+  /// Receives the events of a batch on the UI thread.
+  class Delegate {
+   public:
+    virtual void OnInputBatcherSetViewportMetrics(
+        const ViewportMetrics& metrics) = 0;
+
+    virtual void OnInputBatcherDispatchPointerDataPacket(
+        std::unique_ptr<PointerDataPacket> packet,
+        uint64_t trace_flow_id) = 0;
+
+    virtual void OnInputBatcherDispatchPlatformMessage(
+        std::unique_ptr<PlatformMessage> message) = 0;
+
+    virtual void OnInputBatcherDispatchSemanticsAction(
+        int32_t node_id,
+        SemanticsAction action,
+        fml::MallocMapping args) = 0;
+  };
+
+  /// Returns the bit flags of the event types named in `names`, which may be
+  /// `viewport-metrics`, `pointer`, `platform-message` or `semantics-action`.
+  /// Unknown names are ignored.
+  static uint32_t EventTypesFromNames(const std::vector<std::string>& names);
+
+  /// Creates a batcher whose events of the types in `bypass_event_types`, a
+  /// combination of `EventType` flags, bypass batching.
+  explicit InputBatcher(uint32_t bypass_event_types = 0);
+
+  ~InputBatcher();
+
+  Delivery AddViewportMetrics(const ViewportMetrics& metrics);
+
+  Delivery AddPointerDataPacket(std::unique_ptr<PointerDataPacket> packet,
+                                uint64_t trace_flow_id);
+
+  Delivery AddPlatformMessage(std::unique_ptr<PlatformMessage> message);
+
+  Delivery AddSemanticsAction(int32_t node_id,
+                              SemanticsAction action,
+                              fml::MallocMapping args);
+
+  /// Dispatches the pending events to `delegate` in the order they were
+  /// added, and returns the number of dispatches. The next event then starts a
+  /// new batch. Must be called on the UI thread.
+  size_t Deliver(Delegate& delegate);
+
+  /// Returns the time the oldest pending event was added, or `std::nullopt`
+  /// if no event is pending.
+  std::optional<fml::TimePoint> GetOldestEventTime() const;
+
+ private:
+  struct ViewportMetricsEvent {
+    ViewportMetrics metrics;
+  };
+
+  struct PointerDataPacketEvent {
+    std::unique_ptr<PointerDataPacket> packet;
+    uint64_t trace_flow_id;
+  };
+
+  struct PlatformMessageEvent {
+    std::unique_ptr<PlatformMessage> message;
+  };
+
+  struct SemanticsActionEvent {
+    int32_t node_id;
+    SemanticsAction action;
+    fml::MallocMapping args;
+  };
+
+  using Event = std::variant<ViewportMetricsEvent,
+                             PointerDataPacketEvent,
+                             PlatformMessageEvent,
+                             SemanticsActionEvent>;
+
+  const uint32_t bypass_event_types_;
+  mutable std::mutex mutex_;
+  std::deque<Event> events_;
+  std::optional<fml::TimePoint> oldest_event_time_;
+  bool immediate_delivery_scheduled_ = false;
+
+  Delivery Add(EventType type, Event event);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(InputBatcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_INPUT_BATCHER_H_
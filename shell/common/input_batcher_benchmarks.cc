@@ -0,0 +1,156 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/input_batcher.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+
+namespace flutter {
+
+namespace {
+
+// Counts the dispatches, each of which enters Dart in the engine.
+class CountingDelegate : public InputBatcher::Delegate {
+ public:
+  size_t dispatches = 0;
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherSetViewportMetrics(
+      const ViewportMetrics& metrics) override {
+    dispatches++;
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPointerDataPacket(
+      std::unique_ptr<PointerDataPacket> packet,
+      uint64_t trace_flow_id) override {
+    dispatches++;
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPlatformMessage(
+      std::unique_ptr<PlatformMessage> message) override {
+    dispatches++;
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchSemanticsAction(int32_t node_id,
+                                             SemanticsAction action,
+                                             fml::MallocMapping args) override {
+    dispatches++;
+  }
+};
+
+constexpr size_t kPlatformMessagesPerFrame = 2;
+
+std::unique_ptr<PointerDataPacket> CreatePointerDataPacket() {
+  auto packet = std::make_unique<PointerDataPacket>(1);
+  PointerData data;
+  data.Clear();
+  packet->SetPointerData(0, data);
+  return packet;
+}
+
+std::unique_ptr<PlatformMessage> CreatePlatformMessage() {
+  return std::make_unique<PlatformMessage>(
+      "flutter/keyevent", fml::RefPtr<PlatformMessageResponse>());
+}
+
+void ReportPerFrameCounters(benchmark::State& state,
+                            size_t ui_wakeups,
+                            size_t dispatches) {
+  state.counters["UIWakeupsPerFrame"] =
+      benchmark::Counter(ui_wakeups, benchmark::Counter::kAvgIterations);
+  state.counters["DispatchesPerFrame"] =
+      benchmark::Counter(dispatches, benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+// Each iteration is a frame in which the platform thread sends `range(0)`
+// pointer data packets, then a couple of platform messages, to the UI thread.
+// Events are posted to the UI thread one task each, as without input batching.
+static void BM_InputEventsPostedIndividually(benchmark::State& state) {
+  const int64_t pointer_packets = state.range(0);
+  fml::Thread ui_thread("ui");
+  auto ui_task_runner = ui_thread.GetTaskRunner();
+  CountingDelegate delegate;
+  size_t ui_wakeups = 0;
+  fml::AutoResetWaitableEvent latch;
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < pointer_packets; i++) {
+      ui_task_runner->PostTask(
+          fml::MakeCopyable([&, packet = CreatePointerDataPacket()]() mutable {
+            ui_wakeups++;
+            delegate.OnInputBatcherDispatchPointerDataPacket(std::move(packet),
+                                                             0);
+          }));
+    }
+    for (size_t i = 0; i < kPlatformMessagesPerFrame; i++) {
+      ui_task_runner->PostTask(
+          fml::MakeCopyable([&, message = CreatePlatformMessage()]() mutable {
+            ui_wakeups++;
+            delegate.OnInputBatcherDispatchPlatformMessage(std::move(message));
+          }));
+    }
+    ui_task_runner->PostTask([&latch]() { latch.Signal(); });
+    latch.Wait();
+  }
+
+  ReportPerFrameCounters(state, ui_wakeups, delegate.dispatches);
+}
+
+// The same frames as `BM_InputEventsPostedIndividually`, with the events
+// going through an |InputBatcher| that is delivered at the end of the frame,
+// as the shell does at vsync.
+static void BM_InputEventsBatched(benchmark::State& state) {
+  const int64_t pointer_packets = state.range(0);
+  fml::Thread ui_thread("ui");
+  auto ui_task_runner = ui_thread.GetTaskRunner();
+  CountingDelegate delegate;
+  InputBatcher batcher;
+  size_t ui_wakeups = 0;
+  fml::AutoResetWaitableEvent latch;
+
+  auto schedule = [&](InputBatcher::Delivery delivery) {
+    if (delivery == InputBatcher::Delivery::kAtNextVsync) {
+      // The shell schedules a vsync callback from the UI thread.
+      ui_task_runner->PostTask([&ui_wakeups]() { ui_wakeups++; });
+    }
+  };
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < pointer_packets; i++) {
+      schedule(batcher.AddPointerDataPacket(CreatePointerDataPacket(), i));
+    }
+    for (size_t i = 0; i < kPlatformMessagesPerFrame; i++) {
+      schedule(batcher.AddPlatformMessage(CreatePlatformMessage()));
+    }
+    ui_task_runner->PostTask([&]() {
+      ui_wakeups++;
+      batcher.Deliver(delegate);
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+
+  ReportPerFrameCounters(state, ui_wakeups, delegate.dispatches);
+}
+
+BENCHMARK(BM_InputEventsPostedIndividually)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InputEventsBatched)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,173 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/input_batcher.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Records the events it receives as strings.
+class RecordingDelegate : public InputBatcher::Delegate {
+ public:
+  std::vector<std::string> events;
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherSetViewportMetrics(
+      const ViewportMetrics& metrics) override {
+    events.push_back("metrics " + std::to_string(static_cast<int>(
+                                      metrics.physical_width)));
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPointerDataPacket(
+      std::unique_ptr<PointerDataPacket> packet,
+      uint64_t trace_flow_id) override {
+    events.push_back(
+        "pointer " +
+        std::to_string(packet->data().size() / sizeof(PointerData)) + " " +
+        std::to_string(trace_flow_id));
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPlatformMessage(
+      std::unique_ptr<PlatformMessage> message) override {
+    events.push_back("message " + message->channel());
+  }
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchSemanticsAction(int32_t node_id,
+                                             SemanticsAction action,
+                                             fml::MallocMapping args) override {
+    events.push_back("semantics " + std::to_string(node_id));
+  }
+};
+
+ViewportMetrics CreateViewportMetrics(double width) {
+  ViewportMetrics metrics;
+  metrics.physical_width = width;
+  metrics.physical_height = 100;
+  return metrics;
+}
+
+std::unique_ptr<PointerDataPacket> CreatePointerDataPacket(size_t count) {
+  auto packet = std::make_unique<PointerDataPacket>(count);
+  PointerData data;
+  data.Clear();
+  for (size_t i = 0; i < count; i++) {
+    packet->SetPointerData(i, data);
+  }
+  return packet;
+}
+
+std::unique_ptr<PlatformMessage> CreatePlatformMessage(std::string channel) {
+  return std::make_unique<PlatformMessage>(
+      std::move(channel), fml::RefPtr<PlatformMessageResponse>());
+}
+
+}  // namespace
+
+TEST(InputBatcherTest, OnlyFirstEventOfBatchRequestsVsync) {
+  InputBatcher batcher;
+  RecordingDelegate delegate;
+
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("a")),
+            InputBatcher::Delivery::kAtNextVsync);
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("b")),
+            InputBatcher::Delivery::kScheduled);
+
+  ASSERT_EQ(batcher.Deliver(delegate), 2u);
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("c")),
+            InputBatcher::Delivery::kAtNextVsync);
+
+  ASSERT_EQ(delegate.events,
+            (std::vector<std::string>{"message a", "message b"}));
+}
+
+TEST(InputBatcherTest, BatchDeliveredAtFrameStartDoesNotHoldTheNextOne) {
+  InputBatcher batcher;
+  RecordingDelegate delegate;
+
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("a")),
+            InputBatcher::Delivery::kAtNextVsync);
+  // A frame starts and delivers the batch before its vsync fires, which it
+  // may never do, for example while the application is in the background.
+  ASSERT_EQ(batcher.Deliver(delegate), 1u);
+
+  // The next event still arranges a delivery of its own, so that it is not
+  // left waiting for a vsync that was arranged for the delivered batch.
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("b")),
+            InputBatcher::Delivery::kAtNextVsync);
+  ASSERT_TRUE(batcher.GetOldestEventTime().has_value());
+
+  // The vsync of the first batch finally fires and delivers the second one.
+  ASSERT_EQ(batcher.Deliver(delegate), 1u);
+  ASSERT_EQ(batcher.Deliver(delegate), 0u);
+  ASSERT_EQ(delegate.events,
+            (std::vector<std::string>{"message a", "message b"}));
+}
+
+TEST(InputBatcherTest, DeliversEventsInOrderAndCoalescesAdjacentOnes) {
+  InputBatcher batcher;
+  RecordingDelegate delegate;
+
+  batcher.AddViewportMetrics(CreateViewportMetrics(1));
+  batcher.AddViewportMetrics(CreateViewportMetrics(2));
+  batcher.AddPointerDataPacket(CreatePointerDataPacket(1), 10);
+  batcher.AddPointerDataPacket(CreatePointerDataPacket(2), 11);
+  batcher.AddPlatformMessage(CreatePlatformMessage("a"));
+  batcher.AddPointerDataPacket(CreatePointerDataPacket(3), 12);
+  batcher.AddSemanticsAction(7, SemanticsAction::kTap, fml::MallocMapping());
+  batcher.AddViewportMetrics(CreateViewportMetrics(3));
+
+  ASSERT_TRUE(batcher.GetOldestEventTime().has_value());
+  ASSERT_EQ(batcher.Deliver(delegate), 6u);
+  ASSERT_FALSE(batcher.GetOldestEventTime().has_value());
+  ASSERT_EQ(delegate.events,
+            (std::vector<std::string>{"metrics 2", "pointer 3 10", "message a",
+                                      "pointer 3 12", "semantics 7",
+                                      "metrics 3"}));
+  ASSERT_EQ(batcher.Deliver(delegate), 0u);
+}
+
+TEST(InputBatcherTest, BypassingEventRequestsImmediateDelivery) {
+  InputBatcher batcher(InputBatcher::EventTypesFromNames({"pointer"}));
+  RecordingDelegate delegate;
+
+  ASSERT_EQ(batcher.AddPlatformMessage(CreatePlatformMessage("a")),
+            InputBatcher::Delivery::kAtNextVsync);
+  ASSERT_EQ(batcher.AddPointerDataPacket(CreatePointerDataPacket(1), 1),
+            InputBatcher::Delivery::kNow);
+  ASSERT_EQ(batcher.AddPointerDataPacket(CreatePointerDataPacket(1), 2),
+            InputBatcher::Delivery::kScheduled);
+
+  // The events queued before the bypassing one are delivered with it.
+  ASSERT_EQ(batcher.Deliver(delegate), 2u);
+  ASSERT_EQ(delegate.events,
+            (std::vector<std::string>{"message a", "pointer 2 1"}));
+
+  ASSERT_EQ(batcher.AddPointerDataPacket(CreatePointerDataPacket(1), 3),
+            InputBatcher::Delivery::kNow);
+}
+
+TEST(InputBatcherTest, EventTypesFromNames) {
+  ASSERT_EQ(InputBatcher::EventTypesFromNames({}), 0u);
+  ASSERT_EQ(
+      InputBatcher::EventTypesFromNames({"viewport-metrics", "pointer",
+                                         "platform-message", "semantics-action",
+                                         "unknown"}),
+      static_cast<uint32_t>(InputBatcher::EventType::kViewportMetrics) |
+          static_cast<uint32_t>(InputBatcher::EventType::kPointerDataPacket) |
+          static_cast<uint32_t>(InputBatcher::EventType::kPlatformMessage) |
+          static_cast<uint32_t>(InputBatcher::EventType::kSemanticsAction));
+}
+
+}  // namespace testing
+}  // namespace flutter
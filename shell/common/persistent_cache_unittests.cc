@@ -5,8 +5,12 @@
 #include "flutter/common/graphics/persistent_cache.h"
 
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/packed_cache_file.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
@@ -14,10 +18,15 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/log_settings.h"
+#include "flutter/fml/paths.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/version/version.h"
+#include "flutter/testing/post_task_sync.h"
 #include "flutter/testing/testing.h"
 #include "include/core/SkPicture.h"
 
@@ -402,5 +411,444 @@ TEST_F(PersistentCacheTest,
   DestroyShell(std::move(shell));
 }
 
+static sk_sp<SkData> MakeTestData(const std::string& prefix, int i) {
+  std::string data = prefix + std::to_string(i);
+  return SkData::MakeWithCopy(data.data(), data.size());
+}
+
+// Cuts `bytes` off the end of the packed file in `directory`.
+static void TruncatePackedCacheFile(const fml::UniqueFD& directory,
+                                    size_t bytes) {
+  auto file = fml::OpenFile(directory, PackedCacheFile::kFileName, false,
+                            fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(file.is_valid());
+  size_t size = fml::FileMapping(file).GetSize();
+  ASSERT_TRUE(fml::TruncateFile(file, size - bytes));
+}
+
+TEST(PackedCacheFileTest, FindsAppendedRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_EQ(PackedCacheFile::Open(dir.fd()), nullptr);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                        *MakeTestData("value", i)));
+  }
+  // Supersedes the first record.
+  ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", 0),
+                                      *MakeTestData("new value", 0)));
+
+  auto packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 10u);
+  EXPECT_TRUE(packed_file->NeedsCompaction());
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 0)), "new value0");
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 9)), "value9");
+  EXPECT_EQ(packed_file->Find(*MakeTestData("key", 10)), nullptr);
+}
+
+TEST(PackedCacheFileTest, CompactionIndexesLiveRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i % 5),
+                                        *MakeTestData("value", i)));
+  }
+  ASSERT_TRUE(PackedCacheFile::Compact(dir.fd()));
+
+  auto packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 5u);
+  EXPECT_FALSE(packed_file->NeedsCompaction());
+  for (int i = 0; i < 5; i++) {
+    CheckTextSkData(packed_file->Find(*MakeTestData("key", i)),
+                    "value" + std::to_string(i + 5));
+  }
+
+  // Records appended after compaction are read from the tail of the file.
+  ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", 5),
+                                      *MakeTestData("value", 10)));
+  packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 6u);
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 5)), "value10");
+}
+
+TEST(PackedCacheFileTest, VisitsRecordsInFirstUseOrder) {
+  fml::ScopedTemporaryDirectory dir;
+  auto get_keys = [&dir]() {
+    std::vector<std::string> keys;
+    auto packed_file = PackedCacheFile::Open(dir.fd());
+    if (packed_file) {
+      packed_file->ForEach([&keys](sk_sp<SkData> key, sk_sp<SkData> value) {
+        keys.emplace_back(static_cast<const char*>(key->data()), key->size());
+      });
+    }
+    return keys;
+  };
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                        *MakeTestData("value", i)));
+  }
+  // Storing a key again does not move it after the keys used since.
+  ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", 0),
+                                      *MakeTestData("value", 3)));
+  EXPECT_EQ(get_keys(), (std::vector<std::string>{"key0", "key1", "key2"}));
+
+  // Compaction keeps the order, for the records it indexes and the ones
+  // appended after it.
+  ASSERT_TRUE(PackedCacheFile::Compact(dir.fd()));
+  ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", 3),
+                                      *MakeTestData("value", 4)));
+  ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", 1),
+                                      *MakeTestData("value", 5)));
+  EXPECT_EQ(get_keys(),
+            (std::vector<std::string>{"key0", "key1", "key2", "key3"}));
+  ASSERT_TRUE(PackedCacheFile::Compact(dir.fd()));
+  EXPECT_EQ(get_keys(),
+            (std::vector<std::string>{"key0", "key1", "key2", "key3"}));
+  CheckTextSkData(PackedCacheFile::Open(dir.fd())->Find(*MakeTestData("key", 1)),
+                  "value5");
+}
+
+TEST(PackedCacheFileTest, DropsTruncatedRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                        *MakeTestData("value", i)));
+  }
+  // Simulate a write that was cut short, past the padding of the record.
+  TruncatePackedCacheFile(dir.fd(), 10);
+
+  auto packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 2u);
+  EXPECT_TRUE(packed_file->NeedsCompaction());
+  EXPECT_EQ(packed_file->Find(*MakeTestData("key", 2)), nullptr);
+
+  ASSERT_TRUE(PackedCacheFile::Compact(dir.fd()));
+  packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 2u);
+  EXPECT_FALSE(packed_file->NeedsCompaction());
+}
+
+TEST(PackedCacheFileTest, FindsRecordsAppendedAfterATornRecord) {
+  fml::ScopedTemporaryDirectory dir;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                        *MakeTestData("value", i)));
+  }
+  TruncatePackedCacheFile(dir.fd(), 10);
+  // Later runs append after the torn record.
+  for (int i = 2; i < 4; i++) {
+    ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                        *MakeTestData("value", i)));
+  }
+
+  auto packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 3u);
+  EXPECT_TRUE(packed_file->NeedsCompaction());
+  EXPECT_EQ(packed_file->Find(*MakeTestData("key", 1)), nullptr);
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 2)), "value2");
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 3)), "value3");
+
+  ASSERT_TRUE(PackedCacheFile::Compact(dir.fd()));
+  packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), 3u);
+  EXPECT_FALSE(packed_file->NeedsCompaction());
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 0)), "value0");
+  CheckTextSkData(packed_file->Find(*MakeTestData("key", 3)), "value3");
+}
+
+TEST(PackedCacheFileTest, KeepsRecordsAppendedConcurrently) {
+  constexpr int kThreadCount = 4;
+  constexpr int kRecordsPerThread = 25;
+  fml::ScopedTemporaryDirectory dir;
+
+  // Engines of the same process store from their own workers, and may compact
+  // the file meanwhile.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; t++) {
+    threads.emplace_back([&dir, t]() {
+      for (int i = t * kRecordsPerThread; i < (t + 1) * kRecordsPerThread;
+           i++) {
+        ASSERT_TRUE(PackedCacheFile::Append(dir.fd(), *MakeTestData("key", i),
+                                            *MakeTestData("value", i)));
+        if (i % 10 == 0) {
+          PackedCacheFile::Compact(dir.fd());
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto packed_file = PackedCacheFile::Open(dir.fd());
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(),
+            static_cast<size_t>(kThreadCount * kRecordsPerThread));
+  for (int i = 0; i < kThreadCount * kRecordsPerThread; i++) {
+    CheckTextSkData(packed_file->Find(*MakeTestData("key", i)),
+                    "value" + std::to_string(i));
+  }
+}
+
+TEST_F(PersistentCacheTest, LoadsShadersFromThePackedFileOnColdStart) {
+  constexpr int kShaderCount = 500;
+  const std::string shader_value(4096, 's');
+  auto value = SkData::MakeWithCopy(shader_value.data(), shader_value.size());
+  const std::vector<std::string> cache_components = {
+      "flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()};
+
+  // Caches written by older engines store every shader in its own file.
+  fml::ScopedTemporaryDirectory legacy_dir;
+  auto legacy_cache_dir = fml::CreateDirectory(
+      legacy_dir.fd(), cache_components, fml::FilePermission::kReadWrite);
+  for (int i = 0; i < kShaderCount; i++) {
+    auto key = MakeTestData("shader", i);
+    ASSERT_TRUE(fml::WriteAtomically(
+        legacy_cache_dir, PersistentCache::SkKeyToFilePath(*key).c_str(),
+        *PersistentCache::BuildCacheObject(*key, *value)));
+  }
+  auto count_entry_files = [&legacy_cache_dir]() {
+    size_t count = 0;
+    fml::VisitFiles(legacy_cache_dir, [&count](const fml::UniqueFD& directory,
+                                               const std::string& filename) {
+      if (filename != PackedCacheFile::kFileName) {
+        count++;
+      }
+      return true;
+    });
+    return count;
+  };
+
+  // Without a worker, the shaders are appended to the packed file right away.
+  auto store = [&value](int i) {
+    // Avoid polluting unit tests output with the warnings about storing
+    // without a worker.
+    fml::LogSettings error_only = {fml::LOG_ERROR};
+    fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+    StorePersistentCache(PersistentCache::GetCacheForProcess(),
+                         *MakeTestData("shader", i), *value);
+  };
+  fml::ScopedTemporaryDirectory packed_dir;
+  PersistentCache::SetCacheDirectoryPath(packed_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  for (int i = 0; i < kShaderCount; i++) {
+    store(i);
+  }
+
+  // Loads the shaders below `count` in a new process, and returns how many of
+  // them were found.
+  auto load_all = [&](const std::string& path, int count,
+                      fml::TimeDelta* time) {
+    PersistentCache::SetCacheDirectoryPath(path);
+    PersistentCache::ResetCacheForProcess();
+    auto start = fml::TimePoint::Now();
+    int loaded_count = 0;
+    for (int i = 0; i < count; i++) {
+      auto loaded = PersistentCache::GetCacheForProcess()->load(
+          *MakeTestData("shader", i));
+      if (loaded && loaded->equals(value.get())) {
+        loaded_count++;
+      }
+    }
+    if (time) {
+      *time = fml::TimePoint::Now() - start;
+    }
+    return loaded_count;
+  };
+
+  // The entries survive a restart.
+  fml::TimeDelta legacy_time;
+  fml::TimeDelta packed_time;
+  EXPECT_EQ(load_all(legacy_dir.path(), kShaderCount, &legacy_time),
+            kShaderCount);
+  EXPECT_EQ(load_all(packed_dir.path(), kShaderCount, &packed_time),
+            kShaderCount);
+  FML_LOG(INFO) << "Loading " << kShaderCount
+                << " shaders on a cold start took "
+                << legacy_time.ToMillisecondsF() << "ms from one file each and "
+                << packed_time.ToMillisecondsF() << "ms from the packed file.";
+
+  auto packed_cache_dir = fml::OpenDirectoryReadOnly(
+      packed_dir.fd(), fml::paths::JoinPaths({"flutter_engine",
+                                              GetFlutterEngineVersion(), "skia",
+                                              GetSkiaVersion()})
+                           .c_str());
+  auto packed_file = PackedCacheFile::Open(packed_cache_dir);
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), static_cast<size_t>(kShaderCount));
+
+  // The last shader is torn, as if the process went down while storing it.
+  // The shaders stored by later runs are still found.
+  TruncatePackedCacheFile(packed_cache_dir, 10);
+  PersistentCache::ResetCacheForProcess();
+  store(kShaderCount);
+  EXPECT_EQ(load_all(packed_dir.path(), kShaderCount + 1, nullptr),
+            kShaderCount);
+  EXPECT_EQ(PersistentCache::GetCacheForProcess()->load(
+                *MakeTestData("shader", kShaderCount - 1)),
+            nullptr);
+
+  // The shaders of older engines are moved into the packed file by the first
+  // run with a worker. Their files are removed by the run after it.
+  fml::Thread worker("io.flutter.test.persistent_cache");
+  auto start_with_worker = [&]() {
+    PersistentCache::SetCacheDirectoryPath(legacy_dir.path());
+    PersistentCache::ResetCacheForProcess();
+    auto cache = PersistentCache::GetCacheForProcess();
+    cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+    EXPECT_NE(cache->load(*MakeTestData("shader", 0)), nullptr);
+    PostTaskSync(worker.GetTaskRunner(), []() {});
+    cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+  };
+  start_with_worker();
+  packed_file = PackedCacheFile::Open(legacy_cache_dir);
+  ASSERT_NE(packed_file, nullptr);
+  EXPECT_EQ(packed_file->GetEntryCount(), static_cast<size_t>(kShaderCount));
+  EXPECT_EQ(count_entry_files(), static_cast<size_t>(kShaderCount));
+  start_with_worker();
+  EXPECT_EQ(count_entry_files(), 0u);
+  EXPECT_EQ(load_all(legacy_dir.path(), kShaderCount, nullptr), kShaderCount);
+}
+
+TEST_F(PersistentCacheTest, LoadsSkSLsInFirstUseOrder) {
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+
+  {
+    // Avoid polluting unit tests output with the warnings about storing
+    // without a worker.
+    fml::LogSettings error_only = {fml::LOG_ERROR};
+    fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+    for (int i = 9; i >= 0; i--) {
+      StorePersistentCache(persistent_cache, *MakeTestData("key", i),
+                           *MakeTestData("value", i));
+    }
+  }
+
+  // Entries of older caches come after the packed ones.
+  auto sksl_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion(),
+       PersistentCache::kSkSLSubdirName},
+      fml::FilePermission::kReadWrite);
+  for (int i = 10; i < 13; i++) {
+    auto key = MakeTestData("key", i);
+    ASSERT_TRUE(fml::WriteAtomically(
+        sksl_dir, PersistentCache::SkKeyToFilePath(*key).c_str(),
+        *PersistentCache::BuildCacheObject(*key, *MakeTestData("value", i))));
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  persistent_cache->SetConcurrentTaskRunner(loop->GetTaskRunner());
+  auto sksls = persistent_cache->LoadSkSLs();
+  persistent_cache->SetConcurrentTaskRunner(nullptr);
+  PersistentCache::SetCacheSkSL(false);
+
+  ASSERT_EQ(sksls.size(), 13u);
+  for (int i = 0; i < 10; i++) {
+    CheckTextSkData(sksls[i].key, "key" + std::to_string(9 - i));
+    CheckTextSkData(sksls[i].value, "value" + std::to_string(9 - i));
+  }
+  for (size_t i = 10; i < sksls.size(); i++) {
+    std::string key(reinterpret_cast<const char*>(sksls[i].key->bytes()),
+                    sksls[i].key->size());
+    CheckTextSkData(sksls[i].value, "value" + key.substr(3));
+  }
+}
+
+TEST_F(PersistentCacheTest, LoadsFromThePrewarmedPackedFile) {
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  {
+    // Avoid polluting unit tests output with the warnings about storing
+    // without a worker.
+    fml::LogSettings error_only = {fml::LOG_ERROR};
+    fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+    StorePersistentCache(PersistentCache::GetCacheForProcess(),
+                         *MakeTestData("key", 0), *MakeTestData("value", 0));
+  }
+
+  // Prewarming races with resetting the cache, which must not crash and must
+  // leave a usable cache behind.
+  PersistentCache::ResetCacheForProcess();
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  std::promise<void> prewarmed;
+  loop->GetTaskRunner()->PostTask([&prewarmed]() {
+    PersistentCache::PrewarmCacheForProcess();
+    prewarmed.set_value();
+  });
+  PersistentCache::ResetCacheForProcess();
+  prewarmed.get_future().wait();
+  PersistentCache::PrewarmCacheForProcess();
+
+  auto loaded =
+      PersistentCache::GetCacheForProcess()->load(*MakeTestData("key", 0));
+  ASSERT_NE(loaded, nullptr);
+  CheckTextSkData(loaded, "value0");
+}
+
+TEST_F(PersistentCacheTest, LoadsShadersStoredBeforeTheyAreWritten) {
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  auto cache = PersistentCache::GetCacheForProcess();
+  // Maps the packed file before the shader is stored.
+  ASSERT_EQ(cache->load(*MakeTestData("key", 0)), nullptr);
+
+  // The worker is busy, so the shader is not written yet.
+  fml::Thread worker("io.flutter.test.persistent_cache");
+  fml::AutoResetWaitableEvent worker_blocked;
+  worker.GetTaskRunner()->PostTask([&]() { worker_blocked.Wait(); });
+  cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+  StorePersistentCache(cache, *MakeTestData("key", 0),
+                       *MakeTestData("value", 0));
+  CheckTextSkData(cache->load(*MakeTestData("key", 0)), "value0");
+
+  worker_blocked.Signal();
+  PostTaskSync(worker.GetTaskRunner(), []() {});
+  cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+  CheckTextSkData(cache->load(*MakeTestData("key", 0)), "value0");
+}
+
+TEST_F(PersistentCacheTest, MaintainsThePackedFileOnceAWorkerIsAdded) {
+  fml::ScopedTemporaryDirectory base_dir;
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+  auto key = MakeTestData("key", 0);
+  ASSERT_TRUE(fml::WriteAtomically(
+      cache_dir, PersistentCache::SkKeyToFilePath(*key).c_str(),
+      *PersistentCache::BuildCacheObject(*key, *MakeTestData("value", 0))));
+
+  // The prewarm runs before the shell adds its worker, so the entry file is
+  // only moved into the packed file once there is one.
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::PrewarmCacheForProcess();
+  EXPECT_EQ(PackedCacheFile::Open(cache_dir), nullptr);
+
+  fml::Thread worker("io.flutter.test.persistent_cache");
+  auto cache = PersistentCache::GetCacheForProcess();
+  cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+  PostTaskSync(worker.GetTaskRunner(), []() {});
+  cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+
+  auto packed_file = PackedCacheFile::Open(cache_dir);
+  ASSERT_NE(packed_file, nullptr);
+  CheckTextSkData(packed_file->Find(*key), "value0");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -553,7 +553,9 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
       (!raster_thread_merger_ || raster_thread_merger_->IsMerged());
 
   FrameDamage damage;
-  if (!disable_partial_repaint && frame->framebuffer_info().existing_damage) {
+  const bool diffs_previous_layer_tree =
+      !disable_partial_repaint && frame->framebuffer_info().existing_damage;
+  if (diffs_previous_layer_tree) {
     damage.SetPreviousLayerTree(last_layer_tree_.get());
     damage.AddAdditonalDamage(*frame->framebuffer_info().existing_damage);
   }
@@ -565,6 +567,11 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     return raster_status;
   }
 
+  if (reports_frame_damage_) {
+    ReportFrameDamage(layer_tree,
+                      diffs_previous_layer_tree ? &damage : nullptr);
+  }
+
   SurfaceFrame::SubmitInfo submit_info;
   submit_info.frame_damage = damage.GetFrameDamage();
   submit_info.buffer_damage = damage.GetBufferDamage();
@@ -593,6 +600,23 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
   return raster_status;
 }
 
+void Rasterizer::ReportFrameDamage(flutter::LayerTree& layer_tree,
+                                   const FrameDamage* damage) {
+  std::optional<SkIRect> frame_damage;
+  if (&layer_tree == last_layer_tree_.get()) {
+    // The last layer tree is drawn again.
+    frame_damage = SkIRect::MakeEmpty();
+  } else if (damage) {
+    frame_damage = damage->GetFrameDamage();
+  } else {
+    FrameDamage content_damage;
+    content_damage.SetPreviousLayerTree(last_layer_tree_.get());
+    content_damage.ComputeClipRect(layer_tree);
+    frame_damage = content_damage.GetFrameDamage();
+  }
+  delegate_.OnFrameDamageComputed(!frame_damage || !frame_damage->isEmpty());
+}
+
 static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
     flutter::LayerTree* tree,
     flutter::CompositorContext& compositor_context) {
@@ -766,6 +790,10 @@ void Rasterizer::SetSnapshotSurfaceProducer(
   snapshot_surface_producer_ = std::move(producer);
 }
 
+void Rasterizer::SetReportsFrameDamage(bool reports_frame_damage) {
+  reports_frame_damage_ = reports_frame_damage;
+}
+
 fml::RefPtr<fml::RasterThreadMerger> Rasterizer::GetRasterThreadMerger() {
   return raster_thread_merger_;
 }
@@ -72,6 +72,17 @@ class Rasterizer final : public SnapshotDelegate {
     ///
     virtual void OnFrameRasterized(const FrameTiming& frame_timing) = 0;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate whether the frame that was just
+    ///             rasterized changed from the previously rasterized frame,
+    ///             according to the damage computed by diffing their layer
+    ///             trees. Only called if enabled with
+    ///             `Rasterizer::SetReportsFrameDamage`.
+    ///
+    /// @param[in]  has_damage  Whether any part of the frame changed.
+    ///
+    virtual void OnFrameDamageComputed(bool has_damage) = 0;
+
     /// Time limit for a smooth frame.
     ///
     /// See: `DisplayManager::GetMainDisplayRefreshRate`.
@@ -366,6 +377,17 @@ class Rasterizer final : public SnapshotDelegate {
   void SetSnapshotSurfaceProducer(
       std::unique_ptr<SnapshotSurfaceProducer> producer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the damage of each rasterized frame is reported
+  ///             to the delegate via `Delegate::OnFrameDamageComputed`. This
+  ///             is done on shell initialization. If partial repaint does not
+  ///             diff a frame against the previous one, reporting its damage
+  ///             takes an additional diff.
+  ///
+  /// @param[in]  reports_frame_damage  Whether frame damage is reported.
+  ///
+  void SetReportsFrameDamage(bool reports_frame_damage);
+
   //----------------------------------------------------------------------------
   /// @brief      Returns a pointer to the compositor context used by this
   ///             rasterizer. This pointer will never be `nullptr`.
@@ -482,6 +504,12 @@ class Rasterizer final : public SnapshotDelegate {
 
   void FireNextFrameCallbackIfPresent();
 
+  // Reports whether |layer_tree| changed from the last layer tree to the
+  // delegate. |damage| is the damage computed by the rasterization, if it was
+  // diffed against the last layer tree.
+  void ReportFrameDamage(flutter::LayerTree& layer_tree,
+                         const FrameDamage* damage);
+
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
 
   Delegate& delegate_;
@@ -499,6 +527,7 @@ class Rasterizer final : public SnapshotDelegate {
   std::optional<size_t> max_cache_bytes_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
+  bool reports_frame_damage_ = false;
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
@@ -25,6 +25,7 @@ namespace {
 class MockDelegate : public Rasterizer::Delegate {
  public:
   MOCK_METHOD1(OnFrameRasterized, void(const FrameTiming& frame_timing));
+  MOCK_METHOD1(OnFrameDamageComputed, void(bool has_damage));
   MOCK_METHOD0(GetFrameBudget, fml::Milliseconds());
   MOCK_CONST_METHOD0(GetLatestFrameTargetTime, fml::TimePoint());
   MOCK_CONST_METHOD0(GetTaskRunners, const TaskRunners&());
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -24,10 +25,16 @@ RunConfiguration RunConfiguration::InferFromSettings(
         fml::Duplicate(settings.assets_dir), true));
   }
 
-  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+  auto assets_path = fml::OpenDirectory(settings.assets_path.c_str(), false,
+                                        fml::FilePermission::kRead);
+  // Assets packed by the tool are served from a single mapping. The bundle is
+  // not pushed if there is no packed file, and the directory still serves any
+  // asset that is not in it. The bundle is dropped when the assets are
+  // reloaded, as it would serve their old contents.
+  asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+      assets_path, PackedAssetBundle::kFileName, false));
+  asset_manager->PushBack(
+      std::make_unique<DirectoryAssetBundle>(std::move(assets_path), true));
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
@@ -58,7 +65,7 @@ bool RunConfiguration::IsValid() const {
 }
 
 bool RunConfiguration::AddAssetResolver(
-    std::unique_ptr<AssetResolver> resolver) {
+    std::shared_ptr<AssetResolver> resolver) {
   if (!resolver || !resolver->IsValid()) {
     return false;
   }
@@ -128,7 +128,7 @@ class RunConfiguration {
   /// @return     Returns whether the resolver was successfully registered. The
   ///             resolver must be valid for its registration to be successful.
   ///
-  bool AddAssetResolver(std::unique_ptr<AssetResolver> resolver);
+  bool AddAssetResolver(std::shared_ptr<AssetResolver> resolver);
 
   //----------------------------------------------------------------------------
   /// @brief      Updates the main application entrypoint. If this is not set,
@@ -26,12 +26,14 @@
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
+#include "flutter/shell/profiling/stack_sampler.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 #include "third_party/tonic/common/log.h"
+#include "txt/platform.h"
 
 namespace flutter {
 
@@ -40,6 +42,12 @@ constexpr char kSystemChannel[] = "flutter/system";
 constexpr char kTypeKey[] = "type";
 constexpr char kFontChange[] = "fontsChange";
 
+// How long batched input events wait for a vsync before they are delivered
+// anyway, for example because the embedder does not deliver vsyncs while the
+// application is in the background.
+constexpr fml::TimeDelta kMaxInputBatchDelay =
+    fml::TimeDelta::FromMilliseconds(100);
+
 namespace {
 
 std::unique_ptr<Engine> CreateEngine(
@@ -101,6 +109,10 @@ void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetAllowlist(settings.trace_allowlist);
     }
 
+    if (settings.trace_engine_buffer) {
+      fml::tracing::TraceBufferEnable();
+    }
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -138,10 +150,24 @@ std::unique_ptr<Shell> Shell::Create(
   // Always use the `vm_snapshot` and `isolate_snapshot` provided by the
   // settings to launch the VM.  If the VM is already running, the snapshot
   // arguments are ignored.
-  auto vm_snapshot = DartSnapshot::VMSnapshotFromSettings(settings);
-  auto isolate_snapshot = DartSnapshot::IsolateSnapshotFromSettings(settings);
+  fml::RefPtr<const DartSnapshot> vm_snapshot;
+  fml::RefPtr<const DartSnapshot> isolate_snapshot;
+  {
+    StartupTimeline::ScopedPhase phase(StartupTimeline::kDartSnapshotMapping);
+    vm_snapshot = DartSnapshot::VMSnapshotFromSettings(settings);
+    isolate_snapshot = DartSnapshot::IsolateSnapshotFromSettings(settings);
+  }
+  const fml::TimePoint vm_creation_start = fml::TimePoint::Now();
+  const size_t vm_launch_count = DartVM::GetVMLaunchCount();
   auto vm = DartVMRef::Create(settings, vm_snapshot, isolate_snapshot);
   FML_CHECK(vm) << "Must be able to initialize the VM.";
+  // Only record the creation if this call launched the VM rather than
+  // referencing the running one.
+  if (DartVM::GetVMLaunchCount() != vm_launch_count) {
+    StartupTimeline::GetForProcess().RecordPhase(
+        StartupTimeline::kDartVMCreation, vm_creation_start,
+        fml::TimePoint::Now());
+  }
 
   // If the settings did not specify an `isolate_snapshot`, fall back to the
   // one the VM was launched with.
@@ -182,6 +208,50 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                     !settings.skia_deterministic_rendering_on_cpu),
                 is_gpu_disabled));
 
+  // Start the work that only depends on the settings on the concurrent
+  // workers, so that it overlaps the creation of the subsystems below.
+  auto concurrent_task_runner =
+      shell->GetDartVM()->GetConcurrentWorkerTaskRunner();
+
+  // Nothing waits for the snapshot pages to be read in. They are only read
+  // when the root isolate is launched, which faults on fewer of them if the
+  // prefetch got there first.
+  if (isolate_snapshot) {
+    concurrent_task_runner->PostTask([isolate_snapshot]() {
+      TRACE_EVENT0("flutter", "ShellPrefetchSnapshot");
+      isolate_snapshot->PrefetchMappings();
+    });
+  }
+
+  // Nothing waits for the persistent cache either, as the prewarm reads its
+  // files without holding any lock of the cache. The first load on the raster
+  // thread finds the cache open if the prewarm finished, and opens it itself
+  // otherwise. A cache about to be purged is not worth opening.
+  if (!settings.purge_persistent_cache) {
+    concurrent_task_runner->PostTask(
+        []() { PersistentCache::PrewarmCacheForProcess(); });
+  }
+
+  // The engine waits for the default font manager when it sets it up, after
+  // the shell is set up. The embedder may already be creating it, in which
+  // case the engine sets it up when it runs.
+  std::shared_future<sk_sp<SkFontMgr>> default_font_manager_future;
+  if (!settings.prefetched_default_font_manager) {
+    auto default_font_manager_promise =
+        std::make_shared<std::promise<sk_sp<SkFontMgr>>>();
+    default_font_manager_future =
+        default_font_manager_promise->get_future().share();
+    concurrent_task_runner->PostTask(
+        [default_font_manager_promise,
+         font_initialization_data = settings.font_initialization_data]() {
+          TRACE_EVENT0("flutter", "ShellCreateDefaultFontManager");
+          StartupTimeline::ScopedPhase phase(
+              StartupTimeline::kFontCollectionSetup);
+          default_font_manager_promise->set_value(
+              txt::GetDefaultFontManager(font_initialization_data));
+        });
+  }
+
   // Create the rasterizer on the raster thread.
   std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
   auto rasterizer_future = rasterizer_promise.get_future();
@@ -237,12 +307,15 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
        &unref_queue_promise,                                              //
        platform_view = platform_view->GetWeakPtr(),                       //
        io_task_runner,                                                    //
+       decoded_image_cache_max_bytes =
+           shell->GetSettings().decoded_image_cache_max_bytes,            //
        is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupIOSubsystem");
         auto io_manager = std::make_unique<ShellIOManager>(
             platform_view.getUnsafe()->CreateResourceContext(),
-            is_backgrounded_sync_switch, io_task_runner);
+            is_backgrounded_sync_switch, io_task_runner,
+            decoded_image_cache_max_bytes);
         weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
         unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
         io_manager_promise.set_value(std::move(io_manager));
@@ -274,6 +347,9 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         // from the platform.
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
+        if (shell->frame_rate_controller_) {
+          animator->SetFrameRateController(shell->frame_rate_controller_);
+        }
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -298,6 +374,18 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     return nullptr;
   }
 
+  // Setup the time-consuming default font manager right after the engine is
+  // created, waiting on the UI thread for the workers to finish creating it.
+  if (default_font_manager_future.valid()) {
+    fml::TaskRunner::RunNowOrPostTask(
+        shell->GetTaskRunners().GetUITaskRunner(),
+        [engine = shell->weak_engine_, default_font_manager_future]() {
+          if (engine) {
+            engine->SetupDefaultFontManager(default_font_manager_future.get());
+          }
+        });
+  }
+
   return shell;
 }
 
@@ -376,6 +464,15 @@ Shell::Shell(DartVMRef vm,
 
   display_manager_ = std::make_unique<DisplayManager>();
 
+  if (settings_.enable_input_batching) {
+    input_batcher_ = std::make_unique<InputBatcher>(
+        InputBatcher::EventTypesFromNames(settings_.input_batching_bypass));
+  }
+
+  if (settings_.enable_adaptive_frame_rate) {
+    frame_rate_controller_ = std::make_shared<FrameRateController>();
+  }
+
   // Generate a WeakPtrFactory for use with the raster thread. This does not
   // need to wait on a latch because it can only ever be used from the raster
   // thread from this class, so we have ordering guarantees.
@@ -385,6 +482,25 @@ Shell::Shell(DartVMRef vm,
             std::make_unique<fml::TaskRunnerAffineWeakPtrFactory<Shell>>(this);
       }));
 
+  if (settings_.enable_native_sampling_profiler) {
+    // Every shell that enables the sampler keeps it running until it is
+    // destroyed.
+    StackSampler::Start();
+    // Threads shared by several task runners keep the first name they are
+    // registered with.
+    const std::string& label = task_runners_.GetLabel();
+    StackSampler::RegisterCurrentThread(label + ".platform");
+    task_runners_.GetUITaskRunner()->PostTask([label]() {
+      StackSampler::RegisterCurrentThread(label + ".ui");
+    });
+    task_runners_.GetRasterTaskRunner()->PostTask([label]() {
+      StackSampler::RegisterCurrentThread(label + ".raster");
+    });
+    task_runners_.GetIOTaskRunner()->PostTask([label]() {
+      StackSampler::RegisterCurrentThread(label + ".io");
+    });
+  }
+
   // Install service protocol handlers.
 
   service_protocol_handlers_[ServiceProtocol::kScreenshotExtensionName] = {
@@ -423,12 +539,29 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolEstimateRasterCacheMemory, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetSkSLPrecompilationProgressExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetSkSLPrecompilationProgress,
+                    this, std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetEngineTraceExtensionName] = {
+      task_runners_.GetIOTaskRunner(),
+      std::bind(&Shell::OnServiceProtocolGetEngineTrace, this,
+                std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetNativeProfileExtensionName] =
+      {task_runners_.GetIOTaskRunner(),
+       std::bind(&Shell::OnServiceProtocolGetNativeProfile, this,
+                 std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
   PersistentCache::GetCacheForProcess()->RemoveWorkerTaskRunner(
       task_runners_.GetIOTaskRunner());
 
+  if (settings_.enable_native_sampling_profiler) {
+    StackSampler::Stop();
+  }
+
   vm_->GetServiceProtocol()->RemoveHandler(this);
 
   fml::AutoResetWaitableEvent ui_latch, gpu_latch, platform_latch, io_latch;
@@ -483,6 +616,19 @@ std::unique_ptr<Shell> Shell::Spawn(
     const std::string& initial_route,
     const CreateCallback<PlatformView>& on_create_platform_view,
     const CreateCallback<Rasterizer>& on_create_rasterizer) const {
+  std::unique_ptr<Shell> result = SpawnWithoutRunning(
+      initial_route, on_create_platform_view, on_create_rasterizer);
+  if (!result) {
+    return nullptr;
+  }
+  result->RunEngine(std::move(run_configuration));
+  return result;
+}
+
+std::unique_ptr<Shell> Shell::SpawnWithoutRunning(
+    const std::string& initial_route,
+    const CreateCallback<PlatformView>& on_create_platform_view,
+    const CreateCallback<Rasterizer>& on_create_rasterizer) const {
   FML_DCHECK(task_runners_.IsValid());
   // It's safe to store this value since it is set on the platform thread.
   bool is_gpu_disabled = false;
@@ -511,8 +657,9 @@ std::unique_ptr<Shell> Shell::Spawn(
                              /*initial_route=*/initial_route);
       },
       is_gpu_disabled));
-  result->shared_resource_context_ = io_manager_->GetSharedResourceContext();
-  result->RunEngine(std::move(run_configuration));
+  if (result) {
+    result->shared_resource_context_ = io_manager_->GetSharedResourceContext();
+  }
   return result;
 }
 
@@ -535,7 +682,13 @@ void Shell::NotifyLowMemoryWarning() const {
                                trace_id);
       });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
-  // to purge them.
+  // to purge them. Decoded images are cached separately though.
+  task_runners_.GetIOTaskRunner()->PostTask(
+      [io_manager = io_manager_->GetWeakPtr()]() {
+        if (io_manager && io_manager->GetDecodedImageCache()) {
+          io_manager->GetDecodedImageCache()->Purge();
+        }
+      });
 }
 
 void Shell::RunEngine(RunConfiguration run_configuration) {
@@ -595,6 +748,10 @@ std::optional<DartErrorCode> Shell::GetUIIsolateLastError() const {
   return DartErrorCode::UnknownError;
 }
 
+std::vector<StartupTimeline::PhaseTiming> Shell::GetStartupPhases() const {
+  return StartupTimeline::GetForProcess().GetPhases();
+}
+
 bool Shell::EngineHasLivePorts() const {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
@@ -633,6 +790,7 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   rasterizer_->SetExternalViewEmbedder(view_embedder);
   rasterizer_->SetSnapshotSurfaceProducer(
       platform_view_->CreateSnapshotSurfaceProducer());
+  rasterizer_->SetReportsFrameDamage(frame_rate_controller_ != nullptr);
 
   // The weak ptr must be generated in the platform thread which owns the unique
   // ptr.
@@ -640,20 +798,12 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
-  // Setup the time-consuming default font manager right after engine created.
-  if (!settings_.prefetched_default_font_manager) {
-    fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
-                                      [engine = weak_engine_] {
-                                        if (engine) {
-                                          engine->SetupDefaultFontManager();
-                                        }
-                                      });
-  }
-
   is_setup_ = true;
 
   PersistentCache::GetCacheForProcess()->AddWorkerTaskRunner(
       task_runners_.GetIOTaskRunner());
+  PersistentCache::GetCacheForProcess()->SetConcurrentTaskRunner(
+      vm_->GetConcurrentWorkerTaskRunner());
 
   PersistentCache::GetCacheForProcess()->SetIsDumpingSkp(
       settings_.dump_skp_on_shader_compilation);
@@ -897,12 +1047,16 @@ void Shell::OnPlatformViewSetViewportMetrics(const ViewportMetrics& metrics) {
         }
       });
 
-  task_runners_.GetUITaskRunner()->PostTask(
-      [engine = engine_->GetWeakPtr(), metrics]() {
-        if (engine) {
-          engine->SetViewportMetrics(metrics);
-        }
-      });
+  if (input_batcher_) {
+    ScheduleInputBatchDelivery(input_batcher_->AddViewportMetrics(metrics));
+  } else {
+    task_runners_.GetUITaskRunner()->PostTask(
+        [engine = engine_->GetWeakPtr(), metrics]() {
+          if (engine) {
+            engine->SetViewportMetrics(metrics);
+          }
+        });
+  }
 
   {
     std::scoped_lock<std::mutex> lock(resize_mutex_);
@@ -917,6 +1071,12 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (input_batcher_) {
+    ScheduleInputBatchDelivery(
+        input_batcher_->AddPlatformMessage(std::move(message)));
+    return;
+  }
+
   task_runners_.GetUITaskRunner()->PostTask(fml::MakeCopyable(
       [engine = engine_->GetWeakPtr(), message = std::move(message)]() mutable {
         if (engine) {
@@ -932,13 +1092,22 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
   TRACE_FLOW_BEGIN("flutter", "PointerEvent", next_pointer_flow_id_);
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
-  task_runners_.GetUITaskRunner()->PostTask(
-      fml::MakeCopyable([engine = weak_engine_, packet = std::move(packet),
-                         flow_id = next_pointer_flow_id_]() mutable {
-        if (engine) {
-          engine->DispatchPointerDataPacket(std::move(packet), flow_id);
-        }
-      }));
+  if (frame_rate_controller_) {
+    // The content is about to respond to the user.
+    frame_rate_controller_->Reset();
+  }
+  if (input_batcher_) {
+    ScheduleInputBatchDelivery(input_batcher_->AddPointerDataPacket(
+        std::move(packet), next_pointer_flow_id_));
+  } else {
+    task_runners_.GetUITaskRunner()->PostTask(
+        fml::MakeCopyable([engine = weak_engine_, packet = std::move(packet),
+                           flow_id = next_pointer_flow_id_]() mutable {
+          if (engine) {
+            engine->DispatchPointerDataPacket(std::move(packet), flow_id);
+          }
+        }));
+  }
   next_pointer_flow_id_++;
 }
 
@@ -949,6 +1118,12 @@ void Shell::OnPlatformViewDispatchSemanticsAction(int32_t id,
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (input_batcher_) {
+    ScheduleInputBatchDelivery(
+        input_batcher_->AddSemanticsAction(id, action, std::move(args)));
+    return;
+  }
+
   task_runners_.GetUITaskRunner()->PostTask(
       fml::MakeCopyable([engine = engine_->GetWeakPtr(), id, action,
                          args = std::move(args)]() mutable {
@@ -958,6 +1133,106 @@ void Shell::OnPlatformViewDispatchSemanticsAction(int32_t id,
       }));
 }
 
+void Shell::ScheduleInputBatchDelivery(InputBatcher::Delivery delivery) {
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+
+  // The tasks below only use the shell while the engine is alive, as the shell
+  // is destroyed after it.
+  switch (delivery) {
+    case InputBatcher::Delivery::kScheduled:
+      return;
+    case InputBatcher::Delivery::kNow:
+      task_runners_.GetUITaskRunner()->PostTask(
+          [engine = weak_engine_, shell = this]() {
+            if (engine) {
+              shell->input_batcher_->Deliver(*shell);
+            }
+          });
+      return;
+    case InputBatcher::Delivery::kAtNextVsync:
+      task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_,
+                                                 shell = this]() {
+        if (!engine) {
+          return;
+        }
+        engine->ScheduleSecondaryVsyncCallback(
+            reinterpret_cast<uintptr_t>(shell->input_batcher_.get()),
+            [engine, shell]() {
+              if (engine) {
+                shell->input_batcher_->Deliver(*shell);
+              }
+            });
+        if (!shell->input_batch_fallback_scheduled_) {
+          shell->input_batch_fallback_scheduled_ = true;
+          shell->task_runners_.GetUITaskRunner()->PostDelayedTask(
+              [engine, shell]() {
+                if (engine) {
+                  shell->OnInputBatchFallback();
+                }
+              },
+              kMaxInputBatchDelay);
+        }
+      });
+      return;
+  }
+}
+
+void Shell::OnInputBatchFallback() {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  input_batch_fallback_scheduled_ = false;
+  std::optional<fml::TimePoint> oldest_event_time =
+      input_batcher_->GetOldestEventTime();
+  if (!oldest_event_time) {
+    return;
+  }
+
+  const fml::TimeDelta age = fml::TimePoint::Now() - *oldest_event_time;
+  if (age >= kMaxInputBatchDelay) {
+    TRACE_EVENT0("flutter", "Shell::OnInputBatchFallback");
+    input_batcher_->Deliver(*this);
+    return;
+  }
+
+  input_batch_fallback_scheduled_ = true;
+  task_runners_.GetUITaskRunner()->PostDelayedTask(
+      [engine = weak_engine_, shell = this]() {
+        if (engine) {
+          shell->OnInputBatchFallback();
+        }
+      },
+      kMaxInputBatchDelay - age);
+}
+
+// |InputBatcher::Delegate|
+void Shell::OnInputBatcherSetViewportMetrics(const ViewportMetrics& metrics) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  engine_->SetViewportMetrics(metrics);
+}
+
+// |InputBatcher::Delegate|
+void Shell::OnInputBatcherDispatchPointerDataPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  engine_->DispatchPointerDataPacket(std::move(packet), trace_flow_id);
+}
+
+// |InputBatcher::Delegate|
+void Shell::OnInputBatcherDispatchPlatformMessage(
+    std::unique_ptr<PlatformMessage> message) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  engine_->DispatchPlatformMessage(std::move(message));
+}
+
+// |InputBatcher::Delegate|
+void Shell::OnInputBatcherDispatchSemanticsAction(int32_t node_id,
+                                                  SemanticsAction action,
+                                                  fml::MallocMapping args) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  engine_->DispatchSemanticsAction(node_id, action, std::move(args));
+}
+
 // |PlatformView::Delegate|
 void Shell::OnPlatformViewSetSemanticsEnabled(bool enabled) {
   FML_DCHECK(is_setup_);
@@ -1070,6 +1345,11 @@ void Shell::OnAnimatorBeginFrame(fml::TimePoint frame_target_time,
     std::scoped_lock time_recorder_lock(time_recorder_mutex_);
     latest_frame_target_time_.emplace(frame_target_time);
   }
+  if (input_batcher_) {
+    // Deliver the events received since the last frame before the framework
+    // builds this one.
+    input_batcher_->Deliver(*this);
+  }
   if (engine_) {
     engine_->BeginFrame(frame_target_time, frame_number);
   }
@@ -1339,6 +1619,14 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
 
+  StartupTimeline& startup_timeline = StartupTimeline::GetForProcess();
+  if (!startup_timeline.HasRecordedPhase(
+          StartupTimeline::kFirstRasterizedFrame)) {
+    startup_timeline.RecordPhase(StartupTimeline::kFirstRasterizedFrame,
+                                 timing.Get(FrameTiming::kRasterStart),
+                                 timing.Get(FrameTiming::kRasterFinish));
+  }
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
@@ -1403,6 +1691,14 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   }
 }
 
+void Shell::OnFrameDamageComputed(bool has_damage) {
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  if (frame_rate_controller_) {
+    frame_rate_controller_->RecordFrame(has_damage);
+  }
+}
+
 fml::Milliseconds Shell::GetFrameBudget() {
   double display_refresh_rate = display_manager_->GetMainDisplayRefreshRate();
   if (display_refresh_rate > 0) {
@@ -1671,6 +1967,58 @@ bool Shell::OnServiceProtocolGetSkSLs(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetSkSLPrecompilationProgress(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  const auto progress =
+      PersistentCache::GetCacheForProcess()->GetSkSLPrecompilationProgress();
+  response->SetObject();
+  response->AddMember("type", "SkSLPrecompilationProgress",
+                      response->GetAllocator());
+  response->AddMember<uint64_t>("compiled", progress.compiled,
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("succeeded", progress.succeeded,
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("total", progress.total,
+                                response->GetAllocator());
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetEngineTrace(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "EngineTrace", allocator);
+  response->AddMember("enabled", fml::tracing::TraceBufferIsEnabled(),
+                      allocator);
+  const std::string trace = fml::tracing::TraceBufferExportJSON();
+  response->AddMember("trace", rapidjson::Value(trace.c_str(), allocator),
+                      allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetNativeProfile(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "NativeProfile", allocator);
+  response->AddMember("running", StackSampler::IsRunning(), allocator);
+  response->AddMember<uint64_t>("sampleCount", StackSampler::GetSampleCount(),
+                                allocator);
+  const std::string folded = StackSampler::GetFoldedStacks();
+  response->AddMember("folded", rapidjson::Value(folded.c_str(), allocator),
+                      allocator);
+  if (params.count("reset") != 0 && params.at("reset") == "true") {
+    StackSampler::Reset();
+  }
+  return true;
+}
+
 bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
     rapidjson::Document* response) {
@@ -13,6 +13,7 @@
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
+#include "flutter/common/startup_timeline.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
@@ -36,6 +37,8 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_rate_controller.h"
+#include "flutter/shell/common/input_batcher.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -108,6 +111,7 @@ class Shell final : public PlatformView::Delegate,
                     public Animator::Delegate,
                     public Engine::Delegate,
                     public Rasterizer::Delegate,
+                    public InputBatcher::Delegate,
                     public ServiceProtocol::Handler {
  public:
   template <class T>
@@ -191,7 +195,10 @@ class Shell final : public PlatformView::Delegate,
   ///             configuration as the current Shell but it needs to be in the
   ///             same snapshot or AOT.
   ///
+  /// @return     The spawned shell, or nullptr if it could not be created.
+  ///
   /// @see        http://flutter.dev/go/multiple-engines
+  /// @see        |ShellPool|, to spawn shells before they are needed.
   std::unique_ptr<Shell> Spawn(
       RunConfiguration run_configuration,
       const std::string& initial_route,
@@ -323,6 +330,19 @@ class Shell final : public PlatformView::Delegate,
   ///
   fml::Status WaitForFirstFrame(fml::TimeDelta timeout);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the phases of starting Flutter in this process that have
+  ///             happened so far, such as the creation of the Dart VM and of
+  ///             the root isolate, and the first frame. Only the first shell
+  ///             of a process records the phases that every shell goes
+  ///             through.
+  ///
+  /// @see        StartupTimeline
+  ///
+  /// @return     The phases, sorted by their start time.
+  ///
+  std::vector<StartupTimeline::PhaseTiming> GetStartupPhases() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to reload the system fonts in
   /// FontCollection.
@@ -436,6 +456,19 @@ class Shell final : public PlatformView::Delegate,
   bool is_added_to_service_protocol_ = false;
   uint64_t next_pointer_flow_id_ = 0;
 
+  // Batches the events sent from the platform thread to the UI thread, if
+  // enabled in the settings. Set on the platform thread before the shell is
+  // set up, then used from the platform and UI threads.
+  std::unique_ptr<InputBatcher> input_batcher_;
+  // Whether a task is scheduled on the UI thread to deliver the input batch
+  // in case vsync does not fire. Only accessed on the UI thread.
+  bool input_batch_fallback_scheduled_ = false;
+
+  // Adapts the frame rate of the animator to the content, if enabled in the
+  // settings. Fed with the damage of rasterized frames on the raster thread,
+  // and with user input on the platform thread.
+  std::shared_ptr<FrameRateController> frame_rate_controller_;
+
   bool first_frame_rasterized_ = false;
   std::atomic<bool> waiting_for_first_frame_ = true;
   std::mutex waiting_for_first_frame_mutex_;
@@ -500,6 +533,13 @@ class Shell final : public PlatformView::Delegate,
       const EngineCreateCallback& on_create_engine,
       bool is_gpu_disabled);
 
+  // Creates a shell like |Spawn| but returns it before running it, for
+  // |ShellPool| to run it once it is claimed.
+  std::unique_ptr<Shell> SpawnWithoutRunning(
+      const std::string& initial_route,
+      const CreateCallback<PlatformView>& on_create_platform_view,
+      const CreateCallback<Rasterizer>& on_create_rasterizer) const;
+
   bool Setup(std::unique_ptr<PlatformView> platform_view,
              std::unique_ptr<Engine> engine,
              std::unique_ptr<Rasterizer> rasterizer,
@@ -580,6 +620,32 @@ class Shell final : public PlatformView::Delegate,
   void OnAnimatorDrawLastLayerTree(
       std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) override;
 
+  // Arranges for the events of `input_batcher_` to be delivered on the UI
+  // thread as requested by `delivery`.
+  void ScheduleInputBatchDelivery(InputBatcher::Delivery delivery);
+
+  // Delivers the pending events of `input_batcher_`, or schedules another
+  // check if they are not old enough yet.
+  void OnInputBatchFallback();
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherSetViewportMetrics(
+      const ViewportMetrics& metrics) override;
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPointerDataPacket(
+      std::unique_ptr<PointerDataPacket> packet,
+      uint64_t trace_flow_id) override;
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchPlatformMessage(
+      std::unique_ptr<PlatformMessage> message) override;
+
+  // |InputBatcher::Delegate|
+  void OnInputBatcherDispatchSemanticsAction(int32_t node_id,
+                                             SemanticsAction action,
+                                             fml::MallocMapping args) override;
+
   // |Engine::Delegate|
   void OnEngineUpdateSemantics(
       SemanticsNodeUpdates update,
@@ -617,6 +683,9 @@ class Shell final : public PlatformView::Delegate,
   // |Rasterizer::Delegate|
   void OnFrameRasterized(const FrameTiming&) override;
 
+  // |Rasterizer::Delegate|
+  void OnFrameDamageComputed(bool has_damage) override;
+
   // |Rasterizer::Delegate|
   fml::Milliseconds GetFrameBudget() override;
 
@@ -679,6 +748,31 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Reports how many of the known SkSLs have been precompiled, so tools can
+  // tell whether the first frames still risk compiling shaders.
+  bool OnServiceProtocolGetSkSLPrecompilationProgress(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Returns the events recorded with --trace-engine-buffer, as a string in the
+  // Chrome JSON trace format.
+  bool OnServiceProtocolGetEngineTrace(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Returns the native stacks sampled with --enable-native-sampling-profiler,
+  // in the folded stack format. Discards them afterwards if the "reset"
+  // parameter is "true".
+  bool OnServiceProtocolGetNativeProfile(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Creates an asset bundle from the original settings asset path or
   // directory.
   std::unique_ptr<DirectoryAssetBundle> RestoreOriginalAssetResolver();
@@ -689,6 +783,7 @@ class Shell final : public PlatformView::Delegate,
 
   fml::WeakPtrFactory<Shell> weak_factory_;
   friend class testing::ShellTest;
+  friend class ShellPool;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Shell);
 };
@@ -4,15 +4,120 @@
 
 #include "flutter/shell/common/shell.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/startup_timeline.h"
 #include "flutter/fml/logging.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/runtime/dart_vm_lifecycle.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 
+static Settings CreateSettings(const fml::UniqueFD& assets_dir,
+                               testing::ELFAOTSymbols& aot_symbols) {
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
+        testing::kDefaultAOTAppELFFileName);
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not set up settings with AOT symbols.";
+  } else {
+    settings.application_kernels = [&assets_dir]() {
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+  return settings;
+}
+
+static std::unique_ptr<ThreadHost> CreateThreadHost() {
+  return std::make_unique<ThreadHost>(
+      "io.flutter.bench.", ThreadHost::Type::Platform |
+                               ThreadHost::Type::RASTER |
+                               ThreadHost::Type::IO | ThreadHost::Type::UI);
+}
+
+// A platform view rendering into raster surfaces, so that frames can be
+// rasterized without a GPU.
+class SoftwarePlatformView : public PlatformView,
+                             public GPUSurfaceSoftwareDelegate {
+ public:
+  SoftwarePlatformView(PlatformView::Delegate& delegate,
+                       TaskRunners task_runners)
+      : PlatformView(delegate, std::move(task_runners)) {}
+
+ private:
+  // |PlatformView|
+  std::unique_ptr<Surface> CreateRenderingSurface() override {
+    return std::make_unique<GPUSurfaceSoftware>(this, true);
+  }
+
+  // |GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    return SkSurface::MakeRasterN32Premul(size.width(), size.height());
+  }
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return true;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SoftwarePlatformView);
+};
+
+static std::unique_ptr<Shell> CreateShell(const ThreadHost& thread_host,
+                                          const Settings& settings,
+                                          bool render_frames = false) {
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+
+  return Shell::Create(
+      flutter::PlatformData(), std::move(task_runners), settings,
+      [render_frames](Shell& shell) -> std::unique_ptr<PlatformView> {
+        if (render_frames) {
+          return std::make_unique<SoftwarePlatformView>(
+              shell, shell.GetTaskRunners());
+        }
+        return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+      },
+      [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+}
+
+static void DestroyShell(std::unique_ptr<Shell> shell,
+                         std::unique_ptr<ThreadHost> thread_host) {
+  // Shutdown must occur synchronously on the platform thread.
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      thread_host->platform_thread->GetTaskRunner(),
+      [&shell, &latch]() mutable {
+        shell.reset();
+        latch.Signal();
+      });
+  latch.Wait();
+  thread_host.reset();
+}
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
                                     bool measure_shutdown) {
@@ -24,42 +129,9 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
-    Settings settings = {};
-    settings.task_observer_add = [](intptr_t, fml::closure) {};
-    settings.task_observer_remove = [](intptr_t) {};
-
-    if (DartVM::IsRunningPrecompiledCode()) {
-      aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
-          testing::kDefaultAOTAppELFFileName);
-      FML_CHECK(
-          testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
-          << "Could not set up settings with AOT symbols.";
-    } else {
-      settings.application_kernels = [&]() {
-        std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
-        kernel_mappings.emplace_back(
-            fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
-        return kernel_mappings;
-      };
-    }
-
-    thread_host = std::make_unique<ThreadHost>(
-        "io.flutter.bench.", ThreadHost::Type::Platform |
-                                 ThreadHost::Type::RASTER |
-                                 ThreadHost::Type::IO | ThreadHost::Type::UI);
-
-    TaskRunners task_runners("test",
-                             thread_host->platform_thread->GetTaskRunner(),
-                             thread_host->raster_thread->GetTaskRunner(),
-                             thread_host->ui_thread->GetTaskRunner(),
-                             thread_host->io_thread->GetTaskRunner());
-
-    shell = Shell::Create(
-        flutter::PlatformData(), std::move(task_runners), settings,
-        [](Shell& shell) {
-          return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
-        },
-        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    Settings settings = CreateSettings(assets_dir, aot_symbols);
+    thread_host = CreateThreadHost();
+    shell = CreateShell(*thread_host, settings);
   }
 
   FML_CHECK(shell);
@@ -81,19 +153,8 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_shutdown);
-    // Shutdown must occur synchronously on the platform thread.
-    fml::AutoResetWaitableEvent latch;
-    fml::TaskRunner::RunNowOrPostTask(
-        thread_host->platform_thread->GetTaskRunner(),
-        [&shell, &latch]() mutable {
-          shell.reset();
-          latch.Signal();
-        });
-    latch.Wait();
-    thread_host.reset();
+    DestroyShell(std::move(shell), std::move(thread_host));
   }
-
-  FML_CHECK(!shell);
 }
 
 static void BM_ShellInitialization(benchmark::State& state) {
@@ -120,4 +181,226 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// Creates a shell, runs an entrypoint that renders a single frame, and stops
+// the clock when the frame is rasterized. Unlike |BM_ShellInitialization|,
+// this includes the startup work that finishes after the shell is created.
+static void BM_ShellTimeToFirstFrame(benchmark::State& state) {
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettings(assets_dir, aot_symbols);
+  settings.assets_path = testing::GetFixturesPath();
+  fml::AutoResetWaitableEvent first_frame_latch;
+  settings.frame_rasterized_callback =
+      [&first_frame_latch](const FrameTiming& timing) {
+        first_frame_latch.Signal();
+      };
+
+  while (state.KeepRunning()) {
+    first_frame_latch.Reset();
+    auto thread_host = CreateThreadHost();
+    auto shell = CreateShell(*thread_host, settings, true);
+    FML_CHECK(shell);
+
+    fml::TaskRunner::RunNowOrPostTask(
+        thread_host->platform_thread->GetTaskRunner(), [&]() {
+          auto platform_view = shell->GetPlatformView();
+          platform_view->NotifyCreated();
+          platform_view->SetViewportMetrics({1, 100, 100, 0});
+          auto configuration = RunConfiguration::InferFromSettings(settings);
+          configuration.SetEntrypoint("drawFirstFrame");
+          shell->RunEngine(std::move(configuration));
+        });
+    first_frame_latch.Wait();
+
+    {
+      benchmarking::ScopedPauseTiming pause(state, true);
+      DestroyShell(std::move(shell), std::move(thread_host));
+    }
+  }
+}
+
+BENCHMARK(BM_ShellTimeToFirstFrame)->Unit(benchmark::kMillisecond);
+
+static void PostSync(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                     const fml::closure& task) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(task_runner, [&latch, &task]() {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+// Spawns shells from a running parent and measures how long it takes to get a
+// running one, either spawned on demand or claimed from a pool that was filled
+// while the benchmark was paused, like an application filling it when idle.
+static void SpawnShells(benchmark::State& state, bool from_pool) {
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettings(assets_dir, aot_symbols);
+  settings.assets_path = testing::GetFixturesPath();
+  auto thread_host = CreateThreadHost();
+  auto parent = CreateShell(*thread_host, settings);
+  FML_CHECK(parent);
+  const auto platform_task_runner =
+      thread_host->platform_thread->GetTaskRunner();
+
+  fml::AutoResetWaitableEvent latch;
+  PostSync(platform_task_runner, [&]() {
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("emptyMain");
+    parent->RunEngine(std::move(configuration),
+                      [&latch](Engine::RunStatus run_status) {
+                        FML_CHECK(run_status == Engine::RunStatus::Success);
+                        latch.Signal();
+                      });
+  });
+  latch.Wait();
+
+  auto on_create_platform_view = [](Shell& shell) {
+    return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+  };
+  auto on_create_rasterizer = [](Shell& shell) {
+    return std::make_unique<Rasterizer>(shell);
+  };
+  std::unique_ptr<ShellPool> pool;
+  if (from_pool) {
+    PostSync(platform_task_runner, [&]() {
+      pool = std::make_unique<ShellPool>(*parent, 1, on_create_platform_view,
+                                         on_create_rasterizer);
+    });
+  }
+
+  while (state.KeepRunning()) {
+    if (pool) {
+      benchmarking::ScopedPauseTiming pause(state, true);
+      PostSync(platform_task_runner, [&pool]() { pool->Fill(); });
+    }
+
+    std::unique_ptr<Shell> spawned;
+    PostSync(platform_task_runner, [&]() {
+      auto configuration = RunConfiguration::InferFromSettings(settings);
+      configuration.SetEntrypoint("emptyMain");
+      spawned = pool ? pool->Claim(std::move(configuration), std::string())
+                     : parent->Spawn(std::move(configuration), std::string(),
+                                     on_create_platform_view,
+                                     on_create_rasterizer);
+    });
+    FML_CHECK(spawned);
+
+    {
+      benchmarking::ScopedPauseTiming pause(state, true);
+      PostSync(platform_task_runner, [&spawned]() { spawned.reset(); });
+    }
+  }
+
+  PostSync(platform_task_runner, [&pool]() { pool.reset(); });
+  DestroyShell(std::move(parent), std::move(thread_host));
+}
+
+static void BM_ShellSpawnOnDemand(benchmark::State& state) {
+  SpawnShells(state, false);
+}
+
+BENCHMARK(BM_ShellSpawnOnDemand)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShellClaimFromPool(benchmark::State& state) {
+  SpawnShells(state, true);
+}
+
+BENCHMARK(BM_ShellClaimFromPool)->Unit(benchmark::kMicrosecond);
+
+// The nearest-rank percentile of `values`.
+static double Percentile(std::vector<double> values, double percentile) {
+  FML_CHECK(!values.empty());
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(std::ceil(percentile * values.size()));
+  return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+// Starts a shell and renders its first frame on every iteration, and reports
+// the p50 and p99 duration of each startup phase in microseconds. Cold starts
+// shut the VM down after each iteration, warm starts keep it running, like an
+// application that creates more engines after the first one, so they report
+// no VM creation. Shaders are only precompiled with a GPU context, so the
+// persistent cache load is not reported either.
+static void StartupPhases(benchmark::State& state, bool warm) {
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettings(assets_dir, aot_symbols);
+  settings.assets_path = testing::GetFixturesPath();
+  settings.leak_vm = false;
+  fml::AutoResetWaitableEvent first_frame_latch;
+  settings.frame_rasterized_callback =
+      [&first_frame_latch](const FrameTiming& timing) {
+        first_frame_latch.Signal();
+      };
+
+  std::optional<DartVMRef> warm_vm;
+  if (warm) {
+    warm_vm.emplace(DartVMRef::Create(settings));
+    FML_CHECK(*warm_vm);
+  }
+
+  std::array<std::vector<double>, StartupTimeline::kCount> durations;
+  while (state.KeepRunning()) {
+    StartupTimeline::GetForProcess().Reset();
+    first_frame_latch.Reset();
+    auto thread_host = CreateThreadHost();
+    auto shell = CreateShell(*thread_host, settings, true);
+    FML_CHECK(shell);
+
+    // The frame begins on a vsync from the timer based fallback waiter of the
+    // platform view, and is rasterized into a raster surface.
+    fml::TaskRunner::RunNowOrPostTask(
+        thread_host->platform_thread->GetTaskRunner(), [&]() {
+          auto platform_view = shell->GetPlatformView();
+          platform_view->NotifyCreated();
+          platform_view->SetViewportMetrics({1, 100, 100, 0});
+          auto configuration = RunConfiguration::InferFromSettings(settings);
+          configuration.SetEntrypoint("drawFirstFrame");
+          shell->RunEngine(std::move(configuration),
+                           [](Engine::RunStatus run_status) {
+                             FML_CHECK(run_status ==
+                                       Engine::RunStatus::Success);
+                           });
+        });
+    first_frame_latch.Wait();
+
+    {
+      benchmarking::ScopedPauseTiming pause(state, true);
+      for (const auto& phase : shell->GetStartupPhases()) {
+        durations[phase.phase].push_back(
+            (phase.end - phase.start).ToMicrosecondsF());
+      }
+      DestroyShell(std::move(shell), std::move(thread_host));
+    }
+  }
+
+  for (size_t phase = 0; phase < StartupTimeline::kCount; phase++) {
+    if (durations[phase].empty()) {
+      continue;
+    }
+    const std::string name = StartupTimeline::GetPhaseName(
+        static_cast<StartupTimeline::Phase>(phase));
+    state.counters[name + "_p50_us"] = Percentile(durations[phase], 0.5);
+    state.counters[name + "_p99_us"] = Percentile(durations[phase], 0.99);
+  }
+}
+
+static void BM_ShellColdStartupPhases(benchmark::State& state) {
+  StartupPhases(state, false);
+}
+
+BENCHMARK(BM_ShellColdStartupPhases)->Unit(benchmark::kMillisecond);
+
+static void BM_ShellWarmStartupPhases(benchmark::State& state) {
+  StartupPhases(state, true);
+}
+
+BENCHMARK(BM_ShellWarmStartupPhases)->Unit(benchmark::kMillisecond);
+
 }  // namespace flutter
@@ -36,7 +36,8 @@ sk_sp<GrDirectContext> ShellIOManager::CreateCompatibleResourceLoadingContext(
 ShellIOManager::ShellIOManager(
     sk_sp<GrDirectContext> resource_context,
     std::shared_ptr<const fml::SyncSwitch> is_gpu_disabled_sync_switch,
-    fml::RefPtr<fml::TaskRunner> unref_queue_task_runner)
+    fml::RefPtr<fml::TaskRunner> unref_queue_task_runner,
+    size_t decoded_image_cache_max_bytes)
     : resource_context_(std::move(resource_context)),
       resource_context_weak_factory_(
           resource_context_
@@ -48,6 +49,12 @@ ShellIOManager::ShellIOManager(
           fml::TimeDelta::FromMilliseconds(8),
           GetResourceContext())),
       is_gpu_disabled_sync_switch_(is_gpu_disabled_sync_switch),
+      decoded_image_cache_(
+          decoded_image_cache_max_bytes > 0
+              ? std::make_unique<DecodedImageCache>(
+                    unref_queue_,
+                    decoded_image_cache_max_bytes)
+              : nullptr),
       weak_factory_(this) {
   if (!resource_context_) {
 #ifndef OS_FUCHSIA
@@ -62,7 +69,12 @@ ShellIOManager::~ShellIOManager() {
   // Last chance to drain the IO queue as the platform side reference to the
   // underlying OpenGL context may be going away.
   is_gpu_disabled_sync_switch_->Execute(
-      fml::SyncSwitch::Handlers().SetIfFalse([&] { unref_queue_->Drain(); }));
+      fml::SyncSwitch::Handlers().SetIfFalse([&] {
+        if (decoded_image_cache_) {
+          decoded_image_cache_->Purge();
+        }
+        unref_queue_->Drain();
+      }));
 }
 
 void ShellIOManager::NotifyResourceContextAvailable(
@@ -77,6 +89,10 @@ void ShellIOManager::NotifyResourceContextAvailable(
 
 void ShellIOManager::UpdateResourceContext(
     sk_sp<GrDirectContext> resource_context) {
+  // Cached images may be textures in the previous context.
+  if (decoded_image_cache_) {
+    decoded_image_cache_->Purge();
+  }
   resource_context_ = std::move(resource_context);
   resource_context_weak_factory_ =
       resource_context_
@@ -112,4 +128,9 @@ ShellIOManager::GetIsGpuDisabledSyncSwitch() {
   return is_gpu_disabled_sync_switch_;
 }
 
+// |IOManager|
+DecodedImageCache* ShellIOManager::GetDecodedImageCache() {
+  return decoded_image_cache_.get();
+}
+
 }  // namespace flutter
@@ -27,7 +27,8 @@ class ShellIOManager final : public IOManager {
   ShellIOManager(
       sk_sp<GrDirectContext> resource_context,
       std::shared_ptr<const fml::SyncSwitch> is_gpu_disabled_sync_switch,
-      fml::RefPtr<fml::TaskRunner> unref_queue_task_runner);
+      fml::RefPtr<fml::TaskRunner> unref_queue_task_runner,
+      size_t decoded_image_cache_max_bytes);
 
   ~ShellIOManager() override;
 
@@ -56,6 +57,9 @@ class ShellIOManager final : public IOManager {
   // |IOManager|
   std::shared_ptr<const fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() override;
 
+  // |IOManager|
+  DecodedImageCache* GetDecodedImageCache() override;
+
   sk_sp<GrDirectContext> GetSharedResourceContext() const {
     return resource_context_;
   };
@@ -71,6 +75,9 @@ class ShellIOManager final : public IOManager {
 
   std::shared_ptr<const fml::SyncSwitch> is_gpu_disabled_sync_switch_;
 
+  // Null if decoded images are not cached.
+  std::unique_ptr<DecodedImageCache> decoded_image_cache_;
+
   fml::WeakPtrFactory<ShellIOManager> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ShellIOManager);
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shell_pool.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ShellPool::ShellPool(
+    const Shell& parent,
+    size_t capacity,
+    Shell::CreateCallback<PlatformView> on_create_platform_view,
+    Shell::CreateCallback<Rasterizer> on_create_rasterizer)
+    : parent_(parent),
+      capacity_(capacity),
+      on_create_platform_view_(std::move(on_create_platform_view)),
+      on_create_rasterizer_(std::move(on_create_rasterizer)),
+      weak_factory_(this) {
+  FML_DCHECK(on_create_platform_view_ && on_create_rasterizer_);
+}
+
+ShellPool::~ShellPool() {
+  // Like any shell, the idle shells must be destroyed on the platform thread.
+  FML_DCHECK(parent_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+}
+
+std::unique_ptr<Shell> ShellPool::SpawnIdleShell(
+    const std::string& initial_route) {
+  TRACE_EVENT0("flutter", "ShellPool::SpawnIdleShell");
+  return parent_.SpawnWithoutRunning(initial_route, on_create_platform_view_,
+                                     on_create_rasterizer_);
+}
+
+void ShellPool::Fill() {
+  FML_DCHECK(parent_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+  TRACE_EVENT0("flutter", "ShellPool::Fill");
+  refill_suspended_ = false;
+  while (idle_shells_.size() < capacity_) {
+    auto shell = SpawnIdleShell(std::string());
+    if (!shell) {
+      FML_LOG(ERROR) << "Could not spawn an idle shell.";
+      return;
+    }
+    idle_shells_.push_back(std::move(shell));
+  }
+}
+
+std::unique_ptr<Shell> ShellPool::Claim(RunConfiguration run_configuration,
+                                        const std::string& initial_route) {
+  FML_DCHECK(parent_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+  TRACE_EVENT0("flutter", "ShellPool::Claim");
+  refill_suspended_ = false;
+
+  std::unique_ptr<Shell> shell;
+  if (idle_shells_.empty()) {
+    shell = SpawnIdleShell(initial_route);
+  } else {
+    shell = std::move(idle_shells_.front());
+    idle_shells_.pop_front();
+
+    // The route was not known when the shell was spawned. The engine reads it
+    // when it runs, which is posted to the same thread after this.
+    if (!initial_route.empty()) {
+      fml::TaskRunner::RunNowOrPostTask(
+          shell->GetTaskRunners().GetUITaskRunner(),
+          [engine = shell->GetEngine(), initial_route]() {
+            if (engine) {
+              engine->SetInitialRoute(initial_route);
+            }
+          });
+    }
+
+    // The parent may have lost or regained the GPU since the shell was
+    // spawned.
+    bool is_gpu_disabled = false;
+    parent_.GetIsGpuDisabledSyncSwitch()->Execute(
+        fml::SyncSwitch::Handlers().SetIfTrue(
+            [&is_gpu_disabled] { is_gpu_disabled = true; }));
+    shell->SetGpuAvailability(is_gpu_disabled ? GpuAvailability::kUnavailable
+                                              : GpuAvailability::kAvailable);
+  }
+  ScheduleRefill();
+
+  if (!shell) {
+    return nullptr;
+  }
+  shell->RunEngine(std::move(run_configuration));
+  return shell;
+}
+
+void ShellPool::SetCapacity(size_t capacity) {
+  FML_DCHECK(parent_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+  capacity_ = capacity;
+  while (idle_shells_.size() > capacity_) {
+    idle_shells_.pop_back();
+  }
+  ScheduleRefill();
+}
+
+void ShellPool::NotifyLowMemoryWarning() {
+  FML_DCHECK(parent_.GetTaskRunners()
+                 .GetPlatformTaskRunner()
+                 ->RunsTasksOnCurrentThread());
+  TRACE_EVENT0("flutter", "ShellPool::NotifyLowMemoryWarning");
+  refill_suspended_ = true;
+  idle_shells_.clear();
+}
+
+void ShellPool::ScheduleRefill() {
+  if (refill_scheduled_ || refill_suspended_ ||
+      idle_shells_.size() >= capacity_) {
+    return;
+  }
+  refill_scheduled_ = true;
+  parent_.GetTaskRunners().GetPlatformTaskRunner()->PostTask(
+      [pool = weak_factory_.GetWeakPtr()]() {
+        if (!pool) {
+          return;
+        }
+        pool->refill_scheduled_ = false;
+        if (pool->refill_suspended_ ||
+            pool->idle_shells_.size() >= pool->capacity_) {
+          return;
+        }
+        auto shell = pool->SpawnIdleShell(std::string());
+        if (!shell) {
+          // Do not retry in a loop. The next claim tries again.
+          FML_LOG(ERROR) << "Could not spawn an idle shell.";
+          return;
+        }
+        pool->idle_shells_.push_back(std::move(shell));
+        pool->ScheduleRefill();
+      });
+}
+
+}  // namespace flutter
@@ -0,0 +1,112 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+#define FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps shells spawned from a parent shell ready to be claimed.
+///
+///             Spawning a shell creates its rasterizer, engine, animator and
+///             runtime controller, which delays opening a new page by the
+///             time it takes. The pool spawns the shells ahead of time
+///             instead, and claiming one only has to run it. The pool spawns
+///             a replacement for each claimed shell in a later task, one shell
+///             per task so that the platform thread stays responsive.
+///
+///             The pool, like the shells, must be used on the platform thread
+///             of the parent, and the parent must outlive it.
+///
+class ShellPool {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an empty pool of up to `capacity` idle shells
+  ///             spawned from `parent`. Call |Fill| to spawn them.
+  ///
+  /// @param[in]  on_create_platform_view  Creates the platform view of each
+  ///                                      spawned shell.
+  /// @param[in]  on_create_rasterizer     Creates the rasterizer of each
+  ///                                      spawned shell.
+  ///
+  ShellPool(const Shell& parent,
+            size_t capacity,
+            Shell::CreateCallback<PlatformView> on_create_platform_view,
+            Shell::CreateCallback<Rasterizer> on_create_rasterizer);
+
+  ~ShellPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Spawns idle shells until the pool is at capacity. Unlike the
+  ///             replacement of claimed shells, this happens before the call
+  ///             returns.
+  ///
+  void Fill();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs an idle shell with the given configuration and hands it
+  ///             to the caller, or spawns one if the pool is empty. This is
+  ///             equivalent to |Shell::Spawn| with the callbacks of the pool.
+  ///
+  /// @param[in]  run_configuration  The configuration to run the shell with.
+  ///                                It must be in the same snapshot as the
+  ///                                parent.
+  /// @param[in]  initial_route      The initial route of the shell.
+  ///
+  /// @return     The running shell, or nullptr if it could not be spawned.
+  ///
+  std::unique_ptr<Shell> Claim(RunConfiguration run_configuration,
+                               const std::string& initial_route);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Changes the number of idle shells to keep. Extra idle shells
+  ///             are destroyed right away, and missing ones are spawned in
+  ///             later tasks.
+  ///
+  void SetCapacity(size_t capacity);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Destroys the idle shells to release their memory. The pool
+  ///             spawns no more shells until the next |Claim| or |Fill|.
+  ///             Embedders should call this along with
+  ///             |Shell::NotifyLowMemoryWarning| on the parent.
+  ///
+  void NotifyLowMemoryWarning();
+
+  /// The number of shells that are ready to be claimed.
+  size_t GetIdleCount() const { return idle_shells_.size(); }
+
+  size_t GetCapacity() const { return capacity_; }
+
+ private:
+  const Shell& parent_;
+  size_t capacity_;
+  const Shell::CreateCallback<PlatformView> on_create_platform_view_;
+  const Shell::CreateCallback<Rasterizer> on_create_rasterizer_;
+  std::deque<std::unique_ptr<Shell>> idle_shells_;
+  bool refill_scheduled_ = false;
+  // Set under memory pressure, until the pool is used again.
+  bool refill_suspended_ = false;
+  fml::WeakPtrFactory<ShellPool> weak_factory_;
+
+  std::unique_ptr<Shell> SpawnIdleShell(const std::string& initial_route);
+
+  void ScheduleRefill();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShellPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHELL_POOL_H_
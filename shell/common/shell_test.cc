@@ -271,6 +271,16 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kRunInView:
             shell->OnServiceProtocolRunInView(params, response);
             break;
+          case ServiceProtocolEnum::kGetSkSLPrecompilationProgress:
+            shell->OnServiceProtocolGetSkSLPrecompilationProgress(params,
+                                                                  response);
+            break;
+          case ServiceProtocolEnum::kGetEngineTrace:
+            shell->OnServiceProtocolGetEngineTrace(params, response);
+            break;
+          case ServiceProtocolEnum::kGetNativeProfile:
+            shell->OnServiceProtocolGetNativeProfile(params, response);
+            break;
         }
         finished.set_value(true);
       });
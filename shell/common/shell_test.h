@@ -105,6 +105,9 @@ class ShellTest : public FixtureTest {
     kEstimateRasterCacheMemory,
     kSetAssetBundlePath,
     kRunInView,
+    kGetSkSLPrecompilationProgress,
+    kGetEngineTrace,
+    kGetNativeProfile,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "assets/directory_asset_bundle.h"
@@ -23,15 +24,18 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_external_view_embedder.h"
+#include "flutter/shell/common/shell_pool.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/common/vsync_waiter_fallback.h"
+#include "flutter/shell/profiling/stack_sampler.h"
 #include "flutter/shell/version/version.h"
 #include "flutter/testing/testing.h"
 #include "gmock/gmock.h"
@@ -2157,6 +2161,87 @@ TEST_F(ShellTest,
                                 << expected_json1 << " or " << expected_json2;
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetSkSLPrecompilationProgressWorks) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(),
+                    ServiceProtocolEnum::kGetSkSLPrecompilationProgress,
+                    shell->GetTaskRunners().GetIOTaskRunner(), empty_params,
+                    &document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  DestroyShell(std::move(shell));
+
+  // Nothing has been precompiled without a rendering context.
+  std::string expected_json =
+      "{\"type\":\"SkSLPrecompilationProgress\",\"compiled\":0,"
+      "\"succeeded\":0,\"total\":0}";
+  ASSERT_EQ(buffer.GetString(), expected_json);
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetEngineTraceWorks) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  fml::tracing::TraceBufferClear();
+  fml::tracing::TraceBufferEnable();
+  fml::tracing::TraceEventInstant0("flutter", "EngineTraceTestEvent");
+  fml::tracing::TraceBufferDisable();
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetEngineTrace,
+                    shell->GetTaskRunners().GetIOTaskRunner(), empty_params,
+                    &document);
+  DestroyShell(std::move(shell));
+  fml::tracing::TraceBufferClear();
+
+  ASSERT_TRUE(document.IsObject());
+  ASSERT_STREQ(document["type"].GetString(), "EngineTrace");
+  ASSERT_FALSE(document["enabled"].GetBool());
+  rapidjson::Document trace;
+  trace.Parse(document["trace"].GetString());
+  ASSERT_TRUE(trace.IsObject());
+  ASSERT_TRUE(trace["traceEvents"].IsArray());
+#if FLUTTER_TIMELINE_ENABLED
+  const std::string events = document["trace"].GetString();
+  ASSERT_NE(events.find("\"name\":\"EngineTraceTestEvent\""),
+            std::string::npos);
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetNativeProfileWorks) {
+  Settings settings = CreateSettingsForFixture();
+  settings.enable_native_sampling_profiler = true;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  StackSampler::Reset();
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["reset"] = "true";
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetNativeProfile,
+                    shell->GetTaskRunners().GetIOTaskRunner(), params,
+                    &document);
+  DestroyShell(std::move(shell));
+
+  ASSERT_TRUE(document.IsObject());
+  ASSERT_STREQ(document["type"].GetString(), "NativeProfile");
+  ASSERT_EQ(document["running"].GetBool(), StackSampler::IsSupported());
+  ASSERT_TRUE(document["sampleCount"].IsUint64());
+  ASSERT_TRUE(document["folded"].IsString());
+  if (!StackSampler::IsSupported()) {
+    ASSERT_STREQ(document["folded"].GetString(), "");
+  }
+}
+
 TEST_F(ShellTest, RasterizerScreenshot) {
   Settings settings = CreateSettingsForFixture();
   auto configuration = RunConfiguration::InferFromSettings(settings);
@@ -2534,6 +2619,46 @@ TEST_F(ShellTest, IgnoresInvalidMetrics) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, InputBatchingCoalescesViewportMetrics) {
+  fml::AutoResetWaitableEvent latch;
+  int report_count = 0;
+  double last_width = 0.0;
+  auto native_report_metrics = [&](Dart_NativeArguments args) {
+    report_count++;
+    Dart_DoubleValue(Dart_GetNativeArgument(args, 1), &last_width);
+    latch.Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  settings.enable_input_batching = true;
+  auto task_runner = CreateNewThread();
+  TaskRunners task_runners("test", task_runner, task_runner, task_runner,
+                           task_runner);
+
+  AddNativeCallback("ReportMetrics",
+                    CREATE_NATIVE_ENTRY(native_report_metrics));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("reportMetrics");
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  // Both updates are sent before the next vsync, so only the last one reaches
+  // the framework.
+  task_runner->PostTask([&]() {
+    shell->GetPlatformView()->SetViewportMetrics({1.0, 400, 200, 22});
+    shell->GetPlatformView()->SetViewportMetrics({1.0, 600, 300, 22});
+  });
+  latch.Wait();
+  ASSERT_EQ(report_count, 1);
+  ASSERT_EQ(last_width, 600.0);
+
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 TEST_F(ShellTest,
 #if defined(WINUWP)
        // TODO(cbracken): https://github.com/flutter/flutter/issues/90481
@@ -2591,6 +2716,86 @@ TEST_F(ShellTest,
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, RecordsStartupPhases) {
+  StartupTimeline::GetForProcess().Reset();
+
+  Settings settings = CreateSettingsForFixture();
+  fml::AutoResetWaitableEvent rasterized;
+  settings.frame_rasterized_callback = [&rasterized](const FrameTiming&) {
+    rasterized.Signal();
+  };
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+  rasterized.Wait();
+
+  auto phases = shell->GetStartupPhases();
+  std::set<StartupTimeline::Phase> recorded;
+  for (size_t i = 0; i < phases.size(); i++) {
+    EXPECT_LE(phases[i].start, phases[i].end);
+    if (i > 0) {
+      EXPECT_LE(phases[i - 1].start, phases[i].start);
+    }
+    recorded.insert(phases[i].phase);
+  }
+  // The VM is only created if no other test left it running, and shaders are
+  // only precompiled with a GPU context.
+  for (auto phase : {StartupTimeline::kDartSnapshotMapping,
+                     StartupTimeline::kAssetManagerSetup,
+                     StartupTimeline::kIsolateCreation,
+                     StartupTimeline::kFirstBeginFrame,
+                     StartupTimeline::kFirstRasterizedFrame}) {
+    EXPECT_EQ(recorded.count(phase), 1u)
+        << StartupTimeline::GetPhaseName(phase);
+  }
+
+  // Only the first occurrence of a phase is recorded.
+  auto isolate_creation =
+      std::find_if(phases.begin(), phases.end(), [](const auto& phase) {
+        return phase.phase == StartupTimeline::kIsolateCreation;
+      });
+  ASSERT_NE(isolate_creation, phases.end());
+  const fml::TimePoint now = fml::TimePoint::Now();
+  StartupTimeline::GetForProcess().RecordPhase(
+      StartupTimeline::kIsolateCreation, now, now);
+  for (const auto& phase : shell->GetStartupPhases()) {
+    if (phase.phase == StartupTimeline::kIsolateCreation) {
+      EXPECT_EQ(phase.start, isolate_creation->start);
+    }
+  }
+
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, CanLoadAssetsAfterPrefetchingThem) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  RunConfiguration configuration =
+      RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("canPrefetchResourcesFromAssetDir");
+
+  fml::AutoResetWaitableEvent latch;
+  bool can_access_resource = false;
+  auto native_can_access_resource = [&can_access_resource,
+                                     &latch](Dart_NativeArguments args) {
+    Dart_Handle exception = nullptr;
+    can_access_resource =
+        tonic::DartConverter<bool>::FromArguments(args, 0, exception);
+    latch.Signal();
+  };
+  AddNativeCallback("NotifyCanAccessResource",
+                    CREATE_NATIVE_ENTRY(native_can_access_resource));
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  latch.Wait();
+  ASSERT_TRUE(can_access_resource);
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, EngineRootIsolateLaunchesDontTakeVMDataSettings) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   // Make sure the shell launch does not kick off the creation of the VM
@@ -2963,6 +3168,75 @@ TEST_F(ShellTest, SpawnWithDartEntrypointArgs) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, ShellPoolRunsClaimedShellsAndRefills) {
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  fml::AutoResetWaitableEvent claimed_latch;
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&](auto args) { claimed_latch.Signal(); }));
+
+  const auto platform_task_runner =
+      shell->GetTaskRunners().GetPlatformTaskRunner();
+  std::unique_ptr<ShellPool> pool;
+  PostSync(platform_task_runner, [&]() {
+    pool = std::make_unique<ShellPool>(
+        *shell, 2,
+        [](Shell& shell) {
+          return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+        },
+        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    ASSERT_EQ(pool->GetIdleCount(), 0u);
+    pool->Fill();
+    ASSERT_EQ(pool->GetIdleCount(), 2u);
+  });
+
+  const std::string initial_route("/foo");
+  PostSync(platform_task_runner, [&]() {
+    auto claimed_configuration = RunConfiguration::InferFromSettings(settings);
+    claimed_configuration.SetEntrypoint("fixturesAreFunctionalMain");
+    auto claimed =
+        pool->Claim(std::move(claimed_configuration), initial_route);
+    ASSERT_NE(claimed, nullptr);
+    ASSERT_TRUE(ValidateShell(claimed.get()));
+    ASSERT_EQ(pool->GetIdleCount(), 1u);
+    claimed_latch.Wait();
+
+    PostSync(claimed->GetTaskRunners().GetUITaskRunner(), [&claimed,
+                                                           initial_route]() {
+      ASSERT_EQ("fixturesAreFunctionalMain",
+                claimed->GetEngine()->GetLastEntrypoint());
+      ASSERT_EQ(initial_route, claimed->GetEngine()->InitialRoute());
+    });
+    DestroyShell(std::move(claimed));
+  });
+
+  // The claimed shell was replaced by a task posted while claiming it.
+  PostSync(platform_task_runner, [&]() {
+    ASSERT_EQ(pool->GetIdleCount(), 2u);
+    pool->NotifyLowMemoryWarning();
+    ASSERT_EQ(pool->GetIdleCount(), 0u);
+    pool->SetCapacity(1);
+  });
+
+  // Under memory pressure, nothing is spawned until the pool is used again.
+  PostSync(platform_task_runner, [&]() {
+    ASSERT_EQ(pool->GetIdleCount(), 0u);
+    pool->Fill();
+    ASSERT_EQ(pool->GetIdleCount(), 1u);
+    pool.reset();
+  });
+
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
 TEST_F(ShellTest, UpdateAssetResolverByTypeReplaces) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   Settings settings = CreateSettingsForFixture();
@@ -3270,6 +3544,36 @@ TEST_F(ShellTest, PrefetchDefaultFontManager) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, SetsUpConcurrentlyCreatedDefaultFontManager) {
+  auto get_font_manager_count = [this](Shell* shell) {
+    fml::AutoResetWaitableEvent latch;
+    size_t font_manager_count;
+    fml::TaskRunner::RunNowOrPostTask(
+        shell->GetTaskRunners().GetUITaskRunner(),
+        [this, shell, &latch, &font_manager_count]() {
+          font_manager_count = GetFontCollection(shell)->GetFontManagersCount();
+          latch.Signal();
+        });
+    latch.Wait();
+    return font_manager_count;
+  };
+
+  auto settings = CreateSettingsForFixture();
+  settings.prefetched_default_font_manager = true;
+  auto shell = CreateShell(settings);
+  const size_t font_manager_count_without_default =
+      get_font_manager_count(shell.get());
+  DestroyShell(std::move(shell));
+
+  // The default font manager is created on the concurrent workers while the
+  // shell is created, and set up by a UI task posted as soon as it is.
+  settings.prefetched_default_font_manager = false;
+  shell = CreateShell(settings);
+  ASSERT_EQ(get_font_manager_count(shell.get()),
+            font_manager_count_without_default + 1);
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, OnPlatformViewCreatedWhenUIThreadIsBusy) {
   // This test will deadlock if the threading logic in
   // Shell::OnCreatePlatformView is wrong.
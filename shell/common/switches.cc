@@ -296,6 +296,22 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_startup =
       command_line.HasOption(FlagForSwitch(Switch::TraceStartup));
 
+  settings.trace_engine_buffer =
+      command_line.HasOption(FlagForSwitch(Switch::TraceEngineBuffer));
+
+  settings.enable_native_sampling_profiler = command_line.HasOption(
+      FlagForSwitch(Switch::EnableNativeSamplingProfiler));
+
+  settings.enable_input_batching =
+      command_line.HasOption(FlagForSwitch(Switch::EnableInputBatching));
+  std::string input_batching_bypass;
+  command_line.GetOptionValue(FlagForSwitch(Switch::InputBatchingBypass),
+                              &input_batching_bypass);
+  settings.input_batching_bypass = ParseCommaDelimited(input_batching_bypass);
+
+  settings.enable_adaptive_frame_rate =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAdaptiveFrameRate));
+
 #if !FLUTTER_RELEASE
   settings.trace_skia = true;
 
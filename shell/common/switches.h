@@ -160,6 +160,33 @@ DEF_SWITCH(PurgePersistentCache,
            "purge-persistent-cache",
            "Remove all existing persistent cache. This is mainly for debugging "
            "purposes such as reproducing the shader compilation jank.")
+DEF_SWITCH(TraceEngineBuffer,
+           "trace-engine-buffer",
+           "Record engine trace events into per-thread ring buffers, including "
+           "those emitted before the Dart VM starts. The buffers are "
+           "returned by the _flutter.getEngineTrace service extension in the "
+           "Chrome JSON trace format.")
+DEF_SWITCH(EnableNativeSamplingProfiler,
+           "enable-native-sampling-profiler",
+           "Periodically sample the native call stacks of the engine threads. "
+           "The samples are returned by the _flutter.getNativeProfile service "
+           "extension in the folded stack format used by flame graph tools. "
+           "Only supported on Linux and Android.")
+DEF_SWITCH(EnableInputBatching,
+           "enable-input-batching",
+           "Batch the input events, platform messages and semantics actions "
+           "sent to the UI thread, and deliver them at the start of the next "
+           "frame or at the next vsync instead of one at a time.")
+DEF_SWITCH(InputBatchingBypass,
+           "input-batching-bypass",
+           "A comma separated list of the event types that are delivered right "
+           "away when input batching is enabled. The types are "
+           "viewport-metrics, pointer, platform-message and semantics-action.")
+DEF_SWITCH(EnableAdaptiveFrameRate,
+           "enable-adaptive-frame-rate",
+           "Skip vsyncs while animating content that changes less often than "
+           "the display refreshes, and ask the platform for a matching display "
+           "refresh rate where supported.")
 DEF_SWITCH(
     TraceSystrace,
     "trace-systrace",
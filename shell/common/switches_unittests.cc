@@ -46,5 +46,57 @@ TEST(SwitchesTest, SkiaTraceAllowlistFlag) {
 #endif
 }
 
+TEST(SwitchesTest, TraceEngineBufferFlag) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_FALSE(settings.trace_engine_buffer);
+
+  command_line =
+      fml::CommandLineFromInitializerList({"command", "--trace-engine-buffer"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_TRUE(settings.trace_engine_buffer);
+}
+
+TEST(SwitchesTest, EnableNativeSamplingProfilerFlag) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_FALSE(settings.enable_native_sampling_profiler);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--enable-native-sampling-profiler"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_TRUE(settings.enable_native_sampling_profiler);
+}
+
+TEST(SwitchesTest, InputBatchingFlags) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_FALSE(settings.enable_input_batching);
+  EXPECT_TRUE(settings.input_batching_bypass.empty());
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--enable-input-batching",
+       "--input-batching-bypass=pointer,platform-message"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_TRUE(settings.enable_input_batching);
+  EXPECT_EQ(settings.input_batching_bypass,
+            (std::vector<std::string>{"pointer", "platform-message"}));
+}
+
+TEST(SwitchesTest, EnableAdaptiveFrameRate) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_FALSE(settings.enable_adaptive_frame_rate);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--enable-adaptive-frame-rate"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_TRUE(settings.enable_adaptive_frame_rate);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -163,6 +163,8 @@ bool VsyncWaiter::ShouldAwaitVSyncOnIdle() {
   return true;
 }
 
+void VsyncWaiter::SetPreferredFrameRate(double frame_rate) {}
+
 void VsyncWaiter::PauseDartMicroTasks() {
   auto ui_task_queue_id = task_runners_.GetUITaskRunner()->GetTaskQueueId();
   auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
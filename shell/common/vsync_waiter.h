@@ -36,6 +36,13 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   /// true.
   virtual bool ShouldAwaitVSyncOnIdle();
 
+  /// Informs the platform of the rate, in frames per second, at which the
+  /// animator currently begins frames, so that it may match the display
+  /// refresh rate to it. Only called on the UI thread, when the frame rate is
+  /// adapted to the content. See |FrameRateController|. The default
+  /// implementation does nothing.
+  virtual void SetPreferredFrameRate(double frame_rate);
+
  protected:
   // On some backends, the |FireCallback| needs to be made from a static C
   // method.
@@ -64,5 +64,26 @@ void ConstantFiringVsyncWaiter::AwaitVSync() {
   });
 }
 
+bool SimulatedVsyncWaiter::SimulateVSync() {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  vsync_start_time_ = vsync_start_time_ + period_;
+  if (!vsync_requested_) {
+    return false;
+  }
+  vsync_requested_ = false;
+  FireCallback(vsync_start_time_, vsync_start_time_ + period_);
+  return true;
+}
+
+void SimulatedVsyncWaiter::SetPreferredFrameRate(double frame_rate) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  preferred_frame_rate_ = frame_rate;
+}
+
+void SimulatedVsyncWaiter::AwaitVSync() {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  vsync_requested_ = true;
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -56,6 +56,37 @@ class ConstantFiringVsyncWaiter : public VsyncWaiter {
   void AwaitVSync() override;
 };
 
+/// A display that refreshes at a fixed period on a simulated clock, and
+/// records the frame rate preferred by the engine. All methods must be called
+/// on the UI thread.
+class SimulatedVsyncWaiter : public VsyncWaiter {
+ public:
+  SimulatedVsyncWaiter(TaskRunners task_runners, fml::TimeDelta period)
+      : VsyncWaiter(std::move(task_runners)), period_(period) {}
+
+  /// Simulate the next vsync of the display, one period after the previous
+  /// one. Returns whether a callback was waiting for the vsync, in which case
+  /// it is posted to the UI thread.
+  bool SimulateVSync();
+
+  /// The last frame rate passed to |SetPreferredFrameRate|, or 0.
+  double GetPreferredFrameRate() const { return preferred_frame_rate_; }
+
+  // |VsyncWaiter|
+  void SetPreferredFrameRate(double frame_rate) override;
+
+ protected:
+  // |VsyncWaiter|
+  void AwaitVSync() override;
+
+ private:
+  const fml::TimeDelta period_;
+  // Set in the past so that vsyncs are processed right away.
+  fml::TimePoint vsync_start_time_;
+  bool vsync_requested_ = false;
+  double preferred_frame_rate_ = 0;
+};
+
 }  // namespace testing
 }  // namespace flutter
 
@@ -46,31 +46,58 @@ void AccessibilityBridge::CommitUpdates() {
   ui::AXTreeUpdate update{.tree_data = tree_.data()};
   // Figure out update order, ui::AXTree only accepts update in tree order,
   // where parent node must come before the child node in
-  // ui::AXTreeUpdate.nodes. We start with picking a random node and turn the
-  // entire subtree into a list. We pick another node from the remaining update,
-  // and keep doing so until the update map is empty. We then concatenate the
-  // lists in the reversed order, this guarantees parent updates always come
-  // before child updates.
-  std::vector<std::vector<SemanticsNode>> results;
+  // ui::AXTreeUpdate.nodes. We start with picking a random node and move the
+  // entire subtree into a flat list. We pick another node from the remaining
+  // update, and keep doing so until the update map is empty. We then convert
+  // the subtree lists in the reversed order, this guarantees parent updates
+  // always come before child updates.
+  std::vector<SemanticsNode> nodes;
+  nodes.reserve(pending_semantics_node_updates_.size());
+  std::vector<size_t> subtree_starts;
   while (!pending_semantics_node_updates_.empty()) {
-    auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
-    pending_semantics_node_updates_.erase(begin);
+    subtree_starts.push_back(nodes.size());
+    MoveSubTreeList(pending_semantics_node_updates_.begin()->first, nodes);
   }
 
-  for (size_t i = results.size(); i > 0; i--) {
-    for (SemanticsNode node : results[i - 1]) {
-      ConvertFluterUpdate(node, update);
+  // Nodes that are removed from their parent by this update, along with their
+  // subtrees, are destroyed and must be sent in full to be recreated.
+  std::unordered_set<AccessibilityNodeId> detached_ids;
+  for (const SemanticsNode& node : nodes) {
+    ui::AXNode* ax_node = tree_.GetFromId(node.id);
+    if (!ax_node) {
+      continue;
+    }
+    std::unordered_set<int32_t> new_children(
+        node.children_in_traversal_order.begin(),
+        node.children_in_traversal_order.end());
+    for (ui::AXNode* child : ax_node->children()) {
+      if (new_children.find(child->id()) == new_children.end()) {
+        detached_ids.insert(child->id());
+      }
     }
   }
 
-  tree_.Unserialize(update);
-  pending_semantics_node_updates_.clear();
+  update.nodes.reserve(nodes.size());
+  size_t subtree_end = nodes.size();
+  for (size_t i = subtree_starts.size(); i > 0; i--) {
+    size_t subtree_start = subtree_starts[i - 1];
+    for (size_t j = subtree_start; j < subtree_end; j++) {
+      ConvertFluterUpdate(nodes[j], update);
+      // Leave out nodes that the tree already has, so that the tree doesn't
+      // have to diff them again.
+      if (IsNodeUnchanged(update.nodes.back(), detached_ids)) {
+        update.nodes.pop_back();
+      }
+    }
+    subtree_end = subtree_start;
+  }
   pending_semantics_custom_action_updates_.clear();
 
+  if (update.nodes.empty() && !update.has_tree_data) {
+    return;
+  }
+  tree_.Unserialize(update);
+
   std::string error = tree_.error();
   if (!error.empty()) {
     BASE_LOG() << "Failed to update ui::AXTree, error: " << error;
@@ -178,17 +205,62 @@ void AccessibilityBridge::OnAtomicUpdateFinished(
 }
 
 // Private method.
-void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
-                                         std::vector<SemanticsNode>& result) {
-  result.push_back(target);
-  for (int32_t child : target.children_in_traversal_order) {
-    auto iter = pending_semantics_node_updates_.find(child);
-    if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
-      pending_semantics_node_updates_.erase(iter);
+void AccessibilityBridge::MoveSubTreeList(int32_t target,
+                                          std::vector<SemanticsNode>& result) {
+  // Walk the pending subtree in pre-order with an explicit stack, since long
+  // lists can make the semantics tree too deep to recurse through.
+  std::vector<int32_t> stack = {target};
+  while (!stack.empty()) {
+    int32_t id = stack.back();
+    stack.pop_back();
+    auto iter = pending_semantics_node_updates_.find(id);
+    if (iter == pending_semantics_node_updates_.end()) {
+      continue;
+    }
+    result.push_back(std::move(iter->second));
+    pending_semantics_node_updates_.erase(iter);
+    const std::vector<int32_t>& children =
+        result.back().children_in_traversal_order;
+    stack.insert(stack.end(), children.rbegin(), children.rend());
+  }
+}
+
+bool AccessibilityBridge::IsNodeUnchanged(
+    const ui::AXNodeData& node_data,
+    const std::unordered_set<AccessibilityNodeId>& detached_ids) const {
+  ui::AXNode* node = tree_.GetFromId(node_data.id);
+  if (!node) {
+    return false;
+  }
+  // A node that is moved or removed by this update is recreated by the tree.
+  for (ui::AXNode* ancestor = node; ancestor; ancestor = ancestor->parent()) {
+    if (detached_ids.find(ancestor->id()) != detached_ids.end()) {
+      return false;
     }
   }
+
+  const ui::AXNodeData& old_data = node->data();
+  // The offset container is filled in by the tree after each update, so only
+  // the bounds and transform come from the semantics node.
+  const gfx::Transform* old_transform =
+      old_data.relative_bounds.transform.get();
+  const gfx::Transform* new_transform =
+      node_data.relative_bounds.transform.get();
+  if (!old_transform != !new_transform ||
+      (old_transform && *old_transform != *new_transform)) {
+    return false;
+  }
+  return old_data.role == node_data.role && old_data.state == node_data.state &&
+         old_data.actions == node_data.actions &&
+         old_data.relative_bounds.bounds == node_data.relative_bounds.bounds &&
+         old_data.child_ids == node_data.child_ids &&
+         old_data.string_attributes == node_data.string_attributes &&
+         old_data.int_attributes == node_data.int_attributes &&
+         old_data.float_attributes == node_data.float_attributes &&
+         old_data.bool_attributes == node_data.bool_attributes &&
+         old_data.intlist_attributes == node_data.intlist_attributes &&
+         old_data.stringlist_attributes == node_data.stringlist_attributes &&
+         old_data.html_attributes == node_data.html_attributes;
 }
 
 void AccessibilityBridge::ConvertFluterUpdate(const SemanticsNode& node,
@@ -216,7 +288,7 @@ void AccessibilityBridge::ConvertFluterUpdate(const SemanticsNode& node,
     node_data.child_ids.push_back(child);
   }
   SetTreeData(node, tree_update);
-  tree_update.nodes.push_back(node_data);
+  tree_update.nodes.push_back(std::move(node_data));
 }
 
 void AccessibilityBridge::SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/accessibility_bridge.h"
+#include "flutter/shell/platform/common/test_accessibility_bridge.h"
+
+namespace flutter {
+
+namespace {
+
+// A semantics tree like a long list: a root with one labelled item per row.
+class ListSemanticsTree {
+ public:
+  explicit ListSemanticsTree(size_t length)
+      : labels_(length + 1), children_(length) {
+    for (size_t i = 0; i < length; i++) {
+      children_[i] = i + 1;
+    }
+    labels_[0] = "list";
+    for (size_t i = 1; i <= length; i++) {
+      labels_[i] = "item " + std::to_string(i);
+    }
+  }
+
+  size_t size() const { return labels_.size(); }
+
+  void SetLabel(int32_t id, std::string label) {
+    labels_[id] = std::move(label);
+  }
+
+  // Adds an update for the node |id| to |bridge|.
+  void AddUpdate(AccessibilityBridge* bridge, int32_t id) const {
+    FlutterSemanticsNode node = {};
+    node.id = id;
+    node.text_selection_base = -1;
+    node.text_selection_extent = -1;
+    node.label = labels_[id].c_str();
+    node.hint = "";
+    node.value = "";
+    node.increased_value = "";
+    node.decreased_value = "";
+    node.rect = {0, 48.0 * id, 400, 48.0 * (id + 1)};
+    node.transform = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    if (id == 0) {
+      node.child_count = children_.size();
+      node.children_in_traversal_order = children_.data();
+    }
+    bridge->AddFlutterSemanticsNodeUpdate(&node);
+  }
+
+  // Adds updates for every node to |bridge|.
+  void AddUpdates(AccessibilityBridge* bridge) const {
+    for (size_t i = 0; i < size(); i++) {
+      AddUpdate(bridge, i);
+    }
+  }
+
+ private:
+  std::vector<std::string> labels_;
+  std::vector<int32_t> children_;
+};
+
+std::shared_ptr<AccessibilityBridge> CreateBridge() {
+  return std::make_shared<AccessibilityBridge>(
+      std::make_unique<TestAccessibilityBridgeDelegate>());
+}
+
+}  // namespace
+
+// Builds the whole tree from scratch, as when accessibility is enabled.
+static void BM_AccessibilityBridgeCreateTree(benchmark::State& state) {
+  ListSemanticsTree tree(state.range(0));
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto bridge = CreateBridge();
+    tree.AddUpdates(bridge.get());
+    state.ResumeTiming();
+    bridge->CommitUpdates();
+  }
+}
+
+// Resends every node when only one of them has changed.
+static void BM_AccessibilityBridgeUpdateAllNodes(benchmark::State& state) {
+  ListSemanticsTree tree(state.range(0));
+  auto bridge = CreateBridge();
+  tree.AddUpdates(bridge.get());
+  bridge->CommitUpdates();
+  int generation = 0;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    tree.SetLabel(1, "item 1 v" + std::to_string(generation++));
+    tree.AddUpdates(bridge.get());
+    state.ResumeTiming();
+    bridge->CommitUpdates();
+  }
+}
+
+// Sends only the node that has changed.
+static void BM_AccessibilityBridgeUpdateOneNode(benchmark::State& state) {
+  ListSemanticsTree tree(state.range(0));
+  auto bridge = CreateBridge();
+  tree.AddUpdates(bridge.get());
+  bridge->CommitUpdates();
+  int generation = 0;
+  while (state.KeepRunning()) {
+    tree.SetLabel(1, "item 1 v" + std::to_string(generation++));
+    tree.AddUpdate(bridge.get(), 1);
+    bridge->CommitUpdates();
+  }
+}
+
+BENCHMARK(BM_AccessibilityBridgeCreateTree)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AccessibilityBridgeUpdateAllNodes)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AccessibilityBridgeUpdateOneNode)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
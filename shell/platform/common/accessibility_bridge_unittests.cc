@@ -11,6 +11,29 @@
 namespace flutter {
 namespace testing {
 
+namespace {
+
+// Returns a semantics node with the given |label| and |children|.
+FlutterSemanticsNode CreateSemanticsNode(int32_t id,
+                                         const char* label,
+                                         const std::vector<int32_t>& children) {
+  FlutterSemanticsNode node = {};
+  node.id = id;
+  node.text_selection_base = -1;
+  node.text_selection_extent = -1;
+  node.label = label;
+  node.hint = "";
+  node.value = "";
+  node.increased_value = "";
+  node.decreased_value = "";
+  node.child_count = children.size();
+  node.children_in_traversal_order = children.data();
+  node.custom_accessibility_actions_count = 0;
+  return node;
+}
+
+}  // namespace
+
 TEST(AccessibilityBridgeTest, basicTest) {
   std::shared_ptr<AccessibilityBridge> bridge =
       std::make_shared<AccessibilityBridge>(
@@ -289,5 +312,76 @@ TEST(AccessibilityBridgeTest, doesNotAssignEditableRootToSelectableText) {
       ax::mojom::BoolAttribute::kEditableRoot));
 }
 
+TEST(AccessibilityBridgeTest, skipsUnchangedNodes) {
+  TestAccessibilityBridgeDelegate* delegate =
+      new TestAccessibilityBridgeDelegate();
+  std::unique_ptr<TestAccessibilityBridgeDelegate> ptr(delegate);
+  std::shared_ptr<AccessibilityBridge> bridge =
+      std::make_shared<AccessibilityBridge>(std::move(ptr));
+  std::vector<int32_t> children = {1};
+  std::vector<int32_t> no_children;
+  FlutterSemanticsNode root = CreateSemanticsNode(0, "root", children);
+  FlutterSemanticsNode child1 = CreateSemanticsNode(1, "child 1", no_children);
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+  delegate->accessibilitiy_events.clear();
+
+  // Resend both nodes, only changing the child.
+  child1.label = "new child 1";
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+
+  auto child1_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  EXPECT_EQ(child1_node->GetName(), "new child 1");
+  ASSERT_FALSE(delegate->accessibilitiy_events.empty());
+  for (const auto& event : delegate->accessibilitiy_events) {
+    EXPECT_EQ(event.node->id(), 1);
+  }
+  delegate->accessibilitiy_events.clear();
+
+  // Resending unchanged nodes doesn't change the tree.
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+
+  EXPECT_TRUE(delegate->accessibilitiy_events.empty());
+  EXPECT_EQ(bridge->GetFlutterPlatformNodeDelegateFromID(1).lock(),
+            child1_node);
+}
+
+TEST(AccessibilityBridgeTest, canMoveUnchangedNodes) {
+  std::shared_ptr<AccessibilityBridge> bridge =
+      std::make_shared<AccessibilityBridge>(
+          std::make_unique<TestAccessibilityBridgeDelegate>());
+  std::vector<int32_t> root_children = {1, 2};
+  std::vector<int32_t> moved_children = {3};
+  std::vector<int32_t> no_children;
+  FlutterSemanticsNode root = CreateSemanticsNode(0, "root", root_children);
+  FlutterSemanticsNode child1 =
+      CreateSemanticsNode(1, "child 1", moved_children);
+  FlutterSemanticsNode child2 = CreateSemanticsNode(2, "child 2", no_children);
+  FlutterSemanticsNode child3 = CreateSemanticsNode(3, "child 3", no_children);
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->AddFlutterSemanticsNodeUpdate(&child3);
+  bridge->CommitUpdates();
+
+  // Move the third child from the first child to the second child.
+  child1 = CreateSemanticsNode(1, "child 1", no_children);
+  child2 = CreateSemanticsNode(2, "child 2", moved_children);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->AddFlutterSemanticsNodeUpdate(&child3);
+  bridge->CommitUpdates();
+
+  auto child3_node = bridge->GetFlutterPlatformNodeDelegateFromID(3).lock();
+  ASSERT_TRUE(child3_node);
+  EXPECT_EQ(child3_node->GetAXNode()->parent()->id(), 2);
+  EXPECT_EQ(child3_node->GetName(), "child 3");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -68,7 +68,12 @@ class StandardCodecSerializer {
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the supported list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector, ByteStreamWriter* stream) const;
+  void WriteVector(const std::vector<T>& vector,
+                   ByteStreamWriter* stream) const;
+
+  // The streams share the size encoding and extensions of the serializer.
+  friend class StandardCodecStreamReader;
+  friend class StandardCodecStreamWriter;
 };
 
 }  // namespace flutter
@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "byte_streams.h"
+#include "encodable_value.h"
+#include "standard_codec_serializer.h"
+
+namespace flutter {
+
+// Reads values in the standard codec binary representation one at a time,
+// directly into the caller's variables, without building EncodableValues.
+//
+// Each Read method reads the next value and returns false if it is of a
+// different type. After a failed read the rest of the stream can no longer be
+// interpreted, so all later reads fail as well.
+//
+// Lists and maps are read as a header followed by their elements: a list of
+// length n is followed by n values, and a map of length n by n key/value
+// pairs, each of which is read with the methods below.
+class StandardCodecStreamReader {
+ public:
+  // Creates a reader that reads from |stream|, which must outlive it.
+  //
+  // If provided, |serializer| is used to read values with |ReadValue|, which
+  // allows extended types. It must outlive the reader.
+  explicit StandardCodecStreamReader(
+      ByteStreamReader* stream,
+      const StandardCodecSerializer* serializer = nullptr);
+
+  // Creates a reader that reads from the |size| bytes at |bytes|, which must
+  // outlive it.
+  StandardCodecStreamReader(
+      const uint8_t* bytes,
+      size_t size,
+      const StandardCodecSerializer* serializer = nullptr);
+
+  ~StandardCodecStreamReader();
+
+  // Prevent copying.
+  StandardCodecStreamReader(StandardCodecStreamReader const&) = delete;
+  StandardCodecStreamReader& operator=(StandardCodecStreamReader const&) =
+      delete;
+
+  // Returns whether all reads so far succeeded.
+  bool ok() const { return ok_; }
+
+  // Returns whether the next value is null, without reading it. This allows
+  // reading optional values.
+  bool NextIsNull();
+
+  bool ReadNull();
+
+  bool ReadBool(bool* value);
+
+  bool ReadInt32(int32_t* value);
+
+  // Also reads values that were small enough to be encoded as 32-bit
+  // integers.
+  bool ReadInt64(int64_t* value);
+
+  bool ReadDouble(double* value);
+
+  bool ReadString(std::string* value);
+
+  bool ReadUInt8List(std::vector<uint8_t>* value);
+
+  bool ReadInt32List(std::vector<int32_t>* value);
+
+  bool ReadInt64List(std::vector<int64_t>* value);
+
+  bool ReadFloat32List(std::vector<float>* value);
+
+  bool ReadFloat64List(std::vector<double>* value);
+
+  // Reads the header of a list, and sets |length| to its number of elements.
+  bool ReadListHeader(size_t* length);
+
+  // Reads the header of a map, and sets |length| to its number of entries.
+  bool ReadMapHeader(size_t* length);
+
+  // Reads the next value of any type, for the parts of a message that do not
+  // have a fixed layout.
+  bool ReadValue(EncodableValue* value);
+
+ private:
+  // Reads the type of the next value if it has not been read already.
+  uint8_t PeekType();
+
+  // Consumes the type of the next value, and fails unless it is |type|.
+  bool ReadType(uint8_t type);
+
+  // Reads the elements of a typed list, after its type.
+  template <typename T>
+  bool ReadList(std::vector<T>* value);
+
+  // Set when the reader owns the stream that it reads from.
+  std::unique_ptr<ByteStreamReader> owned_stream_;
+  ByteStreamReader* stream_;
+  const StandardCodecSerializer* serializer_;
+  bool ok_ = true;
+  bool has_next_type_ = false;
+  uint8_t next_type_ = 0;
+};
+
+// Writes values in the standard codec binary representation one at a time,
+// directly from the caller's variables, without building EncodableValues.
+//
+// Lists and maps are written as a header followed by their elements, see
+// |StandardCodecStreamReader|.
+class StandardCodecStreamWriter {
+ public:
+  // Creates a writer that writes to |stream|, which must outlive it.
+  //
+  // If provided, |serializer| is used to write values with |WriteValue|,
+  // which allows extended types. It must outlive the writer.
+  explicit StandardCodecStreamWriter(
+      ByteStreamWriter* stream,
+      const StandardCodecSerializer* serializer = nullptr);
+
+  // Creates a writer that appends to |buffer|, which must outlive it.
+  explicit StandardCodecStreamWriter(
+      std::vector<uint8_t>* buffer,
+      const StandardCodecSerializer* serializer = nullptr);
+
+  ~StandardCodecStreamWriter();
+
+  // Prevent copying.
+  StandardCodecStreamWriter(StandardCodecStreamWriter const&) = delete;
+  StandardCodecStreamWriter& operator=(StandardCodecStreamWriter const&) =
+      delete;
+
+  void WriteNull();
+
+  void WriteBool(bool value);
+
+  void WriteInt32(int32_t value);
+
+  void WriteInt64(int64_t value);
+
+  void WriteDouble(double value);
+
+  void WriteString(std::string_view value);
+
+  void WriteUInt8List(const uint8_t* values, size_t count);
+
+  void WriteInt32List(const int32_t* values, size_t count);
+
+  void WriteInt64List(const int64_t* values, size_t count);
+
+  void WriteFloat32List(const float* values, size_t count);
+
+  void WriteFloat64List(const double* values, size_t count);
+
+  // Writes the header of a list of |length| elements, which must be written
+  // next.
+  void WriteListHeader(size_t length);
+
+  // Writes the header of a map of |length| entries, whose keys and values
+  // must be written next.
+  void WriteMapHeader(size_t length);
+
+  // Writes a value of any type, for the parts of a message that do not have a
+  // fixed layout.
+  void WriteValue(const EncodableValue& value);
+
+ private:
+  // Writes the elements of a typed list, after its type.
+  template <typename T>
+  void WriteList(const T* values, size_t count);
+
+  // Set when the writer owns the stream that it writes to.
+  std::unique_ptr<ByteStreamWriter> owned_stream_;
+  ByteStreamWriter* stream_;
+  const StandardCodecSerializer* serializer_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
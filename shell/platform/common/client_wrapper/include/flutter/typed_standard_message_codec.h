@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_TYPED_STANDARD_MESSAGE_CODEC_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_TYPED_STANDARD_MESSAGE_CODEC_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "message_codec.h"
+#include "standard_codec_serializer.h"
+#include "standard_codec_stream.h"
+
+namespace flutter {
+
+// Describes how values of type |T| are encoded with the standard codec.
+// Specialize it for each type used with TypedStandardMessageCodec, e.g.:
+//
+//   template <>
+//   struct StandardCodecTraits<Point> {
+//     static void Write(const Point& point,
+//                       StandardCodecStreamWriter* writer) {
+//       writer->WriteListHeader(2);
+//       writer->WriteDouble(point.x);
+//       writer->WriteDouble(point.y);
+//     }
+//
+//     static bool Read(StandardCodecStreamReader* reader, Point* point) {
+//       size_t length = 0;
+//       return reader->ReadListHeader(&length) && length == 2 &&
+//              reader->ReadDouble(&point->x) && reader->ReadDouble(&point->y);
+//     }
+//   };
+//
+// Read returns false if the encoded value does not match the layout of |T|.
+template <typename T>
+struct StandardCodecTraits;
+
+// A message codec that encodes values of type |T| in the standard codec
+// binary representation, as described by StandardCodecTraits<T>.
+//
+// Messages are read into and written from |T| directly, which is faster than
+// going through EncodableValue for large messages with a known layout. The
+// encoding is the same, so the Dart side uses a StandardMessageCodec.
+//
+// |T| must be default constructible.
+template <typename T>
+class TypedStandardMessageCodec : public MessageCodec<T> {
+ public:
+  // Returns an instance of the codec, optionally using a custom serializer to
+  // read and write values of extended types.
+  //
+  // If provided, |serializer| must be long-lived. The instance returned is
+  // long-lived, and can be safely passed to, e.g., channel constructors.
+  static const TypedStandardMessageCodec<T>& GetInstance(
+      const StandardCodecSerializer* serializer = nullptr) {
+    if (!serializer) {
+      serializer = &StandardCodecSerializer::GetInstance();
+    }
+    static auto* sInstances =
+        new std::map<const StandardCodecSerializer*,
+                     std::unique_ptr<TypedStandardMessageCodec<T>>>;
+    auto it = sInstances->find(serializer);
+    if (it == sInstances->end()) {
+      // Uses new due to private constructor (to prevent API clients from
+      // accidentally passing temporary codec instances to channels).
+      auto emplace_result = sInstances->emplace(
+          serializer, std::unique_ptr<TypedStandardMessageCodec<T>>(
+                          new TypedStandardMessageCodec<T>(serializer)));
+      it = emplace_result.first;
+    }
+    return *(it->second);
+  }
+
+  ~TypedStandardMessageCodec() = default;
+
+  // Prevent copying.
+  TypedStandardMessageCodec(TypedStandardMessageCodec<T> const&) = delete;
+  TypedStandardMessageCodec& operator=(TypedStandardMessageCodec<T> const&) =
+      delete;
+
+ protected:
+  // |flutter::MessageCodec|
+  //
+  // Returns nullptr for empty messages, and for messages that do not match
+  // the layout of |T|.
+  std::unique_ptr<T> DecodeMessageInternal(
+      const uint8_t* binary_message,
+      const size_t message_size) const override {
+    if (!binary_message || message_size == 0) {
+      return nullptr;
+    }
+    StandardCodecStreamReader reader(binary_message, message_size,
+                                     serializer_);
+    auto message = std::make_unique<T>();
+    if (!StandardCodecTraits<T>::Read(&reader, message.get()) ||
+        !reader.ok()) {
+      return nullptr;
+    }
+    return message;
+  }
+
+  // |flutter::MessageCodec|
+  std::unique_ptr<std::vector<uint8_t>> EncodeMessageInternal(
+      const T& message) const override {
+    auto encoded = std::make_unique<std::vector<uint8_t>>();
+    StandardCodecStreamWriter writer(encoded.get(), serializer_);
+    StandardCodecTraits<T>::Write(message, &writer);
+    return encoded;
+  }
+
+ private:
+  // Instances should be obtained via GetInstance.
+  explicit TypedStandardMessageCodec(const StandardCodecSerializer* serializer)
+      : serializer_(serializer) {}
+
+  const StandardCodecSerializer* serializer_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_TYPED_STANDARD_MESSAGE_CODEC_H_
@@ -3,9 +3,10 @@
 // found in the LICENSE file.
 
 // This file contains what would normally be standard_codec_serializer.cc,
-// standard_message_codec.cc, and standard_method_codec.cc. They are grouped
-// together to simplify use of the client wrapper, since the common case is
-// that any client that needs one of these files needs all three.
+// standard_codec_stream.cc, standard_message_codec.cc, and
+// standard_method_codec.cc. They are grouped together to simplify use of the
+// client wrapper, since the common case is that any client that needs one of
+// these files needs all of them.
 
 #include <cassert>
 #include <cstring>
@@ -16,6 +17,7 @@
 
 #include "byte_buffer_streams.h"
 #include "include/flutter/standard_codec_serializer.h"
+#include "include/flutter/standard_codec_stream.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
 
@@ -188,7 +190,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +207,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +217,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -268,11 +270,11 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -287,6 +289,289 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
                      count * type_size);
 }
 
+// ===== standard_codec_stream.h =====
+
+StandardCodecStreamReader::StandardCodecStreamReader(
+    ByteStreamReader* stream,
+    const StandardCodecSerializer* serializer)
+    : stream_(stream),
+      serializer_(serializer ? serializer
+                             : &StandardCodecSerializer::GetInstance()) {
+  assert(stream);
+}
+
+StandardCodecStreamReader::StandardCodecStreamReader(
+    const uint8_t* bytes,
+    size_t size,
+    const StandardCodecSerializer* serializer)
+    : StandardCodecStreamReader(new ByteBufferStreamReader(bytes, size),
+                                serializer) {
+  owned_stream_.reset(stream_);
+}
+
+StandardCodecStreamReader::~StandardCodecStreamReader() = default;
+
+uint8_t StandardCodecStreamReader::PeekType() {
+  if (!has_next_type_) {
+    next_type_ = stream_->ReadByte();
+    has_next_type_ = true;
+  }
+  return next_type_;
+}
+
+bool StandardCodecStreamReader::ReadType(uint8_t type) {
+  if (!ok_) {
+    return false;
+  }
+  ok_ = PeekType() == type;
+  has_next_type_ = false;
+  return ok_;
+}
+
+bool StandardCodecStreamReader::NextIsNull() {
+  return ok_ && PeekType() == static_cast<uint8_t>(EncodedType::kNull);
+}
+
+bool StandardCodecStreamReader::ReadNull() {
+  return ReadType(static_cast<uint8_t>(EncodedType::kNull));
+}
+
+bool StandardCodecStreamReader::ReadBool(bool* value) {
+  if (!ok_) {
+    return false;
+  }
+  switch (static_cast<EncodedType>(PeekType())) {
+    case EncodedType::kTrue:
+      *value = true;
+      break;
+    case EncodedType::kFalse:
+      *value = false;
+      break;
+    default:
+      ok_ = false;
+      break;
+  }
+  has_next_type_ = false;
+  return ok_;
+}
+
+bool StandardCodecStreamReader::ReadInt32(int32_t* value) {
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kInt32))) {
+    return false;
+  }
+  *value = stream_->ReadInt32();
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadInt64(int64_t* value) {
+  if (ok_ && PeekType() == static_cast<uint8_t>(EncodedType::kInt32)) {
+    has_next_type_ = false;
+    *value = stream_->ReadInt32();
+    return true;
+  }
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kInt64))) {
+    return false;
+  }
+  *value = stream_->ReadInt64();
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadDouble(double* value) {
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kFloat64))) {
+    return false;
+  }
+  stream_->ReadAlignment(8);
+  *value = stream_->ReadDouble();
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadString(std::string* value) {
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kString))) {
+    return false;
+  }
+  size_t size = serializer_->ReadSize(stream_);
+  value->resize(size);
+  if (size > 0) {
+    stream_->ReadBytes(reinterpret_cast<uint8_t*>(&(*value)[0]), size);
+  }
+  return true;
+}
+
+template <typename T>
+bool StandardCodecStreamReader::ReadList(std::vector<T>* value) {
+  size_t count = serializer_->ReadSize(stream_);
+  value->resize(count);
+  if (sizeof(T) > 1) {
+    stream_->ReadAlignment(static_cast<uint8_t>(sizeof(T)));
+  }
+  if (count > 0) {
+    stream_->ReadBytes(reinterpret_cast<uint8_t*>(value->data()),
+                       count * sizeof(T));
+  }
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadUInt8List(std::vector<uint8_t>* value) {
+  return ReadType(static_cast<uint8_t>(EncodedType::kUInt8List)) &&
+         ReadList(value);
+}
+
+bool StandardCodecStreamReader::ReadInt32List(std::vector<int32_t>* value) {
+  return ReadType(static_cast<uint8_t>(EncodedType::kInt32List)) &&
+         ReadList(value);
+}
+
+bool StandardCodecStreamReader::ReadInt64List(std::vector<int64_t>* value) {
+  return ReadType(static_cast<uint8_t>(EncodedType::kInt64List)) &&
+         ReadList(value);
+}
+
+bool StandardCodecStreamReader::ReadFloat32List(std::vector<float>* value) {
+  return ReadType(static_cast<uint8_t>(EncodedType::kFloat32List)) &&
+         ReadList(value);
+}
+
+bool StandardCodecStreamReader::ReadFloat64List(std::vector<double>* value) {
+  return ReadType(static_cast<uint8_t>(EncodedType::kFloat64List)) &&
+         ReadList(value);
+}
+
+bool StandardCodecStreamReader::ReadListHeader(size_t* length) {
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kList))) {
+    return false;
+  }
+  *length = serializer_->ReadSize(stream_);
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadMapHeader(size_t* length) {
+  if (!ReadType(static_cast<uint8_t>(EncodedType::kMap))) {
+    return false;
+  }
+  *length = serializer_->ReadSize(stream_);
+  return true;
+}
+
+bool StandardCodecStreamReader::ReadValue(EncodableValue* value) {
+  if (!ok_) {
+    return false;
+  }
+  uint8_t type = PeekType();
+  has_next_type_ = false;
+  *value = serializer_->ReadValueOfType(type, stream_);
+  return true;
+}
+
+StandardCodecStreamWriter::StandardCodecStreamWriter(
+    ByteStreamWriter* stream,
+    const StandardCodecSerializer* serializer)
+    : stream_(stream),
+      serializer_(serializer ? serializer
+                             : &StandardCodecSerializer::GetInstance()) {
+  assert(stream);
+}
+
+StandardCodecStreamWriter::StandardCodecStreamWriter(
+    std::vector<uint8_t>* buffer,
+    const StandardCodecSerializer* serializer)
+    : StandardCodecStreamWriter(new ByteBufferStreamWriter(buffer),
+                                serializer) {
+  owned_stream_.reset(stream_);
+}
+
+StandardCodecStreamWriter::~StandardCodecStreamWriter() = default;
+
+void StandardCodecStreamWriter::WriteNull() {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kNull));
+}
+
+void StandardCodecStreamWriter::WriteBool(bool value) {
+  stream_->WriteByte(static_cast<uint8_t>(value ? EncodedType::kTrue
+                                                : EncodedType::kFalse));
+}
+
+void StandardCodecStreamWriter::WriteInt32(int32_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt32));
+  stream_->WriteInt32(value);
+}
+
+void StandardCodecStreamWriter::WriteInt64(int64_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt64));
+  stream_->WriteInt64(value);
+}
+
+void StandardCodecStreamWriter::WriteDouble(double value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat64));
+  stream_->WriteAlignment(8);
+  stream_->WriteDouble(value);
+}
+
+void StandardCodecStreamWriter::WriteString(std::string_view value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kString));
+  serializer_->WriteSize(value.size(), stream_);
+  if (!value.empty()) {
+    stream_->WriteBytes(reinterpret_cast<const uint8_t*>(value.data()),
+                        value.size());
+  }
+}
+
+template <typename T>
+void StandardCodecStreamWriter::WriteList(const T* values, size_t count) {
+  serializer_->WriteSize(count, stream_);
+  if (count == 0) {
+    return;
+  }
+  if (sizeof(T) > 1) {
+    stream_->WriteAlignment(static_cast<uint8_t>(sizeof(T)));
+  }
+  stream_->WriteBytes(reinterpret_cast<const uint8_t*>(values),
+                      count * sizeof(T));
+}
+
+void StandardCodecStreamWriter::WriteUInt8List(const uint8_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kUInt8List));
+  WriteList(values, count);
+}
+
+void StandardCodecStreamWriter::WriteInt32List(const int32_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt32List));
+  WriteList(values, count);
+}
+
+void StandardCodecStreamWriter::WriteInt64List(const int64_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt64List));
+  WriteList(values, count);
+}
+
+void StandardCodecStreamWriter::WriteFloat32List(const float* values,
+                                                 size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat32List));
+  WriteList(values, count);
+}
+
+void StandardCodecStreamWriter::WriteFloat64List(const double* values,
+                                                 size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat64List));
+  WriteList(values, count);
+}
+
+void StandardCodecStreamWriter::WriteListHeader(size_t length) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kList));
+  serializer_->WriteSize(length, stream_);
+}
+
+void StandardCodecStreamWriter::WriteMapHeader(size_t length) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kMap));
+  serializer_->WriteSize(length, stream_);
+}
+
+void StandardCodecStreamWriter::WriteValue(const EncodableValue& value) {
+  serializer_->WriteValue(value, stream_);
+}
+
 // ===== standard_message_codec.h =====
 
 // static
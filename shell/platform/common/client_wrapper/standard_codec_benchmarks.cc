@@ -0,0 +1,158 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/typed_standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// A batch of readings, like those that a sensor plugin streams to Dart.
+struct Reading {
+  std::string sensor;
+  int64_t timestamp = 0;
+  std::vector<double> values;
+};
+
+using Readings = std::vector<Reading>;
+
+Readings CreateReadings(size_t count) {
+  Readings readings(count);
+  for (size_t i = 0; i < count; i++) {
+    readings[i].sensor = "accelerometer";
+    readings[i].timestamp = 1000000 + i;
+    readings[i].values = {0.1 * i, 0.2 * i, 0.3 * i};
+  }
+  return readings;
+}
+
+EncodableValue ToEncodableValue(const Readings& readings) {
+  EncodableList list;
+  list.reserve(readings.size());
+  for (const auto& reading : readings) {
+    list.push_back(EncodableValue(EncodableMap{
+        {EncodableValue("sensor"), EncodableValue(reading.sensor)},
+        {EncodableValue("timestamp"), EncodableValue(reading.timestamp)},
+        {EncodableValue("values"), EncodableValue(reading.values)},
+    }));
+  }
+  return EncodableValue(std::move(list));
+}
+
+}  // namespace
+
+template <>
+struct StandardCodecTraits<Readings> {
+  static void Write(const Readings& readings,
+                    StandardCodecStreamWriter* writer) {
+    writer->WriteListHeader(readings.size());
+    for (const auto& reading : readings) {
+      // Keys in the same order as the EncodableMap, so that both codecs
+      // produce the same bytes.
+      writer->WriteMapHeader(3);
+      writer->WriteString("sensor");
+      writer->WriteString(reading.sensor);
+      writer->WriteString("timestamp");
+      writer->WriteInt64(reading.timestamp);
+      writer->WriteString("values");
+      writer->WriteFloat64List(reading.values.data(), reading.values.size());
+    }
+  }
+
+  static bool Read(StandardCodecStreamReader* reader, Readings* readings) {
+    size_t count = 0;
+    if (!reader->ReadListHeader(&count)) {
+      return false;
+    }
+    readings->resize(count);
+    std::string key;
+    for (auto& reading : *readings) {
+      size_t length = 0;
+      if (!reader->ReadMapHeader(&length)) {
+        return false;
+      }
+      for (size_t i = 0; i < length; i++) {
+        if (!reader->ReadString(&key)) {
+          return false;
+        }
+        bool read = false;
+        if (key == "sensor") {
+          read = reader->ReadString(&reading.sensor);
+        } else if (key == "timestamp") {
+          read = reader->ReadInt64(&reading.timestamp);
+        } else if (key == "values") {
+          read = reader->ReadFloat64List(&reading.values);
+        } else {
+          EncodableValue ignored;
+          read = reader->ReadValue(&ignored);
+        }
+        if (!read) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+static void BM_StandardMessageCodecEncode(benchmark::State& state) {
+  const Readings readings = CreateReadings(state.range(0));
+  const auto& codec = StandardMessageCodec::GetInstance();
+  while (state.KeepRunning()) {
+    // Plugins have to build the tree from their own types first.
+    auto encoded = codec.EncodeMessage(ToEncodableValue(readings));
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_TypedStandardMessageCodecEncode(benchmark::State& state) {
+  const Readings readings = CreateReadings(state.range(0));
+  const auto& codec = TypedStandardMessageCodec<Readings>::GetInstance();
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(readings);
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_StandardMessageCodecDecode(benchmark::State& state) {
+  const auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      ToEncodableValue(CreateReadings(state.range(0))));
+  const auto& codec = StandardMessageCodec::GetInstance();
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_TypedStandardMessageCodecDecode(benchmark::State& state) {
+  const auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      ToEncodableValue(CreateReadings(state.range(0))));
+  const auto& codec = TypedStandardMessageCodec<Readings>::GetInstance();
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+BENCHMARK(BM_StandardMessageCodecEncode)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TypedStandardMessageCodecEncode)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardMessageCodecDecode)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TypedStandardMessageCodecDecode)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,173 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_codec_stream.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/client_wrapper/testing/test_codec_extensions.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// The value written by |WriteMixedValue|, as an EncodableValue.
+EncodableValue MixedValue() {
+  return EncodableValue(EncodableList{
+      EncodableValue(),
+      EncodableValue(true),
+      EncodableValue(false),
+      EncodableValue(-7),
+      EncodableValue(int64_t{1} << 40),
+      EncodableValue(3.5),
+      EncodableValue("hello"),
+      EncodableValue(std::vector<uint8_t>{1, 2, 3}),
+      EncodableValue(std::vector<int32_t>{-1, 2}),
+      EncodableValue(std::vector<int64_t>{int64_t{1} << 50}),
+      EncodableValue(std::vector<float>{1.5f, 2.5f}),
+      EncodableValue(std::vector<double>{0.25}),
+      EncodableValue(EncodableMap{
+          {EncodableValue("key"), EncodableValue(EncodableList{})},
+      }),
+  });
+}
+
+void WriteMixedValue(StandardCodecStreamWriter* writer) {
+  const std::vector<uint8_t> bytes = {1, 2, 3};
+  const std::vector<int32_t> ints = {-1, 2};
+  const std::vector<int64_t> longs = {int64_t{1} << 50};
+  const std::vector<float> floats = {1.5f, 2.5f};
+  const std::vector<double> doubles = {0.25};
+  writer->WriteListHeader(13);
+  writer->WriteNull();
+  writer->WriteBool(true);
+  writer->WriteBool(false);
+  writer->WriteInt32(-7);
+  writer->WriteInt64(int64_t{1} << 40);
+  writer->WriteDouble(3.5);
+  writer->WriteString("hello");
+  writer->WriteUInt8List(bytes.data(), bytes.size());
+  writer->WriteInt32List(ints.data(), ints.size());
+  writer->WriteInt64List(longs.data(), longs.size());
+  writer->WriteFloat32List(floats.data(), floats.size());
+  writer->WriteFloat64List(doubles.data(), doubles.size());
+  writer->WriteMapHeader(1);
+  writer->WriteString("key");
+  writer->WriteListHeader(0);
+}
+
+}  // namespace
+
+TEST(StandardCodecStream, WritesTheStandardEncoding) {
+  std::vector<uint8_t> encoded;
+  StandardCodecStreamWriter writer(&encoded);
+  WriteMixedValue(&writer);
+
+  auto expected =
+      StandardMessageCodec::GetInstance().EncodeMessage(MixedValue());
+  EXPECT_EQ(encoded, *expected);
+}
+
+TEST(StandardCodecStream, ReadsTheStandardEncoding) {
+  auto encoded =
+      StandardMessageCodec::GetInstance().EncodeMessage(MixedValue());
+  StandardCodecStreamReader reader(encoded->data(), encoded->size());
+
+  size_t length = 0;
+  ASSERT_TRUE(reader.ReadListHeader(&length));
+  EXPECT_EQ(length, 13u);
+  EXPECT_TRUE(reader.NextIsNull());
+  EXPECT_TRUE(reader.ReadNull());
+  bool flag = false;
+  EXPECT_TRUE(reader.ReadBool(&flag));
+  EXPECT_TRUE(flag);
+  EXPECT_TRUE(reader.ReadBool(&flag));
+  EXPECT_FALSE(flag);
+  int32_t int_value = 0;
+  EXPECT_TRUE(reader.ReadInt32(&int_value));
+  EXPECT_EQ(int_value, -7);
+  int64_t long_value = 0;
+  EXPECT_TRUE(reader.ReadInt64(&long_value));
+  EXPECT_EQ(long_value, int64_t{1} << 40);
+  double double_value = 0;
+  EXPECT_TRUE(reader.ReadDouble(&double_value));
+  EXPECT_EQ(double_value, 3.5);
+  std::string string_value;
+  EXPECT_TRUE(reader.ReadString(&string_value));
+  EXPECT_EQ(string_value, "hello");
+  std::vector<uint8_t> bytes;
+  EXPECT_TRUE(reader.ReadUInt8List(&bytes));
+  EXPECT_EQ(bytes, std::vector<uint8_t>({1, 2, 3}));
+  std::vector<int32_t> ints;
+  EXPECT_TRUE(reader.ReadInt32List(&ints));
+  EXPECT_EQ(ints, std::vector<int32_t>({-1, 2}));
+  std::vector<int64_t> longs;
+  EXPECT_TRUE(reader.ReadInt64List(&longs));
+  EXPECT_EQ(longs, std::vector<int64_t>({int64_t{1} << 50}));
+  std::vector<float> floats;
+  EXPECT_TRUE(reader.ReadFloat32List(&floats));
+  EXPECT_EQ(floats, std::vector<float>({1.5f, 2.5f}));
+  std::vector<double> doubles;
+  EXPECT_TRUE(reader.ReadFloat64List(&doubles));
+  EXPECT_EQ(doubles, std::vector<double>({0.25}));
+  ASSERT_TRUE(reader.ReadMapHeader(&length));
+  EXPECT_EQ(length, 1u);
+  EXPECT_TRUE(reader.ReadString(&string_value));
+  EXPECT_EQ(string_value, "key");
+  EncodableValue value;
+  EXPECT_TRUE(reader.ReadValue(&value));
+  EXPECT_EQ(value, EncodableValue(EncodableList{}));
+  EXPECT_TRUE(reader.ok());
+}
+
+TEST(StandardCodecStream, ReadsInt32AsInt64) {
+  auto encoded =
+      StandardMessageCodec::GetInstance().EncodeMessage(EncodableValue(42));
+  StandardCodecStreamReader reader(encoded->data(), encoded->size());
+  int64_t value = 0;
+  EXPECT_TRUE(reader.ReadInt64(&value));
+  EXPECT_EQ(value, 42);
+}
+
+TEST(StandardCodecStream, FailsOnUnexpectedTypes) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      EncodableValue(EncodableList{EncodableValue("a"), EncodableValue(1)}));
+  StandardCodecStreamReader reader(encoded->data(), encoded->size());
+
+  size_t length = 0;
+  EXPECT_FALSE(reader.ReadMapHeader(&length));
+  EXPECT_FALSE(reader.ok());
+  // The position in the stream is lost, so later reads fail as well.
+  EXPECT_FALSE(reader.ReadListHeader(&length));
+  EXPECT_FALSE(reader.NextIsNull());
+}
+
+TEST(StandardCodecStream, ReadsAndWritesExtendedValues) {
+  const PointExtensionSerializer& serializer =
+      PointExtensionSerializer::GetInstance();
+  std::vector<uint8_t> encoded;
+  StandardCodecStreamWriter writer(&encoded, &serializer);
+  writer.WriteListHeader(2);
+  writer.WriteValue(CustomEncodableValue(Point(9, 7)));
+  writer.WriteInt32(1);
+
+  StandardCodecStreamReader reader(encoded.data(), encoded.size(),
+                                   &serializer);
+  size_t length = 0;
+  ASSERT_TRUE(reader.ReadListHeader(&length));
+  EXPECT_EQ(length, 2u);
+  EncodableValue value;
+  ASSERT_TRUE(reader.ReadValue(&value));
+  const Point& point =
+      std::any_cast<Point>(std::get<CustomEncodableValue>(value));
+  EXPECT_EQ(point, Point(9, 7));
+  int32_t int_value = 0;
+  EXPECT_TRUE(reader.ReadInt32(&int_value));
+  EXPECT_EQ(int_value, 1);
+}
+
+}  // namespace flutter
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/typed_standard_message_codec.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+struct Sample {
+  std::string name;
+  std::optional<std::string> label;
+  int64_t timestamp = 0;
+  std::vector<double> values;
+
+  bool operator==(const Sample& other) const {
+    return name == other.name && label == other.label &&
+           timestamp == other.timestamp && values == other.values;
+  }
+};
+
+}  // namespace
+
+template <>
+struct StandardCodecTraits<Sample> {
+  static void Write(const Sample& sample, StandardCodecStreamWriter* writer) {
+    writer->WriteListHeader(4);
+    writer->WriteString(sample.name);
+    if (sample.label) {
+      writer->WriteString(*sample.label);
+    } else {
+      writer->WriteNull();
+    }
+    writer->WriteInt64(sample.timestamp);
+    writer->WriteFloat64List(sample.values.data(), sample.values.size());
+  }
+
+  static bool Read(StandardCodecStreamReader* reader, Sample* sample) {
+    size_t length = 0;
+    if (!reader->ReadListHeader(&length) || length != 4 ||
+        !reader->ReadString(&sample->name)) {
+      return false;
+    }
+    if (reader->NextIsNull()) {
+      reader->ReadNull();
+    } else if (!reader->ReadString(&sample->label.emplace())) {
+      return false;
+    }
+    return reader->ReadInt64(&sample->timestamp) &&
+           reader->ReadFloat64List(&sample->values);
+  }
+};
+
+TEST(TypedStandardMessageCodec, RoundTrips) {
+  const auto& codec = TypedStandardMessageCodec<Sample>::GetInstance();
+  Sample sample{"sensor", std::nullopt, int64_t{1} << 33, {1.0, 2.0, 3.0}};
+  auto encoded = codec.EncodeMessage(sample);
+  ASSERT_TRUE(encoded);
+  auto decoded = codec.DecodeMessage(*encoded);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(*decoded, sample);
+
+  sample.label = "left";
+  decoded = codec.DecodeMessage(*codec.EncodeMessage(sample));
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(*decoded, sample);
+}
+
+TEST(TypedStandardMessageCodec, MatchesStandardMessageCodec) {
+  const auto& codec = TypedStandardMessageCodec<Sample>::GetInstance();
+  Sample sample{"sensor", "left", 12, {0.5}};
+  EncodableValue value(EncodableList{
+      EncodableValue("sensor"),
+      EncodableValue("left"),
+      EncodableValue(int64_t{12}),
+      EncodableValue(std::vector<double>{0.5}),
+  });
+
+  auto encoded = codec.EncodeMessage(sample);
+  auto expected = StandardMessageCodec::GetInstance().EncodeMessage(value);
+  EXPECT_EQ(*encoded, *expected);
+}
+
+TEST(TypedStandardMessageCodec, RejectsMessagesOfOtherLayouts) {
+  const auto& codec = TypedStandardMessageCodec<Sample>::GetInstance();
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      EncodableValue(EncodableList{EncodableValue(1), EncodableValue(2)}));
+  EXPECT_EQ(codec.DecodeMessage(*encoded), nullptr);
+  EXPECT_EQ(codec.DecodeMessage(nullptr, 0), nullptr);
+}
+
+}  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/common/json_message_codec.h"
 
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -33,6 +34,14 @@ std::unique_ptr<std::vector<uint8_t>> JsonMessageCodec::EncodeMessageInternal(
 std::unique_ptr<rapidjson::Document> JsonMessageCodec::DecodeMessageInternal(
     const uint8_t* binary_message,
     const size_t message_size) const {
+  // rapidjson stops at the first nul character, which would silently drop the
+  // rest of the message.
+  if (message_size > 0 &&
+      memchr(binary_message, '\0', message_size) != nullptr) {
+    std::cerr << "Unable to parse JSON message:" << std::endl
+              << "The message contains a nul character." << std::endl;
+    return nullptr;
+  }
   auto raw_message = reinterpret_cast<const char*>(binary_message);
   auto json_message = std::make_unique<rapidjson::Document>();
   rapidjson::ParseResult result =
@@ -6,6 +6,7 @@
 
 #include <limits>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -43,4 +44,17 @@ TEST(JsonMessageCodec, EncodeDecode) {
   CheckEncodeDecode(array);
 }
 
+// Tests that a message is not truncated at a nul character.
+TEST(JsonMessageCodec, DecodeRejectsEmbeddedNul) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  const std::string message("[1]\0[2]", 7);
+  EXPECT_EQ(codec.DecodeMessage(
+                reinterpret_cast<const uint8_t*>(message.data()),
+                message.size()),
+            nullptr);
+  EXPECT_NE(codec.DecodeMessage(
+                reinterpret_cast<const uint8_t*>(message.data()), 3),
+            nullptr);
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #include "flutter/shell/platform/common/json_method_codec.h"
 
 #include "flutter/shell/platform/common/json_message_codec.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 namespace flutter {
 
@@ -30,6 +32,32 @@ std::unique_ptr<rapidjson::Document> ExtractElement(
   return extracted;
 }
 
+// Writes method calls and envelopes directly, without first building them as
+// documents.
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+// Writes |value| as a JSON string.
+void WriteString(JsonWriter& writer, const std::string& value) {
+  writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+// Writes |document|, or null if there is no document.
+void WriteDocument(JsonWriter& writer, const rapidjson::Document* document) {
+  if (document) {
+    document->Accept(writer);
+  } else {
+    writer.Null();
+  }
+}
+
+// Returns the JSON written to |buffer| as an encoded message.
+std::unique_ptr<std::vector<uint8_t>> GetEncodedMessage(
+    const rapidjson::StringBuffer& buffer) {
+  const char* buffer_start = buffer.GetString();
+  return std::make_unique<std::vector<uint8_t>>(
+      buffer_start, buffer_start + buffer.GetSize());
+}
+
 }  // namespace
 
 // static
@@ -66,34 +94,28 @@ JsonMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 
 std::unique_ptr<std::vector<uint8_t>> JsonMethodCodec::EncodeMethodCallInternal(
     const MethodCall<rapidjson::Document>& method_call) const {
-  // TODO: Consider revisiting the codec APIs to avoid the need to copy
-  // everything when doing encoding (e.g., by having a version that takes
-  // owership of the object to encode, so that it can be moved instead).
-  rapidjson::Document message(rapidjson::kObjectType);
-  auto& allocator = message.GetAllocator();
-  rapidjson::Value name(method_call.method_name(), allocator);
-  rapidjson::Value arguments;
-  if (method_call.arguments()) {
-    arguments.CopyFrom(*method_call.arguments(), allocator);
-  }
-  message.AddMember(kMessageMethodKey, name, allocator);
-  message.AddMember(kMessageArgumentsKey, arguments, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(message);
+  // Serialize the call directly, rather than copying the arguments into a new
+  // document just to encode it.
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartObject();
+  writer.Key(kMessageMethodKey);
+  WriteString(writer, method_call.method_name());
+  writer.Key(kMessageArgumentsKey);
+  WriteDocument(writer, method_call.arguments());
+  writer.EndObject();
+  return GetEncodedMessage(buffer);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
 JsonMethodCodec::EncodeSuccessEnvelopeInternal(
     const rapidjson::Document* result) const {
-  rapidjson::Document envelope;
-  envelope.SetArray();
-  rapidjson::Value result_value;
-  if (result) {
-    result_value.CopyFrom(*result, envelope.GetAllocator());
-  }
-  envelope.PushBack(result_value, envelope.GetAllocator());
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartArray();
+  WriteDocument(writer, result);
+  writer.EndArray();
+  return GetEncodedMessage(buffer);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -101,17 +123,14 @@ JsonMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const rapidjson::Document* error_details) const {
-  rapidjson::Document envelope(rapidjson::kArrayType);
-  auto& allocator = envelope.GetAllocator();
-  envelope.PushBack(rapidjson::Value(error_code, allocator), allocator);
-  envelope.PushBack(rapidjson::Value(error_message, allocator), allocator);
-  rapidjson::Value details_value;
-  if (error_details) {
-    details_value.CopyFrom(*error_details, allocator);
-  }
-  envelope.PushBack(details_value, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartArray();
+  WriteString(writer, error_code);
+  WriteString(writer, error_message);
+  WriteDocument(writer, error_details);
+  writer.EndArray();
+  return GetEncodedMessage(buffer);
 }
 
 bool JsonMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
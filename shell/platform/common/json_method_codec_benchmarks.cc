@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/json_method_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns editing state arguments like those that the text input plugins send
+// to the framework after each edit, for a field containing |text_length|
+// characters.
+std::unique_ptr<rapidjson::Document> CreateEditingState(size_t text_length) {
+  std::string text;
+  text.reserve(text_length);
+  for (size_t i = 0; i < text_length; i++) {
+    text.push_back(i % 8 == 7 ? ' ' : static_cast<char>('a' + i % 26));
+  }
+
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  args->PushBack(1, allocator);
+  rapidjson::Value editing_state(rapidjson::kObjectType);
+  editing_state.AddMember("selectionAffinity", "TextAffinity.downstream",
+                          allocator);
+  editing_state.AddMember("selectionBase", 3, allocator);
+  editing_state.AddMember("selectionExtent", 3, allocator);
+  editing_state.AddMember("selectionIsDirectional", false, allocator);
+  editing_state.AddMember("composingBase", -1, allocator);
+  editing_state.AddMember("composingExtent", -1, allocator);
+  editing_state.AddMember(
+      "text",
+      rapidjson::Value(text.data(),
+                       static_cast<rapidjson::SizeType>(text.size()),
+                       allocator)
+          .Move(),
+      allocator);
+  args->PushBack(editing_state, allocator);
+  return args;
+}
+
+std::unique_ptr<std::vector<uint8_t>> EncodeEditingStateCall(
+    const char* method,
+    size_t text_length) {
+  MethodCall<rapidjson::Document> call(method,
+                                       CreateEditingState(text_length));
+  return JsonMethodCodec::GetInstance().EncodeMethodCall(call);
+}
+
+}  // namespace
+
+// Encodes the TextInputClient.updateEditingState calls sent to the framework.
+static void BM_JsonMethodCodecEncodeEditingState(benchmark::State& state) {
+  const auto& codec = JsonMethodCodec::GetInstance();
+  MethodCall<rapidjson::Document> call("TextInputClient.updateEditingState",
+                                       CreateEditingState(state.range(0)));
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMethodCall(call);
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+// Decodes the TextInput.setEditingState calls received from the framework.
+static void BM_JsonMethodCodecDecodeEditingState(benchmark::State& state) {
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const auto encoded =
+      EncodeEditingStateCall("TextInput.setEditingState", state.range(0));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMethodCall(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_JsonMethodCodecEncodeSuccessEnvelope(benchmark::State& state) {
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const auto result = CreateEditingState(state.range(0));
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeSuccessEnvelope(result.get());
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+BENCHMARK(BM_JsonMethodCodecEncodeEditingState)
+    ->Range(16, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_JsonMethodCodecDecodeEditingState)
+    ->Range(16, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_JsonMethodCodecEncodeSuccessEnvelope)
+    ->Range(16, 16384)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
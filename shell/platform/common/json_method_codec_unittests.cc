@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/common/json_method_codec.h"
 
+#include <string>
+
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_result_functions.h"
 #include "gtest/gtest.h"
 
@@ -55,6 +57,26 @@ TEST(JsonMethodCodec, HandlesMethodCallsWithArgument) {
   EXPECT_TRUE(MethodCallsAreEqual(call, *decoded));
 }
 
+TEST(JsonMethodCodec, EncodesMethodCallsAsJsonObjects) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+
+  auto arguments =
+      std::make_unique<rapidjson::Document>(rapidjson::kObjectType);
+  auto& allocator = arguments->GetAllocator();
+  arguments->AddMember("text", "a\"b", allocator);
+  MethodCall<rapidjson::Document> call("hello", std::move(arguments));
+  auto encoded = codec.EncodeMethodCall(call);
+  ASSERT_TRUE(encoded);
+  EXPECT_EQ(std::string(encoded->begin(), encoded->end()),
+            "{\"method\":\"hello\",\"args\":{\"text\":\"a\\\"b\"}}");
+
+  MethodCall<rapidjson::Document> null_call("hello", nullptr);
+  encoded = codec.EncodeMethodCall(null_call);
+  ASSERT_TRUE(encoded);
+  EXPECT_EQ(std::string(encoded->begin(), encoded->end()),
+            "{\"method\":\"hello\",\"args\":null}");
+}
+
 TEST(JsonMethodCodec, HandlesSuccessEnvelopesWithNullResult) {
   const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
   auto encoded = codec.EncodeSuccessEnvelope();
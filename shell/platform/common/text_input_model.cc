@@ -27,6 +27,39 @@ bool IsTrailingSurrogate(char32_t code_point) {
   return (code_point & 0xFFFFFC00) == 0xDC00;
 }
 
+// The smallest gap to leave in the text buffer when it grows.
+constexpr size_t kMinimumGapSize = 64;
+
+// Appends |length| UTF-16 code units from |text| to |output| as UTF-8.
+// Unpaired surrogates are replaced with U+FFFD.
+void AppendUtf8(const char16_t* text, size_t length, std::string* output) {
+  for (size_t i = 0; i < length; i++) {
+    char32_t c = text[i];
+    if (c < 0x80) {
+      output->push_back(static_cast<char>(c));
+      continue;
+    }
+    if (IsLeadingSurrogate(c) && i + 1 < length &&
+        IsTrailingSurrogate(text[i + 1])) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+      i++;
+    } else if (IsLeadingSurrogate(c) || IsTrailingSurrogate(c)) {
+      c = 0xFFFD;
+    }
+    if (c < 0x800) {
+      output->push_back(static_cast<char>(0xC0 | (c >> 6)));
+    } else if (c < 0x10000) {
+      output->push_back(static_cast<char>(0xE0 | (c >> 12)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    } else {
+      output->push_back(static_cast<char>(0xF0 | (c >> 18)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    }
+    output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  }
+}
+
 }  // namespace
 
 TextInputModel::TextInputModel() = default;
@@ -36,7 +69,13 @@ TextInputModel::~TextInputModel() = default;
 void TextInputModel::SetText(const std::string& text) {
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf16_converter;
-  text_ = utf16_converter.from_bytes(text);
+  buffer_ = utf16_converter.from_bytes(text);
+  gap_start_ = buffer_.length();
+  gap_end_ = buffer_.length();
+  utf8_text_ = text;
+  utf8_text_valid_ = true;
+  utf8_offset_position_ = 0;
+  utf8_offset_ = 0;
   selection_ = TextRange(0);
   composing_range_ = TextRange(0);
 }
@@ -73,7 +112,7 @@ void TextInputModel::UpdateComposingText(const std::u16string& text) {
     return;
   }
   DeleteSelected();
-  text_.replace(composing_range_.start(), composing_range_.length(), text);
+  ReplaceText(composing_range_.start(), composing_range_.length(), text);
   composing_range_.set_end(composing_range_.start() + text.length());
   selection_ = TextRange(composing_range_.end());
 }
@@ -103,7 +142,7 @@ bool TextInputModel::DeleteSelected() {
     return false;
   }
   size_t start = selection_.start();
-  text_.erase(start, selection_.length());
+  ReplaceText(start, selection_.length(), std::u16string());
   selection_ = TextRange(start);
   if (composing_) {
     // This occurs only immediately after composing has begun with a selection.
@@ -130,12 +169,13 @@ void TextInputModel::AddText(const std::u16string& text) {
   DeleteSelected();
   if (composing_) {
     // Delete the current composing text, set the cursor to composing start.
-    text_.erase(composing_range_.start(), composing_range_.length());
+    ReplaceText(composing_range_.start(), composing_range_.length(),
+                std::u16string());
     selection_ = TextRange(composing_range_.start());
     composing_range_.set_end(composing_range_.start() + text.length());
   }
   size_t position = selection_.position();
-  text_.insert(position, text);
+  ReplaceText(position, 0, text);
   selection_ = TextRange(position + text.length());
 }
 
@@ -152,8 +192,8 @@ bool TextInputModel::Backspace() {
   // There is no selection. Delete the preceding codepoint.
   size_t position = selection_.position();
   if (position != editable_range().start()) {
-    int count = IsTrailingSurrogate(text_.at(position - 1)) ? 2 : 1;
-    text_.erase(position - count, count);
+    int count = IsTrailingSurrogate(CharAt(position - 1)) ? 2 : 1;
+    ReplaceText(position - count, count, std::u16string());
     selection_ = TextRange(position - count);
     if (composing_) {
       composing_range_.set_end(composing_range_.end() - count);
@@ -170,8 +210,8 @@ bool TextInputModel::Delete() {
   // There is no selection. Delete the preceding codepoint.
   size_t position = selection_.position();
   if (position < editable_range().end()) {
-    int count = IsLeadingSurrogate(text_.at(position)) ? 2 : 1;
-    text_.erase(position, count);
+    int count = IsLeadingSurrogate(CharAt(position)) ? 2 : 1;
+    ReplaceText(position, count, std::u16string());
     if (composing_) {
       composing_range_.set_end(composing_range_.end() - count);
     }
@@ -191,17 +231,17 @@ bool TextInputModel::DeleteSurrounding(int offset_from_cursor, int count) {
         count = i;
         break;
       }
-      start -= IsTrailingSurrogate(text_.at(start - 1)) ? 2 : 1;
+      start -= IsTrailingSurrogate(CharAt(start - 1)) ? 2 : 1;
     }
   } else {
     for (int i = 0; i < offset_from_cursor && start != max_pos; i++) {
-      start += IsLeadingSurrogate(text_.at(start)) ? 2 : 1;
+      start += IsLeadingSurrogate(CharAt(start)) ? 2 : 1;
     }
   }
 
   auto end = start;
   for (int i = 0; i < count && end != max_pos; i++) {
-    end += IsLeadingSurrogate(text_.at(start)) ? 2 : 1;
+    end += IsLeadingSurrogate(CharAt(start)) ? 2 : 1;
   }
 
   if (start == end) {
@@ -209,7 +249,7 @@ bool TextInputModel::DeleteSurrounding(int offset_from_cursor, int count) {
   }
 
   auto deleted_length = end - start;
-  text_.erase(start, deleted_length);
+  ReplaceText(start, deleted_length, std::u16string());
 
   // Cursor moves only if deleted area is before it.
   selection_ = TextRange(offset_from_cursor <= 0 ? start : selection_.start());
@@ -266,7 +306,7 @@ bool TextInputModel::MoveCursorForward() {
   // Otherwise, move the cursor forward.
   size_t position = selection_.position();
   if (position != editable_range().end()) {
-    int count = IsLeadingSurrogate(text_.at(position)) ? 2 : 1;
+    int count = IsLeadingSurrogate(CharAt(position)) ? 2 : 1;
     selection_ = TextRange(position + count);
     return true;
   }
@@ -282,7 +322,7 @@ bool TextInputModel::MoveCursorBack() {
   // Otherwise, move the cursor backward.
   size_t position = selection_.position();
   if (position != editable_range().start()) {
-    int count = IsTrailingSurrogate(text_.at(position - 1)) ? 2 : 1;
+    int count = IsTrailingSurrogate(CharAt(position - 1)) ? 2 : 1;
     selection_ = TextRange(position - count);
     return true;
   }
@@ -290,18 +330,157 @@ bool TextInputModel::MoveCursorBack() {
 }
 
 std::string TextInputModel::GetText() const {
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(text_);
+  if (!utf8_text_valid_) {
+    utf8_text_.clear();
+    utf8_text_.reserve(text_length());
+    size_t split = gap_start_;
+    // Don't split a surrogate pair across the two halves of the buffer.
+    if (split > 0 && IsLeadingSurrogate(buffer_[split - 1])) {
+      split--;
+    }
+    AppendUtf8(buffer_.data(), split, &utf8_text_);
+    char16_t pair[2];
+    if (split != gap_start_) {
+      pair[0] = buffer_[split];
+      CopyText(split + 1, std::min(split + 2, text_length()), &pair[1]);
+      AppendUtf8(pair, std::min<size_t>(2, text_length() - split),
+                 &utf8_text_);
+      split += 2;
+    }
+    if (split < text_length()) {
+      AppendUtf8(buffer_.data() + split + gap_end_ - gap_start_,
+                 text_length() - split, &utf8_text_);
+    }
+    utf8_text_valid_ = true;
+  }
+  return utf8_text_;
 }
 
 int TextInputModel::GetCursorOffset() const {
-  // Measure the length of the current text up to the selection extent.
-  // There is probably a much more efficient way of doing this.
-  auto leading_text = text_.substr(0, selection_.extent());
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(leading_text).size();
+  return GetUtf8Offset(selection_.extent());
+}
+
+void TextInputModel::ReplaceText(size_t start,
+                                 size_t length,
+                                 const std::u16string& text) {
+  size_t end = start + length;
+  // Edits next to half of a surrogate pair can change how the text around
+  // them is encoded, so the UTF-8 text has to be encoded again from scratch.
+  bool splits_surrogate_pair =
+      (start > 0 && IsLeadingSurrogate(CharAt(start - 1))) ||
+      (end < text_length() && IsTrailingSurrogate(CharAt(end))) ||
+      (!text.empty() && (IsTrailingSurrogate(text.front()) ||
+                         IsLeadingSurrogate(text.back())));
+  if (splits_surrogate_pair) {
+    utf8_text_valid_ = false;
+    utf8_offset_position_ = 0;
+    utf8_offset_ = 0;
+  } else {
+    // The text before |start| doesn't change, so its UTF-8 offset remains
+    // valid after the edit.
+    size_t utf8_start = GetUtf8Offset(start);
+    if (utf8_text_valid_) {
+      size_t utf8_end = utf8_start;
+      for (size_t i = start; i < end; i++) {
+        utf8_end += GetUtf8Length(i);
+      }
+      std::string utf8;
+      AppendUtf8(text.data(), text.length(), &utf8);
+      utf8_text_.replace(utf8_start, utf8_end - utf8_start, utf8);
+    }
+  }
+
+  MoveGap(start, text.length());
+  gap_end_ += length;
+  std::copy(text.begin(), text.end(), buffer_.begin() + gap_start_);
+  gap_start_ += text.length();
+}
+
+void TextInputModel::MoveGap(size_t position, size_t size) {
+  if (gap_end_ - gap_start_ < size) {
+    size_t length = text_length();
+    size_t gap = std::max({size, length, kMinimumGapSize});
+    std::u16string buffer(length + gap, u'\0');
+    CopyText(0, position, &buffer[0]);
+    CopyText(position, length, &buffer[position + gap]);
+    buffer_.swap(buffer);
+    gap_start_ = position;
+    gap_end_ = position + gap;
+    return;
+  }
+  if (position < gap_start_) {
+    size_t count = gap_start_ - position;
+    std::copy_backward(buffer_.begin() + position,
+                       buffer_.begin() + gap_start_,
+                       buffer_.begin() + gap_end_);
+    gap_start_ -= count;
+    gap_end_ -= count;
+  } else if (position > gap_start_) {
+    size_t count = position - gap_start_;
+    std::copy(buffer_.begin() + gap_end_, buffer_.begin() + gap_end_ + count,
+              buffer_.begin() + gap_start_);
+    gap_start_ += count;
+    gap_end_ += count;
+  }
+}
+
+void TextInputModel::CopyText(size_t start,
+                              size_t end,
+                              char16_t* output) const {
+  size_t gap_length = gap_end_ - gap_start_;
+  for (size_t i = start; i < std::min(end, gap_start_); i++) {
+    *output++ = buffer_[i];
+  }
+  for (size_t i = std::max(start, gap_start_); i < end; i++) {
+    *output++ = buffer_[i + gap_length];
+  }
+}
+
+size_t TextInputModel::GetUtf8Length(size_t position) const {
+  char16_t c = CharAt(position);
+  if (c < 0x80) {
+    return 1;
+  }
+  if (c < 0x800) {
+    return 2;
+  }
+  // A surrogate pair is four bytes in UTF-8, counted at the leading
+  // surrogate. Unpaired surrogates are replaced with U+FFFD.
+  if (IsLeadingSurrogate(c) && position + 1 < text_length() &&
+      IsTrailingSurrogate(CharAt(position + 1))) {
+    return 4;
+  }
+  if (IsTrailingSurrogate(c) && position > 0 &&
+      IsLeadingSurrogate(CharAt(position - 1))) {
+    return 0;
+  }
+  return 3;
+}
+
+size_t TextInputModel::GetUtf8Offset(size_t position) const {
+  // Measure from the last known offset, which is usually close by, or from
+  // either end of the text when that is closer.
+  size_t length = text_length();
+  size_t distance = position > utf8_offset_position_
+                        ? position - utf8_offset_position_
+                        : utf8_offset_position_ - position;
+  if (position < distance) {
+    utf8_offset_position_ = 0;
+    utf8_offset_ = 0;
+  } else if (utf8_text_valid_ && length - position < distance) {
+    utf8_offset_position_ = length;
+    utf8_offset_ = utf8_text_.length();
+  }
+  size_t offset = utf8_offset_;
+  for (size_t i = utf8_offset_position_; i < position; i++) {
+    offset += GetUtf8Length(i);
+  }
+  for (size_t i = position; i < utf8_offset_position_; i++) {
+    offset -= GetUtf8Length(i);
+  }
+  utf8_offset_position_ = position;
+  utf8_offset_ = offset;
+  return offset;
 }
 
 }  // namespace flutter
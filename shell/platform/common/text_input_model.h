@@ -179,7 +179,7 @@ class TextInputModel {
   int GetCursorOffset() const;
 
   // Returns a range covering the entire text.
-  TextRange text_range() const { return TextRange(0, text_.length()); }
+  TextRange text_range() const { return TextRange(0, text_length()); }
 
   // The current selection.
   TextRange selection() const { return selection_; }
@@ -207,7 +207,52 @@ class TextInputModel {
     return composing_ ? composing_range_ : text_range();
   }
 
-  std::u16string text_;
+  // Returns the length of the text in UTF-16 code units.
+  size_t text_length() const {
+    return buffer_.length() - (gap_end_ - gap_start_);
+  }
+
+  // Returns the UTF-16 code unit at |position|.
+  char16_t CharAt(size_t position) const {
+    return buffer_[position < gap_start_ ? position
+                                         : position + gap_end_ - gap_start_];
+  }
+
+  // Replaces |length| UTF-16 code units at |start| with |text|.
+  void ReplaceText(size_t start, size_t length, const std::u16string& text);
+
+  // Moves the gap to |position|, growing it to at least |size| code units.
+  void MoveGap(size_t position, size_t size);
+
+  // Copies the text in [start, end) to |output|.
+  void CopyText(size_t start, size_t end, char16_t* output) const;
+
+  // Returns the number of bytes in the UTF-8 encoding of the text that come
+  // from the UTF-16 code unit at |position|.
+  size_t GetUtf8Length(size_t position) const;
+
+  // Returns the offset in the UTF-8 encoded text of the UTF-16 |position|.
+  size_t GetUtf8Offset(size_t position) const;
+
+  // The text is held in a gap buffer: |buffer_| holds the text before the gap
+  // in [0, gap_start_) and the rest of the text in [gap_end_, length). Edits
+  // move the gap to where they happen, so typing doesn't move the text after
+  // the cursor.
+  std::u16string buffer_;
+  size_t gap_start_ = 0;
+  size_t gap_end_ = 0;
+
+  // The text encoded as UTF-8. Once requested it is kept up to date by edits,
+  // rather than encoding the whole text for each update.
+  mutable std::string utf8_text_;
+  mutable bool utf8_text_valid_ = true;
+
+  // A UTF-16 position and its offset in the UTF-8 encoded text, so that
+  // offsets near the last edit or query can be found without measuring all
+  // of the text before them.
+  mutable size_t utf8_offset_position_ = 0;
+  mutable size_t utf8_offset_ = 0;
+
   TextRange selection_ = TextRange(0);
   TextRange composing_range_ = TextRange(0);
   bool composing_ = false;
@@ -0,0 +1,80 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/text_input_model.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns a model holding a document of about |size| bytes of text, with the
+// cursor in the middle.
+std::unique_ptr<TextInputModel> CreateDocument(size_t size) {
+  const std::string line =
+      "The quick brown fox jumps over the lazy dog. Voix ambiguë d'un cœur "
+      "qui, au zéphyr, préfère les jattes de kiwis. 😀\n";
+  std::string text;
+  text.reserve(size + line.size());
+  while (text.size() < size) {
+    text += line;
+  }
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText(text);
+  model->SetSelection(TextRange(model->text_range().end() / 2));
+  return model;
+}
+
+}  // namespace
+
+// Types into a document, reading back the state that the text input plugins
+// send to the framework after each key press.
+static void BM_TextInputModelType(benchmark::State& state) {
+  auto model = CreateDocument(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddCodePoint('a');
+    std::string text = model->GetText();
+    int cursor_offset = model->GetCursorOffset();
+    benchmark::DoNotOptimize(text);
+    benchmark::DoNotOptimize(cursor_offset);
+  }
+}
+
+// Types and deletes characters without reading back the state.
+static void BM_TextInputModelEdit(benchmark::State& state) {
+  auto model = CreateDocument(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddCodePoint('a');
+    model->Backspace();
+  }
+}
+
+// Alternates between typing at the start and the end of a document.
+static void BM_TextInputModelEditFarApart(benchmark::State& state) {
+  auto model = CreateDocument(state.range(0));
+  size_t end = model->text_range().end();
+  while (state.KeepRunning()) {
+    model->SetSelection(TextRange(0));
+    model->AddCodePoint('a');
+    model->SetSelection(TextRange(end));
+    model->Backspace();
+    std::string text = model->GetText();
+    benchmark::DoNotOptimize(text);
+  }
+}
+
+BENCHMARK(BM_TextInputModelType)
+    ->Range(1024, 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextInputModelEdit)
+    ->Range(1024, 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextInputModelEditFarApart)
+    ->Range(1024, 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
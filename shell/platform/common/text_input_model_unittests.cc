@@ -4,7 +4,9 @@
 
 #include "flutter/shell/platform/common/text_input_model.h"
 
+#include <codecvt>
 #include <limits>
+#include <locale>
 #include <map>
 #include <vector>
 
@@ -1718,4 +1720,75 @@ TEST(TextInputModel, GetCursorOffsetReverseSelection) {
   EXPECT_EQ(model->GetCursorOffset(), 1);
 }
 
+TEST(TextInputModel, GetTextAfterEditInsideSurrogatePair) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("a\U0001F600b");
+  EXPECT_TRUE(model->SetSelection(TextRange(2)));
+  model->AddText(u"x");
+  // Unpaired surrogates are replaced with U+FFFD.
+  EXPECT_EQ(model->GetText(), "a\uFFFDx\uFFFDb");
+  EXPECT_EQ(model->GetCursorOffset(), 5);
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_EQ(model->GetText(), "a\U0001F600b");
+  EXPECT_EQ(model->GetCursorOffset(), 5);
+}
+
+TEST(TextInputModel, GetTextAfterManyEdits) {
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
+      converter;
+  auto model = std::make_unique<TextInputModel>();
+  std::u16string expected;
+  for (int i = 0; i < 1000; i++) {
+    expected += u"ab\u00a2\u20ac\U00010348 ";
+  }
+  model->SetText(converter.to_bytes(expected));
+
+  // Insert and delete text all over the document, including characters that
+  // take 1, 2, 3 and 4 bytes in UTF-8.
+  const std::u16string insertions[] = {u"x", u"\u00e9", u"\u4e2d",
+                                       u"\U0001F600", u"hello"};
+  uint32_t random = 1;
+  for (int i = 0; i < 500; i++) {
+    random = random * 1103515245 + 12345;
+    size_t position = (random >> 8) % (expected.length() + 1);
+    if (position < expected.length() && (expected[position] & 0xFC00) == 0xDC00) {
+      position--;
+    }
+    EXPECT_TRUE(model->SetSelection(TextRange(position)));
+    switch (i % 3) {
+      case 0: {
+        const std::u16string& text = insertions[(random >> 4) % 5];
+        model->AddText(text);
+        expected.insert(position, text);
+        position += text.length();
+        break;
+      }
+      case 1:
+        if (position > 0) {
+          size_t count = (expected[position - 1] & 0xFC00) == 0xDC00 ? 2 : 1;
+          EXPECT_TRUE(model->Backspace());
+          expected.erase(position - count, count);
+          position -= count;
+        }
+        break;
+      case 2:
+        if (position < expected.length()) {
+          size_t count = (expected[position] & 0xFC00) == 0xD800 ? 2 : 1;
+          EXPECT_TRUE(model->Delete());
+          expected.erase(position, count);
+        }
+        break;
+    }
+    // Only read the text back some of the time, so that edits are applied
+    // both with and without the UTF-8 text having been requested.
+    if (i % 7 < 3) {
+      ASSERT_EQ(model->GetText(), converter.to_bytes(expected));
+    }
+    EXPECT_EQ(model->GetCursorOffset(),
+              static_cast<int>(
+                  converter.to_bytes(expected.substr(0, position)).size()));
+  }
+  EXPECT_EQ(model->GetText(), converter.to_bytes(expected));
+}
+
 }  // namespace flutter
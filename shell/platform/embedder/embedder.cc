@@ -37,6 +37,7 @@ extern const intptr_t kPlatformStrongDillSize;
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/common/startup_timeline.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
@@ -1140,6 +1141,14 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
     };
   }
 
+  flutter::VsyncWaiterEmbedder::PreferredFrameRateCallback
+      preferred_frame_rate_callback = nullptr;
+  if (SAFE_ACCESS(args, preferred_frame_rate_callback, nullptr) != nullptr) {
+    preferred_frame_rate_callback =
+        [ptr = args->preferred_frame_rate_callback,
+         user_data](double frame_rate) { return ptr(user_data, frame_rate); };
+  }
+
   flutter::PlatformViewEmbedder::ComputePlatformResolvedLocaleCallback
       compute_platform_resolved_locale_callback = nullptr;
   if (SAFE_ACCESS(args, compute_platform_resolved_locale_callback, nullptr) !=
@@ -1196,13 +1205,34 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
                                       user_data]() { return ptr(user_data); };
   }
 
+  const FlutterCompositor* compositor = SAFE_ACCESS(args, compositor, nullptr);
   auto external_view_embedder_result =
-      InferExternalViewEmbedderFromArgs(SAFE_ACCESS(args, compositor, nullptr));
+      InferExternalViewEmbedderFromArgs(compositor);
   if (external_view_embedder_result.second) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments,
                               "Compositor arguments were invalid.");
   }
 
+  const bool present_layers_on_platform_thread =
+      compositor != nullptr &&
+      SAFE_ACCESS(compositor, present_layers_on_platform_thread, false);
+  const FlutterCustomTaskRunners* custom_task_runners =
+      SAFE_ACCESS(args, custom_task_runners, nullptr);
+  if (present_layers_on_platform_thread &&
+      (custom_task_runners == nullptr ||
+       SAFE_ACCESS(custom_task_runners, platform_task_runner, nullptr) ==
+           nullptr)) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Presenting layers on the platform thread requires a custom platform "
+        "task runner.");
+  }
+
+  // The platform view creation callback takes ownership of the external view
+  // embedder, but is only invoked once the shell is created below.
+  flutter::EmbedderExternalViewEmbedder* external_view_embedder =
+      external_view_embedder_result.first.get();
+
   flutter::PlatformViewEmbedder::PlatformDispatchTable platform_dispatch_table =
       {
           update_semantics_nodes_callback,            //
@@ -1211,6 +1241,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           vsync_callback,                             //
           compute_platform_resolved_locale_callback,  //
           on_pre_engine_restart_callback,             //
+          preferred_frame_rate_callback,              //
       };
 
   auto on_create_platform_view = InferPlatformViewCreationCallback(
@@ -1281,7 +1312,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
 
   auto thread_host =
       flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
-          SAFE_ACCESS(args, custom_task_runners, nullptr));
+          custom_task_runners);
 
   if (!thread_host || !thread_host->IsValid()) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments,
@@ -1296,6 +1327,11 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
                               "Task runner configuration was invalid.");
   }
 
+  if (present_layers_on_platform_thread) {
+    external_view_embedder->SetPresentTaskRunner(
+        task_runners.GetPlatformTaskRunner());
+  }
+
   auto run_configuration =
       flutter::RunConfiguration::InferFromSettings(settings);
 
@@ -1831,6 +1867,82 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+namespace {
+
+// The response data of |FlutterEngineSendPlatformMessageResponseNoCopy|,
+// which the embedder lets the engine write to until it is released.
+class EmbedderResponseMapping final : public fml::Mapping {
+ public:
+  EmbedderResponseMapping(uint8_t* data,
+                          size_t size,
+                          VoidCallback release_callback,
+                          void* user_data)
+      : data_(data),
+        size_(size),
+        release_callback_(release_callback),
+        user_data_(user_data) {}
+
+  ~EmbedderResponseMapping() override {
+    if (release_callback_) {
+      release_callback_(user_data_);
+    }
+  }
+
+  // |fml::Mapping|
+  size_t GetSize() const override { return size_; }
+
+  // |fml::Mapping|
+  const uint8_t* GetMapping() const override { return data_; }
+
+  // |fml::Mapping|
+  bool IsDontNeedSafe() const override { return false; }
+
+  // |fml::Mapping|
+  uint8_t* GetMutableMapping() override { return data_; }
+
+ private:
+  uint8_t* const data_;
+  const size_t size_;
+  const VoidCallback release_callback_;
+  void* const user_data_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderResponseMapping);
+};
+
+}  // namespace
+
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* user_data) {
+  // Taking the buffer over first releases it on every path.
+  auto mapping = std::make_unique<EmbedderResponseMapping>(
+      data, data_length, release_callback, user_data);
+
+  if (data_length != 0 && data == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Data size was non zero but the pointer to the data was null.");
+  }
+
+  auto response = handle->message->response();
+
+  if (response) {
+    if (data_length == 0) {
+      response->CompleteEmpty();
+    } else {
+      response->Complete(std::move(mapping));
+    }
+  }
+
+  delete handle;
+
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -2360,6 +2472,58 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
   }
 }
 
+namespace {
+static FlutterEngineStartupPhase ToEmbedderStartupPhase(
+    flutter::StartupTimeline::Phase phase) {
+  switch (phase) {
+    case flutter::StartupTimeline::kDartSnapshotMapping:
+      return kFlutterEngineStartupPhaseDartSnapshotMapping;
+    case flutter::StartupTimeline::kDartVMCreation:
+      return kFlutterEngineStartupPhaseDartVMCreation;
+    case flutter::StartupTimeline::kAssetManagerSetup:
+      return kFlutterEngineStartupPhaseAssetManagerSetup;
+    case flutter::StartupTimeline::kFontCollectionSetup:
+      return kFlutterEngineStartupPhaseFontCollectionSetup;
+    case flutter::StartupTimeline::kIsolateCreation:
+      return kFlutterEngineStartupPhaseIsolateCreation;
+    case flutter::StartupTimeline::kPersistentCacheLoad:
+      return kFlutterEngineStartupPhasePersistentCacheLoad;
+    case flutter::StartupTimeline::kFirstBeginFrame:
+      return kFlutterEngineStartupPhaseFirstBeginFrame;
+    case flutter::StartupTimeline::kFirstRasterizedFrame:
+    case flutter::StartupTimeline::kCount:
+      break;
+  }
+  return kFlutterEngineStartupPhaseFirstRasterizedFrame;
+}
+}  // namespace
+
+FlutterEngineResult FlutterEngineGetStartupPhases(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterEngineStartupPhaseCallback callback,
+    void* user_data) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid startup phase callback.");
+  }
+
+  for (const auto& phase : engine->GetShell().GetStartupPhases()) {
+    FlutterEngineStartupPhaseTiming timing = {};
+    timing.struct_size = sizeof(FlutterEngineStartupPhaseTiming);
+    timing.phase = ToEmbedderStartupPhase(phase.phase);
+    timing.name = flutter::StartupTimeline::GetPhaseName(phase.phase);
+    timing.start_nanos = phase.start.ToEpochDelta().ToNanoseconds();
+    timing.end_nanos = phase.end.ToEpochDelta().ToNanoseconds();
+    callback(&timing, user_data);
+  }
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2410,6 +2574,9 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(GetStartupPhases, FlutterEngineGetStartupPhases);
+  SET_PROC(SendPlatformMessageResponseNoCopy,
+           FlutterEngineSendPlatformMessageResponseNoCopy);
 #undef SET_PROC
 
   return kSuccess;
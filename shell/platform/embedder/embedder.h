@@ -314,6 +314,8 @@ typedef bool (*TextureFrameCallback)(void* /* user data */,
                                      FlutterOpenGLTexture* /* texture out */);
 typedef void (*VsyncCallback)(void* /* user data */, intptr_t /* baton */);
 typedef void (*OnPreEngineRestartCallback)(void* /* user data */);
+typedef void (*FlutterPreferredFrameRateCallback)(void* /* user data */,
+                                                  double /* frame rate */);
 
 /// A structure to represent the width and height.
 typedef struct {
@@ -1145,6 +1147,22 @@ typedef struct {
   FlutterLayersPresentCallback present_layers_callback;
   /// Avoid caching backing stores provided by this compositor.
   bool avoid_backing_store_cache;
+  /// If true, `present_layers_callback` is invoked on the platform thread
+  /// instead of the render thread. The engine keeps rendering the layers into
+  /// their backing stores on the render thread, and waits for the platform
+  /// thread to present them before it starts on the next frame. This lets
+  /// embedders whose platform views must be positioned on the platform thread
+  /// avoid running the render and platform task runners on the same thread.
+  ///
+  /// Requires a custom `FlutterCustomTaskRunners.platform_task_runner`. As
+  /// the callback then runs on the platform thread, the OpenGL context the
+  /// embedder uses to present the layers must be made current on the platform
+  /// thread instead of the render thread, and must not be the context that
+  /// `FlutterOpenGLRendererConfig.make_current` makes current for rendering.
+  /// Every frame is presented, except those rendered while the engine waits
+  /// for the surface to be torn down in `FlutterEngineDeinitialize` or
+  /// `FlutterEngineShutdown`.
+  bool present_layers_on_platform_thread;
 } FlutterCompositor;
 
 typedef struct {
@@ -1217,6 +1235,47 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// The phases of starting Flutter reported by `FlutterEngineGetStartupPhases`.
+typedef enum {
+  /// Mapping the VM and isolate snapshots.
+  kFlutterEngineStartupPhaseDartSnapshotMapping,
+  /// Launching the Dart VM. This only happens for the first engine of a
+  /// process, or after the VM was shut down.
+  kFlutterEngineStartupPhaseDartVMCreation,
+  /// Giving the engine its assets and registering the fonts they contain.
+  kFlutterEngineStartupPhaseAssetManagerSetup,
+  /// Setting up the default font manager.
+  kFlutterEngineStartupPhaseFontCollectionSetup,
+  /// Creating and launching the root isolate.
+  kFlutterEngineStartupPhaseIsolateCreation,
+  /// Loading and precompiling the shaders of the persistent cache.
+  kFlutterEngineStartupPhasePersistentCacheLoad,
+  /// Building the first frame.
+  kFlutterEngineStartupPhaseFirstBeginFrame,
+  /// Rasterizing the first frame.
+  kFlutterEngineStartupPhaseFirstRasterizedFrame,
+} FlutterEngineStartupPhase;
+
+typedef struct {
+  /// The size of this struct. Must be
+  /// sizeof(FlutterEngineStartupPhaseTiming).
+  size_t struct_size;
+  FlutterEngineStartupPhase phase;
+  /// The name of the phase, for example "DartVMCreation". The string is
+  /// owned by the engine and only valid for the duration of the callback.
+  const char* name;
+  /// When the phase started, on the clock of `FlutterEngineGetCurrentTime`.
+  uint64_t start_nanos;
+  /// When the phase ended, on the clock of `FlutterEngineGetCurrentTime`.
+  uint64_t end_nanos;
+} FlutterEngineStartupPhaseTiming;
+
+/// A callback made by the engine for each phase reported by
+/// `FlutterEngineGetStartupPhases`.
+typedef void (*FlutterEngineStartupPhaseCallback)(
+    const FlutterEngineStartupPhaseTiming* timing,
+    void* user_data);
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -1589,6 +1648,20 @@ typedef struct {
   //
   // The first argument is the `user_data` from `FlutterEngineInitialize`.
   OnPreEngineRestartCallback on_pre_engine_restart_callback;
+
+  // A callback that is invoked when the rate, in frames per second, at which
+  // the engine begins frames changes.
+  //
+  // This optional callback is only invoked if a `vsync_callback` is specified
+  // and the engine is started with the `--enable-adaptive-frame-rate` switch.
+  // The engine then skips vsyncs while the content changes less often than the
+  // display refreshes, and the embedder may lower the display refresh rate to
+  // the preferred frame rate to save power. The engine keeps working if the
+  // refresh rate is not changed. The callback is made on an internal
+  // engine-managed thread, like the `vsync_callback`.
+  //
+  // The first argument is the `user_data` from `FlutterEngineInitialize`.
+  FlutterPreferredFrameRateCallback preferred_frame_rate_callback;
 } FlutterProjectArgs;
 
 #ifndef FLUTTER_ENGINE_NO_PROTOTYPES
@@ -1849,6 +1922,40 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+//------------------------------------------------------------------------------
+/// @brief      Send a response from the native side to a platform message from
+///             the Dart Flutter application without copying the response
+///             data.
+///
+///             Unlike `FlutterEngineSendPlatformMessageResponse`, the engine
+///             takes over the buffer and may hand it to the Dart application,
+///             which can write to it. The buffer must stay valid, and must not
+///             be used by the embedder, until the engine calls
+///             `release_callback`. The callback may be called on any thread,
+///             including before this call returns if the response is dropped.
+///
+/// @param[in]  engine            The running engine instance.
+/// @param[in]  handle            The platform message response handle.
+/// @param[in]  data              The data to associate with the platform
+///                               message response.
+/// @param[in]  data_length       The length of the platform message response
+///                               data.
+/// @param[in]  release_callback  Called with `user_data` when the engine no
+///                               longer uses the data. It is called once, even
+///                               if the call fails. May be NULL.
+/// @param[in]  user_data         The user data passed to `release_callback`.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* user_data);
+
 //------------------------------------------------------------------------------
 /// @brief      This API is only meant to be used by platforms that need to
 ///             flush tasks on a message loop not controlled by the Flutter
@@ -2251,6 +2358,31 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
     const FlutterEngineDisplay* displays,
     size_t display_count);
 
+//------------------------------------------------------------------------------
+/// @brief      Reports the phases of starting Flutter in this process that
+///             have happened so far, such as the creation of the Dart VM, of
+///             the root isolate and of the first frame. Phases are recorded
+///             the first time they happen in the process, so an engine that
+///             is not the first one of the process reports the phases of the
+///             first one for the steps they both went through.
+///
+///             The callback is made on the calling thread before this call
+///             returns, once per phase in the order in which the phases
+///             started.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  callback   The callback made for each phase.
+/// @param[in]  user_data  A baton passed by the engine to the callback. This
+///                        baton is not interpreted by the engine in any way.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetStartupPhases(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineStartupPhaseCallback callback,
+    void* user_data);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2367,6 +2499,18 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (*FlutterEngineGetStartupPhasesFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineStartupPhaseCallback callback,
+    void* user_data);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageResponseNoCopyFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* user_data);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2411,6 +2555,9 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineGetStartupPhasesFnPtr GetStartupPhases;
+  FlutterEngineSendPlatformMessageResponseNoCopyFnPtr
+      SendPlatformMessageResponseNoCopy;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
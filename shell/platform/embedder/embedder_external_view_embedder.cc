@@ -5,13 +5,29 @@
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
-#include "flutter/shell/platform/embedder/embedder_layers.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/platform/embedder/embedder_render_target.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
 
+// Coordinates presenting a frame on the present task runner with the raster
+// thread that rendered it.
+struct EmbedderExternalViewEmbedder::PresentHandshake {
+  std::mutex mutex;
+  std::condition_variable condition;
+  // Set by the present task runner.
+  bool presenting = false;
+  bool presented = false;
+  // Set when presenting is suspended before the present task runner picked up
+  // the frame. The layers may be gone by then, so the frame must not be
+  // presented.
+  bool cancelled = false;
+};
+
 EmbedderExternalViewEmbedder::EmbedderExternalViewEmbedder(
     bool avoid_backing_store_cache,
     const CreateRenderTargetCallback& create_render_target_callback,
@@ -30,6 +46,38 @@ void EmbedderExternalViewEmbedder::SetSurfaceTransformationCallback(
   surface_transformation_callback_ = surface_transformation_callback;
 }
 
+void EmbedderExternalViewEmbedder::SetPresentTaskRunner(
+    fml::RefPtr<fml::TaskRunner> present_task_runner) {
+  present_task_runner_ = std::move(present_task_runner);
+}
+
+void EmbedderExternalViewEmbedder::SuspendPresenting() {
+  std::shared_ptr<PresentHandshake> pending_present;
+  {
+    std::scoped_lock lock(present_mutex_);
+    presenting_suspended_ = true;
+    pending_present = pending_present_;
+  }
+  if (!pending_present) {
+    return;
+  }
+
+  // This runs on the present task runner, so the pending frame is either not
+  // picked up yet or already presented.
+  {
+    std::scoped_lock lock(pending_present->mutex);
+    if (!pending_present->presenting) {
+      pending_present->cancelled = true;
+    }
+  }
+  pending_present->condition.notify_all();
+}
+
+void EmbedderExternalViewEmbedder::ResumePresenting() {
+  std::scoped_lock lock(present_mutex_);
+  presenting_suspended_ = false;
+}
+
 SkMatrix EmbedderExternalViewEmbedder::GetSurfaceTransformation() const {
   if (!surface_transformation_callback_) {
     return SkMatrix{};
@@ -255,7 +303,7 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
     // Flush the layer description down to the embedder for presentation.
     //
     // @warning: Embedder may trample on our OpenGL context here.
-    presented_layers.InvokePresentCallback(present_callback_);
+    PresentLayers(presented_layers);
   }
 
   // See why this is necessary in the comment where this collection in realized.
@@ -275,4 +323,54 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
   frame->Submit();
 }
 
+void EmbedderExternalViewEmbedder::PresentLayers(const EmbedderLayers& layers) {
+  if (!present_task_runner_ ||
+      present_task_runner_->RunsTasksOnCurrentThread()) {
+    layers.InvokePresentCallback(present_callback_);
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "EmbedderExternalViewEmbedder::PresentLayers");
+  auto handshake = std::make_shared<PresentHandshake>();
+  {
+    std::scoped_lock lock(present_mutex_);
+    if (presenting_suspended_) {
+      FML_DLOG(INFO) << "Presenting is suspended. The frame is not presented.";
+      return;
+    }
+    pending_present_ = handshake;
+  }
+
+  present_task_runner_->PostTask(
+      [handshake, &layers, &present_callback = present_callback_]() {
+        {
+          std::scoped_lock lock(handshake->mutex);
+          if (handshake->cancelled) {
+            return;
+          }
+          handshake->presenting = true;
+        }
+        handshake->condition.notify_all();
+
+        // The raster thread waits until the layers are presented, so they are
+        // still alive.
+        layers.InvokePresentCallback(present_callback);
+
+        {
+          std::scoped_lock lock(handshake->mutex);
+          handshake->presented = true;
+        }
+        handshake->condition.notify_all();
+      });
+
+  {
+    std::unique_lock lock(handshake->mutex);
+    handshake->condition.wait(
+        lock, [&] { return handshake->presented || handshake->cancelled; });
+  }
+
+  std::scoped_lock lock(present_mutex_);
+  pending_present_.reset();
+}
+
 }  // namespace flutter
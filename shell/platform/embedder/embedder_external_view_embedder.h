@@ -6,12 +6,16 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_EXTERNAL_VIEW_EMBEDDER_H_
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
 #include "flutter/shell/platform/embedder/embedder_external_view.h"
+#include "flutter/shell/platform/embedder/embedder_layers.h"
 #include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
 
 namespace flutter {
@@ -74,6 +78,34 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   void SetSurfaceTransformationCallback(
       SurfaceTransformationCallback surface_transformation_callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the task runner the present callback is invoked on. By
+  ///             default, the present callback is invoked on the raster
+  ///             thread. With a present task runner, the layers are still
+  ///             rendered on the raster thread, which then waits for the
+  ///             present task runner to present them.
+  ///
+  /// @param[in]  present_task_runner  The task runner to present layers on,
+  ///                                  usually the platform task runner.
+  ///
+  void SetPresentTaskRunner(fml::RefPtr<fml::TaskRunner> present_task_runner);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stops presenting frames on the present task runner, and
+  ///             cancels the frame the raster thread is waiting to present, if
+  ///             any. Must be called on the present task runner before it
+  ///             blocks on the raster thread, for example while the platform
+  ///             view is destroyed, so that the two threads do not wait on each
+  ///             other. Frames submitted while presenting is suspended are
+  ///             dropped.
+  ///
+  void SuspendPresenting();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Presents frames again after `SuspendPresenting`.
+  ///
+  void ResumePresenting();
+
  private:
   // |ExternalViewEmbedder|
   void CancelFrame() override;
@@ -104,10 +136,17 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   SkCanvas* GetRootCanvas() override;
 
  private:
+  struct PresentHandshake;
+
   const bool avoid_backing_store_cache_;
   const CreateRenderTargetCallback create_render_target_callback_;
   const PresentCallback present_callback_;
   SurfaceTransformationCallback surface_transformation_callback_;
+  fml::RefPtr<fml::TaskRunner> present_task_runner_;
+  std::mutex present_mutex_;
+  bool presenting_suspended_ = false;
+  // The frame the raster thread waits for the present task runner to present.
+  std::shared_ptr<PresentHandshake> pending_present_;
   SkISize pending_frame_size_ = SkISize::Make(0, 0);
   double pending_device_pixel_ratio_ = 1.0;
   SkMatrix pending_surface_transformation_;
@@ -119,6 +158,8 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
 
   SkMatrix GetSurfaceTransformation() const;
 
+  void PresentLayers(const EmbedderLayers& layers);
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalViewEmbedder);
 };
 
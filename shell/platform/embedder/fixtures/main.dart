@@ -288,6 +288,14 @@ void platform_messages_no_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void platform_messages_no_copy_response() {
+  PlatformDispatcher.instance.sendPlatformMessage('test/no_copy', null, (ByteData? data) {
+    var list = data!.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
+    signalNativeMessage(utf8.decode(list));
+  });
+}
+
 @pragma('vm:entry-point')
 void null_platform_messages() {
   PlatformDispatcher.instance.onPlatformMessage =
@@ -989,3 +997,33 @@ void invalid_backingstore() {
   };
   PlatformDispatcher.instance.scheduleFrame();
 }
+
+Picture CreateCirclesPicture(int count, int seed) {
+  Paint paint = Paint();
+  paint.color = Color.fromARGB(127, 0, 0, 255);
+  PictureRecorder baseRecorder = PictureRecorder();
+  Canvas canvas = Canvas(baseRecorder);
+  for (int i = 0; i < count; i++) {
+    final double x = ((seed + i * 7) % 800).toDouble();
+    final double y = ((seed + i * 13) % 600).toDouble();
+    canvas.drawCircle(Offset(x, y), 20.0, paint);
+  }
+  return baseRecorder.endRecording();
+}
+
+@pragma('vm:entry-point')
+void render_platform_views_continuously() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+    // A new picture every frame, so the raster cache does not hide its cost.
+    builder.addPicture(Offset(0.0, 0.0), CreateCirclesPicture(1000, frame++));
+    builder.addPlatformView(42, width: 200.0, height: 200.0);
+    builder.addPicture(Offset(0.0, 0.0), CreateSimplePicture());
+    PlatformDispatcher.instance.views.first.render(builder.build());
+  };
+  PlatformDispatcher.instance.onDrawFrame = () {
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
@@ -81,12 +81,25 @@ void PlatformViewEmbedder::HandlePlatformMessage(
       std::move(message));
 }
 
+// |PlatformView|
+void PlatformViewEmbedder::NotifyDestroyed() {
+  // The platform thread waits for the raster thread to tear down the surface,
+  // so the raster thread must not wait for it to present a frame meanwhile.
+  if (external_view_embedder_) {
+    external_view_embedder_->SuspendPresenting();
+  }
+  PlatformView::NotifyDestroyed();
+}
+
 // |PlatformView|
 std::unique_ptr<Surface> PlatformViewEmbedder::CreateRenderingSurface() {
   if (embedder_surface_ == nullptr) {
     FML_LOG(ERROR) << "Embedder surface was null.";
     return nullptr;
   }
+  if (external_view_embedder_) {
+    external_view_embedder_->ResumePresenting();
+  }
   return embedder_surface_->CreateGPUSurface();
 }
 
@@ -113,7 +126,8 @@ std::unique_ptr<VsyncWaiter> PlatformViewEmbedder::CreateVSyncWaiter() {
   }
 
   return std::make_unique<VsyncWaiterEmbedder>(
-      platform_dispatch_table_.vsync_callback, task_runners_);
+      platform_dispatch_table_.vsync_callback,
+      platform_dispatch_table_.preferred_frame_rate_callback, task_runners_);
 }
 
 // |PlatformView|
@@ -48,6 +48,8 @@ class PlatformViewEmbedder final : public PlatformView {
     ComputePlatformResolvedLocaleCallback
         compute_platform_resolved_locale_callback;
     OnPreEngineRestartCallback on_pre_engine_restart_callback;  // optional
+    VsyncWaiterEmbedder::PreferredFrameRateCallback
+        preferred_frame_rate_callback;  // optional
   };
 
   // Create a platform view that sets up a software rasterizer.
@@ -89,6 +91,9 @@ class PlatformViewEmbedder final : public PlatformView {
   // |PlatformView|
   void HandlePlatformMessage(std::unique_ptr<PlatformMessage> message) override;
 
+  // |PlatformView|
+  void NotifyDestroyed() override;
+
  private:
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
   std::unique_ptr<EmbedderSurface> embedder_surface_;
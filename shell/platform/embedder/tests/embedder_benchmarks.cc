@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "embedder.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/shell/platform/embedder/tests/embedder_config_builder.h"
+#include "flutter/shell/platform/embedder/tests/embedder_test_context_software.h"
+#include "flutter/shell/platform/embedder/tests/embedder_unittests_util.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+// Measures how long tasks posted to the platform thread wait while the engine
+// renders a scene with a platform view every frame, using the software test
+// compositor.
+//
+// With merged threads (`merged/1`), the render task runner is the platform
+// task runner, so rasterization delays platform tasks. Otherwise
+// (`merged/0`), layers are rendered on the engine's raster thread, and only
+// presenting them runs on the platform thread.
+//
+// The iteration time is the platform task latency. The `FrameIntervalMs`
+// counter is the average time between two presented frames.
+static void BM_PlatformTaskLatencyWithPlatformViews(benchmark::State& state) {
+  const bool merge_threads = state.range(0) != 0;
+
+  EmbedderTestContextSoftware context(GetFixturesPath());
+  fml::Thread platform_thread("benchmark_platform_thread");
+  auto platform_task_runner = platform_thread.GetTaskRunner();
+
+  std::mutex engine_mutex;
+  UniqueEngine engine;
+  EmbedderTestTaskRunner test_task_runner(
+      platform_task_runner, [&](FlutterTask task) {
+        std::scoped_lock lock(engine_mutex);
+        if (engine.is_valid()) {
+          FlutterEngineRunTask(engine.get(), &task);
+        }
+      });
+  const auto task_runner_description =
+      test_task_runner.GetFlutterTaskRunnerDescription();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor(/*avoid_backing_store_cache=*/false,
+                        /*present_layers_on_platform_thread=*/!merge_threads);
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+  builder.SetDartEntrypoint("render_platform_views_continuously");
+  builder.SetPlatformTaskRunner(&task_runner_description);
+  if (merge_threads) {
+    builder.SetRenderTaskRunner(&task_runner_description);
+  }
+
+  std::mutex presents_mutex;
+  std::vector<fml::TimePoint> presents;
+  fml::AutoResetWaitableEvent first_frame_latch;
+  context.GetCompositor().SetPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        std::scoped_lock lock(presents_mutex);
+        presents.push_back(fml::TimePoint::Now());
+        if (presents.size() == 1) {
+          first_frame_latch.Signal();
+        }
+      },
+      /*one_shot=*/false);
+
+  fml::AutoResetWaitableEvent latch;
+  platform_task_runner->PostTask([&]() {
+    std::scoped_lock lock(engine_mutex);
+    engine = builder.LaunchEngine();
+    FML_CHECK(engine.is_valid());
+
+    // Send a window metrics events so frames may be scheduled.
+    FlutterWindowMetricsEvent event = {};
+    event.struct_size = sizeof(event);
+    event.width = 800;
+    event.height = 600;
+    event.pixel_ratio = 1.0;
+    FML_CHECK(FlutterEngineSendWindowMetricsEvent(engine.get(), &event) ==
+              kSuccess);
+    latch.Signal();
+  });
+  latch.Wait();
+  first_frame_latch.Wait();
+
+  for (auto _ : state) {
+    const fml::TimePoint posted = fml::TimePoint::Now();
+    fml::TimeDelta latency;
+    platform_task_runner->PostTask([&]() {
+      latency = fml::TimePoint::Now() - posted;
+      latch.Signal();
+    });
+    latch.Wait();
+    state.SetIterationTime(latency.ToSecondsF());
+  }
+
+  platform_task_runner->PostTask([&]() {
+    std::scoped_lock lock(engine_mutex);
+    engine.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  std::scoped_lock lock(presents_mutex);
+  state.counters["Frames"] = presents.size();
+  if (presents.size() > 1) {
+    state.counters["FrameIntervalMs"] =
+        (presents.back() - presents.front()).ToMillisecondsF() /
+        (presents.size() - 1);
+  }
+}
+
+BENCHMARK(BM_PlatformTaskLatencyWithPlatformViews)
+    ->ArgName("merged")
+    ->Arg(1)
+    ->Arg(0)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace testing
+}  // namespace flutter
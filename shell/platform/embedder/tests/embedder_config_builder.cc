@@ -283,7 +283,9 @@ void EmbedderConfigBuilder::SetPlatformMessageCallback(
   context_.SetPlatformMessageCallback(callback);
 }
 
-void EmbedderConfigBuilder::SetCompositor(bool avoid_backing_store_cache) {
+void EmbedderConfigBuilder::SetCompositor(
+    bool avoid_backing_store_cache,
+    bool present_layers_on_platform_thread) {
   context_.SetupCompositor();
   auto& compositor = context_.GetCompositor();
   compositor_.struct_size = sizeof(compositor_);
@@ -314,6 +316,8 @@ void EmbedderConfigBuilder::SetCompositor(bool avoid_backing_store_cache) {
     );
   };
   compositor_.avoid_backing_store_cache = avoid_backing_store_cache;
+  compositor_.present_layers_on_platform_thread =
+      present_layers_on_platform_thread;
   project_args_.compositor = &compositor_;
 }
 
@@ -67,6 +67,53 @@ TEST_F(EmbedderTest, CanLaunchAndShutdownWithValidProjectArgs) {
   engine.reset();
 }
 
+TEST_F(EmbedderTest, CanGetStartupPhases) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  fml::AutoResetWaitableEvent latch;
+  context.AddIsolateCreateCallback([&latch]() { latch.Signal(); });
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  latch.Wait();
+
+  using Timings = std::vector<FlutterEngineStartupPhaseTiming>;
+  Timings timings;
+  ASSERT_EQ(FlutterEngineGetStartupPhases(
+                engine.get(),
+                [](const FlutterEngineStartupPhaseTiming* timing,
+                   void* user_data) {
+                  reinterpret_cast<Timings*>(user_data)->push_back(*timing);
+                },
+                &timings),
+            kSuccess);
+
+  // The snapshots are mapped while the engine is launched.
+  ASSERT_FALSE(timings.empty());
+  bool has_snapshot_mapping = false;
+  for (size_t i = 0; i < timings.size(); i++) {
+    EXPECT_EQ(timings[i].struct_size, sizeof(FlutterEngineStartupPhaseTiming));
+    EXPECT_NE(timings[i].name, nullptr);
+    EXPECT_LE(timings[i].start_nanos, timings[i].end_nanos);
+    EXPECT_LE(timings[i].end_nanos, FlutterEngineGetCurrentTime());
+    if (i > 0) {
+      EXPECT_LE(timings[i - 1].start_nanos, timings[i].start_nanos);
+    }
+    has_snapshot_mapping |=
+        timings[i].phase == kFlutterEngineStartupPhaseDartSnapshotMapping;
+  }
+  EXPECT_TRUE(has_snapshot_mapping);
+
+  EXPECT_EQ(FlutterEngineGetStartupPhases(engine.get(), nullptr, nullptr),
+            kInvalidArguments);
+  EXPECT_EQ(FlutterEngineGetStartupPhases(
+                nullptr,
+                [](const FlutterEngineStartupPhaseTiming* timing,
+                   void* user_data) {},
+                nullptr),
+            kInvalidArguments);
+}
+
 // TODO(41999): Disabled because flaky.
 TEST_F(EmbedderTest, DISABLED_CanLaunchAndShutdownMultipleTimes) {
   EmbedderConfigBuilder builder(
@@ -144,8 +191,6 @@ TEST_F(EmbedderTest, CanTerminateCleanly) {
   ASSERT_TRUE(engine.is_valid());
 }
 
-std::atomic_size_t EmbedderTestTaskRunner::sEmbedderTaskRunnerIdentifiers = {};
-
 TEST_F(EmbedderTest, CanSpecifyCustomPlatformTaskRunner) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
   fml::AutoResetWaitableEvent latch;
@@ -362,6 +407,59 @@ TEST_F(EmbedderTest, PlatformMessagesCanReceiveResponse) {
   captures.latch.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Responds to a platform message from Dart with a buffer that the engine takes
+/// over instead of copying, and checks that Dart receives its contents.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeRespondedToWithoutCopies) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  fml::AutoResetWaitableEvent latch;
+
+  fml::Thread thread;
+  UniqueEngine engine;
+  // Large enough to be handed to Dart instead of copied into its heap.
+  std::string response(2048, 'x');
+  std::string received;
+
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+        received = tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        latch.Signal();
+      }));
+
+  thread.GetTaskRunner()->PostTask([&]() {
+    EmbedderConfigBuilder builder(context);
+    builder.SetSoftwareRendererConfig();
+    builder.SetDartEntrypoint("platform_messages_no_copy_response");
+    builder.SetPlatformMessageCallback(
+        [&](const FlutterPlatformMessage* message) {
+          ASSERT_EQ(strcmp(message->channel, "test/no_copy"), 0);
+          auto result = FlutterEngineSendPlatformMessageResponseNoCopy(
+              engine.get(), message->response_handle,
+              reinterpret_cast<uint8_t*>(response.data()), response.size(),
+              nullptr, nullptr);
+          ASSERT_EQ(result, kSuccess);
+        });
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+  });
+
+  latch.Wait();
+  ASSERT_EQ(received, std::string(2048, 'x'));
+
+  // Since the engine was started on its own thread, it must be killed there as
+  // well. The response buffer is no longer used after this.
+  fml::AutoResetWaitableEvent kill_latch;
+  thread.GetTaskRunner()->PostTask(
+      fml::MakeCopyable([&engine, &kill_latch]() mutable {
+        engine.reset();
+        kill_latch.Signal();
+      }));
+  kill_latch.Wait();
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a platform message can be sent with no response handle. Instead
 /// of the platform message integrity checked via a response handle, a native
@@ -1035,6 +1133,101 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
       ImageMatchesFixture("verifyb143464703_soft_noxform.png", rendered_scene));
 }
 
+//------------------------------------------------------------------------------
+/// Presenting layers on the platform thread needs a platform task runner that
+/// the engine can post the present step to.
+///
+TEST_F(EmbedderTest,
+       PresentingLayersOnPlatformThreadRequiresCustomPlatformTaskRunner) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor(/*avoid_backing_store_cache=*/false,
+                        /*present_layers_on_platform_thread=*/true);
+  builder.SetDartEntrypoint("can_composite_platform_views");
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+//------------------------------------------------------------------------------
+/// Layers are rendered on the raster thread, and presented on the platform
+/// thread, when the compositor asks for it.
+///
+TEST_F(EmbedderTest, CompositorCanPresentLayersOnPlatformThread) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  auto platform_task_runner = CreateNewThread("test_platform_thread");
+  static std::mutex engine_mutex;
+  UniqueEngine engine;
+  fml::AutoResetWaitableEvent sync_latch;
+
+  EmbedderTestTaskRunner test_task_runner(
+      platform_task_runner, [&](FlutterTask task) {
+        std::scoped_lock lock(engine_mutex);
+        if (!engine.is_valid()) {
+          return;
+        }
+        ASSERT_EQ(FlutterEngineRunTask(engine.get(), &task), kSuccess);
+      });
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor(/*avoid_backing_store_cache=*/false,
+                        /*present_layers_on_platform_thread=*/true);
+  builder.SetDartEntrypoint("can_composite_platform_views");
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+
+  fml::CountDownLatch latch(3);
+  context.GetCompositor().SetNextPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        ASSERT_TRUE(platform_task_runner->RunsTasksOnCurrentThread());
+        ASSERT_EQ(layers_count, 3u);
+        ASSERT_EQ(layers[0]->type, kFlutterLayerContentTypeBackingStore);
+        ASSERT_EQ(layers[1]->type, kFlutterLayerContentTypePlatformView);
+        ASSERT_EQ(layers[1]->platform_view->identifier, 42);
+        ASSERT_EQ(layers[2]->type, kFlutterLayerContentTypeBackingStore);
+        latch.CountDown();
+      });
+
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&latch](Dart_NativeArguments args) { latch.CountDown(); }));
+
+  const auto task_runner_description =
+      test_task_runner.GetFlutterTaskRunnerDescription();
+  builder.SetPlatformTaskRunner(&task_runner_description);
+
+  platform_task_runner->PostTask([&]() {
+    std::scoped_lock lock(engine_mutex);
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+
+    // Send a window metrics events so frames may be scheduled.
+    FlutterWindowMetricsEvent event = {};
+    event.struct_size = sizeof(event);
+    event.width = 800;
+    event.height = 600;
+    event.pixel_ratio = 1.0;
+    ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+              kSuccess);
+    sync_latch.Signal();
+  });
+  sync_latch.Wait();
+
+  latch.Wait();
+
+  platform_task_runner->PostTask([&]() {
+    std::scoped_lock lock(engine_mutex);
+    engine.reset();
+    sync_latch.Signal();
+  });
+  sync_latch.Wait();
+}
+
 TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
@@ -11,6 +11,8 @@
 namespace flutter {
 namespace testing {
 
+std::atomic_size_t EmbedderTestTaskRunner::sEmbedderTaskRunnerIdentifiers = {};
+
 sk_sp<SkSurface> CreateRenderSurface(const FlutterLayer& layer,
                                      GrDirectContext* context) {
   const auto image_info =
@@ -6,9 +6,13 @@
 
 namespace flutter {
 
-VsyncWaiterEmbedder::VsyncWaiterEmbedder(const VsyncCallback& vsync_callback,
-                                         flutter::TaskRunners task_runners)
-    : VsyncWaiter(std::move(task_runners)), vsync_callback_(vsync_callback) {
+VsyncWaiterEmbedder::VsyncWaiterEmbedder(
+    const VsyncCallback& vsync_callback,
+    const PreferredFrameRateCallback& preferred_frame_rate_callback,
+    flutter::TaskRunners task_runners)
+    : VsyncWaiter(std::move(task_runners)),
+      vsync_callback_(vsync_callback),
+      preferred_frame_rate_callback_(preferred_frame_rate_callback) {
   FML_DCHECK(vsync_callback_);
 }
 
@@ -21,6 +25,13 @@ void VsyncWaiterEmbedder::AwaitVSync() {
   vsync_callback_(baton);
 }
 
+// |VsyncWaiter|
+void VsyncWaiterEmbedder::SetPreferredFrameRate(double frame_rate) {
+  if (preferred_frame_rate_callback_) {
+    preferred_frame_rate_callback_(frame_rate);
+  }
+}
+
 // static
 bool VsyncWaiterEmbedder::OnEmbedderVsync(
     const flutter::TaskRunners& task_runners,
@@ -13,8 +13,11 @@ namespace flutter {
 class VsyncWaiterEmbedder final : public VsyncWaiter {
  public:
   using VsyncCallback = std::function<void(intptr_t)>;
+  using PreferredFrameRateCallback = std::function<void(double)>;
 
   VsyncWaiterEmbedder(const VsyncCallback& callback,
+                      const PreferredFrameRateCallback&
+                          preferred_frame_rate_callback,
                       flutter::TaskRunners task_runners);
 
   ~VsyncWaiterEmbedder() override;
@@ -26,10 +29,14 @@ class VsyncWaiterEmbedder final : public VsyncWaiter {
 
  private:
   const VsyncCallback vsync_callback_;
+  const PreferredFrameRateCallback preferred_frame_rate_callback_;
 
   // |VsyncWaiter|
   void AwaitVSync() override;
 
+  // |VsyncWaiter|
+  void SetPreferredFrameRate(double frame_rate) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterEmbedder);
 };
 
@@ -8,6 +8,7 @@
 
 #include <cstring>
 
+#include "flutter/shell/platform/linux/fl_value_private.h"
 #include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
 
@@ -122,11 +123,12 @@ static gboolean write_value(rapidjson::Writer<rapidjson::StringBuffer>& writer,
 
 // Handler to parse JSON using rapidjson in SAX mode.
 struct FlValueHandler {
+  FlValueArena* arena;
   GPtrArray* stack;
   FlValue* key;
   GError* error;
 
-  FlValueHandler() {
+  explicit FlValueHandler(FlValueArena* arena) : arena(arena) {
     stack = g_ptr_array_new_with_free_func(
         reinterpret_cast<GDestroyNotify>(fl_value_unref));
     key = nullptr;
@@ -184,26 +186,26 @@ struct FlValueHandler {
 
   // The following implements the rapidjson SAX API.
 
-  bool Null() { return add(fl_value_new_null()); }
+  bool Null() { return add(fl_value_arena_new_null(arena)); }
 
-  bool Bool(bool b) { return add(fl_value_new_bool(b)); }
+  bool Bool(bool b) { return add(fl_value_arena_new_bool(arena, b)); }
 
-  bool Int(int i) { return add(fl_value_new_int(i)); }
+  bool Int(int i) { return add(fl_value_arena_new_int(arena, i)); }
 
-  bool Uint(unsigned i) { return add(fl_value_new_int(i)); }
+  bool Uint(unsigned i) { return add(fl_value_arena_new_int(arena, i)); }
 
-  bool Int64(int64_t i) { return add(fl_value_new_int(i)); }
+  bool Int64(int64_t i) { return add(fl_value_arena_new_int(arena, i)); }
 
   bool Uint64(uint64_t i) {
     // For some reason (bug in rapidjson?) this is not returned in Int64.
     if (i == G_MAXINT64) {
-      return add(fl_value_new_int(i));
+      return add(fl_value_arena_new_int(arena, i));
     } else {
-      return add(fl_value_new_float(i));
+      return add(fl_value_arena_new_float(arena, i));
     }
   }
 
-  bool Double(double d) { return add(fl_value_new_float(d)); }
+  bool Double(double d) { return add(fl_value_arena_new_float(arena, d)); }
 
   bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) {
     g_set_error(&error, FL_MESSAGE_CODEC_ERROR, FL_MESSAGE_CODEC_ERROR_FAILED,
@@ -212,17 +214,17 @@ struct FlValueHandler {
   }
 
   bool String(const char* str, rapidjson::SizeType length, bool copy) {
-    FlValue* v = fl_value_new_string_sized(str, length);
+    FlValue* v = fl_value_arena_new_string_sized(arena, str, length);
     return add(v);
   }
 
-  bool StartObject() { return add(fl_value_new_map()); }
+  bool StartObject() { return add(fl_value_arena_new_map(arena, 0)); }
 
   bool Key(const char* str, rapidjson::SizeType length, bool copy) {
     if (key != nullptr) {
       fl_value_unref(key);
     }
-    key = fl_value_new_string_sized(str, length);
+    key = fl_value_arena_new_string_sized(arena, str, length);
     return true;
   }
 
@@ -231,7 +233,7 @@ struct FlValueHandler {
     return true;
   }
 
-  bool StartArray() { return add(fl_value_new_list()); }
+  bool StartArray() { return add(fl_value_arena_new_list(arena, 0)); }
 
   bool EndArray(rapidjson::SizeType elementCount) {
     pop();
@@ -250,8 +252,7 @@ static GBytes* fl_json_message_codec_encode_message(FlMessageCodec* codec,
     return nullptr;
   }
 
-  const gchar* text = buffer.GetString();
-  return g_bytes_new(text, strlen(text));
+  return g_bytes_new(buffer.GetString(), buffer.GetSize());
 }
 
 // Implements FlMessageCodec:decode_message.
@@ -268,10 +269,19 @@ static FlValue* fl_json_message_codec_decode_message(FlMessageCodec* codec,
     return nullptr;
   }
 
-  FlValueHandler handler;
+  // Parse in place from a nul-terminated copy of the message, which the codec
+  // owns until parsing is done, as the handler copies everything it needs out
+  // of it. The message has no nul character that would end it early, as
+  // g_utf8_validate() rejects them.
+  g_autofree gchar* text = static_cast<gchar*>(g_malloc(data_length + 1));
+  memcpy(text, data, data_length);
+  text[data_length] = '\0';
+
+  g_autoptr(FlValueArena) arena = fl_value_arena_new();
+  FlValueHandler handler(arena);
   rapidjson::Reader reader;
-  rapidjson::MemoryStream ss(data, data_length);
-  if (!reader.Parse(ss, handler)) {
+  rapidjson::InsituStringStream ss(text);
+  if (!reader.Parse<rapidjson::kParseInsituFlag>(ss, handler)) {
     if (handler.error != nullptr) {
       g_propagate_error(error, handler.error);
       handler.error = nullptr;
@@ -57,6 +57,18 @@ TEST(FlJsonMessageCodecTest, EncodeNull) {
   EXPECT_STREQ(text, "null");
 }
 
+TEST(FlJsonMessageCodecTest, DecodeEmbeddedNul) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  static const char kMessage[] = "[1]\0[2]";
+  g_autoptr(GBytes) message = g_bytes_new(kMessage, sizeof(kMessage) - 1);
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlValue) value = fl_message_codec_decode_message(
+      FL_MESSAGE_CODEC(codec), message, &error);
+  EXPECT_TRUE(g_error_matches(error, FL_JSON_MESSAGE_CODEC_ERROR,
+                              FL_JSON_MESSAGE_CODEC_ERROR_INVALID_UTF8));
+  EXPECT_EQ(value, nullptr);
+}
+
 TEST(FlJsonMessageCodecTest, DecodeNull) {
   g_autoptr(FlValue) value = decode_message("null");
   ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_NULL);
@@ -782,3 +794,33 @@ TEST(FlJsonMessageCodecTest, EncodeDecode) {
 
   EXPECT_TRUE(fl_value_equal(input, output));
 }
+
+TEST(FlJsonMessageCodecTest, DecodeEditingState) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+
+  g_autofree gchar* message = g_strdup(
+      "{ \"method\": \"TextInput.setEditingState\",\n"
+      "  \"args\": { \"text\": \"say \\\"hi\\\"\\n\", \"selectionBase\": 3,\n"
+      "              \"selectionExtent\": 3, \"composingBase\": -1 } }");
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlValue) value =
+      fl_json_message_codec_decode(codec, message, &error);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(error, nullptr);
+
+  // Decoded strings don't refer to the message.
+  g_clear_pointer(&message, g_free);
+
+  FlValue* method = fl_value_lookup_string(value, "method");
+  ASSERT_NE(method, nullptr);
+  EXPECT_STREQ(fl_value_get_string(method), "TextInput.setEditingState");
+  FlValue* args = fl_value_lookup_string(value, "args");
+  ASSERT_NE(args, nullptr);
+  ASSERT_EQ(fl_value_get_type(args), FL_VALUE_TYPE_MAP);
+  EXPECT_EQ(fl_value_get_length(args), static_cast<size_t>(4));
+  EXPECT_STREQ(fl_value_get_string(fl_value_lookup_string(args, "text")),
+               "say \"hi\"\n");
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(args, "selectionBase")), 3);
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(args, "composingBase")),
+            -1);
+}
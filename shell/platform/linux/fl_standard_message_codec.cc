@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
 #include "flutter/shell/platform/linux/fl_standard_message_codec_private.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
@@ -159,15 +160,16 @@ static gboolean read_uint32(GBytes* buffer,
 // Reads a #FL_VALUE_TYPE_INT stored as a signed 32 bit integer from @buffer.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT if successful or %NULL on
 // error.
-static FlValue* read_int32_value(GBytes* buffer,
+static FlValue* read_int32_value(FlValueArena* arena,
+                                 GBytes* buffer,
                                  size_t* offset,
                                  GError** error) {
   if (!check_size(buffer, *offset, sizeof(int32_t), error)) {
     return nullptr;
   }
 
-  FlValue* value = fl_value_new_int(
-      reinterpret_cast<const int32_t*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_int(
+      arena, reinterpret_cast<const int32_t*>(get_data(buffer, offset))[0]);
   *offset += sizeof(int32_t);
   return value;
 }
@@ -175,15 +177,16 @@ static FlValue* read_int32_value(GBytes* buffer,
 // Reads a #FL_VALUE_TYPE_INT stored as a signed 64 bit integer from @buffer.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT if successful or %NULL on
 // error.
-static FlValue* read_int64_value(GBytes* buffer,
+static FlValue* read_int64_value(FlValueArena* arena,
+                                 GBytes* buffer,
                                  size_t* offset,
                                  GError** error) {
   if (!check_size(buffer, *offset, sizeof(int64_t), error)) {
     return nullptr;
   }
 
-  FlValue* value = fl_value_new_int(
-      reinterpret_cast<const int64_t*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_int(
+      arena, reinterpret_cast<const int64_t*>(get_data(buffer, offset))[0]);
   *offset += sizeof(int64_t);
   return value;
 }
@@ -191,7 +194,8 @@ static FlValue* read_int64_value(GBytes* buffer,
 // Reads a 64 bit floating point number from @buffer and writes it to @value.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_FLOAT if successful or %NULL on
 // error.
-static FlValue* read_float64_value(GBytes* buffer,
+static FlValue* read_float64_value(FlValueArena* arena,
+                                   GBytes* buffer,
                                    size_t* offset,
                                    GError** error) {
   if (!read_align(buffer, offset, 8, error)) {
@@ -201,8 +205,8 @@ static FlValue* read_float64_value(GBytes* buffer,
     return nullptr;
   }
 
-  FlValue* value = fl_value_new_float(
-      reinterpret_cast<const double*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_float(
+      arena, reinterpret_cast<const double*>(get_data(buffer, offset))[0]);
   *offset += sizeof(double);
   return value;
 }
@@ -211,6 +215,7 @@ static FlValue* read_float64_value(GBytes* buffer,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_STRING if successful or %NULL
 // on error.
 static FlValue* read_string_value(FlStandardMessageCodec* self,
+                                  FlValueArena* arena,
                                   GBytes* buffer,
                                   size_t* offset,
                                   GError** error) {
@@ -222,16 +227,20 @@ static FlValue* read_string_value(FlStandardMessageCodec* self,
   if (!check_size(buffer, *offset, length, error)) {
     return nullptr;
   }
-  FlValue* value = fl_value_new_string_sized(
-      reinterpret_cast<const gchar*>(get_data(buffer, offset)), length);
+  FlValue* value = fl_value_arena_new_string_sized(
+      arena, reinterpret_cast<const gchar*>(get_data(buffer, offset)), length);
   *offset += length;
   return value;
 }
 
-// Reads an unsigned 8 bit list from @buffer in standard codec format.
-// Returns a new #FlValue of type #FL_VALUE_TYPE_UINT8_LIST if successful or
-// %NULL on error.
-static FlValue* read_uint8_list_value(FlStandardMessageCodec* self,
+// Reads a list of numbers from @buffer in standard codec format.
+// Returns a new #FlValue of @type if successful or %NULL on error.
+//
+// Large lists refer to the data in @buffer rather than copying it.
+static FlValue* read_typed_list_value(FlStandardMessageCodec* self,
+                                      FlValueArena* arena,
+                                      FlValueType type,
+                                      size_t element_size,
                                       GBytes* buffer,
                                       size_t* offset,
                                       GError** error) {
@@ -240,107 +249,15 @@ static FlValue* read_uint8_list_value(FlStandardMessageCodec* self,
                                            error)) {
     return nullptr;
   }
-  if (!check_size(buffer, *offset, sizeof(uint8_t) * length, error)) {
+  if (!read_align(buffer, offset, element_size, error)) {
     return nullptr;
   }
-  FlValue* value = fl_value_new_uint8_list(get_data(buffer, offset), length);
-  *offset += length;
-  return value;
-}
-
-// Reads a signed 32 bit list from @buffer in standard codec format.
-// Returns a new #FlValue of type #FL_VALUE_TYPE_INT32_LIST if successful or
-// %NULL on error.
-static FlValue* read_int32_list_value(FlStandardMessageCodec* self,
-                                      GBytes* buffer,
-                                      size_t* offset,
-                                      GError** error) {
-  uint32_t length;
-  if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
-                                           error)) {
-    return nullptr;
-  }
-  if (!read_align(buffer, offset, 4, error)) {
-    return nullptr;
-  }
-  if (!check_size(buffer, *offset, sizeof(int32_t) * length, error)) {
-    return nullptr;
-  }
-  FlValue* value = fl_value_new_int32_list(
-      reinterpret_cast<const int32_t*>(get_data(buffer, offset)), length);
-  *offset += sizeof(int32_t) * length;
-  return value;
-}
-
-// Reads a signed 64 bit list from @buffer in standard codec format.
-// Returns a new #FlValue of type #FL_VALUE_TYPE_INT64_LIST if successful or
-// %NULL on error.
-static FlValue* read_int64_list_value(FlStandardMessageCodec* self,
-                                      GBytes* buffer,
-                                      size_t* offset,
-                                      GError** error) {
-  uint32_t length;
-  if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
-                                           error)) {
-    return nullptr;
-  }
-  if (!read_align(buffer, offset, 8, error)) {
+  if (!check_size(buffer, *offset, element_size * length, error)) {
     return nullptr;
   }
-  if (!check_size(buffer, *offset, sizeof(int64_t) * length, error)) {
-    return nullptr;
-  }
-  FlValue* value = fl_value_new_int64_list(
-      reinterpret_cast<const int64_t*>(get_data(buffer, offset)), length);
-  *offset += sizeof(int64_t) * length;
-  return value;
-}
-
-// Reads a 32 bit floating point number list from @buffer in standard codec
-// format. Returns a new #FlValue of type #FL_VALUE_TYPE_FLOAT32_LIST if
-// successful or %NULL on error.
-static FlValue* read_float32_list_value(FlStandardMessageCodec* self,
-                                        GBytes* buffer,
-                                        size_t* offset,
-                                        GError** error) {
-  uint32_t length;
-  if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
-                                           error)) {
-    return nullptr;
-  }
-  if (!read_align(buffer, offset, 4, error)) {
-    return nullptr;
-  }
-  if (!check_size(buffer, *offset, sizeof(float) * length, error)) {
-    return nullptr;
-  }
-  FlValue* value = fl_value_new_float32_list(
-      reinterpret_cast<const float*>(get_data(buffer, offset)), length);
-  *offset += sizeof(float) * length;
-  return value;
-}
-
-// Reads a floating point number list from @buffer in standard codec format.
-// Returns a new #FlValue of type #FL_VALUE_TYPE_FLOAT_LIST if successful or
-// %NULL on error.
-static FlValue* read_float64_list_value(FlStandardMessageCodec* self,
-                                        GBytes* buffer,
-                                        size_t* offset,
-                                        GError** error) {
-  uint32_t length;
-  if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
-                                           error)) {
-    return nullptr;
-  }
-  if (!read_align(buffer, offset, 8, error)) {
-    return nullptr;
-  }
-  if (!check_size(buffer, *offset, sizeof(double) * length, error)) {
-    return nullptr;
-  }
-  FlValue* value = fl_value_new_float_list(
-      reinterpret_cast<const double*>(get_data(buffer, offset)), length);
-  *offset += sizeof(double) * length;
+  FlValue* value =
+      fl_value_arena_new_typed_list(arena, type, buffer, *offset, length);
+  *offset += element_size * length;
   return value;
 }
 
@@ -348,6 +265,7 @@ static FlValue* read_float64_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_LIST if successful or %NULL on
 // error.
 static FlValue* read_list_value(FlStandardMessageCodec* self,
+                                FlValueArena* arena,
                                 GBytes* buffer,
                                 size_t* offset,
                                 GError** error) {
@@ -357,14 +275,18 @@ static FlValue* read_list_value(FlStandardMessageCodec* self,
     return nullptr;
   }
 
-  g_autoptr(FlValue) list = fl_value_new_list();
+  // Only reserve space for elements that could be in the buffer, so corrupt
+  // lengths don't cause large allocations.
+  size_t remaining = g_bytes_get_size(buffer) - *offset;
+  g_autoptr(FlValue) list =
+      fl_value_arena_new_list(arena, MIN(length, remaining));
   for (size_t i = 0; i < length; i++) {
-    g_autoptr(FlValue) child =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    FlValue* child = fl_standard_message_codec_read_value(self, arena, buffer,
+                                                          offset, error);
     if (child == nullptr) {
       return nullptr;
     }
-    fl_value_append(list, child);
+    fl_value_append_take(list, child);
   }
 
   return fl_value_ref(list);
@@ -374,6 +296,7 @@ static FlValue* read_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_MAP if successful or %NULL on
 // error.
 static FlValue* read_map_value(FlStandardMessageCodec* self,
+                               FlValueArena* arena,
                                GBytes* buffer,
                                size_t* offset,
                                GError** error) {
@@ -383,19 +306,21 @@ static FlValue* read_map_value(FlStandardMessageCodec* self,
     return nullptr;
   }
 
-  g_autoptr(FlValue) map = fl_value_new_map();
+  size_t remaining = g_bytes_get_size(buffer) - *offset;
+  g_autoptr(FlValue) map =
+      fl_value_arena_new_map(arena, MIN(length, remaining / 2));
   for (size_t i = 0; i < length; i++) {
-    g_autoptr(FlValue) key =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    g_autoptr(FlValue) key = fl_standard_message_codec_read_value(
+        self, arena, buffer, offset, error);
     if (key == nullptr) {
       return nullptr;
     }
-    g_autoptr(FlValue) value =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    FlValue* value = fl_standard_message_codec_read_value(self, arena, buffer,
+                                                          offset, error);
     if (value == nullptr) {
       return nullptr;
     }
-    fl_value_set(map, key, value);
+    fl_value_set_take(map, fl_value_ref(key), value);
   }
 
   return fl_value_ref(map);
@@ -423,9 +348,10 @@ static FlValue* fl_standard_message_codec_decode_message(FlMessageCodec* codec,
   FlStandardMessageCodec* self =
       reinterpret_cast<FlStandardMessageCodec*>(codec);
 
+  g_autoptr(FlValueArena) arena = fl_value_arena_new();
   size_t offset = 0;
-  g_autoptr(FlValue) value =
-      fl_standard_message_codec_read_value(self, message, &offset, error);
+  g_autoptr(FlValue) value = fl_standard_message_codec_read_value(
+      self, arena, message, &offset, error);
   if (value == nullptr) {
     return nullptr;
   }
@@ -627,6 +553,7 @@ gboolean fl_standard_message_codec_write_value(FlStandardMessageCodec* self,
 }
 
 FlValue* fl_standard_message_codec_read_value(FlStandardMessageCodec* self,
+                                              FlValueArena* arena,
                                               GBytes* buffer,
                                               size_t* offset,
                                               GError** error) {
@@ -635,41 +562,43 @@ FlValue* fl_standard_message_codec_read_value(FlStandardMessageCodec* self,
     return nullptr;
   }
 
-  g_autoptr(FlValue) value = nullptr;
   if (type == kValueNull) {
-    return fl_value_new_null();
+    return fl_value_arena_new_null(arena);
   } else if (type == kValueTrue) {
-    return fl_value_new_bool(TRUE);
+    return fl_value_arena_new_bool(arena, TRUE);
   } else if (type == kValueFalse) {
-    return fl_value_new_bool(FALSE);
+    return fl_value_arena_new_bool(arena, FALSE);
   } else if (type == kValueInt32) {
-    value = read_int32_value(buffer, offset, error);
+    return read_int32_value(arena, buffer, offset, error);
   } else if (type == kValueInt64) {
-    value = read_int64_value(buffer, offset, error);
+    return read_int64_value(arena, buffer, offset, error);
   } else if (type == kValueFloat64) {
-    value = read_float64_value(buffer, offset, error);
+    return read_float64_value(arena, buffer, offset, error);
   } else if (type == kValueString) {
-    value = read_string_value(self, buffer, offset, error);
+    return read_string_value(self, arena, buffer, offset, error);
   } else if (type == kValueUint8List) {
-    value = read_uint8_list_value(self, buffer, offset, error);
+    return read_typed_list_value(self, arena, FL_VALUE_TYPE_UINT8_LIST,
+                                 sizeof(uint8_t), buffer, offset, error);
   } else if (type == kValueInt32List) {
-    value = read_int32_list_value(self, buffer, offset, error);
+    return read_typed_list_value(self, arena, FL_VALUE_TYPE_INT32_LIST,
+                                 sizeof(int32_t), buffer, offset, error);
   } else if (type == kValueInt64List) {
-    value = read_int64_list_value(self, buffer, offset, error);
+    return read_typed_list_value(self, arena, FL_VALUE_TYPE_INT64_LIST,
+                                 sizeof(int64_t), buffer, offset, error);
   } else if (type == kValueFloat32List) {
-    value = read_float32_list_value(self, buffer, offset, error);
+    return read_typed_list_value(self, arena, FL_VALUE_TYPE_FLOAT32_LIST,
+                                 sizeof(float), buffer, offset, error);
   } else if (type == kValueFloat64List) {
-    value = read_float64_list_value(self, buffer, offset, error);
+    return read_typed_list_value(self, arena, FL_VALUE_TYPE_FLOAT_LIST,
+                                 sizeof(double), buffer, offset, error);
   } else if (type == kValueList) {
-    value = read_list_value(self, buffer, offset, error);
+    return read_list_value(self, arena, buffer, offset, error);
   } else if (type == kValueMap) {
-    value = read_map_value(self, buffer, offset, error);
+    return read_map_value(self, arena, buffer, offset, error);
   } else {
     g_set_error(error, FL_MESSAGE_CODEC_ERROR,
                 FL_MESSAGE_CODEC_ERROR_UNSUPPORTED_TYPE,
                 "Unexpected standard codec type %02x", type);
     return nullptr;
   }
-
-  return value == nullptr ? nullptr : fl_value_ref(value);
 }
@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+
+namespace {
+
+// Creates a batch of readings, like those that a sensor plugin streams to
+// Dart: a list of maps, each with a few scalar values and a list of numbers.
+FlValue* create_readings(size_t count, size_t values_length) {
+  g_autofree double* values = g_new(double, values_length);
+  for (size_t i = 0; i < values_length; i++) {
+    values[i] = 0.1 * i;
+  }
+
+  FlValue* readings = fl_value_new_list();
+  for (size_t i = 0; i < count; i++) {
+    g_autoptr(FlValue) reading = fl_value_new_map();
+    fl_value_set_string_take(reading, "sensor",
+                             fl_value_new_string("accelerometer"));
+    fl_value_set_string_take(reading, "timestamp",
+                             fl_value_new_int(1000000 + i));
+    fl_value_set_string_take(reading, "values",
+                             fl_value_new_float_list(values, values_length));
+    fl_value_append(readings, reading);
+  }
+  return readings;
+}
+
+GBytes* encode_readings(size_t count, size_t values_length) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) readings = create_readings(count, values_length);
+  return fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), readings,
+                                         nullptr);
+}
+
+}  // namespace
+
+// Decodes many small values, where allocating the FlValue nodes dominates.
+static void BM_FlStandardMessageCodecDecodeManyValues(
+    benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GBytes) message = encode_readings(state.range(0), 3);
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) value = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * g_bytes_get_size(message));
+}
+
+// Decodes a few large typed lists, where copying the list data dominates.
+static void BM_FlStandardMessageCodecDecodeLargeLists(
+    benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GBytes) message = encode_readings(4, state.range(0));
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) value = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * g_bytes_get_size(message));
+}
+
+static void BM_FlStandardMessageCodecEncode(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) readings = create_readings(state.range(0), 3);
+  while (state.KeepRunning()) {
+    g_autoptr(GBytes) message = fl_message_codec_encode_message(
+        FL_MESSAGE_CODEC(codec), readings, nullptr);
+    benchmark::DoNotOptimize(message);
+  }
+}
+
+BENCHMARK(BM_FlStandardMessageCodecDecodeManyValues)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FlStandardMessageCodecDecodeLargeLists)
+    ->Range(1024, 1024 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FlStandardMessageCodecEncode)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
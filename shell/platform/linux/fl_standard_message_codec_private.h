@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_STANDARD_MESSAGE_CODEC_PRIVATE_H_
 #define FLUTTER_SHELL_PLATFORM_LINUX_FL_STANDARD_MESSAGE_CODEC_PRIVATE_H_
 
+#include "flutter/shell/platform/linux/fl_value_private.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
 
 G_BEGIN_DECLS
@@ -60,17 +61,20 @@ gboolean fl_standard_message_codec_write_value(FlStandardMessageCodec* codec,
 /**
  * fl_standard_message_codec_read_value:
  * @codec: an #FlStandardMessageCodec.
+ * @arena: (allow-none): an #FlValueArena to allocate values from, or %NULL to
+ * allocate them on the heap.
  * @buffer: buffer to read from.
  * @offset: (inout): read position in @buffer.
- * @value: location to read size.
  * @error: (allow-none): #GError location to store the error occurring, or
  * %NULL.
  *
- * Reads an #FlValue in Flutter Standard encoding.
+ * Reads an #FlValue in Flutter Standard encoding. Large typed lists in the
+ * value refer to the data in @buffer, and keep it alive.
  *
  * Returns: a new #FlValue or %NULL on error.
  */
 FlValue* fl_standard_message_codec_read_value(FlStandardMessageCodec* codec,
+                                              FlValueArena* arena,
                                               GBytes* buffer,
                                               size_t* offset,
                                               GError** error);
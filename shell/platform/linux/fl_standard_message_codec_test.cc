@@ -1089,3 +1089,67 @@ TEST(FlStandardMessageCodecTest, EncodeDecode) {
 
   ASSERT_TRUE(fl_value_equal(input, output));
 }
+
+TEST(FlStandardMessageCodecTest, DecodeLargeTypedListsWithoutCopying) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+
+  double data[1024];
+  for (int i = 0; i < 1024; i++) {
+    data[i] = i * 0.25;
+  }
+  g_autoptr(FlValue) input = fl_value_new_list();
+  fl_value_append_take(input, fl_value_new_string("samples"));
+  fl_value_append_take(input, fl_value_new_float_list(data, 1024));
+
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GBytes) message =
+      fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), input, &error);
+  ASSERT_NE(message, nullptr);
+
+  g_autoptr(FlValue) output =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  ASSERT_NE(output, nullptr);
+  EXPECT_EQ(error, nullptr);
+  EXPECT_TRUE(fl_value_equal(input, output));
+
+  // The list elements are read directly from the message.
+  gsize message_size;
+  const uint8_t* message_data =
+      static_cast<const uint8_t*>(g_bytes_get_data(message, &message_size));
+  const uint8_t* list_data = reinterpret_cast<const uint8_t*>(
+      fl_value_get_float_list(fl_value_get_list_value(output, 1)));
+  EXPECT_GE(list_data, message_data);
+  EXPECT_LT(list_data, message_data + message_size);
+}
+
+TEST(FlStandardMessageCodecTest, DecodedValuesOutliveMessage) {
+  FlStandardMessageCodec* codec = fl_standard_message_codec_new();
+
+  int64_t data[512];
+  for (int i = 0; i < 512; i++) {
+    data[i] = G_MAXINT64 - i;
+  }
+  g_autoptr(FlValue) input = fl_value_new_map();
+  fl_value_set_string_take(input, "name", fl_value_new_string("sensor"));
+  fl_value_set_string_take(input, "values",
+                           fl_value_new_int64_list(data, 512));
+
+  g_autoptr(GError) error = nullptr;
+  GBytes* message =
+      fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), input, &error);
+  ASSERT_NE(message, nullptr);
+  FlValue* output =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  ASSERT_NE(output, nullptr);
+  g_autoptr(FlValue) values =
+      fl_value_ref(fl_value_lookup_string(output, "values"));
+
+  // Values are still valid once the message, the codec and the rest of the
+  // decoded value are released.
+  g_bytes_unref(message);
+  g_object_unref(codec);
+  fl_value_unref(output);
+
+  g_autoptr(FlValue) expected = fl_value_new_int64_list(data, 512);
+  EXPECT_TRUE(fl_value_equal(values, expected));
+}
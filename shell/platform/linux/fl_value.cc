@@ -3,14 +3,52 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
+#include <algorithm>
 #include <cstring>
 
+// Size of the first block allocated by an arena. Later blocks double in size
+// up to kArenaMaxBlockSize, so small messages don't reserve much memory.
+static constexpr size_t kArenaMinBlockSize = 1024;
+static constexpr size_t kArenaMaxBlockSize = 64 * 1024;
+
+// Alignment of allocations from an arena, enough for any FlValue.
+static constexpr size_t kArenaAlignment = 8;
+
+// Typed lists smaller than this are copied rather than referring to the
+// buffer they were read from, as the copy is cheaper than keeping the whole
+// buffer alive.
+static constexpr size_t kMinTypedListViewSize = 256;
+
+typedef struct _FlValueArenaBlock FlValueArenaBlock;
+
+struct _FlValueArenaBlock {
+  FlValueArenaBlock* next;
+  size_t size;
+  size_t used;
+  // Followed by @size bytes of data.
+};
+
+struct _FlValueArena {
+  // One reference for the creator, and one for each value allocated from
+  // the arena.
+  gint ref_count;
+
+  // Blocks allocated so far, the one being allocated from first.
+  FlValueArenaBlock* blocks;
+
+  // Size of the next block to allocate.
+  size_t next_block_size;
+};
+
 struct _FlValue {
   FlValueType type;
   int ref_count;
+  // Arena this value was allocated from, or %NULL if allocated on the heap.
+  FlValueArena* arena;
 };
 
 typedef struct {
@@ -37,30 +75,40 @@ typedef struct {
   FlValue parent;
   uint8_t* values;
   size_t values_length;
+  // Buffer @values refers to, or %NULL if they are owned by this value.
+  GBytes* bytes;
 } FlValueUint8List;
 
 typedef struct {
   FlValue parent;
   int32_t* values;
   size_t values_length;
+  // Buffer @values refers to, or %NULL if they are owned by this value.
+  GBytes* bytes;
 } FlValueInt32List;
 
 typedef struct {
   FlValue parent;
   int64_t* values;
   size_t values_length;
+  // Buffer @values refers to, or %NULL if they are owned by this value.
+  GBytes* bytes;
 } FlValueInt64List;
 
 typedef struct {
   FlValue parent;
   float* values;
   size_t values_length;
+  // Buffer @values refers to, or %NULL if they are owned by this value.
+  GBytes* bytes;
 } FlValueFloat32List;
 
 typedef struct {
   FlValue parent;
   double* values;
   size_t values_length;
+  // Buffer @values refers to, or %NULL if they are owned by this value.
+  GBytes* bytes;
 } FlValueFloatList;
 
 typedef struct {
@@ -74,13 +122,171 @@ typedef struct {
   GPtrArray* values;
 } FlValueMap;
 
-static FlValue* fl_value_new(FlValueType type, size_t size) {
-  FlValue* self = static_cast<FlValue*>(g_malloc0(size));
+static FlValueArenaBlock* fl_value_arena_block_new(size_t size,
+                                                   FlValueArenaBlock* next) {
+  FlValueArenaBlock* block = static_cast<FlValueArenaBlock*>(
+      g_malloc(sizeof(FlValueArenaBlock) + size));
+  block->next = next;
+  block->size = size;
+  block->used = 0;
+  return block;
+}
+
+// Allocates @size bytes from @arena. The memory is not initialized.
+static gpointer fl_value_arena_alloc(FlValueArena* arena, size_t size) {
+  size = (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+
+  FlValueArenaBlock* block = arena->blocks;
+  if (block == nullptr || block->size - block->used < size) {
+    if (block != nullptr && size > kArenaMaxBlockSize / 4) {
+      // Give large allocations their own block, so the space left in the
+      // current block can still be used.
+      block = fl_value_arena_block_new(size, block->next);
+      arena->blocks->next = block;
+    } else {
+      block = fl_value_arena_block_new(std::max(arena->next_block_size, size),
+                                       arena->blocks);
+      arena->blocks = block;
+      arena->next_block_size =
+          std::min(arena->next_block_size * 2, kArenaMaxBlockSize);
+    }
+  }
+
+  // The data follows the block header, which keeps it aligned.
+  static_assert(sizeof(FlValueArenaBlock) % kArenaAlignment == 0,
+                "Arena blocks must keep their data aligned");
+  uint8_t* data = reinterpret_cast<uint8_t*>(block + 1) + block->used;
+  block->used += size;
+  return data;
+}
+
+// Releases a reference to @arena, and frees it if it was the last one.
+static void fl_value_arena_release(FlValueArena* arena) {
+  if (!g_atomic_int_dec_and_test(&arena->ref_count)) {
+    return;
+  }
+
+  FlValueArenaBlock* block = arena->blocks;
+  while (block != nullptr) {
+    FlValueArenaBlock* next = block->next;
+    g_free(block);
+    block = next;
+  }
+  g_free(arena);
+}
+
+static FlValue* fl_value_new(FlValueArena* arena,
+                             FlValueType type,
+                             size_t size) {
+  FlValue* self;
+  if (arena != nullptr) {
+    self = static_cast<FlValue*>(fl_value_arena_alloc(arena, size));
+    memset(self, 0, size);
+    self->arena = arena;
+    g_atomic_int_inc(&arena->ref_count);
+  } else {
+    self = static_cast<FlValue*>(g_malloc0(size));
+  }
   self->type = type;
   self->ref_count = 1;
   return self;
 }
 
+// Gets the size of each element in a typed list of @type.
+static size_t fl_value_get_element_size(FlValueType type) {
+  switch (type) {
+    case FL_VALUE_TYPE_UINT8_LIST:
+      return sizeof(uint8_t);
+    case FL_VALUE_TYPE_INT32_LIST:
+      return sizeof(int32_t);
+    case FL_VALUE_TYPE_INT64_LIST:
+      return sizeof(int64_t);
+    case FL_VALUE_TYPE_FLOAT32_LIST:
+      return sizeof(float);
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      return sizeof(double);
+    default:
+      return 0;
+  }
+}
+
+// Creates a typed list of @type with @values_length elements at @values.
+// If @bytes is not %NULL the list takes a reference to it, and @values point
+// into it. Otherwise @values are owned by the list.
+static FlValue* fl_value_new_typed_list(FlValueArena* arena,
+                                        FlValueType type,
+                                        gpointer values,
+                                        size_t values_length,
+                                        GBytes* bytes) {
+  switch (type) {
+    case FL_VALUE_TYPE_UINT8_LIST: {
+      FlValueUint8List* self = reinterpret_cast<FlValueUint8List*>(
+          fl_value_new(arena, type, sizeof(FlValueUint8List)));
+      self->values = static_cast<uint8_t*>(values);
+      self->values_length = values_length;
+      self->bytes = bytes;
+      return reinterpret_cast<FlValue*>(self);
+    }
+    case FL_VALUE_TYPE_INT32_LIST: {
+      FlValueInt32List* self = reinterpret_cast<FlValueInt32List*>(
+          fl_value_new(arena, type, sizeof(FlValueInt32List)));
+      self->values = static_cast<int32_t*>(values);
+      self->values_length = values_length;
+      self->bytes = bytes;
+      return reinterpret_cast<FlValue*>(self);
+    }
+    case FL_VALUE_TYPE_INT64_LIST: {
+      FlValueInt64List* self = reinterpret_cast<FlValueInt64List*>(
+          fl_value_new(arena, type, sizeof(FlValueInt64List)));
+      self->values = static_cast<int64_t*>(values);
+      self->values_length = values_length;
+      self->bytes = bytes;
+      return reinterpret_cast<FlValue*>(self);
+    }
+    case FL_VALUE_TYPE_FLOAT32_LIST: {
+      FlValueFloat32List* self = reinterpret_cast<FlValueFloat32List*>(
+          fl_value_new(arena, type, sizeof(FlValueFloat32List)));
+      self->values = static_cast<float*>(values);
+      self->values_length = values_length;
+      self->bytes = bytes;
+      return reinterpret_cast<FlValue*>(self);
+    }
+    case FL_VALUE_TYPE_FLOAT_LIST: {
+      FlValueFloatList* self = reinterpret_cast<FlValueFloatList*>(
+          fl_value_new(arena, type, sizeof(FlValueFloatList)));
+      self->values = static_cast<double*>(values);
+      self->values_length = values_length;
+      self->bytes = bytes;
+      return reinterpret_cast<FlValue*>(self);
+    }
+    default:
+      g_return_val_if_reached(nullptr);
+  }
+}
+
+// Creates a typed list of @type that contains a copy of @data.
+static FlValue* fl_value_new_typed_list_copy(FlValueArena* arena,
+                                             FlValueType type,
+                                             gconstpointer data,
+                                             size_t data_length) {
+  size_t size = fl_value_get_element_size(type) * data_length;
+  gpointer values =
+      arena != nullptr ? fl_value_arena_alloc(arena, size) : g_malloc(size);
+  memcpy(values, data, size);
+  return fl_value_new_typed_list(arena, type, values, data_length, nullptr);
+}
+
+// Frees the elements of a typed list.
+static void fl_value_free_typed_list(FlValue* self,
+                                     gpointer values,
+                                     GBytes* bytes) {
+  if (bytes != nullptr) {
+    g_bytes_unref(bytes);
+  } else if (self->arena == nullptr) {
+    g_free(values);
+  }
+}
+
 // Helper function to match GDestroyNotify type.
 static void fl_value_destroy(gpointer value) {
   fl_value_unref(static_cast<FlValue*>(value));
@@ -237,109 +443,162 @@ static void value_to_string(FlValue* value, GString* buffer) {
   }
 }
 
-G_MODULE_EXPORT FlValue* fl_value_new_null() {
-  return fl_value_new(FL_VALUE_TYPE_NULL, sizeof(FlValue));
+FlValueArena* fl_value_arena_new() {
+  FlValueArena* arena = g_new0(FlValueArena, 1);
+  arena->ref_count = 1;
+  arena->next_block_size = kArenaMinBlockSize;
+  return arena;
 }
 
-G_MODULE_EXPORT FlValue* fl_value_new_bool(bool value) {
+void fl_value_arena_unref(FlValueArena* arena) {
+  g_return_if_fail(arena != nullptr);
+  fl_value_arena_release(arena);
+}
+
+FlValue* fl_value_arena_new_null(FlValueArena* arena) {
+  return fl_value_new(arena, FL_VALUE_TYPE_NULL, sizeof(FlValue));
+}
+
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value) {
   FlValueBool* self = reinterpret_cast<FlValueBool*>(
-      fl_value_new(FL_VALUE_TYPE_BOOL, sizeof(FlValueBool)));
+      fl_value_new(arena, FL_VALUE_TYPE_BOOL, sizeof(FlValueBool)));
   self->value = value ? true : false;
   return reinterpret_cast<FlValue*>(self);
 }
 
-G_MODULE_EXPORT FlValue* fl_value_new_int(int64_t value) {
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value) {
   FlValueInt* self = reinterpret_cast<FlValueInt*>(
-      fl_value_new(FL_VALUE_TYPE_INT, sizeof(FlValueInt)));
+      fl_value_new(arena, FL_VALUE_TYPE_INT, sizeof(FlValueInt)));
   self->value = value;
   return reinterpret_cast<FlValue*>(self);
 }
 
-G_MODULE_EXPORT FlValue* fl_value_new_float(double value) {
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value) {
   FlValueDouble* self = reinterpret_cast<FlValueDouble*>(
-      fl_value_new(FL_VALUE_TYPE_FLOAT, sizeof(FlValueDouble)));
+      fl_value_new(arena, FL_VALUE_TYPE_FLOAT, sizeof(FlValueDouble)));
   self->value = value;
   return reinterpret_cast<FlValue*>(self);
 }
 
+FlValue* fl_value_arena_new_string_sized(FlValueArena* arena,
+                                         const gchar* value,
+                                         size_t value_length) {
+  FlValueString* self = reinterpret_cast<FlValueString*>(
+      fl_value_new(arena, FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
+  if (arena != nullptr) {
+    self->value =
+        static_cast<gchar*>(fl_value_arena_alloc(arena, value_length + 1));
+    memcpy(self->value, value, value_length);
+    self->value[value_length] = '\0';
+  } else {
+    self->value =
+        value_length == 0 ? g_strdup("") : g_strndup(value, value_length);
+  }
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_typed_list(FlValueArena* arena,
+                                       FlValueType type,
+                                       GBytes* buffer,
+                                       size_t offset,
+                                       size_t length) {
+  size_t element_size = fl_value_get_element_size(type);
+  g_return_val_if_fail(element_size != 0, nullptr);
+
+  const uint8_t* data =
+      static_cast<const uint8_t*>(g_bytes_get_data(buffer, nullptr)) + offset;
+  size_t size = element_size * length;
+  if (size >= kMinTypedListViewSize &&
+      reinterpret_cast<uintptr_t>(data) % element_size == 0) {
+    return fl_value_new_typed_list(arena, type, const_cast<uint8_t*>(data),
+                                   length, g_bytes_ref(buffer));
+  }
+  return fl_value_new_typed_list_copy(arena, type, data, length);
+}
+
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t reserved_length) {
+  FlValueList* self = reinterpret_cast<FlValueList*>(
+      fl_value_new(arena, FL_VALUE_TYPE_LIST, sizeof(FlValueList)));
+  self->values = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t reserved_length) {
+  FlValueMap* self = reinterpret_cast<FlValueMap*>(
+      fl_value_new(arena, FL_VALUE_TYPE_MAP, sizeof(FlValueMap)));
+  self->keys = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  self->values = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  return reinterpret_cast<FlValue*>(self);
+}
+
+G_MODULE_EXPORT FlValue* fl_value_new_null() {
+  return fl_value_arena_new_null(nullptr);
+}
+
+G_MODULE_EXPORT FlValue* fl_value_new_bool(bool value) {
+  return fl_value_arena_new_bool(nullptr, value);
+}
+
+G_MODULE_EXPORT FlValue* fl_value_new_int(int64_t value) {
+  return fl_value_arena_new_int(nullptr, value);
+}
+
+G_MODULE_EXPORT FlValue* fl_value_new_float(double value) {
+  return fl_value_arena_new_float(nullptr, value);
+}
+
 G_MODULE_EXPORT FlValue* fl_value_new_string(const gchar* value) {
   FlValueString* self = reinterpret_cast<FlValueString*>(
-      fl_value_new(FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
+      fl_value_new(nullptr, FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
   self->value = g_strdup(value);
   return reinterpret_cast<FlValue*>(self);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_string_sized(const gchar* value,
                                                    size_t value_length) {
-  FlValueString* self = reinterpret_cast<FlValueString*>(
-      fl_value_new(FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
-  self->value =
-      value_length == 0 ? g_strdup("") : g_strndup(value, value_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_arena_new_string_sized(nullptr, value, value_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_uint8_list(const uint8_t* data,
                                                  size_t data_length) {
-  FlValueUint8List* self = reinterpret_cast<FlValueUint8List*>(
-      fl_value_new(FL_VALUE_TYPE_UINT8_LIST, sizeof(FlValueUint8List)));
-  self->values_length = data_length;
-  self->values = static_cast<uint8_t*>(g_malloc(sizeof(uint8_t) * data_length));
-  memcpy(self->values, data, sizeof(uint8_t) * data_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_new_typed_list_copy(nullptr, FL_VALUE_TYPE_UINT8_LIST, data,
+                                      data_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_uint8_list_from_bytes(GBytes* data) {
   gsize length;
-  const uint8_t* d =
-      static_cast<const uint8_t*>(g_bytes_get_data(data, &length));
-  return fl_value_new_uint8_list(d, length);
+  gconstpointer d = g_bytes_get_data(data, &length);
+  return fl_value_new_typed_list(nullptr, FL_VALUE_TYPE_UINT8_LIST,
+                                 const_cast<gpointer>(d), length,
+                                 g_bytes_ref(data));
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_int32_list(const int32_t* data,
                                                  size_t data_length) {
-  FlValueInt32List* self = reinterpret_cast<FlValueInt32List*>(
-      fl_value_new(FL_VALUE_TYPE_INT32_LIST, sizeof(FlValueInt32List)));
-  self->values_length = data_length;
-  self->values = static_cast<int32_t*>(g_malloc(sizeof(int32_t) * data_length));
-  memcpy(self->values, data, sizeof(int32_t) * data_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_new_typed_list_copy(nullptr, FL_VALUE_TYPE_INT32_LIST, data,
+                                      data_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_int64_list(const int64_t* data,
                                                  size_t data_length) {
-  FlValueInt64List* self = reinterpret_cast<FlValueInt64List*>(
-      fl_value_new(FL_VALUE_TYPE_INT64_LIST, sizeof(FlValueInt64List)));
-  self->values_length = data_length;
-  self->values = static_cast<int64_t*>(g_malloc(sizeof(int64_t) * data_length));
-  memcpy(self->values, data, sizeof(int64_t) * data_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_new_typed_list_copy(nullptr, FL_VALUE_TYPE_INT64_LIST, data,
+                                      data_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_float32_list(const float* data,
                                                    size_t data_length) {
-  FlValueFloat32List* self = reinterpret_cast<FlValueFloat32List*>(
-      fl_value_new(FL_VALUE_TYPE_FLOAT32_LIST, sizeof(FlValueFloat32List)));
-  self->values_length = data_length;
-  self->values = static_cast<float*>(g_malloc(sizeof(float) * data_length));
-  memcpy(self->values, data, sizeof(float) * data_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_new_typed_list_copy(nullptr, FL_VALUE_TYPE_FLOAT32_LIST,
+                                      data, data_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_float_list(const double* data,
                                                  size_t data_length) {
-  FlValueFloatList* self = reinterpret_cast<FlValueFloatList*>(
-      fl_value_new(FL_VALUE_TYPE_FLOAT_LIST, sizeof(FlValueFloatList)));
-  self->values_length = data_length;
-  self->values = static_cast<double*>(g_malloc(sizeof(double) * data_length));
-  memcpy(self->values, data, sizeof(double) * data_length);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_new_typed_list_copy(nullptr, FL_VALUE_TYPE_FLOAT_LIST, data,
+                                      data_length);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_list() {
-  FlValueList* self = reinterpret_cast<FlValueList*>(
-      fl_value_new(FL_VALUE_TYPE_LIST, sizeof(FlValueList)));
-  self->values = g_ptr_array_new_with_free_func(fl_value_destroy);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_arena_new_list(nullptr, 0);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_list_from_strv(
@@ -353,11 +612,7 @@ G_MODULE_EXPORT FlValue* fl_value_new_list_from_strv(
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_map() {
-  FlValueMap* self = reinterpret_cast<FlValueMap*>(
-      fl_value_new(FL_VALUE_TYPE_MAP, sizeof(FlValueMap)));
-  self->keys = g_ptr_array_new_with_free_func(fl_value_destroy);
-  self->values = g_ptr_array_new_with_free_func(fl_value_destroy);
-  return reinterpret_cast<FlValue*>(self);
+  return fl_value_arena_new_map(nullptr, 0);
 }
 
 G_MODULE_EXPORT FlValue* fl_value_ref(FlValue* self) {
@@ -377,32 +632,34 @@ G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
   switch (self->type) {
     case FL_VALUE_TYPE_STRING: {
       FlValueString* v = reinterpret_cast<FlValueString*>(self);
-      g_free(v->value);
+      if (self->arena == nullptr) {
+        g_free(v->value);
+      }
       break;
     }
     case FL_VALUE_TYPE_UINT8_LIST: {
       FlValueUint8List* v = reinterpret_cast<FlValueUint8List*>(self);
-      g_free(v->values);
+      fl_value_free_typed_list(self, v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_INT32_LIST: {
       FlValueInt32List* v = reinterpret_cast<FlValueInt32List*>(self);
-      g_free(v->values);
+      fl_value_free_typed_list(self, v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_INT64_LIST: {
       FlValueInt64List* v = reinterpret_cast<FlValueInt64List*>(self);
-      g_free(v->values);
+      fl_value_free_typed_list(self, v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_FLOAT32_LIST: {
       FlValueFloat32List* v = reinterpret_cast<FlValueFloat32List*>(self);
-      g_free(v->values);
+      fl_value_free_typed_list(self, v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_FLOAT_LIST: {
       FlValueFloatList* v = reinterpret_cast<FlValueFloatList*>(self);
-      g_free(v->values);
+      fl_value_free_typed_list(self, v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_LIST: {
@@ -422,7 +679,12 @@ G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
     case FL_VALUE_TYPE_FLOAT:
       break;
   }
-  g_free(self);
+
+  if (self->arena != nullptr) {
+    fl_value_arena_release(self->arena);
+  } else {
+    g_free(self);
+  }
 }
 
 G_MODULE_EXPORT FlValueType fl_value_get_type(FlValue* self) {
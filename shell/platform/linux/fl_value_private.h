@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+
+G_BEGIN_DECLS
+
+/**
+ * FlValueArena:
+ *
+ * #FlValueArena allocates many #FlValue nodes from a few large blocks, which
+ * is cheaper than allocating each node on its own when decoding large
+ * messages.
+ *
+ * Values allocated from an arena behave like any other #FlValue: each value
+ * keeps the arena alive until it is freed, so values can outlive the code
+ * that decoded them. The arena memory is released when the arena and all the
+ * values allocated from it have been unreferenced.
+ *
+ * An arena must only be used to allocate values from one thread at a time.
+ */
+typedef struct _FlValueArena FlValueArena;
+
+/**
+ * fl_value_arena_new:
+ *
+ * Creates a new arena to allocate values from.
+ *
+ * Returns: a new #FlValueArena.
+ */
+FlValueArena* fl_value_arena_new();
+
+/**
+ * fl_value_arena_unref:
+ * @arena: an #FlValueArena.
+ *
+ * Releases the reference held by the creator of @arena. No more values can be
+ * allocated from it after this.
+ */
+void fl_value_arena_unref(FlValueArena* arena);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FlValueArena, fl_value_arena_unref)
+
+/**
+ * fl_value_arena_new_null:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ *
+ * Creates an #FlValue that contains a null value, see fl_value_new_null().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_null(FlValueArena* arena);
+
+/**
+ * fl_value_arena_new_bool:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains a boolean value, see fl_value_new_bool().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value);
+
+/**
+ * fl_value_arena_new_int:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains an integer, see fl_value_new_int().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value);
+
+/**
+ * fl_value_arena_new_float:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains a floating point number, see
+ * fl_value_new_float().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value);
+
+/**
+ * fl_value_arena_new_string_sized:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @value: a buffer containing UTF-8 text. It does not require a nul terminator.
+ * @value_length: the number of bytes to use from @value.
+ *
+ * Creates an #FlValue that contains UTF-8 text, see
+ * fl_value_new_string_sized(). When allocated from an arena the text is
+ * stored in the arena as well.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_string_sized(FlValueArena* arena,
+                                         const gchar* value,
+                                         size_t value_length);
+
+/**
+ * fl_value_arena_new_typed_list:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @type: one of the typed list types, e.g. #FL_VALUE_TYPE_INT32_LIST.
+ * @buffer: buffer containing the list elements.
+ * @offset: offset of the first element in @buffer.
+ * @length: number of elements in the list.
+ *
+ * Creates an ordered list of numbers read from @buffer, which must contain
+ * @length elements at @offset.
+ *
+ * Large lists that are correctly aligned in @buffer refer to the data in
+ * @buffer rather than copying it, and keep @buffer alive until they are
+ * freed. Other lists are copied.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_typed_list(FlValueArena* arena,
+                                       FlValueType type,
+                                       GBytes* buffer,
+                                       size_t offset,
+                                       size_t length);
+
+/**
+ * fl_value_arena_new_list:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @reserved_length: number of elements to reserve space for.
+ *
+ * Creates an ordered list, see fl_value_new_list().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t reserved_length);
+
+/**
+ * fl_value_arena_new_map:
+ * @arena: (allow-none): an #FlValueArena or %NULL to allocate from the heap.
+ * @reserved_length: number of entries to reserve space for.
+ *
+ * Creates an ordered associative array, see fl_value_new_map().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t reserved_length);
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
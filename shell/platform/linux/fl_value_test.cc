@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
@@ -260,6 +261,27 @@ TEST(FlValueTest, Uint8ListToString) {
   EXPECT_STREQ(text, "[0, 1, 254, 255]");
 }
 
+TEST(FlValueTest, Uint8ListFromBytes) {
+  uint8_t data[] = {0x00, 0x01, 0xFE, 0xFF};
+  g_autoptr(GBytes) bytes = g_bytes_new(data, 4);
+  g_autoptr(FlValue) value = fl_value_new_uint8_list_from_bytes(bytes);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_UINT8_LIST);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(4));
+  // The data is not copied.
+  EXPECT_EQ(fl_value_get_uint8_list(value),
+            g_bytes_get_data(bytes, nullptr));
+  EXPECT_EQ(fl_value_get_uint8_list(value)[3], 0xFF);
+}
+
+TEST(FlValueTest, Uint8ListFromBytesOutlivesBytes) {
+  uint8_t data[] = {1, 2, 3};
+  GBytes* bytes = g_bytes_new(data, 3);
+  g_autoptr(FlValue) value = fl_value_new_uint8_list_from_bytes(bytes);
+  g_bytes_unref(bytes);
+  g_autoptr(FlValue) expected = fl_value_new_uint8_list(data, 3);
+  EXPECT_TRUE(fl_value_equal(value, expected));
+}
+
 TEST(FlValueTest, Int32List) {
   int32_t data[] = {0, -1, G_MAXINT32, G_MININT32};
   g_autoptr(FlValue) value = fl_value_new_int32_list(data, 4);
@@ -938,3 +960,100 @@ TEST(FlValueTest, ListMapNotEqual) {
   g_autoptr(FlValue) value2 = fl_value_new_map();
   EXPECT_FALSE(fl_value_equal(value1, value2));
 }
+
+TEST(FlValueTest, ArenaValues) {
+  FlValueArena* arena = fl_value_arena_new();
+  g_autoptr(FlValue) list = fl_value_arena_new_list(arena, 6);
+  fl_value_append_take(list, fl_value_arena_new_null(arena));
+  fl_value_append_take(list, fl_value_arena_new_bool(arena, true));
+  fl_value_append_take(list, fl_value_arena_new_int(arena, 42));
+  fl_value_append_take(list, fl_value_arena_new_float(arena, M_PI));
+  fl_value_append_take(list,
+                       fl_value_arena_new_string_sized(arena, "hello!", 5));
+  g_autoptr(FlValue) map = fl_value_arena_new_map(arena, 1);
+  fl_value_set_take(map, fl_value_arena_new_string_sized(arena, "key", 3),
+                    fl_value_arena_new_int(arena, -1));
+  fl_value_append(list, map);
+
+  // Values remain valid after the arena is released by its creator.
+  fl_value_arena_unref(arena);
+
+  g_autoptr(FlValue) expected = fl_value_new_list();
+  fl_value_append_take(expected, fl_value_new_null());
+  fl_value_append_take(expected, fl_value_new_bool(true));
+  fl_value_append_take(expected, fl_value_new_int(42));
+  fl_value_append_take(expected, fl_value_new_float(M_PI));
+  fl_value_append_take(expected, fl_value_new_string("hello"));
+  g_autoptr(FlValue) expected_map = fl_value_new_map();
+  fl_value_set_string_take(expected_map, "key", fl_value_new_int(-1));
+  fl_value_append(expected, expected_map);
+  EXPECT_TRUE(fl_value_equal(list, expected));
+
+  // Values from the arena can be modified like any other.
+  fl_value_append_take(list, fl_value_new_string("heap"));
+  EXPECT_EQ(fl_value_get_length(list), static_cast<size_t>(7));
+}
+
+TEST(FlValueTest, ArenaManyValues) {
+  g_autoptr(FlValueArena) arena = fl_value_arena_new();
+  g_autoptr(FlValue) list = fl_value_arena_new_list(arena, 0);
+  // Enough values to need several blocks, and a string that needs a block of
+  // its own.
+  for (int i = 0; i < 10000; i++) {
+    fl_value_append_take(list, fl_value_arena_new_int(arena, i));
+  }
+  g_autofree gchar* text = static_cast<gchar*>(g_malloc(100000));
+  memset(text, 'a', 100000);
+  fl_value_append_take(list,
+                       fl_value_arena_new_string_sized(arena, text, 100000));
+  fl_value_append_take(list, fl_value_arena_new_int(arena, 10000));
+
+  ASSERT_EQ(fl_value_get_length(list), static_cast<size_t>(10002));
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_EQ(fl_value_get_int(fl_value_get_list_value(list, i)), i);
+  }
+  EXPECT_EQ(strlen(fl_value_get_string(fl_value_get_list_value(list, 10000))),
+            static_cast<size_t>(100000));
+  EXPECT_EQ(fl_value_get_int(fl_value_get_list_value(list, 10001)), 10000);
+}
+
+TEST(FlValueTest, ArenaTypedListView) {
+  double data[1024];
+  for (int i = 0; i < 1024; i++) {
+    data[i] = i * 0.5;
+  }
+  g_autoptr(GBytes) bytes = g_bytes_new(data, sizeof(data));
+  g_autoptr(FlValueArena) arena = fl_value_arena_new();
+
+  // Large lists refer to the buffer.
+  g_autoptr(FlValue) view = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_FLOAT_LIST, bytes, 8 * sizeof(double), 1000);
+  ASSERT_EQ(fl_value_get_type(view), FL_VALUE_TYPE_FLOAT_LIST);
+  ASSERT_EQ(fl_value_get_length(view), static_cast<size_t>(1000));
+  EXPECT_EQ(fl_value_get_float_list(view),
+            static_cast<const double*>(g_bytes_get_data(bytes, nullptr)) + 8);
+  EXPECT_EQ(fl_value_get_float_list(view)[999], 1007 * 0.5);
+
+  // Small lists are copied.
+  g_autoptr(FlValue) copy = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_FLOAT_LIST, bytes, 0, 4);
+  ASSERT_EQ(fl_value_get_length(copy), static_cast<size_t>(4));
+  EXPECT_NE(fl_value_get_float_list(copy),
+            static_cast<const double*>(g_bytes_get_data(bytes, nullptr)));
+  g_autoptr(FlValue) expected = fl_value_new_float_list(data, 4);
+  EXPECT_TRUE(fl_value_equal(copy, expected));
+}
+
+TEST(FlValueTest, TypedListViewOutlivesBuffer) {
+  int32_t data[256];
+  for (int i = 0; i < 256; i++) {
+    data[i] = -i;
+  }
+  GBytes* bytes = g_bytes_new(data, sizeof(data));
+  g_autoptr(FlValue) value = fl_value_arena_new_typed_list(
+      nullptr, FL_VALUE_TYPE_INT32_LIST, bytes, 0, 256);
+  g_bytes_unref(bytes);
+
+  g_autoptr(FlValue) expected = fl_value_new_int32_list(data, 256);
+  EXPECT_TRUE(fl_value_equal(value, expected));
+}
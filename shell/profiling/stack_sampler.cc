@@ -0,0 +1,451 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/stack_sampler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/thread_local.h"
+
+namespace flutter {
+
+namespace {
+
+// Dart's profiler interrupts threads with SIGPROF, so use a signal that is
+// ignored by default and otherwise unused by the engine and the VM.
+constexpr int kSampleSignal = SIGURG;
+
+// The deepest stack that is recorded. Deeper stacks lose their outermost
+// frames.
+constexpr size_t kMaxFrames = 64;
+
+// The number of distinct stacks kept per thread. Samples of other stacks are
+// only counted.
+constexpr size_t kMaxStacksPerThread = 4096;
+
+// How long to wait for a thread to handle the signal before skipping it.
+constexpr auto kSampleTimeout = std::chrono::milliseconds(10);
+
+// A sample being taken, written by the signal handler of the sampled thread.
+struct PendingSample {
+  // The bounds of the stack of the sampled thread.
+  uintptr_t stack_low = 0;
+  uintptr_t stack_high = 0;
+  // The program counter and the return addresses of the frames, innermost
+  // first.
+  uintptr_t frames[kMaxFrames];
+  size_t depth = 0;
+  std::atomic<bool> done;
+};
+
+// The sample being taken. Only written by the handler that took it from
+// |gPendingSampleTag|, or by the sampling thread while no sample is pending.
+PendingSample gSample;
+
+// Identifies the sample the next signal should fill in: a generation in the
+// high 32 bits and the id of the thread being sampled in the low 32 bits, or
+// zero if no sample is pending. The signal may also come from elsewhere, to
+// this or another thread, which must not take the sample. The handler takes
+// it by clearing the tag, and the generation makes sure that a late handler,
+// which read the tag of a sample that was abandoned, cannot take the sample
+// of the next thread instead.
+std::atomic<uint64_t> gPendingSampleTag;
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The signal handler needs lock free atomics.");
+
+uint64_t MakeSampleTag(uint32_t generation, pid_t tid) {
+  return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(tid);
+}
+
+// The handler of the signal before the sampler installed its own, which is
+// called for the signals that are not samples, and restored when the sampler
+// stops.
+struct sigaction gPreviousAction;
+
+struct SampledThread {
+  std::string name;
+  pid_t tid;
+  uintptr_t stack_low;
+  uintptr_t stack_high;
+};
+
+struct ThreadProfile {
+  std::map<std::vector<uintptr_t>, size_t> stacks;
+  size_t dropped_samples = 0;
+};
+
+struct SamplerState {
+  // Serializes |StackSampler::Start| and |StackSampler::Stop|, which joins the
+  // sampling thread without holding |mutex|.
+  std::mutex start_stop_mutex;
+  std::mutex mutex;
+  std::condition_variable stop_condition;
+  std::vector<SampledThread> threads;
+  std::map<std::string, ThreadProfile> profiles;
+  size_t sample_count = 0;
+  std::unique_ptr<std::thread> thread;
+  // The number of |StackSampler::Start| calls not yet balanced by a
+  // |StackSampler::Stop|.
+  size_t start_count = 0;
+  bool stopping = false;
+  // The generation of the last sample. Only used by the sampling thread.
+  uint32_t sample_generation = 0;
+};
+
+// Leaked so that exiting threads can still unregister themselves.
+SamplerState& GetState() {
+  static SamplerState* state = new SamplerState();
+  return *state;
+}
+
+pid_t GetCurrentThreadId() {
+  return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+// Unregisters a thread when it exits, so that its id, which the kernel may
+// hand to a new thread, is no longer signalled.
+class ThreadRegistration {
+ public:
+  explicit ThreadRegistration(pid_t tid) : tid_(tid) {}
+
+  ~ThreadRegistration() {
+    SamplerState& state = GetState();
+    std::scoped_lock lock(state.mutex);
+    state.threads.erase(
+        std::remove_if(state.threads.begin(), state.threads.end(),
+                       [this](const SampledThread& thread) {
+                         return thread.tid == tid_;
+                       }),
+        state.threads.end());
+  }
+
+ private:
+  const pid_t tid_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadRegistration);
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<ThreadRegistration>
+    tls_registration;
+
+// Walks the frame pointer chain of the interrupted code. This runs in a
+// signal handler, so it only reads memory that is known to be on the stack.
+size_t UnwindStack(const ucontext_t* context,
+                   uintptr_t stack_low,
+                   uintptr_t stack_high,
+                   uintptr_t* frames,
+                   size_t max_frames) {
+  uintptr_t pc;
+  uintptr_t fp;
+  uintptr_t sp;
+#if defined(__x86_64__)
+  pc = context->uc_mcontext.gregs[REG_RIP];
+  fp = context->uc_mcontext.gregs[REG_RBP];
+  sp = context->uc_mcontext.gregs[REG_RSP];
+#elif defined(__i386__)
+  pc = context->uc_mcontext.gregs[REG_EIP];
+  fp = context->uc_mcontext.gregs[REG_EBP];
+  sp = context->uc_mcontext.gregs[REG_ESP];
+#elif defined(__aarch64__)
+  pc = context->uc_mcontext.pc;
+  fp = context->uc_mcontext.regs[29];
+  sp = context->uc_mcontext.sp;
+#elif defined(__arm__)
+  // The frame layout of 32-bit ARM code depends on the instruction set and
+  // compiler, so only the interrupted function is recorded.
+  frames[0] = context->uc_mcontext.arm_pc;
+  return 1;
+#else
+  return 0;
+#endif
+  size_t depth = 0;
+  frames[depth++] = pc;
+  // Frames below the stack pointer may not be mapped yet.
+  uintptr_t low = std::max(stack_low, sp);
+  while (depth < max_frames && fp >= low &&
+         fp <= stack_high - 2 * sizeof(uintptr_t) &&
+         fp % sizeof(uintptr_t) == 0) {
+    const uintptr_t* frame = reinterpret_cast<const uintptr_t*>(fp);
+    uintptr_t next_fp = frame[0];
+    uintptr_t return_address = frame[1];
+    if (return_address == 0) {
+      break;
+    }
+    frames[depth++] = return_address;
+    // Stacks grow down, so callers' frames are at higher addresses.
+    if (next_fp <= fp) {
+      break;
+    }
+    fp = next_fp;
+  }
+  return depth;
+}
+
+void CallPreviousHandler(int signal, siginfo_t* info, void* context) {
+  if (gPreviousAction.sa_flags & SA_SIGINFO) {
+    if (gPreviousAction.sa_sigaction != nullptr) {
+      gPreviousAction.sa_sigaction(signal, info, context);
+    }
+  } else if (gPreviousAction.sa_handler != SIG_DFL &&
+             gPreviousAction.sa_handler != SIG_IGN &&
+             gPreviousAction.sa_handler != nullptr) {
+    gPreviousAction.sa_handler(signal);
+  }
+}
+
+void HandleSampleSignal(int signal, siginfo_t* info, void* context) {
+  int saved_errno = errno;
+  const pid_t tid = GetCurrentThreadId();
+  uint64_t tag = gPendingSampleTag.load();
+  if (tag != 0 && static_cast<pid_t>(tag & 0xFFFFFFFF) == tid &&
+      gPendingSampleTag.compare_exchange_strong(tag, 0)) {
+    gSample.depth = UnwindStack(static_cast<const ucontext_t*>(context),
+                                gSample.stack_low, gSample.stack_high,
+                                gSample.frames, kMaxFrames);
+    gSample.done.store(true, std::memory_order_release);
+  } else {
+    errno = saved_errno;
+    CallPreviousHandler(signal, info, context);
+  }
+  errno = saved_errno;
+}
+
+bool InstallSignalHandler() {
+  struct sigaction action = {};
+  action.sa_sigaction = HandleSampleSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return sigaction(kSampleSignal, &action, &gPreviousAction) == 0;
+}
+
+void RestoreSignalHandler() {
+  sigaction(kSampleSignal, &gPreviousAction, nullptr);
+}
+
+// Interrupts |thread| and adds its stack to the profile. Called with the
+// state locked.
+void SampleThread(SamplerState& state, const SampledThread& thread) {
+  PendingSample& sample = gSample;
+  sample.stack_low = thread.stack_low;
+  sample.stack_high = thread.stack_high;
+  sample.depth = 0;
+  sample.done.store(false, std::memory_order_relaxed);
+  // Zero is left out, so that a tag is never zero.
+  if (++state.sample_generation == 0) {
+    state.sample_generation = 1;
+  }
+  gPendingSampleTag.store(MakeSampleTag(state.sample_generation, thread.tid));
+
+  if (syscall(SYS_tgkill, getpid(), thread.tid, kSampleSignal) != 0) {
+    gPendingSampleTag.store(0);
+    return;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + kSampleTimeout;
+  while (!sample.done.load(std::memory_order_acquire)) {
+    // Give up on threads that don't handle the signal in time, unless the
+    // handler has already taken the sample and is about to finish.
+    if (std::chrono::steady_clock::now() > deadline &&
+        gPendingSampleTag.exchange(0) != 0) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  state.sample_count++;
+  ThreadProfile& profile = state.profiles[thread.name];
+  std::vector<uintptr_t> stack(sample.frames, sample.frames + sample.depth);
+  auto found = profile.stacks.find(stack);
+  if (found != profile.stacks.end()) {
+    found->second++;
+  } else if (profile.stacks.size() < kMaxStacksPerThread) {
+    profile.stacks.emplace(std::move(stack), 1);
+  } else {
+    profile.dropped_samples++;
+  }
+}
+
+void SampleThreads(fml::TimeDelta interval) {
+  SamplerState& state = GetState();
+  std::unique_lock lock(state.mutex);
+  while (!state.stopping) {
+    for (const auto& thread : state.threads) {
+      SampleThread(state, thread);
+    }
+    state.stop_condition.wait_for(
+        lock, std::chrono::microseconds(interval.ToMicroseconds()));
+  }
+}
+
+// Returns a readable name for the code at |address|.
+std::string Symbolize(uintptr_t address) {
+  Dl_info info;
+  std::ostringstream name;
+  if (dladdr(reinterpret_cast<void*>(address), &info) == 0) {
+    name << "0x" << std::hex << address;
+    return name.str();
+  }
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+      name << demangled;
+    } else {
+      name << info.dli_sname;
+    }
+    free(demangled);
+    return name.str();
+  }
+  const char* module = info.dli_fname != nullptr ? info.dli_fname : "";
+  if (const char* slash = strrchr(module, '/')) {
+    module = slash + 1;
+  }
+  name << module << "+0x" << std::hex
+       << address - reinterpret_cast<uintptr_t>(info.dli_fbase);
+  return name.str();
+}
+
+}  // namespace
+
+bool StackSampler::IsSupported() {
+  return true;
+}
+
+void StackSampler::Start(fml::TimeDelta interval) {
+  SamplerState& state = GetState();
+  std::scoped_lock start_stop_lock(state.start_stop_mutex);
+  std::scoped_lock lock(state.mutex);
+  state.start_count++;
+  if (state.thread) {
+    return;
+  }
+  if (!InstallSignalHandler()) {
+    FML_LOG(ERROR) << "Could not install the stack sampling signal handler.";
+    return;
+  }
+  state.stopping = false;
+  state.thread = std::make_unique<std::thread>(SampleThreads, interval);
+}
+
+void StackSampler::Stop() {
+  SamplerState& state = GetState();
+  std::scoped_lock start_stop_lock(state.start_stop_mutex);
+  std::unique_ptr<std::thread> thread;
+  {
+    std::scoped_lock lock(state.mutex);
+    if (state.start_count == 0 || --state.start_count > 0) {
+      return;
+    }
+    state.stopping = true;
+    thread = std::move(state.thread);
+  }
+  state.stop_condition.notify_all();
+  if (thread) {
+    thread->join();
+    RestoreSignalHandler();
+  }
+}
+
+bool StackSampler::IsRunning() {
+  SamplerState& state = GetState();
+  std::scoped_lock lock(state.mutex);
+  return state.thread != nullptr;
+}
+
+void StackSampler::RegisterCurrentThread(const std::string& name) {
+  if (tls_registration.get() != nullptr) {
+    return;
+  }
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+    return;
+  }
+  void* stack_address = nullptr;
+  size_t stack_size = 0;
+  int result = pthread_attr_getstack(&attributes, &stack_address, &stack_size);
+  pthread_attr_destroy(&attributes);
+  if (result != 0) {
+    return;
+  }
+
+  const pid_t tid = GetCurrentThreadId();
+  const uintptr_t stack_low = reinterpret_cast<uintptr_t>(stack_address);
+  SamplerState& state = GetState();
+  {
+    std::scoped_lock lock(state.mutex);
+    state.threads.push_back({name, tid, stack_low, stack_low + stack_size});
+  }
+  tls_registration.reset(new ThreadRegistration(tid));
+}
+
+size_t StackSampler::GetSampleCount() {
+  SamplerState& state = GetState();
+  std::scoped_lock lock(state.mutex);
+  return state.sample_count;
+}
+
+std::string StackSampler::GetFoldedStacks() {
+  std::map<std::string, ThreadProfile> profiles;
+  {
+    SamplerState& state = GetState();
+    std::scoped_lock lock(state.mutex);
+    profiles = state.profiles;
+  }
+
+  // Symbolize outside of the lock, so that sampling isn't held up.
+  std::map<uintptr_t, std::string> symbols;
+  std::ostringstream folded;
+  for (const auto& [thread_name, profile] : profiles) {
+    for (const auto& [stack, count] : profile.stacks) {
+      folded << thread_name;
+      for (size_t i = stack.size(); i-- > 0;) {
+        // Look return addresses up by the call instruction before them.
+        uintptr_t address = i == 0 ? stack[i] : stack[i] - 1;
+        auto symbol = symbols.find(address);
+        if (symbol == symbols.end()) {
+          symbol = symbols.emplace(address, Symbolize(address)).first;
+        }
+        folded << ';' << symbol->second;
+      }
+      folded << ' ' << count << '\n';
+    }
+    if (profile.dropped_samples > 0) {
+      folded << thread_name << ";[dropped] " << profile.dropped_samples
+             << '\n';
+    }
+  }
+  return folded.str();
+}
+
+void StackSampler::Reset() {
+  SamplerState& state = GetState();
+  std::scoped_lock lock(state.mutex);
+  state.profiles.clear();
+  state.sample_count = 0;
+}
+
+}  // namespace flutter
@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PROFILING_STACK_SAMPLER_H_
+#define FLUTTER_SHELL_PROFILING_STACK_SAMPLER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+/**
+ * @brief Periodically samples the native call stacks of registered engine
+ * threads, and aggregates the samples in-process.
+ *
+ * There is one sampler per process, since the signal used to interrupt
+ * threads is process wide. On Linux and Android a dedicated thread interrupts
+ * each registered thread with a signal. The signal handler walks the frame
+ * pointer chain of the interrupted thread into a preallocated buffer, so it
+ * neither allocates nor locks. Identical stacks are counted together, and
+ * symbolized only when the profile is requested. Stacks are only as deep as
+ * the frame pointer chain of the code that was interrupted. Signals that are
+ * not samples are passed on to the handler installed before the sampler's,
+ * which is restored when sampling stops.
+ *
+ * On other platforms `IsSupported` returns false and no samples are taken.
+ */
+class StackSampler {
+ public:
+  /// The default time between two samples of a thread.
+  static constexpr fml::TimeDelta kDefaultInterval =
+      fml::TimeDelta::FromMilliseconds(10);
+
+  static bool IsSupported();
+
+  /**
+   * @brief Starts sampling the registered threads every `interval`, unless
+   * the sampler is already running. Each call must be balanced by a call to
+   * `Stop`, so that several shells can share the sampler.
+   */
+  static void Start(fml::TimeDelta interval = kDefaultInterval);
+
+  /**
+   * @brief Stops sampling once every `Start` has been balanced by a `Stop`.
+   * The samples taken so far are kept.
+   */
+  static void Stop();
+
+  static bool IsRunning();
+
+  /**
+   * @brief Samples the calling thread, under `name`, until it exits.
+   * Registering a thread again has no effect.
+   */
+  static void RegisterCurrentThread(const std::string& name);
+
+  /**
+   * @brief The number of samples taken so far.
+   */
+  static size_t GetSampleCount();
+
+  /**
+   * @brief Returns the samples in the folded stack format understood by
+   * flame graph tools: one line per distinct stack, holding the thread name
+   * and the frames from the outermost to the innermost, separated by
+   * semicolons, then a space and the number of samples.
+   */
+  static std::string GetFoldedStacks();
+
+  /**
+   * @brief Discards the samples taken so far.
+   */
+  static void Reset();
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(StackSampler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PROFILING_STACK_SAMPLER_H_
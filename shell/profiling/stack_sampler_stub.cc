@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/stack_sampler.h"
+
+namespace flutter {
+
+bool StackSampler::IsSupported() {
+  return false;
+}
+
+void StackSampler::Start(fml::TimeDelta interval) {
+  // Not supported.
+}
+
+void StackSampler::Stop() {}
+
+bool StackSampler::IsRunning() {
+  return false;
+}
+
+void StackSampler::RegisterCurrentThread(const std::string& name) {}
+
+size_t StackSampler::GetSampleCount() {
+  return 0;
+}
+
+std::string StackSampler::GetFoldedStacks() {
+  return "";
+}
+
+void StackSampler::Reset() {}
+
+}  // namespace flutter
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/stack_sampler.h"
+
+#include <signal.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Keeps a thread busy in a function that shows up in its samples.
+__attribute__((noinline)) void SpinUntil(const std::atomic<bool>& done) {
+  while (!done.load()) {
+  }
+}
+
+std::atomic<int> gUrgentSignalCount = 0;
+
+void HandleUrgentSignal(int signal) {
+  gUrgentSignalCount++;
+}
+
+}  // namespace
+
+TEST(StackSamplerTest, SamplesRegisteredThreads) {
+  if (!StackSampler::IsSupported()) {
+    GTEST_SKIP() << "Stack sampling is not supported on this platform.";
+  }
+  StackSampler::Reset();
+
+  std::atomic<bool> registered = false;
+  std::atomic<bool> done = false;
+  std::thread thread([&] {
+    StackSampler::RegisterCurrentThread("sampled");
+    registered = true;
+    SpinUntil(done);
+  });
+  while (!registered) {
+    std::this_thread::yield();
+  }
+
+  StackSampler::Start(fml::TimeDelta::FromMilliseconds(1));
+  ASSERT_TRUE(StackSampler::IsRunning());
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (StackSampler::GetSampleCount() < 10 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  StackSampler::Stop();
+  done = true;
+  thread.join();
+
+  ASSERT_FALSE(StackSampler::IsRunning());
+  ASSERT_GE(StackSampler::GetSampleCount(), 10u);
+  const std::string folded = StackSampler::GetFoldedStacks();
+  ASSERT_EQ(folded.rfind("sampled;", 0), 0u) << folded;
+
+  StackSampler::Reset();
+  ASSERT_EQ(StackSampler::GetSampleCount(), 0u);
+  ASSERT_EQ(StackSampler::GetFoldedStacks(), "");
+}
+
+TEST(StackSamplerTest, StopsSamplingExitedThreads) {
+  if (!StackSampler::IsSupported()) {
+    GTEST_SKIP() << "Stack sampling is not supported on this platform.";
+  }
+  std::thread([] { StackSampler::RegisterCurrentThread("exited"); }).join();
+  StackSampler::Reset();
+
+  StackSampler::Start(fml::TimeDelta::FromMilliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  StackSampler::Stop();
+
+  ASSERT_EQ(StackSampler::GetFoldedStacks().find("exited"), std::string::npos);
+}
+
+TEST(StackSamplerTest, RunsUntilEveryStartIsStopped) {
+  if (!StackSampler::IsSupported()) {
+    GTEST_SKIP() << "Stack sampling is not supported on this platform.";
+  }
+  StackSampler::Start();
+  StackSampler::Start();
+  StackSampler::Stop();
+  ASSERT_TRUE(StackSampler::IsRunning());
+  StackSampler::Stop();
+  ASSERT_FALSE(StackSampler::IsRunning());
+  // Unbalanced stops are ignored.
+  StackSampler::Stop();
+  StackSampler::Start();
+  ASSERT_TRUE(StackSampler::IsRunning());
+  StackSampler::Stop();
+  ASSERT_FALSE(StackSampler::IsRunning());
+}
+
+TEST(StackSamplerTest, PassesOtherSignalsToThePreviousHandler) {
+  if (!StackSampler::IsSupported()) {
+    GTEST_SKIP() << "Stack sampling is not supported on this platform.";
+  }
+  struct sigaction action = {};
+  action.sa_handler = HandleUrgentSignal;
+  sigemptyset(&action.sa_mask);
+  struct sigaction original_action;
+  ASSERT_EQ(sigaction(SIGURG, &action, &original_action), 0);
+  gUrgentSignalCount = 0;
+
+  StackSampler::Start(fml::TimeDelta::FromMilliseconds(1));
+  raise(SIGURG);
+  EXPECT_EQ(gUrgentSignalCount, 1);
+  StackSampler::Stop();
+
+  // The handler is restored once sampling stops.
+  struct sigaction restored_action;
+  ASSERT_EQ(sigaction(SIGURG, nullptr, &restored_action), 0);
+  EXPECT_EQ(restored_action.sa_handler, HandleUrgentSignal);
+  raise(SIGURG);
+  EXPECT_EQ(gUrgentSignalCount, 2);
+
+  ASSERT_EQ(sigaction(SIGURG, &original_action, nullptr), 0);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -67,6 +67,15 @@ void main() {
     final List<int> expected = await readFile('square.png');
     expect(Uint8List.view(data.buffer), expected);
   });
+
+  test('Image.toByteData fast PNG format decodes to the same pixels', () async {
+    final Image image = await Square4x4Image.image;
+    final ByteData data = (await image.toByteData(format: ImageByteFormat.pngFast))!;
+    final Codec codec = await instantiateImageCodec(Uint8List.view(data.buffer));
+    final FrameInfo frame = await codec.getNextFrame();
+    final ByteData decoded = (await frame.image.toByteData())!;
+    expect(Uint8List.view(decoded.buffer), Square4x4Image.bytes);
+  });
 }
 
 class Square4x4Image {
@@ -171,6 +171,8 @@ def RunCCTests(build_dir, filter, coverage, capture_core_dump):
     "--gtest_shuffle",
   ]
 
+  RunEngineExecutable(build_dir, 'assets_unittests', filter, shuffle_flags, coverage=coverage)
+
   RunEngineExecutable(build_dir, 'client_wrapper_glfw_unittests', filter, shuffle_flags, coverage=coverage)
 
   RunEngineExecutable(build_dir, 'common_cpp_core_unittests', filter, shuffle_flags, coverage=coverage)
@@ -241,13 +243,23 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'shell_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'embedder_benchmarks', filter, icu_flags)
+
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'assets_benchmarks', filter, icu_flags)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter, icu_flags)
+
+  RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter, icu_flags)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter, icu_flags)
 
+    RunEngineExecutable(build_dir, 'flutter_linux_benchmarks', filter, icu_flags)
+
 
 def RunDartTest(build_dir, test_packages, dart_file, verbose_dart_snapshot, multithreaded,
                 enable_observatory=False, expect_failure=False):
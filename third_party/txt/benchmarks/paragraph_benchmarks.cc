@@ -22,6 +22,7 @@
 #include "flutter/fml/logging.h"
 #include "flutter/third_party/txt/tests/txt_test_utils.h"
 #include "minikin/LayoutUtils.h"
+#include "minikin/WordBreaker.h"
 #include "third_party/benchmark/include/benchmark/benchmark.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -426,6 +427,57 @@ BENCHMARK_REGISTER_F(ParagraphFixture, AddStyleRun)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+static std::vector<uint16_t> RepeatText(const char* text, size_t length) {
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::vector<uint16_t> result;
+  while (result.size() < length) {
+    result.insert(result.end(), icu_text.getBuffer(),
+                  icu_text.getBuffer() + icu_text.length());
+  }
+  result.resize(length);
+  return result;
+}
+
+static void RunWordBreaker(benchmark::State& state,
+                           const std::vector<uint16_t>& text) {
+  minikin::WordBreaker breaker;
+  breaker.setLocale();
+  while (state.KeepRunning()) {
+    breaker.setText(text.data(), text.size());
+    while (breaker.next() < static_cast<ssize_t>(text.size())) {
+    }
+  }
+  breaker.finish();
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_DEFINE_F(ParagraphFixture, WordBreakLatin)(benchmark::State& state) {
+  std::vector<uint16_t> text = RepeatText(
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+      "eiusmod tempor incididunt ut labore et dolore magna aliqua. \"Ut enim "
+      "ad minim veniam,\" quis nostrud exercitation? Ullamco laboris 1,024. ",
+      state.range(0));
+  RunWordBreaker(state, text);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, WordBreakLatin)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 14)
+    ->Complexity(benchmark::oN);
+
+BENCHMARK_DEFINE_F(ParagraphFixture, WordBreakMixedScript)
+(benchmark::State& state) {
+  std::vector<uint16_t> text = RepeatText(
+      "Lorem ipsum dolor sit amet, 你好世界，这是一个测试。 consectetur "
+      "adipiscing elit (sed do) eiusmod — مرحبا بالعالم tempor well-known "
+      "https://flutter.dev/docs 😀👍🏽 incididunt ut labore. ",
+      state.range(0));
+  RunWordBreaker(state, text);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, WordBreakMixedScript)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 14)
+    ->Complexity(benchmark::oN);
+
 BENCHMARK_DEFINE_F(ParagraphFixture, SkTextBlobAlloc)(benchmark::State& state) {
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -229,12 +229,89 @@ ssize_t WordBreaker::findNextBreakInEmailOrUrl() {
   return i;
 }
 
+// libtxt extension: line break classes of the ASCII characters handled by the
+// fast path in findNextBreakInAsciiRun. Anything else is left to ICU.
+enum AsciiBreakClass : uint8_t {
+  ASCII_OTHER,
+  ASCII_WORD,      // AL and NU: letters and digits.
+  ASCII_INFIX,     // IS: , . : ;
+  ASCII_QUOTE,     // QU: " '
+  ASCII_EXCLAIM,   // EX: ! ?
+  ASCII_SPACE,     // SP
+};
+
+static AsciiBreakClass asciiBreakClass(uint16_t c) {
+  if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+      ('0' <= c && c <= '9')) {
+    return ASCII_WORD;
+  }
+  switch (c) {
+    case ' ':
+      return ASCII_SPACE;
+    case ',':
+    case '.':
+    case ':':
+    case ';':
+      return ASCII_INFIX;
+    case '"':
+    case '\'':
+      return ASCII_QUOTE;
+    case '!':
+    case '?':
+      return ASCII_EXCLAIM;
+    default:
+      return ASCII_OTHER;
+  }
+}
+
+// libtxt extension: find the next break without ICU when the text at the
+// current offset is a run of plain ASCII words. Within such a run UAX #14
+// prohibits every break (LB13, LB19, LB23, LB25, LB29) except the one after
+// the trailing spaces (LB18), provided the next word starts with a letter or
+// digit. Returns -1 if the run contains anything else, in which case the
+// caller falls back to ICU.
+ssize_t WordBreaker::findNextBreakInAsciiRun() const {
+  size_t i = mCurrent;
+  AsciiBreakClass previous = ASCII_OTHER;
+  for (; i < mTextSize; i++) {
+    const AsciiBreakClass current = asciiBreakClass(mText[i]);
+    if (current == ASCII_SPACE) {
+      break;
+    }
+    // LB31 allows a break between EX and a following letter or digit, and
+    // ICU has its own opinion about the rest; leave those cases to it.
+    if (current == ASCII_OTHER ||
+        (previous == ASCII_EXCLAIM && current == ASCII_WORD)) {
+      return -1;
+    }
+    previous = current;
+  }
+  if (i == (size_t)mCurrent) {
+    return -1;
+  }
+  while (i < mTextSize && mText[i] == ' ') {
+    i++;
+  }
+  if (i == mTextSize) {
+    return i;
+  }
+  return asciiBreakClass(mText[i]) == ASCII_WORD ? (ssize_t)i : -1;
+}
+
 ssize_t WordBreaker::next() {
   mLast = mCurrent;
 
   detectEmailOrUrl();
   if (mInEmailOrUrl) {
     mCurrent = findNextBreakInEmailOrUrl();
+    return mCurrent;
+  }
+
+  const ssize_t asciiBreak = findNextBreakInAsciiRun();
+  if (asciiBreak >= 0) {
+    mCurrent = asciiBreak;
+    // The ICU iterator did not advance; resynchronize it on the next query.
+    mIteratorWasReset = true;
   } else {  // Business as usual
     mCurrent = (ssize_t)iteratorNext();
   }
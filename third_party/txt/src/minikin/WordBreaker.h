@@ -60,6 +60,7 @@ class WordBreaker {
   int32_t iteratorNext();
   void detectEmailOrUrl();
   ssize_t findNextBreakInEmailOrUrl();
+  ssize_t findNextBreakInAsciiRun() const;
 
   std::unique_ptr<icu::BreakIterator> mBreakIterator;
   UText mUText = UTEXT_INITIALIZER;
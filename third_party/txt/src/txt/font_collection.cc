@@ -334,6 +334,14 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  if (fallback_index_) {
+    const std::shared_ptr<minikin::FontFamily>& indexed =
+        MatchIndexedFallbackFont(ch, locale);
+    if (indexed) {
+      return indexed;
+    }
+  }
+
   for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
     std::vector<const char*> bcp47;
     if (!locale.empty())
@@ -352,11 +360,65 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
                   family_name) == fallback_fonts_for_locale_[locale].end())
       fallback_fonts_for_locale_[locale].push_back(family_name);
 
-    return GetFallbackFontFamily(manager, family_name);
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(manager, family_name);
+    if (family) {
+      UpdateFallbackIndex(locale, family_name, *family);
+    }
+    return family;
   }
   return g_null_family;
 }
 
+const std::shared_ptr<minikin::FontFamily>&
+FontCollection::MatchIndexedFallbackFont(uint32_t ch,
+                                         const std::string& locale) {
+  const std::string* indexed_name =
+      fallback_index_->FindFamilyForChar(ch, locale);
+  if (indexed_name == nullptr) {
+    return g_null_family;
+  }
+  TRACE_EVENT0("flutter", "FontCollection::MatchIndexedFallbackFont");
+  // Copy the name as refreshing the index below may invalidate it.
+  std::string family_name = *indexed_name;
+
+  for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(manager, family_name);
+    if (!family) {
+      continue;
+    }
+    if (!family->getCoverage().get(ch)) {
+      // The installed fonts changed since the index was built. Refresh the
+      // stale coverage and let the font managers resolve this character.
+      UpdateFallbackIndex(locale, family_name, *family);
+      return g_null_family;
+    }
+
+    std::vector<std::string>& locale_families =
+        fallback_fonts_for_locale_[locale];
+    if (std::find(locale_families.begin(), locale_families.end(),
+                  family_name) == locale_families.end())
+      locale_families.push_back(family_name);
+
+    return family;
+  }
+  return g_null_family;
+}
+
+void FontCollection::UpdateFallbackIndex(const std::string& locale,
+                                         const std::string& family_name,
+                                         const minikin::FontFamily& family) {
+  if (!fallback_index_ ||
+      !indexed_fallback_families_[locale].insert(family_name).second) {
+    return;
+  }
+  if (fallback_index_->AddFamily(locale, family_name, family.getCoverage()) &&
+      fallback_index_updated_) {
+    fallback_index_updated_();
+  }
+}
+
 const std::shared_ptr<minikin::FontFamily>&
 FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
                                       const std::string& family_name) {
@@ -381,6 +443,14 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
   return insert_it.first->second;
 }
 
+void FontCollection::SetFallbackIndex(
+    std::unique_ptr<FontFallbackIndex> index,
+    FallbackIndexUpdatedCallback on_updated) {
+  fallback_index_ = std::move(index);
+  fallback_index_updated_ = std::move(on_updated);
+  indexed_fallback_families_.clear();
+}
+
 void FontCollection::ClearFontFamilyCache() {
   font_collections_cache_.clear();
 
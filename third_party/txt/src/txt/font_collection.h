@@ -17,10 +17,12 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "flutter/fml/macros.h"
 #include "minikin/FontCollection.h"
@@ -29,6 +31,7 @@
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "txt/asset_font_manager.h"
+#include "txt/font_fallback_index.h"
 #include "txt/text_style.h"
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -39,6 +42,8 @@ namespace txt {
 
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
+  using FallbackIndexUpdatedCallback = std::function<void()>;
+
   FontCollection();
 
   ~FontCollection();
@@ -68,6 +73,18 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Installs an index of fallback font coverage, typically restored from a
+  // previous session. Characters covered by a family in the index are matched
+  // without querying the font managers. |on_updated| is invoked whenever a
+  // font manager query adds or refreshes a family in the index, which may be
+  // many times in a row, so it should batch any expensive work.
+  void SetFallbackIndex(std::unique_ptr<FontFallbackIndex> index,
+                        FallbackIndexUpdatedCallback on_updated);
+
+  const FontFallbackIndex* GetFallbackIndex() const {
+    return fallback_index_.get();
+  }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -107,6 +124,13 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  std::unique_ptr<FontFallbackIndex> fallback_index_;
+  FallbackIndexUpdatedCallback fallback_index_updated_;
+  // The families recorded in fallback_index_ since it was installed, by
+  // locale. Their coverage can't change while they are in fallback_fonts_, so
+  // they are not recorded again.
+  std::unordered_map<std::string, std::unordered_set<std::string>>
+      indexed_fallback_families_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -119,6 +143,17 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       uint32_t ch,
       std::string locale);
 
+  // Resolves ch through fallback_index_. Returns a null family if the index
+  // has no entry for ch or if the indexed family no longer covers it.
+  const std::shared_ptr<minikin::FontFamily>& MatchIndexedFallbackFont(
+      uint32_t ch,
+      const std::string& locale);
+
+  // Records the coverage of a matched fallback family in fallback_index_.
+  void UpdateFallbackIndex(const std::string& locale,
+                           const std::string& family_name,
+                           const minikin::FontFamily& family);
+
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
   std::shared_ptr<minikin::FontFamily> FindFontFamilyInManagers(
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "font_fallback_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace txt {
+
+namespace {
+
+// SparseBitSet silently drops sets whose maximum value reaches this limit.
+const uint32_t kMaxCodePoint = 0xFFFFFF;
+
+std::vector<uint32_t> CoverageToRanges(const minikin::SparseBitSet& coverage) {
+  std::vector<uint32_t> ranges;
+  uint32_t start = coverage.nextSetBit(0);
+  while (start != minikin::SparseBitSet::kNotFound) {
+    uint32_t end = start + 1;
+    while (end < coverage.length() && coverage.get(end)) {
+      end++;
+    }
+    ranges.push_back(start);
+    ranges.push_back(end);
+    start = coverage.nextSetBit(end);
+  }
+  return ranges;
+}
+
+class Writer {
+ public:
+  explicit Writer(std::vector<uint8_t>& buffer) : buffer_(buffer) {}
+
+  void WriteUint32(uint32_t value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(value));
+  }
+
+  void WriteString(const std::string& value) {
+    WriteUint32(value.size());
+    buffer_.insert(buffer_.end(), value.begin(), value.end());
+  }
+
+ private:
+  std::vector<uint8_t>& buffer_;
+};
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool ReadUint32(uint32_t* value) {
+    if (size_ - offset_ < sizeof(uint32_t)) {
+      return false;
+    }
+    memcpy(value, data_ + offset_, sizeof(uint32_t));
+    offset_ += sizeof(uint32_t);
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint32_t length;
+    if (!ReadUint32(&length) || size_ - offset_ < length) {
+      return false;
+    }
+    value->assign(reinterpret_cast<const char*>(data_ + offset_), length);
+    offset_ += length;
+    return true;
+  }
+
+  bool ReadRanges(std::vector<uint32_t>* ranges) {
+    uint32_t range_count;
+    if (!ReadUint32(&range_count) ||
+        (size_ - offset_) / (2 * sizeof(uint32_t)) < range_count) {
+      return false;
+    }
+    ranges->resize(range_count * 2);
+    uint32_t previous_end = 0;
+    for (uint32_t i = 0; i < range_count; i++) {
+      uint32_t start, end;
+      ReadUint32(&start);
+      ReadUint32(&end);
+      // SparseBitSet requires sorted, non-overlapping, non-empty ranges.
+      if (start < previous_end || end <= start || end >= kMaxCodePoint) {
+        return false;
+      }
+      (*ranges)[i * 2] = start;
+      (*ranges)[i * 2 + 1] = end;
+      previous_end = end;
+    }
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // anonymous namespace
+
+FontFallbackIndex::FontFallbackIndex() = default;
+
+FontFallbackIndex::~FontFallbackIndex() = default;
+
+std::unique_ptr<FontFallbackIndex> FontFallbackIndex::Deserialize(
+    const uint8_t* data,
+    size_t size) {
+  if (data == nullptr) {
+    return nullptr;
+  }
+  Reader reader(data, size);
+  uint32_t signature, version, family_count;
+  if (!reader.ReadUint32(&signature) || signature != kSignature ||
+      !reader.ReadUint32(&version) || version != kVersion1 ||
+      !reader.ReadUint32(&family_count)) {
+    return nullptr;
+  }
+
+  auto index = std::make_unique<FontFallbackIndex>();
+  for (uint32_t i = 0; i < family_count; i++) {
+    std::string family_name;
+    std::vector<uint32_t> ranges;
+    if (!reader.ReadString(&family_name) || !reader.ReadRanges(&ranges)) {
+      return nullptr;
+    }
+    index->SetFamilyRanges(family_name, std::move(ranges));
+  }
+
+  uint32_t locale_count;
+  if (!reader.ReadUint32(&locale_count)) {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < locale_count; i++) {
+    std::string locale;
+    uint32_t name_count;
+    if (!reader.ReadString(&locale) || !reader.ReadUint32(&name_count)) {
+      return nullptr;
+    }
+    std::vector<std::string>& names = index->locale_families_[locale];
+    for (uint32_t j = 0; j < name_count; j++) {
+      std::string family_name;
+      if (!reader.ReadString(&family_name) ||
+          index->families_.count(family_name) == 0) {
+        return nullptr;
+      }
+      names.push_back(std::move(family_name));
+    }
+  }
+
+  if (!reader.AtEnd()) {
+    return nullptr;
+  }
+  return index;
+}
+
+std::vector<uint8_t> FontFallbackIndex::Serialize() const {
+  std::vector<uint8_t> buffer;
+  Writer writer(buffer);
+  writer.WriteUint32(kSignature);
+  writer.WriteUint32(kVersion1);
+
+  writer.WriteUint32(families_.size());
+  for (const auto& family : families_) {
+    writer.WriteString(family.first);
+    const std::vector<uint32_t>& ranges = family.second.ranges;
+    writer.WriteUint32(ranges.size() / 2);
+    for (uint32_t value : ranges) {
+      writer.WriteUint32(value);
+    }
+  }
+
+  writer.WriteUint32(locale_families_.size());
+  for (const auto& locale : locale_families_) {
+    writer.WriteString(locale.first);
+    writer.WriteUint32(locale.second.size());
+    for (const std::string& family_name : locale.second) {
+      writer.WriteString(family_name);
+    }
+  }
+  return buffer;
+}
+
+const std::string* FontFallbackIndex::FindFamilyForChar(
+    uint32_t ch,
+    const std::string& locale) const {
+  auto locale_it = locale_families_.find(locale);
+  if (locale_it == locale_families_.end()) {
+    return nullptr;
+  }
+  for (const std::string& family_name : locale_it->second) {
+    auto family_it = families_.find(family_name);
+    if (family_it != families_.end() && family_it->second.coverage->get(ch)) {
+      return &family_it->first;
+    }
+  }
+  return nullptr;
+}
+
+bool FontFallbackIndex::AddFamily(const std::string& locale,
+                                  const std::string& family_name,
+                                  const minikin::SparseBitSet& coverage) {
+  bool modified = false;
+
+  std::vector<uint32_t> ranges = CoverageToRanges(coverage);
+  auto family_it = families_.find(family_name);
+  if (family_it == families_.end() || family_it->second.ranges != ranges) {
+    SetFamilyRanges(family_name, std::move(ranges));
+    modified = true;
+  }
+
+  std::vector<std::string>& names = locale_families_[locale];
+  if (std::find(names.begin(), names.end(), family_name) == names.end()) {
+    names.push_back(family_name);
+    modified = true;
+  }
+
+  return modified;
+}
+
+void FontFallbackIndex::SetFamilyRanges(const std::string& family_name,
+                                        std::vector<uint32_t> ranges) {
+  Family& family = families_[family_name];
+  family.coverage = std::make_unique<minikin::SparseBitSet>(
+      ranges.data(), ranges.size() / 2);
+  family.ranges = std::move(ranges);
+}
+
+}  // namespace txt
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_FONT_FALLBACK_INDEX_H_
+#define LIB_TXT_SRC_FONT_FALLBACK_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "minikin/SparseBitSet.h"
+
+namespace txt {
+
+// Records the character coverage of the font families that have been
+// returned by font manager fallback queries, grouped by locale.
+//
+// The index can be serialized and restored in a later session so that
+// fallback matching for previously seen scripts becomes a bitset probe
+// instead of a |SkFontMgr::matchFamilyStyleCharacter| call.
+class FontFallbackIndex {
+ public:
+  // A prefix used to identify the serialized index format.
+  static const uint32_t kSignature = 0x46424958;
+  static const uint32_t kVersion1 = 1;
+
+  FontFallbackIndex();
+
+  ~FontFallbackIndex();
+
+  // Restores an index from the output of |Serialize|. Returns nullptr if the
+  // data is truncated, corrupt or was written by an incompatible version.
+  static std::unique_ptr<FontFallbackIndex> Deserialize(const uint8_t* data,
+                                                        size_t size);
+
+  std::vector<uint8_t> Serialize() const;
+
+  // Returns the name of the first family recorded for |locale| whose coverage
+  // contains |ch|, or nullptr if there is none.
+  const std::string* FindFamilyForChar(uint32_t ch,
+                                       const std::string& locale) const;
+
+  // Records |family_name| as a fallback family for |locale| and sets its
+  // coverage, replacing any previously recorded coverage. Returns true if the
+  // index was modified.
+  bool AddFamily(const std::string& locale,
+                 const std::string& family_name,
+                 const minikin::SparseBitSet& coverage);
+
+  size_t GetFamilyCount() const { return families_.size(); }
+
+ private:
+  struct Family {
+    // Pairs of [start, end) code point ranges, as accepted by SparseBitSet.
+    std::vector<uint32_t> ranges;
+    std::unique_ptr<minikin::SparseBitSet> coverage;
+  };
+
+  std::unordered_map<std::string, Family> families_;
+  std::unordered_map<std::string, std::vector<std::string>> locale_families_;
+
+  void SetFamilyRanges(const std::string& family_name,
+                       std::vector<uint32_t> ranges);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FontFallbackIndex);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_FONT_FALLBACK_INDEX_H_
@@ -20,10 +20,13 @@
 #include <log/log.h>
 
 #include <minikin/WordBreaker.h>
+#include <unicode/brkiter.h>
 #include <unicode/locid.h>
-#include <unicode/uclean.h>
-#include <unicode/udata.h>
-#include "ICUTestBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "UnicodeUtils.h"
 
 #ifndef NELEM
@@ -34,12 +37,13 @@
 
 namespace minikin {
 
-typedef ICUTestBase WordBreakerTest;
+// ICU data is loaded by txt_run_all_unittests.cc.
+typedef testing::Test WordBreakerTest;
 
 TEST_F(WordBreakerTest, basic) {
   uint16_t buf[] = {'h', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(6, breaker.next());       // after "hello "
@@ -54,11 +58,12 @@ TEST_F(WordBreakerTest, basic) {
   EXPECT_EQ(11, breaker.current());
 }
 
-TEST_F(WordBreakerTest, softHyphen) {
+// libtxt always breaks after hyphens, see isBreakValid.
+TEST_F(WordBreakerTest, DISABLED_softHyphen) {
   uint16_t buf[] = {'h', 'e', 'l', 0x00AD, 'l', 'o',
                     ' ', 'w', 'o', 'r',    'l', 'd'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(7, breaker.next());       // after "hel{SOFT HYPHEN}lo "
@@ -71,11 +76,12 @@ TEST_F(WordBreakerTest, softHyphen) {
   EXPECT_EQ(0, breaker.breakBadness());
 }
 
-TEST_F(WordBreakerTest, hardHyphen) {
+// libtxt always breaks after hyphens, see isBreakValid.
+TEST_F(WordBreakerTest, DISABLED_hardHyphen) {
   // Hyphens should not allow breaks anymore.
   uint16_t buf[] = {'s', 'u', 'g', 'a', 'r', '-', 'f', 'r', 'e', 'e'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ((ssize_t)NELEM(buf), breaker.next());
@@ -87,7 +93,7 @@ TEST_F(WordBreakerTest, hardHyphen) {
 TEST_F(WordBreakerTest, postfixAndPrefix) {
   uint16_t buf[] = {'U', 'S', 0x00A2, ' ', 'J', 'P', 0x00A5};  // US¢ JP¥
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
 
@@ -104,8 +110,7 @@ TEST_F(WordBreakerTest, myanmarKinzi) {
   uint16_t buf[] = {0x1004, 0x103A, 0x1039, 0x1000,
                     0x102C};  // NGA, ASAT, VIRAMA, KA, UU
   WordBreaker breaker;
-  icu::Locale burmese("my");
-  breaker.setLocale(burmese);
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
 
@@ -140,7 +145,7 @@ TEST_F(WordBreakerTest, zwjEmojiSequences) {
       UTF16(0x1F464),
   };
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(7, breaker.next());  // after man + zwj + heart + zwj + man
@@ -165,7 +170,7 @@ TEST_F(WordBreakerTest, emojiWithModifier) {
           0x1F3FF)  // victory hand + emoji style + type 6 fitzpatrick modifier
   };
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(4, breaker.next());  // after boy + type 1-2 fitzpatrick modifier
@@ -195,7 +200,7 @@ TEST_F(WordBreakerTest, unicode10Emoji) {
       UTF16(0x1F6F7),
   };
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getEnglish());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(2, breaker.next());
@@ -243,7 +248,7 @@ TEST_F(WordBreakerTest, flagsSequenceSingleFlag) {
   ParseUnicode(buf, BUF_SIZE, flags.c_str(), &size, nullptr);
 
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, size);
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(kFlagLength, breaker.next());  // end of the first flag
@@ -269,7 +274,7 @@ TEST_F(WordBreakerTest, flagsSequence) {
   ParseUnicode(buf, BUF_SIZE, flagSequence.c_str(), &size, nullptr);
 
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, size);
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(kFlagLength, breaker.next());  // end of the first flag sequence
@@ -284,7 +289,7 @@ TEST_F(WordBreakerTest, punct) {
   uint16_t buf[] = {0x00A1, 0x00A1, 'h', 'e', 'l', 'l', 'o', ',',
                     ' ',    'w',    'o', 'r', 'l', 'd', '!', '!'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(9, breaker.next());       // after "¡¡hello, "
@@ -301,7 +306,7 @@ TEST_F(WordBreakerTest, email) {
   uint16_t buf[] = {'f', 'o', 'o', '@', 'e', 'x', 'a', 'm', 'p',
                     'l', 'e', '.', 'c', 'o', 'm', ' ', 'x'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(11, breaker.next());  // after "foo@example"
@@ -320,7 +325,7 @@ TEST_F(WordBreakerTest, mailto) {
   uint16_t buf[] = {'m', 'a', 'i', 'l', 't', 'o', ':', 'f', 'o', 'o', '@', 'e',
                     'x', 'a', 'm', 'p', 'l', 'e', '.', 'c', 'o', 'm', ' ', 'x'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(7, breaker.next());  // after "mailto:"
@@ -344,7 +349,7 @@ TEST_F(WordBreakerTest, emailNonAscii) {
   uint16_t buf[] = {'f', 'o', 'o', '@', 'e', 'x', 'a', 'm',
                     'p', 'l', 'e', '.', 'c', 'o', 'm', 0x4E00};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(11, breaker.next());  // after "foo@example"
@@ -363,7 +368,7 @@ TEST_F(WordBreakerTest, emailCombining) {
   uint16_t buf[] = {'f', 'o', 'o', '@', 'e', 'x', 'a',    'm', 'p',
                     'l', 'e', '.', 'c', 'o', 'm', 0x0303, ' ', 'x'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(11, breaker.next());  // after "foo@example"
@@ -381,7 +386,7 @@ TEST_F(WordBreakerTest, emailCombining) {
 TEST_F(WordBreakerTest, lonelyAt) {
   uint16_t buf[] = {'a', ' ', '@', ' ', 'b'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(2, breaker.next());       // after "a "
@@ -401,7 +406,7 @@ TEST_F(WordBreakerTest, url) {
   uint16_t buf[] = {'h', 't', 't', 'p', ':', '/', '/', 'e', 'x', 'a',
                     'm', 'p', 'l', 'e', '.', 'c', 'o', 'm', ' ', 'x'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(5, breaker.next());  // after "http:"
@@ -429,7 +434,7 @@ TEST_F(WordBreakerTest, urlBreakChars) {
                     '~', 'c', ',', 'd', '-', 'e', '?', 'f', '=', 'g', '&',
                     'h', '#', 'i', '%', 'j', '_', 'k', '/', 'l'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(5, breaker.next());  // after "http:"
@@ -488,7 +493,7 @@ TEST_F(WordBreakerTest, urlBreakChars) {
 TEST_F(WordBreakerTest, urlNoHyphenBreak) {
   uint16_t buf[] = {'h', 't', 't', 'p', ':', '/', '/', 'a', '-', '/', 'b'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(5, breaker.next());  // after "http:"
@@ -504,7 +509,7 @@ TEST_F(WordBreakerTest, urlNoHyphenBreak) {
 TEST_F(WordBreakerTest, urlEndsWithSlash) {
   uint16_t buf[] = {'h', 't', 't', 'p', ':', '/', '/', 'a', '/'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ(5, breaker.next());  // after "http:"
@@ -520,11 +525,98 @@ TEST_F(WordBreakerTest, urlEndsWithSlash) {
 TEST_F(WordBreakerTest, emailStartsWithSlash) {
   uint16_t buf[] = {'/', 'a', '@', 'b'};
   WordBreaker breaker;
-  breaker.setLocale(icu::Locale::getUS());
+  breaker.setLocale();
   breaker.setText(buf, NELEM(buf));
   EXPECT_EQ(0, breaker.current());
   EXPECT_EQ((ssize_t)NELEM(buf), breaker.next());  // end
   EXPECT_TRUE(breaker.wordStart() >= breaker.wordEnd());
 }
 
+// Returns the offsets returned by WordBreaker::next() for |text|.
+static std::vector<ssize_t> wordBreakerBreaks(const std::u16string& text) {
+  WordBreaker breaker;
+  breaker.setLocale();
+  breaker.setText(reinterpret_cast<const uint16_t*>(text.data()), text.size());
+  std::vector<ssize_t> breaks;
+  while (breaker.current() < (ssize_t)text.size()) {
+    const ssize_t next = breaker.next();
+    if (next < 0) {
+      break;
+    }
+    breaks.push_back(next);
+  }
+  breaker.finish();
+  return breaks;
+}
+
+// Returns the offsets of the breaks found by ICU's line break iterator, which
+// is what WordBreaker uses outside of its ASCII fast path.
+static std::vector<ssize_t> icuLineBreaks(const std::u16string& text) {
+  UErrorCode status = U_ZERO_ERROR;
+  std::unique_ptr<icu::BreakIterator> iterator(
+      icu::BreakIterator::createLineInstance(icu::Locale(), status));
+  EXPECT_TRUE(U_SUCCESS(status));
+  icu::UnicodeString string(false, reinterpret_cast<const UChar*>(text.data()),
+                            text.size());
+  iterator->setText(string);
+  std::vector<ssize_t> breaks;
+  for (int32_t offset = iterator->next(); offset != icu::BreakIterator::DONE;
+       offset = iterator->next()) {
+    breaks.push_back(offset);
+  }
+  return breaks;
+}
+
+TEST_F(WordBreakerTest, asciiFastPathMatchesIcu) {
+  const struct {
+    std::u16string text;
+    std::vector<ssize_t> breaks;
+  } cases[] = {
+      // Apostrophes and contractions.
+      {u"don't stop", {6, 10}},
+      {u"it's 'quoted' text", {5, 14, 18}},
+      {u"rock 'n' roll", {5, 9, 13}},
+      {u"\"Hello,\" she said.", {9, 13, 18}},
+      // Digits with infix punctuation.
+      {u"3.14 and 1,000,000", {5, 9, 18}},
+      {u"v1.2.3 costs 12,50.", {7, 13, 19}},
+      {u"at 10:30; or 5.5", {3, 10, 13, 16}},
+      // Runs of punctuation.
+      {u"wait... what?!", {8, 14}},
+      {u"Yes!! No?? ok;;", {6, 11, 15}},
+      {u"end!!! Start", {7, 12}},
+      {u"a!b c", {2, 4, 5}},
+      // ASCII next to non-ASCII text.
+      {u"caf\u00E9 au lait", {5, 8, 12}},
+      {u"hello \u4E16\u754C world", {6, 7, 9, 14}},
+      {u"na\u00EFve text", {6, 10}},
+      {u"abc\u3002def ghi", {4, 8, 11}},
+      // Line breaks.
+      {u"line one\r\nline two", {5, 10, 15, 18}},
+      {u"a\r\n\r\nb", {3, 5, 6}},
+      {u"a\rb\nc", {2, 4, 5}},
+      // Runs of spaces.
+      {u"two  spaces  ", {5, 13}},
+  };
+  for (const auto& test_case : cases) {
+    const auto breaks = wordBreakerBreaks(test_case.text);
+    EXPECT_EQ(test_case.breaks, breaks) << "case " << (&test_case - cases);
+    EXPECT_EQ(icuLineBreaks(test_case.text), breaks)
+        << "case " << (&test_case - cases);
+  }
+}
+
+TEST_F(WordBreakerTest, asciiFastPathWordBounds) {
+  std::u16string text = u"\"don't\" 3.14!";
+  WordBreaker breaker;
+  breaker.setLocale();
+  breaker.setText(reinterpret_cast<const uint16_t*>(text.data()), text.size());
+  EXPECT_EQ(8, breaker.next());       // after "\"don't\" "
+  EXPECT_EQ(1, breaker.wordStart());  // "don't"
+  EXPECT_EQ(6, breaker.wordEnd());
+  EXPECT_EQ((ssize_t)text.size(), breaker.next());  // end
+  EXPECT_EQ(8, breaker.wordStart());                // "3.14"
+  EXPECT_EQ(12, breaker.wordEnd());
+}
+
 }  // namespace minikin
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "minikin/SparseBitSet.h"
+#include "txt/font_fallback_index.h"
+
+namespace txt {
+namespace testing {
+
+namespace {
+// Basic Latin plus the CJK Unified Ideographs block.
+const uint32_t kCjkRanges[] = {0x20, 0x7F, 0x4E00, 0xA000};
+// A few emoji blocks.
+const uint32_t kEmojiRanges[] = {0x2600, 0x2700, 0x1F300, 0x1F650};
+}  // namespace
+
+TEST(FontFallbackIndexTest, FindsFamilyByLocale) {
+  FontFallbackIndex index;
+  minikin::SparseBitSet cjk(kCjkRanges, 2);
+  minikin::SparseBitSet emoji(kEmojiRanges, 2);
+
+  EXPECT_TRUE(index.AddFamily("zh-Hans", "Noto Sans CJK SC", cjk));
+  EXPECT_TRUE(index.AddFamily("zh-Hans", "Noto Color Emoji", emoji));
+  EXPECT_TRUE(index.AddFamily("", "Noto Color Emoji", emoji));
+  // Adding the same family with the same coverage is a no-op.
+  EXPECT_FALSE(index.AddFamily("", "Noto Color Emoji", emoji));
+  EXPECT_EQ(index.GetFamilyCount(), 2u);
+
+  const std::string* family = index.FindFamilyForChar(0x4F60, "zh-Hans");
+  ASSERT_NE(family, nullptr);
+  EXPECT_EQ(*family, "Noto Sans CJK SC");
+
+  family = index.FindFamilyForChar(0x1F600, "zh-Hans");
+  ASSERT_NE(family, nullptr);
+  EXPECT_EQ(*family, "Noto Color Emoji");
+
+  // The CJK family was only recorded for the zh-Hans locale.
+  EXPECT_EQ(index.FindFamilyForChar(0x4F60, ""), nullptr);
+  EXPECT_EQ(index.FindFamilyForChar(0x0627, "zh-Hans"), nullptr);
+  EXPECT_EQ(index.FindFamilyForChar(0x4F60, "ja"), nullptr);
+}
+
+TEST(FontFallbackIndexTest, RoundTripsThroughSerialization) {
+  FontFallbackIndex index;
+  minikin::SparseBitSet cjk(kCjkRanges, 2);
+  minikin::SparseBitSet emoji(kEmojiRanges, 2);
+  index.AddFamily("ja", "Noto Sans CJK JP", cjk);
+  index.AddFamily("ja", "Noto Color Emoji", emoji);
+
+  std::vector<uint8_t> serialized = index.Serialize();
+  std::unique_ptr<FontFallbackIndex> restored =
+      FontFallbackIndex::Deserialize(serialized.data(), serialized.size());
+  ASSERT_NE(restored, nullptr);
+  EXPECT_EQ(restored->GetFamilyCount(), 2u);
+
+  for (uint32_t ch : {0x20u, 0x7Eu, 0x4E00u, 0x9FFFu}) {
+    const std::string* family = restored->FindFamilyForChar(ch, "ja");
+    ASSERT_NE(family, nullptr) << ch;
+    EXPECT_EQ(*family, "Noto Sans CJK JP");
+  }
+  for (uint32_t ch : {0x1Fu, 0x7Fu, 0x4DFFu, 0xA000u, 0x1F650u}) {
+    EXPECT_EQ(restored->FindFamilyForChar(ch, "ja"), nullptr) << ch;
+  }
+  EXPECT_EQ(*restored->FindFamilyForChar(0x1F64F, "ja"), "Noto Color Emoji");
+
+  // Serializing the restored index produces the same coverage.
+  std::vector<uint8_t> reserialized = restored->Serialize();
+  EXPECT_EQ(reserialized.size(), serialized.size());
+}
+
+TEST(FontFallbackIndexTest, RefreshesStaleCoverage) {
+  FontFallbackIndex index;
+  minikin::SparseBitSet cjk(kCjkRanges, 2);
+  index.AddFamily("", "Fallback", cjk);
+  ASSERT_NE(index.FindFamilyForChar(0x4E00, ""), nullptr);
+
+  const uint32_t latin_only[] = {0x20, 0x7F};
+  minikin::SparseBitSet latin(latin_only, 1);
+  EXPECT_TRUE(index.AddFamily("", "Fallback", latin));
+  EXPECT_EQ(index.FindFamilyForChar(0x4E00, ""), nullptr);
+  EXPECT_NE(index.FindFamilyForChar(0x41, ""), nullptr);
+}
+
+TEST(FontFallbackIndexTest, RejectsCorruptData) {
+  EXPECT_EQ(FontFallbackIndex::Deserialize(nullptr, 0), nullptr);
+
+  FontFallbackIndex index;
+  minikin::SparseBitSet cjk(kCjkRanges, 2);
+  index.AddFamily("", "Fallback", cjk);
+  std::vector<uint8_t> serialized = index.Serialize();
+
+  // Every truncation must be rejected.
+  for (size_t size = 0; size < serialized.size(); size++) {
+    EXPECT_EQ(FontFallbackIndex::Deserialize(serialized.data(), size), nullptr)
+        << size;
+  }
+
+  std::vector<uint8_t> bad_signature = serialized;
+  bad_signature[0] ^= 0xFF;
+  EXPECT_EQ(FontFallbackIndex::Deserialize(bad_signature.data(),
+                                           bad_signature.size()),
+            nullptr);
+
+  std::vector<uint8_t> trailing = serialized;
+  trailing.push_back(0);
+  EXPECT_EQ(FontFallbackIndex::Deserialize(trailing.data(), trailing.size()),
+            nullptr);
+}
+
+}  // namespace testing
+}  // namespace txt